@@ -0,0 +1,364 @@
+// Headless simulation runner: steps ParticleScene or PhysicsTestScene with a
+// fixed seed and fixed steps, as fast as possible, without a window. Prints
+// throughput, contacts and peak memory, and optionally a checksum of every
+// TransformComponent position so optimizations can be checked bit-exact.
+//
+//   HeadlessRunner --scene particles --seed 42 --steps 3600 --particles 2000 --checksum
+#include "../../Common/include/FrameArena.h"
+#include "../../Common/include/JobSystem.h"
+#include "../../Common/include/Profiler.h"
+#include "../../Logic/include/ParticleScene.h"
+#include "../../Logic/include/PhysicsTestScene.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+struct RunnerOptions {
+  std::string scene = "particles";
+  uint32_t seed = 1;
+  int steps = 3600;
+  size_t particles = 1000;   // Particle scene: total to spawn
+  int spawnPerStep = 4;      // Particle scene: 0 spawns them all before the first step
+  int cubes = 0;             // Physics scene: random cubes added up front
+  std::string broadphase;    // Empty keeps the scene's default
+  std::string collisionMode; // Likewise
+  std::string resolution;    // Likewise
+  bool jobs = false;         // Start the job system (parallel loops no longer run inline)
+  size_t threads = 0;        // Job system workers, 0 = one per spare hardware thread (at least one)
+  bool checksum = false;
+  int checksumEvery = 0;
+  std::string tracePath;     // Chrome trace of the last profiled steps
+  std::string loadPath;      // Snapshot replacing the scene's initial state
+  std::string savePath;      // Snapshot of the final state
+};
+
+void PrintUsage() {
+  std::cout << "Usage: HeadlessRunner [options]\n"
+            << "  --scene particles|physics  Scene to run (default particles)\n"
+            << "  --seed N                   Random seed (default 1)\n"
+            << "  --steps N                  Fixed steps to run (default 3600)\n"
+            << "  --particles N              Particles to spawn (default 1000)\n"
+            << "  --spawn-per-step N         Particles spawned per step, 0 = all at once (default 4)\n"
+            << "  --cubes N                  Random cubes for the physics scene (default 0)\n"
+            << "  --broadphase brute|hash|sap\n"
+            << "  --collision-mode sequential|parallel\n"
+            << "                             Particle scene collision mode; parallel runs\n"
+            << "                             the narrowphase on the job system\n"
+            << "  --resolution pair|iterative\n"
+            << "                             Particle scene contact resolution\n"
+            << "  --jobs                     Start the job system worker threads. Only\n"
+            << "                             parallel code paths use them: the broadphase,\n"
+            << "                             transform rebuilds, and the narrowphase with\n"
+            << "                             --collision-mode parallel\n"
+            << "  --threads N                Job system workers, implies --jobs (default one\n"
+            << "                             per spare hardware thread, at least one)\n"
+            << "  --checksum                 Print a checksum of all positions at the end\n"
+            << "  --checksum-every N         Also print it every N steps\n"
+            << "  --trace FILE               Write a Chrome trace of the last steps\n"
+            << "  --load FILE                Start from a scene snapshot (add --particles 0\n"
+            << "                             to spawn nothing on top)\n"
+            << "  --save FILE                Write a scene snapshot at the end\n";
+}
+
+bool ParseOptions(int argc, char **argv, RunnerOptions &options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    auto value = [&]() -> const char * {
+      if (i + 1 >= argc) {
+        std::cerr << "Missing value for " << arg << std::endl;
+        return nullptr;
+      }
+      return argv[++i];
+    };
+
+    if (arg == "--help" || arg == "-h") {
+      PrintUsage();
+      std::exit(0);
+    } else if (arg == "--jobs") {
+      options.jobs = true;
+    } else if (arg == "--checksum") {
+      options.checksum = true;
+    } else if (arg == "--scene" || arg == "--broadphase" || arg == "--collision-mode" ||
+               arg == "--resolution" || arg == "--trace" || arg == "--load" || arg == "--save") {
+      const char *text = value();
+      if (!text)
+        return false;
+      (arg == "--scene"            ? options.scene
+       : arg == "--broadphase"     ? options.broadphase
+       : arg == "--collision-mode" ? options.collisionMode
+       : arg == "--resolution"     ? options.resolution
+       : arg == "--trace"          ? options.tracePath
+       : arg == "--load"           ? options.loadPath
+                                   : options.savePath) = text;
+    } else if (arg == "--seed" || arg == "--steps" || arg == "--particles" ||
+               arg == "--spawn-per-step" || arg == "--cubes" || arg == "--checksum-every" ||
+               arg == "--threads") {
+      const char *text = value();
+      if (!text)
+        return false;
+      char *end = nullptr;
+      const unsigned long long number = std::strtoull(text, &end, 10);
+      if (!*text || *end) {
+        std::cerr << "Invalid number for " << arg << ": " << text << std::endl;
+        return false;
+      }
+      if (arg == "--seed") {
+        options.seed = static_cast<uint32_t>(number);
+      } else if (arg == "--steps") {
+        options.steps = static_cast<int>(number);
+      } else if (arg == "--particles") {
+        options.particles = static_cast<size_t>(number);
+      } else if (arg == "--spawn-per-step") {
+        options.spawnPerStep = static_cast<int>(number);
+      } else if (arg == "--cubes") {
+        options.cubes = static_cast<int>(number);
+      } else if (arg == "--threads") {
+        options.threads = static_cast<size_t>(number);
+        options.jobs = true;
+      } else {
+        options.checksumEvery = static_cast<int>(number);
+        options.checksum = true;
+      }
+    } else {
+      std::cerr << "Unknown option " << arg << std::endl;
+      PrintUsage();
+      return false;
+    }
+  }
+
+  if (options.scene != "particles" && options.scene != "physics") {
+    std::cerr << "Unknown scene " << options.scene << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// FNV-1a over entity IDs and the raw bits of their double-precision
+// positions, so any change in the last bit of any coordinate shows up
+uint64_t PositionChecksum(const Engine::Logic::Scene &scene) {
+  uint64_t hash = 14695981039346656037ull;
+  auto mix = [&hash](const void *data, size_t size) {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++i) {
+      hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+  };
+
+  for (const auto &entity : scene.GetEntities()) {
+    if (!entity)
+      continue;
+    auto transform = entity->GetComponent<Engine::Logic::TransformComponent>();
+    if (!transform)
+      continue;
+    const int id = entity->GetID();
+    const glm::dvec3 &position = transform->GetPrecisePosition();
+    const double coordinates[3] = {position.x, position.y, position.z};
+    mix(&id, sizeof(id));
+    mix(coordinates, sizeof(coordinates));
+  }
+  return hash;
+}
+
+std::string ToHex(uint64_t value) {
+  char text[17];
+  std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(value));
+  return text;
+}
+
+// Peak resident set size of the process in bytes, 0 if unknown
+size_t PeakMemory() {
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+    return counters.PeakWorkingSetSize;
+  }
+  return 0;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#ifdef __APPLE__
+  return static_cast<size_t>(usage.ru_maxrss); // Bytes on macOS
+#else
+  return static_cast<size_t>(usage.ru_maxrss) * 1024; // Kilobytes on Linux
+#endif
+#endif
+}
+
+bool ApplyBroadphase(Engine::Logic::CollisionSystem &collisions, const std::string &name) {
+  using Engine::Logic::BroadphaseType;
+  if (name.empty())
+    return true;
+  if (name == "brute") {
+    collisions.SetBroadphase(BroadphaseType::BRUTE_FORCE);
+  } else if (name == "hash") {
+    collisions.SetBroadphase(BroadphaseType::SPATIAL_HASH);
+  } else if (name == "sap") {
+    collisions.SetBroadphase(BroadphaseType::SWEEP_AND_PRUNE);
+  } else {
+    std::cerr << "Unknown broadphase " << name << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool ApplyCollisionSettings(Engine::Logic::CollisionSystem &collisions,
+                            const RunnerOptions &options) {
+  using Engine::Logic::CollisionMode;
+  using Engine::Logic::ContactResolution;
+  if (options.collisionMode == "sequential") {
+    collisions.SetMode(CollisionMode::SEQUENTIAL);
+  } else if (options.collisionMode == "parallel") {
+    collisions.SetMode(CollisionMode::PARALLEL);
+  } else if (!options.collisionMode.empty()) {
+    std::cerr << "Unknown collision mode " << options.collisionMode << std::endl;
+    return false;
+  }
+
+  if (options.resolution == "pair") {
+    collisions.SetResolution(ContactResolution::PER_PAIR);
+  } else if (options.resolution == "iterative") {
+    collisions.SetResolution(ContactResolution::ITERATIVE);
+  } else if (!options.resolution.empty()) {
+    std::cerr << "Unknown resolution " << options.resolution << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  RunnerOptions options;
+  if (!ParseOptions(argc, argv, options)) {
+    return 1;
+  }
+
+  PROFILE_THREAD("Main");
+  if (options.jobs) {
+    Engine::Common::JobSystem::Get().Start(options.threads);
+  }
+
+  std::unique_ptr<Engine::Logic::ParticleScene> particleScene;
+  std::unique_ptr<Engine::Logic::PhysicsTestScene> physicsScene;
+  std::shared_ptr<Engine::Logic::Scene> scene;
+
+  if (options.scene == "particles") {
+    particleScene = std::make_unique<Engine::Logic::ParticleScene>(options.seed);
+    particleScene->SetVerbose(false);
+    particleScene->ReserveParticles(options.particles);
+    if (!ApplyBroadphase(*particleScene->GetCollisionSystem(), options.broadphase) ||
+        !ApplyCollisionSettings(*particleScene->GetCollisionSystem(), options)) {
+      return 1;
+    }
+    scene = particleScene->GetScene();
+  } else {
+    physicsScene = std::make_unique<Engine::Logic::PhysicsTestScene>(options.seed);
+    physicsScene->SetVerbose(false);
+    for (int i = 0; i < options.cubes; ++i) {
+      physicsScene->SpawnRandomCube();
+    }
+    scene = physicsScene->GetScene();
+  }
+
+  if (!options.loadPath.empty()) {
+    const auto loadStart = std::chrono::steady_clock::now();
+    const bool loaded = particleScene ? particleScene->LoadSnapshot(options.loadPath)
+                                      : physicsScene->LoadSnapshot(options.loadPath);
+    if (!loaded) {
+      return 1;
+    }
+    std::cout << "Loaded " << scene->GetEntityCount() << " entities from " << options.loadPath << " in "
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count()
+              << " ms" << std::endl;
+  }
+
+  const float stepSize = scene->GetTimestep().GetStepSize();
+  size_t spawned = 0;
+  size_t totalContacts = 0;
+  size_t maxContacts = 0;
+
+  std::cout << "Running " << options.scene << " scene, seed " << options.seed << ", "
+            << options.steps << " steps of " << stepSize * 1000.0f << " ms" << std::endl;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int step = 0; step < options.steps; ++step) {
+    PROFILE_FRAME();
+    Engine::Common::FrameArena::Get().BeginFrame();
+
+    if (particleScene) {
+      const size_t batch = options.spawnPerStep > 0 ? static_cast<size_t>(options.spawnPerStep)
+                                                    : options.particles;
+      for (size_t i = 0; i < batch && spawned < options.particles; ++i, ++spawned) {
+        particleScene->SpawnParticle();
+      }
+      particleScene->Update(stepSize);
+
+      // Contacts of the step's last substep
+      const size_t contacts = particleScene->GetCollisionSystem()->GetContacts().size();
+      totalContacts += contacts;
+      maxContacts = std::max(maxContacts, contacts);
+    } else {
+      physicsScene->Update(stepSize);
+    }
+
+    if (options.checksumEvery > 0 && (step + 1) % options.checksumEvery == 0) {
+      std::cout << "step " << (step + 1) << " checksum " << ToHex(PositionChecksum(*scene))
+                << std::endl;
+    }
+  }
+  const double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  PROFILE_FRAME(); // Closes the last step for the trace
+
+  const double steps = static_cast<double>(std::max(options.steps, 1));
+  std::cout << "Steps:          " << options.steps << " in " << seconds << " s" << std::endl;
+  std::cout << "Steps/sec:      " << (seconds > 0.0 ? options.steps / seconds : 0.0) << std::endl;
+  std::cout << "ms/step:        " << seconds * 1000.0 / steps << std::endl;
+  std::cout << "Entities:       " << scene->GetEntityCount() << std::endl;
+  if (particleScene) {
+    std::cout << "Contacts/step:  " << totalContacts / steps << " (max " << maxContacts << ")"
+              << std::endl;
+  }
+  std::cout << "Peak memory:    " << PeakMemory() / (1024.0 * 1024.0) << " MB" << std::endl;
+  if (scene->GetTimestep().GetDroppedTime() > 0.0f) {
+    std::cout << "Warning: " << scene->GetTimestep().GetDroppedTime() << " s of simulation dropped"
+              << std::endl;
+  }
+  if (options.checksum) {
+    std::cout << "Checksum:       " << ToHex(PositionChecksum(*scene)) << std::endl;
+  }
+
+  if (!options.savePath.empty()) {
+    const bool saved = particleScene ? particleScene->SaveSnapshot(options.savePath)
+                                     : physicsScene->SaveSnapshot(options.savePath);
+    if (!saved) {
+      return 1;
+    }
+  }
+
+  if (!options.tracePath.empty()) {
+    Engine::Common::Profiler::Get().WriteChromeTrace(options.tracePath);
+  }
+
+  // Scenes go before the job system, their systems may still hold jobs
+  particleScene.reset();
+  physicsScene.reset();
+  scene.reset();
+  Engine::Common::JobSystem::Get().Stop();
+  return 0;
+}
@@ -1,34 +1,82 @@
 #include "../../../renderer/include/ImGuiManager.h"
+#include "../../Common/include/FrameArena.h"
+#include "../../Common/include/GpuParticleSystem.h"
+#include "../../Common/include/JobSystem.h"
+#include "../../Common/include/ProfilerPanel.h"
 #include "../../Common/include/RendererWrapper.h"
 #include "../../Logic/include/DemoScene.h"
 #include "../../Logic/include/ParticleScene.h"
 #include "../../Logic/include/PhysicsTestScene.h"
 #include "../../Logic/include/SceneManager.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
 #include <glm/glm.hpp>
 #include <iostream>
-
-enum class AppState { MAIN_MENU, DEMO_SCENE, PHYSICS_SCENE, EXITING };
+#include <string>
+#include <vector>
+
+enum class AppState {
+  MAIN_MENU,
+  DEMO_SCENE,
+  PHYSICS_SCENE,
+  PARTICLE_SCENE,
+  EXITING
+};
 
 class BasicEngineApp {
 private:
   Engine::Common::OpenGLRendererWrapper renderer;
   Engine::Logic::SceneManager sceneManager;
 
-  std::unique_ptr<Engine::Logic::DemoScene> demoScene;
-  std::unique_ptr<Engine::Logic::PhysicsTestScene> physicsScene;
+  // Built on the scene manager's loader thread the first time each scene is
+  // picked, null until then
+  std::shared_ptr<Engine::Logic::DemoScene> demoScene;
+  std::shared_ptr<Engine::Logic::PhysicsTestScene> physicsScene;
+  std::shared_ptr<Engine::Logic::ParticleScene> particleScene;
 
   AppState currentState = AppState::MAIN_MENU;
   AppState nextState = AppState::MAIN_MENU;
   bool stateTransitionPending = false;
+  AppState loadingState = AppState::MAIN_MENU; // Entered once its scene is current
+  bool stateLoadPending = false;
+
+  // Particles the pool holds before the first spawn burst
+  static constexpr size_t PARTICLE_POOL_SIZE = 2048;
+
+  // GPU mode of the particle scene, created the first time it is switched
+  // on. The box keeps particles that miss the cup; tall, since bursts are
+  // spawned in rows above it.
+  static constexpr size_t GPU_PARTICLE_CAPACITY = 1 << 18;
+  static constexpr float GPU_BOUNDS_HALF_WIDTH = 2048.0f;
+  static constexpr float GPU_BOUNDS_BELOW = 512.0f;
+  static constexpr float GPU_BOUNDS_ABOVE = 16384.0f;
+  Engine::Common::GpuParticleSystem gpuParticles;
+  uint32_t gpuCupRevision = 0; // Walls uploaded for this cup
+  std::vector<Engine::Logic::ParticleScene::ParticleSpawn> gpuSpawns;
+  std::vector<Engine::Common::GpuParticleSystem::Particle> gpuUploads;
+  std::string gpuStatus;
 
   bool showMainMenu = true;
   bool showDebugInfo = false;
+  bool showProfiler = false;
+  Engine::Common::ProfilerPanel profilerPanel;
 
   bool physicsEnabled = true;
   float physicsTimeScale = 1.0f;
-  // float particleRadius = 8.0f;
-  // bool particlePhysicsEnabled = true;
-  // float particleTimeScale = 1.0f;
+  float particleRadius = 8.0f;
+  bool particlePhysicsEnabled = true;
+  float particleTimeScale = 1.0f;
+
+  // Scene snapshots (SceneSerializer)
+  char snapshotPath[256] = "scene.besc";
+  std::string snapshotStatus;
+
+  // Instance data for the current frame
+  std::vector<const Engine::Logic::TransformComponent *> cubeSources;
+  std::vector<glm::mat4> cubeTransforms;
+  std::vector<glm::vec3> cubeColors;
 
 public:
   bool Initialize() {
@@ -37,13 +85,13 @@ public:
       return false;
     }
 
-    // Create scene instances
-    demoScene = std::make_unique<Engine::Logic::DemoScene>();
-    physicsScene = std::make_unique<Engine::Logic::PhysicsTestScene>();
+    PROFILE_THREAD("Main");
+
+    // One worker per spare hardware thread, shared by every system
+    Engine::Common::JobSystem::Get().Start();
 
-    // Register scenes with the scene manager
-    sceneManager.RegisterScene("Demo", demoScene->GetScene());
-    sceneManager.RegisterScene("Physics Test", physicsScene->GetScene());
+    // Scenes are built in the background when first picked
+    RegisterSceneBuilders();
 
     std::cout << "BasicEngine initialized successfully!" << std::endl;
     sceneManager.PrintSceneList();
@@ -61,6 +109,10 @@ public:
       float deltaTime = currentTime - lastFrameTime;
       lastFrameTime = currentTime;
 
+      // Everything on the frame arena from the last frame is dropped here
+      Engine::Common::FrameArena::Get().BeginFrame();
+      PROFILE_FRAME();
+
       ProcessStateTransition();
       Update(deltaTime);
       Render();
@@ -68,24 +120,97 @@ public:
   }
 
   void Shutdown() {
+    sceneManager.CancelLoad();
     demoScene.reset();
     physicsScene.reset();
+    particleScene.reset();
+    gpuParticles.Shutdown();
+    Engine::Common::JobSystem::Get().Stop();
     renderer.Shutdown();
   }
 
 private:
+  void RegisterSceneBuilders() {
+    // Builders run on the loader thread. The wrapper only reaches the app in
+    // a main thread step, after the renderer has room for its instances.
+    sceneManager.RegisterSceneBuilder(
+        "Demo", [this](Engine::Logic::SceneLoadContext &context) {
+          auto wrapper = std::make_shared<Engine::Logic::DemoScene>();
+          StageInstances(context, wrapper->GetScene()->GetEntityCount());
+          context.AddMainThreadStep([this, wrapper]() { demoScene = wrapper; });
+          return wrapper->GetScene();
+        });
+
+    sceneManager.RegisterSceneBuilder(
+        "Physics Test", [this](Engine::Logic::SceneLoadContext &context) {
+          auto wrapper = std::make_shared<Engine::Logic::PhysicsTestScene>();
+          StageInstances(context, wrapper->GetScene()->GetEntityCount());
+          context.AddMainThreadStep([this, wrapper]() { physicsScene = wrapper; });
+          return wrapper->GetScene();
+        });
+
+    sceneManager.RegisterSceneBuilder(
+        "Particles", [this](Engine::Logic::SceneLoadContext &context) {
+          auto wrapper = std::make_shared<Engine::Logic::ParticleScene>();
+
+          // Fill the pool here rather than in the frames of the first bursts
+          for (size_t pooled = 0; pooled < PARTICLE_POOL_SIZE;) {
+            if (context.IsCancelled())
+              break;
+            pooled = std::min(pooled + 256, PARTICLE_POOL_SIZE);
+            wrapper->ReserveParticles(pooled);
+            context.SetProgress(static_cast<float>(pooled) / PARTICLE_POOL_SIZE);
+          }
+
+          StageInstances(context, wrapper->GetScene()->GetEntityCount() +
+                                      PARTICLE_POOL_SIZE);
+          context.AddMainThreadStep([this, wrapper]() { particleScene = wrapper; });
+          return wrapper->GetScene();
+        });
+  }
+
+  // Sizes the per-frame instance storage for a scene that is loading
+  void StageInstances(Engine::Logic::SceneLoadContext &context, size_t count) {
+    context.AddMainThreadStep([this, count]() {
+      renderer.ReserveInstances(count);
+      cubeSources.reserve(count);
+      cubeTransforms.reserve(count);
+      cubeColors.reserve(count);
+    });
+  }
+
   void ProcessStateTransition() {
     if (!stateTransitionPending)
       return;
+    stateTransitionPending = false;
 
-    switch (currentState) {
-    case AppState::DEMO_SCENE:
-    case AppState::PHYSICS_SCENE:
-    default:
-      break;
+    const char *sceneName = GetSceneName(nextState);
+    if (!sceneName) {
+      stateLoadPending = false;
+      EnterState(nextState);
+      return;
+    }
+
+    // The current state keeps running until the scene is ready
+    if (sceneManager.LoadSceneAsync(sceneName)) {
+      loadingState = nextState;
+      stateLoadPending = true;
     }
+  }
+
+  // Enters the state waiting for its scene once the scene manager has made
+  // that scene current
+  void ProcessStateLoad() {
+    if (!stateLoadPending ||
+        sceneManager.GetCurrentSceneName() != GetSceneName(loadingState))
+      return;
+
+    stateLoadPending = false;
+    EnterState(loadingState);
+  }
 
-    currentState = nextState;
+  void EnterState(AppState state) {
+    currentState = state;
 
     switch (currentState) {
     case AppState::MAIN_MENU:
@@ -94,29 +219,35 @@ private:
       break;
 
     case AppState::DEMO_SCENE:
-      sceneManager.LoadScene("Demo");
       showMainMenu = false;
       std::cout << "Entered Demo Scene" << std::endl;
       break;
 
     case AppState::PHYSICS_SCENE:
-      sceneManager.LoadScene("Physics Test");
       showMainMenu = false;
       physicsScene->SetPhysicsEnabled(physicsEnabled);
       physicsScene->SetTimeScale(physicsTimeScale);
       std::cout << "Entered Physics Test Scene" << std::endl;
       break;
 
+    case AppState::PARTICLE_SCENE:
+      showMainMenu = false;
+      particleScene->SetPhysicsEnabled(particlePhysicsEnabled);
+      particleScene->SetTimeScale(particleTimeScale);
+      particleScene->SetParticleRadius(particleRadius);
+      std::cout << "Entered Particle Scene" << std::endl;
+      break;
+
     case AppState::EXITING:
       std::cout << "Exiting application..." << std::endl;
       break;
     }
-
-    stateTransitionPending = false;
   }
 
   void Update(float deltaTime) {
+    PROFILE_SCOPE("App::Update");
     sceneManager.ProcessSceneTransition();
+    ProcessStateLoad();
 
     switch (currentState) {
     case AppState::MAIN_MENU:
@@ -131,12 +262,17 @@ private:
       physicsScene->Update(deltaTime);
       break;
 
+    case AppState::PARTICLE_SCENE:
+      particleScene->Update(deltaTime);
+      break;
+
     case AppState::EXITING:
       break;
     }
   }
 
   void Render() {
+    PROFILE_SCOPE("App::Render");
     renderer.BeginFrame();
     if (currentState != AppState::MAIN_MENU) {
       RenderCurrentScene();
@@ -146,28 +282,58 @@ private:
   }
 
   void RenderCurrentScene() {
+    PROFILE_SCOPE("App::RenderCurrentScene");
     auto currentScene = sceneManager.GetCurrentScene();
     if (!currentScene)
       return;
 
+    // Gathered every frame, the vectors keep their capacity
+    cubeSources.clear();
+    cubeColors.clear();
+
+    // Physics runs in fixed steps, draw between the last two
+    const float alpha = currentScene->GetInterpolationAlpha();
+
     for (const auto &entity : currentScene->GetEntities()) {
       if (!entity || !entity->IsActive())
         continue;
 
-      auto transform =
-          entity->GetComponent<Engine::Logic::TransformComponent>();
-      auto renderComp = entity->GetComponent<Engine::Logic::RenderComponent>();
+      // Raw lookups, no shared_ptr copies per entity
+      const auto &registry = entity->GetRegistry();
+      auto *transform =
+          registry.Get<Engine::Logic::TransformComponent>(entity->GetHandle());
+      auto *renderComp =
+          registry.Get<Engine::Logic::RenderComponent>(entity->GetHandle());
 
       if (transform && renderComp && renderComp->IsVisible()) {
-        if (renderComp->GetPrimitiveType() ==
-            Engine::Logic::PrimitiveType::CUBE) {
-          renderer.RenderCube(transform->GetTransformMatrix());
+        // There is no circle mesh yet, particles are drawn as cubes
+        Engine::Logic::PrimitiveType primitive = renderComp->GetPrimitiveType();
+        if (primitive == Engine::Logic::PrimitiveType::CUBE ||
+            primitive == Engine::Logic::PrimitiveType::CIRCLE) {
+          cubeSources.push_back(transform);
+          cubeColors.push_back(renderComp->GetColor());
         }
       }
     }
+
+    // Relative to the renderer's floating origin, built from the doubles
+    cubeTransforms.resize(cubeSources.size());
+    currentScene->GetTransformSystem().BuildRelativeMatrices(
+        cubeSources.data(), cubeSources.size(),
+        renderer.GetFloatingOrigin().GetOrigin(), alpha, cubeTransforms.data());
+
+    renderer.SubmitInstances(Engine::Common::RenderPrimitive::CUBE,
+                             cubeTransforms.data(), cubeColors.data(),
+                             cubeTransforms.size());
+
+    if (currentState == AppState::PARTICLE_SCENE &&
+        particleScene->IsGpuSimulation()) {
+      renderer.RenderGpuParticles(gpuParticles);
+    }
   }
 
   void RenderUI() {
+    PROFILE_SCOPE("App::RenderUI");
     if (showMainMenu) {
       RenderMainMenu();
     } else {
@@ -177,12 +343,16 @@ private:
     if (showDebugInfo) {
       RenderDebugInfo();
     }
+
+    if (showProfiler) {
+      profilerPanel.Draw(&showProfiler);
+    }
   }
 
   void RenderMainMenu() {
     // Center the main menu
     ImGuiIO &io = ImGui::GetIO();
-    ImVec2 windowSize(400, 350); // Increased height for new scene
+    ImVec2 windowSize(400, 400); // Room for the load progress bar
     ImVec2 windowPos((io.DisplaySize.x - windowSize.x) * 0.5f,
                      (io.DisplaySize.y - windowSize.y) * 0.5f);
 
@@ -226,8 +396,18 @@ private:
 
       ImGui::Spacing();
 
+      if (ImGui::Button("Particle Physics", ImVec2(350, 40))) {
+        RequestStateChange(AppState::PARTICLE_SCENE);
+      }
+      ImGui::Text(" • Circles falling into a cup");
+      ImGui::Text(" • Broadphase and multithreaded collisions");
+
+      ImGui::Spacing();
+      RenderLoadProgress();
+
       // Options
       ImGui::Checkbox("Show Debug Info", &showDebugInfo);
+      ImGui::Checkbox("Show Profiler", &showProfiler);
 
       ImGui::Spacing();
 
@@ -238,12 +418,21 @@ private:
     ImGui::End();
   }
 
+  void RenderLoadProgress() {
+    if (!sceneManager.IsLoading())
+      return;
+
+    ImGui::Text("Loading %s...", sceneManager.GetLoadingSceneName().c_str());
+    ImGui::ProgressBar(sceneManager.GetLoadProgress(), ImVec2(350, 0));
+  }
+
   void RenderSceneUI() {
     // Back to menu button (always visible)
     if (ImGui::Begin("Scene Controls")) {
       if (ImGui::Button("Back to Main Menu")) {
         RequestStateChange(AppState::MAIN_MENU);
       }
+      RenderLoadProgress();
 
       ImGui::Separator();
 
@@ -256,16 +445,81 @@ private:
       case AppState::PHYSICS_SCENE:
         RenderPhysicsSceneControls();
         break;
+
+      case AppState::PARTICLE_SCENE:
+        RenderParticleSceneControls();
+        break;
       default:
         break;
       }
 
+      ImGui::Separator();
+      RenderSnapshotControls();
+
       ImGui::Separator();
       ImGui::Checkbox("Show Debug Info", &showDebugInfo);
+      ImGui::Checkbox("Show Profiler", &showProfiler);
     }
     ImGui::End();
   }
 
+  void RenderSnapshotControls() {
+    ImGui::Text("Snapshot");
+    ImGui::InputText("File", snapshotPath, sizeof(snapshotPath));
+
+    if (ImGui::Button("Save Scene")) {
+      bool saved = false;
+      switch (currentState) {
+      case AppState::DEMO_SCENE:
+        saved = demoScene->SaveSnapshot(snapshotPath);
+        break;
+      case AppState::PHYSICS_SCENE:
+        saved = physicsScene->SaveSnapshot(snapshotPath);
+        break;
+      case AppState::PARTICLE_SCENE:
+        saved = particleScene->SaveSnapshot(snapshotPath);
+        break;
+      default:
+        break;
+      }
+      snapshotStatus = saved ? "Saved " + std::to_string(GetCurrentEntityCount()) + " entities"
+                             : std::string("Save failed, see the console");
+    }
+
+    ImGui::SameLine();
+    if (ImGui::Button("Load Scene")) {
+      const auto start = std::chrono::steady_clock::now();
+      bool loaded = false;
+      switch (currentState) {
+      case AppState::DEMO_SCENE:
+        loaded = demoScene->LoadSnapshot(snapshotPath);
+        break;
+      case AppState::PHYSICS_SCENE:
+        loaded = physicsScene->LoadSnapshot(snapshotPath);
+        break;
+      case AppState::PARTICLE_SCENE:
+        loaded = particleScene->LoadSnapshot(snapshotPath);
+        break;
+      default:
+        break;
+      }
+      const double ms =
+          std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+      snapshotStatus = loaded ? "Loaded " + std::to_string(GetCurrentEntityCount()) + " entities in " +
+                                    std::to_string(ms) + " ms"
+                              : std::string("Load failed, see the console");
+    }
+
+    if (!snapshotStatus.empty()) {
+      ImGui::Text("%s", snapshotStatus.c_str());
+    }
+  }
+
+  size_t GetCurrentEntityCount() const {
+    auto scene = sceneManager.GetCurrentScene();
+    return scene ? scene->GetEntityCount() : 0;
+  }
+
   void RenderDemoSceneControls() {
     ImGui::Text("Demo Scene Controls");
 
@@ -323,6 +577,8 @@ private:
       physicsScene->SetTimeScale(physicsTimeScale);
     }
 
+    RenderTimestepControls(*physicsScene->GetScene());
+
     if (ImGui::Button("Reset Scene")) {
       physicsScene->Reset();
     }
@@ -363,11 +619,257 @@ private:
     }
   }
 
+  void RenderParticleSceneControls() {
+    ImGui::Text("Particle Scene Controls");
+
+    if (ImGui::Checkbox("Enable Physics", &particlePhysicsEnabled)) {
+      particleScene->SetPhysicsEnabled(particlePhysicsEnabled);
+    }
+
+    if (ImGui::SliderFloat("Time Scale", &particleTimeScale, 0.0f, 3.0f)) {
+      particleScene->SetTimeScale(particleTimeScale);
+    }
+
+    RenderTimestepControls(*particleScene->GetScene());
+
+    if (ImGui::SliderFloat("Particle Radius", &particleRadius,
+                           particleScene->GetMinParticleRadius(),
+                           particleScene->GetMaxParticleRadius())) {
+      particleScene->SetParticleRadius(particleRadius);
+    }
+
+    if (Engine::Common::GpuParticleSystem::IsSupported()) {
+      bool gpu = particleScene->IsGpuSimulation();
+      if (ImGui::Checkbox("GPU Simulation", &gpu)) {
+        SetGpuParticlesEnabled(gpu);
+      }
+    } else {
+      ImGui::TextDisabled("GPU Simulation needs OpenGL 4.3");
+    }
+    if (!gpuStatus.empty()) {
+      ImGui::TextWrapped("%s", gpuStatus.c_str());
+    }
+    if (particleScene->IsGpuSimulation()) {
+      RenderGpuParticleControls();
+      return;
+    }
+
+    if (ImGui::Button("Spawn 1")) {
+      particleScene->SpawnParticle();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Spawn 10")) {
+      for (int i = 0; i < 10; ++i)
+        particleScene->SpawnParticle();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Spawn 100")) {
+      for (int i = 0; i < 100; ++i)
+        particleScene->SpawnParticle();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Clear")) {
+      particleScene->ClearAllParticles();
+    }
+
+    ImGui::Text("Particles: %zu", particleScene->GetParticleCount());
+
+    // Collision system controls
+    auto collisions = particleScene->GetCollisionSystem();
+    if (!collisions)
+      return;
+
+    ImGui::Separator();
+    ImGui::Text("Collisions");
+
+    bool parallel =
+        collisions->GetMode() == Engine::Logic::CollisionMode::PARALLEL;
+    if (ImGui::Checkbox("Multithreaded", &parallel)) {
+      collisions->SetMode(parallel ? Engine::Logic::CollisionMode::PARALLEL
+                                   : Engine::Logic::CollisionMode::SEQUENTIAL);
+    }
+
+    int maxThreads = static_cast<int>(
+        Engine::Common::JobSystem::Get().GetThreadCount());
+    int threads = static_cast<int>(collisions->GetThreadCount());
+    if (threads == 0 || threads > maxThreads)
+      threads = maxThreads;
+    if (ImGui::SliderInt("Threads", &threads, 1, std::max(maxThreads, 1))) {
+      collisions->SetThreadCount(static_cast<size_t>(threads));
+    }
+
+    const char *broadphases[] = {"Brute Force", "Spatial Hash",
+                                 "Sweep and Prune"};
+    int broadphase = static_cast<int>(collisions->GetBroadphaseType());
+    if (ImGui::Combo("Broadphase", &broadphase, broadphases,
+                     IM_ARRAYSIZE(broadphases))) {
+      collisions->SetBroadphase(
+          static_cast<Engine::Logic::BroadphaseType>(broadphase));
+    }
+
+    const char *resolutions[] = {"Per Pair", "Iterative Solver"};
+    int resolution = static_cast<int>(collisions->GetResolution());
+    if (ImGui::Combo("Resolution", &resolution, resolutions,
+                     IM_ARRAYSIZE(resolutions))) {
+      collisions->SetResolution(
+          static_cast<Engine::Logic::ContactResolution>(resolution));
+    }
+
+    if (collisions->GetResolution() ==
+        Engine::Logic::ContactResolution::ITERATIVE) {
+      Engine::Logic::SolverSettings &solver = collisions->GetSolverSettings();
+      ImGui::SliderInt("Velocity Iterations", &solver.velocityIterations, 1,
+                       32);
+      ImGui::SliderInt("Position Iterations", &solver.positionIterations, 0,
+                       8);
+      ImGui::Checkbox("Warm Starting", &solver.warmStarting);
+      ImGui::SliderFloat("Friction", &solver.friction, 0.0f, 1.0f);
+      ImGui::Checkbox("Sleeping", &solver.sleeping);
+      if (solver.sleeping) {
+        ImGui::SliderFloat("Sleep Velocity", &solver.sleepVelocity, 0.0f,
+                           50.0f);
+        ImGui::SliderFloat("Time to Sleep (s)", &solver.timeToSleep, 0.1f,
+                           5.0f);
+      }
+
+      const Engine::Logic::ContactSolver &contactSolver =
+          collisions->GetSolver();
+      ImGui::Text("Warm started: %zu", contactSolver.GetWarmStartedCount());
+      if (solver.sleeping) {
+        ImGui::Text("Sleeping: %zu bodies, %zu islands",
+                    contactSolver.GetSleepingBodyCount(),
+                    contactSolver.GetIslandCount());
+      }
+    }
+
+    const Engine::Logic::CollisionTimings &timings = collisions->GetTimings();
+    ImGui::Text("Sync: %.2f ms", timings.syncMs);
+    ImGui::Text("Broadphase: %.2f ms", timings.broadphaseMs);
+    ImGui::Text("Narrowphase: %.2f ms", timings.narrowphaseMs);
+    ImGui::Text("Resolve: %.2f ms", timings.resolveMs);
+    ImGui::Text("Total: %.2f ms", timings.totalMs);
+    ImGui::Text("Pairs: %zu tested, %zu hit", collisions->GetPairsTested(),
+                collisions->GetPairsHit());
+  }
+
+  void SetGpuParticlesEnabled(bool enabled) {
+    if (!enabled) {
+      particleScene->SetGpuStep(nullptr);
+      gpuParticles.Clear();
+      return;
+    }
+
+    if (!gpuParticles.IsInitialized() &&
+        !gpuParticles.Initialize(GPU_PARTICLE_CAPACITY)) {
+      gpuStatus = "GPU particles failed to start, see the log";
+      return;
+    }
+    gpuStatus.clear();
+
+    Engine::Common::GpuParticleSystem::Settings settings;
+    const glm::vec2 cupCenter = particleScene->GetCupCenter();
+    settings.gravity = particleScene->GetGravity();
+    settings.restitution = particleScene->GetParticleBounciness();
+    settings.boundsMin =
+        cupCenter - glm::vec2(GPU_BOUNDS_HALF_WIDTH, GPU_BOUNDS_BELOW);
+    settings.boundsMax =
+        cupCenter + glm::vec2(GPU_BOUNDS_HALF_WIDTH, GPU_BOUNDS_ABOVE);
+    settings.maxRadius = particleScene->GetMaxParticleRadius();
+    gpuParticles.SetSettings(settings);
+    gpuCupRevision = 0; // Uploaded on the first step
+
+    // Runs in the scene's fixed steps, so substeps and the time scale apply
+    particleScene->SetGpuStep([this](float dt) {
+      if (gpuCupRevision != particleScene->GetCupRevision()) {
+        std::vector<Engine::Common::GpuParticleSystem::Wall> walls;
+        for (const auto &segment : particleScene->GetWallSegments()) {
+          walls.push_back({segment.start, segment.end, segment.radius});
+        }
+        gpuParticles.SetWalls(walls);
+        gpuCupRevision = particleScene->GetCupRevision();
+      }
+      gpuParticles.Step(dt);
+    });
+  }
+
+  void SpawnGpuParticles(size_t count) {
+    const auto &settings = gpuParticles.GetSettings();
+    const float width = (settings.boundsMax.x - settings.boundsMin.x) * 0.9f;
+
+    gpuSpawns.clear();
+    particleScene->GenerateSpawns(count, width, gpuSpawns);
+    gpuUploads.clear();
+    for (const auto &spawn : gpuSpawns) {
+      gpuUploads.push_back(
+          {spawn.position, spawn.velocity, spawn.radius,
+           Engine::Common::GpuParticleSystem::PackColor(spawn.color),
+           {0.0f, 0.0f}});
+    }
+    gpuParticles.Spawn(gpuUploads.data(), gpuUploads.size());
+  }
+
+  void RenderGpuParticleControls() {
+    const size_t bursts[] = {1000, 10000, 100000};
+    for (size_t count : bursts) {
+      char label[32];
+      std::snprintf(label, sizeof(label), "Spawn %zuk", count / 1000);
+      if (ImGui::Button(label)) {
+        SpawnGpuParticles(count);
+      }
+      ImGui::SameLine();
+    }
+    if (ImGui::Button("Clear")) {
+      gpuParticles.Clear();
+    }
+
+    ImGui::Text("Particles: %zu / %zu", gpuParticles.GetCount(),
+                gpuParticles.GetCapacity());
+
+    // Read back a few steps late, never waited on
+    const Engine::Common::GpuParticleSystem::Stats &stats =
+        gpuParticles.GetStats();
+    ImGui::Separator();
+    ImGui::Text("GPU Stats (step %llu)",
+                static_cast<unsigned long long>(stats.step));
+    ImGui::Text("Contacts: %u pairs, %u on walls", stats.contacts,
+                stats.wallContacts);
+    ImGui::Text("Speed: %.1f average, %.1f max", stats.averageSpeed,
+                stats.maxSpeed);
+    ImGui::Text("Skipped readbacks: %d", gpuParticles.GetSkippedReadbacks());
+  }
+
+  void RenderTimestepControls(Engine::Logic::Scene &scene) {
+    Engine::Logic::FixedTimestep &timestep = scene.GetTimestep();
+
+    int rate = static_cast<int>(std::lround(1.0f / timestep.GetStepSize()));
+    if (ImGui::SliderInt("Physics Rate (Hz)", &rate, 10, 240)) {
+      timestep.SetStepSize(1.0f / static_cast<float>(rate));
+    }
+    int substeps = timestep.GetSubsteps();
+    if (ImGui::SliderInt("Substeps", &substeps, 1, 8)) {
+      timestep.SetSubsteps(substeps);
+    }
+    int maxSteps = timestep.GetMaxStepsPerFrame();
+    if (ImGui::SliderInt("Max Steps per Frame", &maxSteps, 1, 16)) {
+      timestep.SetMaxStepsPerFrame(maxSteps);
+    }
+    bool interpolate = scene.IsInterpolationEnabled();
+    if (ImGui::Checkbox("Interpolate Transforms", &interpolate)) {
+      scene.SetInterpolationEnabled(interpolate);
+    }
+    ImGui::Text("Steps last frame: %d, dropped %.2f s",
+                timestep.GetLastStepCount(), timestep.GetDroppedTime());
+  }
+
   void RenderDebugInfo() {
     if (ImGui::Begin("Debug Information")) {
       ImGui::Text("Application State: %s", GetStateString(currentState));
       ImGui::Text("FPS: %.1f", ImGui::GetIO().Framerate);
       ImGui::Text("Frame Time: %.3f ms", 1000.0f / ImGui::GetIO().Framerate);
+      const auto &arena = Engine::Common::FrameArena::Get().GetStats();
+      ImGui::Text("Frame Arena: peak %.1f KB (last frame %.1f KB) of %.1f KB",
+                  arena.peak / 1024.0f, arena.lastFramePeak / 1024.0f,
+                  arena.capacity / 1024.0f);
 
       ImGui::Separator();
 
@@ -389,6 +891,20 @@ private:
     stateTransitionPending = true;
   }
 
+  // Scene manager name of the scene a state runs, null for the others
+  const char *GetSceneName(AppState state) {
+    switch (state) {
+    case AppState::DEMO_SCENE:
+      return "Demo";
+    case AppState::PHYSICS_SCENE:
+      return "Physics Test";
+    case AppState::PARTICLE_SCENE:
+      return "Particles";
+    default:
+      return nullptr;
+    }
+  }
+
   const char *GetStateString(AppState state) {
     switch (state) {
     case AppState::MAIN_MENU:
@@ -397,6 +913,8 @@ private:
       return "Demo Scene";
     case AppState::PHYSICS_SCENE:
       return "Physics Scene";
+    case AppState::PARTICLE_SCENE:
+      return "Particle Scene";
     case AppState::EXITING:
       return "Exiting";
     default:
@@ -0,0 +1,29 @@
+# Runs the bench executable with JSON output. Called by the bench_json target:
+# cmake -DBENCH=<exe> -DOUTPUT=<json> -DSOURCE_DIR=<repo> [-DARGS=<args>] -P RunBench.cmake
+
+set(COMMIT "unknown")
+find_package(Git QUIET)
+if(GIT_FOUND)
+  execute_process(
+      COMMAND ${GIT_EXECUTABLE} rev-parse --short HEAD
+      WORKING_DIRECTORY ${SOURCE_DIR}
+      OUTPUT_VARIABLE COMMIT
+      OUTPUT_STRIP_TRAILING_WHITESPACE
+      ERROR_QUIET
+  )
+endif()
+
+separate_arguments(EXTRA_ARGS NATIVE_COMMAND "${ARGS}")
+
+execute_process(
+    COMMAND ${BENCH}
+        --benchmark_out=${OUTPUT}
+        --benchmark_out_format=json
+        --benchmark_context=git_commit=${COMMIT}
+        ${EXTRA_ARGS}
+    RESULT_VARIABLE RESULT
+)
+if(NOT RESULT EQUAL 0)
+  message(FATAL_ERROR "bench failed (${RESULT})")
+endif()
+message(STATUS "Benchmark results: ${OUTPUT} (commit ${COMMIT})")
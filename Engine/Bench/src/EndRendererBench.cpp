@@ -0,0 +1,92 @@
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "../../Common/include/JobSystem.h"
+#include "../../EndViewer/include/EndRenderer.h"
+#include <benchmark/benchmark.h>
+#include <memory>
+
+namespace {
+
+constexpr int WIDTH = 1280;
+constexpr int HEIGHT = 720;
+constexpr int WARMUP_FRAMES = 30; // Shader compiles, bakes and first chunk meshes
+
+// Hidden window whose default framebuffer is the render target. Created
+// once for the whole run; without a display it stays invalid and the
+// renderer benchmarks are skipped.
+struct HeadlessContext {
+    GLFWwindow* window = nullptr;
+    const char* error = nullptr;
+
+    HeadlessContext() {
+        if (!glfwInit()) {
+            error = "GLFW unavailable (no display?)";
+            return;
+        }
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        window = glfwCreateWindow(WIDTH, HEIGHT, "bench", nullptr, nullptr);
+        if (!window) {
+            error = "No OpenGL 3.3 context";
+            return;
+        }
+        glfwMakeContextCurrent(window);
+        glfwSwapInterval(0);
+        glewExperimental = GL_TRUE;
+        if (glewInit() != GLEW_OK) {
+            error = "GLEW initialization failed";
+            return;
+        }
+        while (glGetError() != GL_NO_ERROR) {}
+    }
+
+    ~HeadlessContext() {
+        if (window) glfwDestroyWindow(window);
+        glfwTerminate();
+    }
+};
+
+// Arg: render mode (0 = ray march, 1 = chunk meshes). Time per frame
+// includes the GPU, every frame ends with glFinish.
+void BM_EndRendererFrame(benchmark::State& state) {
+    static HeadlessContext context;
+    if (context.error) {
+        state.SkipWithError(context.error);
+        return;
+    }
+
+    Engine::Common::JobSystem::Get().Start();
+    {
+        EndViewer::EndRenderer renderer;
+        if (!renderer.initialize(context.window, nullptr)) {
+            state.SkipWithError("EndRenderer failed to initialize (run from the bench directory for shaders/)");
+            Engine::Common::JobSystem::Get().Stop();
+            return;
+        }
+
+        EndViewer::EndRenderer::Settings& settings = renderer.getSettings();
+        settings.renderMode = static_cast<int>(state.range(0));
+        settings.showDebugUI = false;
+        settings.hotReloadShaders = false;
+        settings.dynamicResolution = false; // Keep the workload fixed
+
+        // Fixed timestep without input, so the camera stays put
+        for (int i = 0; i < WARMUP_FRAMES; i++) {
+            renderer.renderFrame(1.0f / 60.0f);
+            glFinish();
+        }
+        for (auto _ : state) {
+            renderer.renderFrame(1.0f / 60.0f);
+            glFinish();
+        }
+        state.SetLabel(state.range(0) == 0 ? "ray march" : "chunk meshes");
+        renderer.shutdown();
+    }
+    Engine::Common::JobSystem::Get().Stop();
+}
+BENCHMARK(BM_EndRendererFrame)->DenseRange(0, 1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+} // namespace
@@ -0,0 +1,123 @@
+#include "../../Common/include/JobSystem.h"
+#include "../../Logic/include/CollisionComponent.h"
+#include "../../Logic/include/CollisionSystem.h"
+#include "../../Logic/include/RenderComponent.h"
+#include "../../Logic/include/Scene.h"
+#include "../../Logic/include/SimplePhysicsComponent.h"
+#include "../../Logic/include/TransformComponent.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace Engine::Logic;
+
+namespace {
+
+constexpr float RADIUS = 4.0f;
+
+// Circles on a jittered grid, neighbours overlapping a little, so about two
+// contacts per particle. Positions are restored before every measured step,
+// so each iteration solves the same contacts.
+struct ParticleField {
+    Scene scene;
+    CollisionSystem collisions;
+    std::vector<std::shared_ptr<Entity>> particles;
+    std::vector<glm::vec3> positions;
+
+    ParticleField(int count, BroadphaseType broadphase, CollisionMode mode) : scene("Bench") {
+        collisions.SetBroadphase(broadphase);
+        collisions.SetMode(mode);
+        collisions.GetSolverSettings().sleeping = false; // A resting field would stop costing anything
+
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> jitter(-0.2f, 0.2f);
+        const int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count))));
+        const float spacing = RADIUS * 1.9f;
+        for (int i = 0; i < count; i++) {
+            auto particle = scene.CreateEntity();
+            auto transform = particle->AddComponent<TransformComponent>();
+            particle->AddComponent<CollisionComponent>(CollisionShape::CIRCLE, false, false, "particle");
+            auto physics = particle->AddComponent<SimplePhysicsComponent>(1.0f, false);
+            particle->GetComponent<CollisionComponent>()->SetCircle(RADIUS, glm::vec2(0.0f));
+            physics->SetWorldBounds(false);
+
+            const glm::vec3 position((i % columns) * spacing + jitter(rng), (i / columns) * spacing + jitter(rng), 0.0f);
+            transform->SetPosition(position);
+            positions.push_back(position);
+            particles.push_back(particle);
+            collisions.RegisterEntity(particle);
+        }
+    }
+
+    void Restore() {
+        for (size_t i = 0; i < particles.size(); i++) {
+            particles[i]->GetComponent<TransformComponent>()->SetPosition(positions[i]);
+            particles[i]->GetComponent<SimplePhysicsComponent>()->SetVelocity(glm::vec3(0.0f));
+        }
+    }
+};
+
+void RunCollisionUpdate(benchmark::State& state, CollisionMode mode) {
+    const int count = static_cast<int>(state.range(0));
+    const BroadphaseType broadphase = static_cast<BroadphaseType>(state.range(1));
+    ParticleField field(count, broadphase, mode);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        field.Restore();
+        state.ResumeTiming();
+        field.collisions.Update(1.0f / 60.0f);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.counters["pairs_tested"] = static_cast<double>(field.collisions.GetPairsTested());
+    state.counters["contacts"] = static_cast<double>(field.collisions.GetContacts().size());
+    state.SetLabel(field.collisions.GetBroadphase()->GetTypeName());
+}
+
+// Args: particles, broadphase (BroadphaseType)
+void BM_CollisionUpdate(benchmark::State& state) {
+    RunCollisionUpdate(state, CollisionMode::SEQUENTIAL);
+}
+BENCHMARK(BM_CollisionUpdate)
+    ->ArgsProduct({{100, 1000, 10000},
+                   {static_cast<int>(BroadphaseType::BRUTE_FORCE), static_cast<int>(BroadphaseType::SPATIAL_HASH),
+                    static_cast<int>(BroadphaseType::SWEEP_AND_PRUNE)}})
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_CollisionUpdateParallel(benchmark::State& state) {
+    Engine::Common::JobSystem::Get().Start();
+    RunCollisionUpdate(state, CollisionMode::PARALLEL);
+    Engine::Common::JobSystem::Get().Stop();
+}
+BENCHMARK(BM_CollisionUpdateParallel)
+    ->ArgsProduct({{1000, 10000},
+                   {static_cast<int>(BroadphaseType::SPATIAL_HASH), static_cast<int>(BroadphaseType::SWEEP_AND_PRUNE)}})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+// Arg: entities with a transform, a render component and a moving body, run
+// through the default Physics and Transforms systems
+void BM_SceneUpdate(benchmark::State& state) {
+    const int count = static_cast<int>(state.range(0));
+    Scene scene("Bench");
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> velocity(-1.0f, 1.0f);
+    for (int i = 0; i < count; i++) {
+        auto entity = scene.CreateEntity();
+        entity->AddComponent<TransformComponent>(glm::vec3(static_cast<float>(i % 100), static_cast<float>(i / 100), 0.0f));
+        entity->AddComponent<RenderComponent>(PrimitiveType::CUBE, glm::vec3(1.0f), true);
+        auto physics = entity->AddComponent<SimplePhysicsComponent>(1.0f, false);
+        physics->SetWorldBounds(false);
+        physics->SetVelocity(glm::vec3(velocity(rng), velocity(rng), 0.0f));
+    }
+
+    for (auto _ : state) {
+        scene.Update(1.0f / 60.0f);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_SceneUpdate)->RangeMultiplier(10)->Range(100, 100000)->Unit(benchmark::kMicrosecond);
+
+} // namespace
@@ -0,0 +1,116 @@
+#include "../../EndViewer/include/EndDensity.h"
+#include "../../EndViewer/include/SimplexNoise.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace EndViewer;
+
+namespace {
+
+// Fixed sample points, so every run and every commit sees the same input
+struct SamplePoints {
+    std::vector<double> xs, ys, zs;
+
+    SamplePoints(size_t count, double minRadius, double maxRadius, uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> radius(minRadius, maxRadius);
+        std::uniform_real_distribution<double> angle(0.0, 6.283185307179586);
+        std::uniform_real_distribution<double> height(0.0, 128.0);
+        for (size_t i = 0; i < count; i++) {
+            const double r = radius(rng), a = angle(rng);
+            xs.push_back(r * std::cos(a));
+            ys.push_back(height(rng));
+            zs.push_back(r * std::sin(a));
+        }
+    }
+};
+
+constexpr size_t POINT_COUNT = 4096;
+
+const SamplePoints& NoisePoints() {
+    static const SamplePoints points(POINT_COUNT, 0.0, 1000.0, 1);
+    return points;
+}
+
+void BM_SimplexSample2D(benchmark::State& state) {
+    const SimplexNoise noise(12345);
+    const SamplePoints& points = NoisePoints();
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(noise.sample2D(points.xs[i] * 0.01, points.zs[i] * 0.01));
+        i = (i + 1) % POINT_COUNT;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SimplexSample2D);
+
+void BM_SimplexSample3D(benchmark::State& state) {
+    const SimplexNoise noise(12345);
+    const SamplePoints& points = NoisePoints();
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(noise.sample3D(points.xs[i] * 0.01, points.ys[i] * 0.01, points.zs[i] * 0.01));
+        i = (i + 1) % POINT_COUNT;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SimplexSample3D);
+
+// Arg: octave count
+void BM_SimplexOctave3D(benchmark::State& state) {
+    const SimplexNoise noise(12345);
+    const SamplePoints& points = NoisePoints();
+    const int octaves = static_cast<int>(state.range(0));
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(noise.octave3D(points.xs[i] * 0.01, points.ys[i] * 0.01, points.zs[i] * 0.01, octaves));
+        i = (i + 1) % POINT_COUNT;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SimplexOctave3D)->Arg(1)->Arg(4)->Arg(8);
+
+// Arg: points per batch (SIMD kernel with BASIC_ENGINE_SIMD)
+void BM_SimplexSample3DBatch(benchmark::State& state) {
+    const SimplexNoise noise(12345);
+    const SamplePoints& points = NoisePoints();
+    const size_t count = static_cast<size_t>(state.range(0));
+    std::vector<double> xs(count), ys(count), zs(count), out(count);
+    for (size_t i = 0; i < count; i++) {
+        xs[i] = points.xs[i % POINT_COUNT] * 0.01;
+        ys[i] = points.ys[i % POINT_COUNT] * 0.01;
+        zs[i] = points.zs[i % POINT_COUNT] * 0.01;
+    }
+    for (auto _ : state) {
+        noise.sample3DBatch(xs.data(), ys.data(), zs.data(), out.data(), count);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_SimplexSample3DBatch)->Arg(64)->Arg(4096);
+
+// Arg: region (0 = main island, 1 = exclusion zone, 2 = outer islands)
+void BM_EndDensitySample(benchmark::State& state) {
+    static const SamplePoints regions[] = {
+        SamplePoints(POINT_COUNT, 0.0, EndDensity::MAIN_ISLAND_RADIUS, 2),
+        SamplePoints(POINT_COUNT, EndDensity::EXCLUSION_ZONE_START, EndDensity::EXCLUSION_ZONE_END, 3),
+        SamplePoints(POINT_COUNT, 2000.0, 20000.0, 4),
+    };
+    static const char* labels[] = {"main island", "exclusion", "outer"};
+
+    const EndDensity density(0);
+    const SamplePoints& points = regions[state.range(0)];
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(density.sample(points.xs[i], points.ys[i], points.zs[i]));
+        i = (i + 1) % POINT_COUNT;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(labels[state.range(0)]);
+}
+BENCHMARK(BM_EndDensitySample)->DenseRange(0, 2);
+
+} // namespace
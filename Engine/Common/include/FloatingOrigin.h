@@ -0,0 +1,64 @@
+#ifndef FLOATING_ORIGIN_H
+#define FLOATING_ORIGIN_H
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace Engine {
+namespace Common {
+
+// Origin of the float coordinates a renderer works in. World positions are
+// kept in doubles and everything handed to the GPU is relative to this
+// origin, so floats only ever hold distances around the camera. The origin
+// sits on a grid of cellSize (a power of two keeps the shifts exact in
+// float) and jumps to the camera's cell once the camera is further than the
+// rebase distance away.
+class FloatingOrigin {
+private:
+  glm::dvec3 origin{0.0};
+  glm::ivec3 cell{0};
+  glm::dvec3 lastShift{0.0};
+  double rebaseDistance;
+  double cellSize;
+  uint32_t generation = 0;
+
+public:
+  explicit FloatingOrigin(double rebaseDistance = 4096.0,
+                          double cellSize = 16.0);
+
+  // Re-centres on the camera's cell if it strayed too far. Returns true when
+  // the origin moved; anything holding origin-relative floats (the camera
+  // itself) subtracts GetLastShift from them.
+  bool Update(const glm::dvec3 &cameraWorld);
+
+  // Puts the origin on the cell of world right away (teleports), reported
+  // like a rebase
+  void Reset(const glm::dvec3 &world = glm::dvec3(0.0));
+
+  const glm::dvec3 &GetOrigin() const { return origin; }
+  const glm::ivec3 &GetCell() const { return cell; }
+  const glm::dvec3 &GetLastShift() const { return lastShift; }
+  double GetCellSize() const { return cellSize; }
+  double GetRebaseDistance() const { return rebaseDistance; }
+  void SetRebaseDistance(double distance) { rebaseDistance = distance; }
+
+  // Counts origin moves, for caches of relative data
+  uint32_t GetGeneration() const { return generation; }
+
+  glm::vec3 ToRelative(const glm::dvec3 &world) const {
+    return glm::vec3(world - origin);
+  }
+  glm::dvec3 ToWorld(const glm::vec3 &relative) const {
+    return origin + glm::dvec3(relative);
+  }
+
+  // Splits world into the index of the cell it's in and the offset inside
+  // that cell, each component in [0, cellSize)
+  static void Split(const glm::dvec3 &world, double cellSize, glm::ivec3 &cell,
+                    glm::vec3 &offset);
+};
+
+} // namespace Common
+} // namespace Engine
+
+#endif
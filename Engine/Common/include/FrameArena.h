@@ -0,0 +1,131 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Engine {
+namespace Common {
+
+// Bump allocator for data that lives at most one frame (debug strings,
+// scratch lists). Allocating moves a pointer, freeing does nothing except
+// for the most recent allocation (so a growing string reuses its space), and
+// BeginFrame drops everything at once.
+//
+// - Memory allocated before the next BeginFrame must not be used after it
+// - Only the thread that called BeginFrame allocates from the arena; other
+//   threads, and everyone before the first BeginFrame, are passed through to
+//   the upstream resource. Free frame memory on the thread that allocated it.
+// - A frame that outgrows the block spills into extra blocks, and the next
+//   BeginFrame replaces them with one block large enough for that frame
+class FrameArena : public std::pmr::memory_resource {
+public:
+  static constexpr size_t DEFAULT_CAPACITY = 256 * 1024;
+
+  struct Stats {
+    size_t used = 0;           // Bytes handed out this frame
+    size_t peak = 0;           // Highest use this frame
+    size_t lastFramePeak = 0;  // Highest use of the previous frame
+    size_t capacity = 0;       // Bytes in all blocks
+    size_t overflowBlocks = 0; // Extra blocks this frame
+    uint64_t frame = 0;
+  };
+
+private:
+  struct Block {
+    std::unique_ptr<unsigned char[]> data;
+    size_t size = 0;
+  };
+
+  std::vector<Block> blocks; // The first is kept, the others overflowed
+  size_t offset = 0;         // Into the last block
+  size_t initialCapacity;
+  // Set by BeginFrame, read by every thread that allocates; no thread (the
+  // default id) until the first BeginFrame
+  std::atomic<std::thread::id> owner{std::thread::id()};
+  std::pmr::memory_resource *upstream;
+  Stats stats;
+
+public:
+  explicit FrameArena(size_t capacity = DEFAULT_CAPACITY,
+                      std::pmr::memory_resource *upstreamResource =
+                          std::pmr::new_delete_resource());
+  ~FrameArena() override = default;
+
+  FrameArena(const FrameArena &) = delete;
+  FrameArena &operator=(const FrameArena &) = delete;
+
+  // The arena of the main loop, reset once per frame by the application
+  static FrameArena &Get();
+
+  // Frees everything allocated since the last call and makes the calling
+  // thread the owner
+  void BeginFrame();
+
+  bool IsActive() const {
+    return owner.load(std::memory_order_acquire) != std::thread::id();
+  }
+  const Stats &GetStats() const { return stats; }
+
+protected:
+  void *do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void *pointer, size_t bytes, size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+
+private:
+  // The default id never matches a running thread
+  bool OnOwnerThread() const {
+    return std::this_thread::get_id() == owner.load(std::memory_order_acquire);
+  }
+  bool Contains(const void *pointer) const;
+  void AddBlock(size_t minimumSize);
+};
+
+// Standard allocator over a memory resource, the frame arena unless told
+// otherwise. Unlike std::pmr::polymorphic_allocator it is default
+// constructed onto the arena, so plain std:: containers and streams can be
+// declared with it.
+template <typename T> class FrameAllocator {
+public:
+  using value_type = T;
+
+  std::pmr::memory_resource *resource;
+
+  FrameAllocator() noexcept : resource(&FrameArena::Get()) {}
+  explicit FrameAllocator(std::pmr::memory_resource *r) noexcept : resource(r) {}
+  template <typename U>
+  FrameAllocator(const FrameAllocator<U> &other) noexcept : resource(other.resource) {}
+
+  T *allocate(size_t count) {
+    return static_cast<T *>(resource->allocate(count * sizeof(T), alignof(T)));
+  }
+  void deallocate(T *pointer, size_t count) noexcept {
+    resource->deallocate(pointer, count * sizeof(T), alignof(T));
+  }
+
+  template <typename U> bool operator==(const FrameAllocator<U> &other) const noexcept {
+    return resource == other.resource;
+  }
+  template <typename U> bool operator!=(const FrameAllocator<U> &other) const noexcept {
+    return resource != other.resource;
+  }
+};
+
+template <typename T> using FrameVector = std::vector<T, FrameAllocator<T>>;
+using FrameString = std::basic_string<char, std::char_traits<char>, FrameAllocator<char>>;
+using FrameStringStream =
+    std::basic_ostringstream<char, std::char_traits<char>, FrameAllocator<char>>;
+
+} // namespace Common
+} // namespace Engine
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace Engine {
+namespace Common {
+
+// View frustum as six inward-facing planes. The planes are stored in two
+// groups of four (structure of arrays, the last two are padding that accept
+// everything) so SIMD builds test a sphere against four planes per step.
+class Frustum {
+public:
+  static constexpr int PLANE_COUNT = 6;
+  static constexpr int PADDED_PLANE_COUNT = 8;
+
+private:
+  alignas(16) float planeX[PADDED_PLANE_COUNT];
+  alignas(16) float planeY[PADDED_PLANE_COUNT];
+  alignas(16) float planeZ[PADDED_PLANE_COUNT];
+  alignas(16) float planeW[PADDED_PLANE_COUNT];
+
+public:
+  // Accepts everything until SetFromMatrix is called
+  Frustum();
+
+  // Extracts the planes of a projection * view matrix
+  void SetFromMatrix(const glm::mat4 &viewProjection);
+
+  // True if the sphere is at least partly inside. Conservative near the
+  // frustum's edges, like any plane-only sphere test.
+  bool IntersectsSphere(const glm::vec3 &center, float radius) const;
+
+  // spheres[i] = (center, radius). Writes the indices of the spheres that
+  // intersect to visible (room for count) and returns how many there are.
+  size_t CullSpheres(const glm::vec4 *spheres, size_t count,
+                     uint32_t *visible) const;
+
+  // True when built with the SSE2 path
+  static bool IsSimdEnabled();
+};
+
+} // namespace Common
+} // namespace Engine
+
+#endif
@@ -0,0 +1,186 @@
+#ifndef GPU_PARTICLE_SYSTEM_H
+#define GPU_PARTICLE_SYSTEM_H
+
+#include "ShaderProgram.h"
+#include <GL/glew.h>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+namespace Engine {
+namespace Common {
+
+// 2D circle particles simulated with compute shaders (GL 4.3). Particles
+// live in a shader storage buffer; each Step integrates them, sorts them
+// into a uniform grid by counting sort (count, scan, scatter) and resolves
+// circle-circle contacts from the 3x3 cells around each particle, then
+// circle-wall contacts. Render draws quads straight from the same buffer.
+//
+// Particle data never comes back to the CPU: only the aggregate Stats are
+// copied to a ring of READBACK_SLOTS buffers behind a fence and picked up
+// by a later Step once the GPU is past them, never waited on. Use it from
+// the thread that owns the context.
+class GpuParticleSystem {
+public:
+  static constexpr int READBACK_SLOTS = 4;
+  static constexpr uint32_t MAX_WALLS = 16;
+  static constexpr uint32_t MAX_GRID_CELLS = 1u << 18;
+
+  // std430 layout of the particle buffer (gpu_particles_common.glsl)
+  struct Particle {
+    glm::vec2 position;
+    glm::vec2 velocity;
+    float radius;   // At most Settings::maxRadius
+    uint32_t color; // RGBA8, red in the low byte (packUnorm4x8)
+    float padding[2];
+  };
+  static_assert(sizeof(Particle) == 32, "Particle layout changed");
+
+  // Capsule, the segment start-end inflated by radius
+  struct Wall {
+    glm::vec2 start;
+    glm::vec2 end;
+    float radius;
+  };
+
+  struct Settings {
+    glm::vec2 gravity = glm::vec2(0.0f, -500.0f);
+    float airResistance = 0.99f; // Horizontal velocity kept per step
+    float restitution = 0.6f;
+    float restitutionThreshold = 20.0f; // Slower contacts don't bounce
+    // Particles bounce off the sides of this box, the grid covers it
+    glm::vec2 boundsMin = glm::vec2(-2048.0f);
+    glm::vec2 boundsMax = glm::vec2(2048.0f);
+    float maxRadius = 15.0f; // Grid cells are at least twice this wide
+  };
+
+  // Totals over one step, a few steps old
+  struct Stats {
+    uint64_t step = 0; // Step the numbers are from, 0 before the first
+    uint32_t particles = 0;
+    uint32_t contacts = 0;     // Overlapping particle pairs
+    uint32_t wallContacts = 0; // Particles touching a wall or the bounds
+    float maxSpeed = 0.0f;
+    float averageSpeed = 0.0f;
+  };
+
+private:
+  enum Binding : GLuint {
+    PARTICLE_BINDING,
+    PREDICTED_BINDING,
+    CELL_BINDING,
+    CELL_COUNT_BINDING,
+    CELL_START_BINDING,
+    SORTED_BINDING,
+    WALL_BINDING,
+    STATS_BINDING,
+    BINDING_COUNT
+  };
+
+  static constexpr GLuint WORKGROUP_SIZE = 256; // local_size_x of the passes
+
+  // std430 mirrors of the shaders' Wall and Stats
+  struct WallData {
+    float segment[4];
+    float radius;
+    float padding[3];
+  };
+  static_assert(sizeof(WallData) == 32, "WallData layout changed");
+
+  struct StatsData {
+    uint32_t contacts;
+    uint32_t wallContacts;
+    uint32_t maxSpeed; // Float bits
+    uint32_t speedSum;
+    uint32_t padding[4];
+  };
+  static_assert(sizeof(StatsData) == 32, "StatsData layout changed");
+
+  struct Readback {
+    GLuint buffer = 0;
+    GLsync fence = nullptr; // Set while the copy is in flight
+    uint64_t step = 0;
+    uint32_t particles = 0;
+  };
+
+  ShaderProgram integrateProgram;
+  ShaderProgram scanProgram;
+  ShaderProgram scatterProgram;
+  ShaderProgram collideProgram;
+  ShaderProgram renderProgram;
+
+  GLuint buffers[BINDING_COUNT] = {};
+  GLuint emptyVAO = 0; // Core profiles draw nothing without one bound
+  Readback readbacks[READBACK_SLOTS];
+  int nextReadback = 0;
+
+  Settings settings;
+  glm::vec2 gridOrigin = glm::vec2(0.0f);
+  glm::ivec2 gridSize = glm::ivec2(1);
+  float cellSize = 1.0f;
+  uint32_t wallCount = 0;
+
+  size_t capacity = 0;
+  size_t count = 0;
+  uint64_t stepCount = 0;
+  Stats stats;
+  int skippedReadbacks = 0;
+  bool initialized = false;
+
+public:
+  GpuParticleSystem() = default;
+  ~GpuParticleSystem() { Shutdown(); }
+
+  GpuParticleSystem(const GpuParticleSystem &) = delete;
+  GpuParticleSystem &operator=(const GpuParticleSystem &) = delete;
+
+  // GL 4.3 with storage buffers readable from vertex shaders. Needs a
+  // current context.
+  static bool IsSupported();
+
+  // Loads the shaders and sizes every buffer for capacity particles.
+  // Returns false (errors on std::cerr) if unsupported or a shader fails.
+  bool Initialize(size_t capacity, const std::string &shaderDirectory = "shaders/");
+  // Releases the GL objects (call while the context is still current)
+  void Shutdown();
+  bool IsInitialized() const { return initialized; }
+
+  // Takes effect from the next step. The grid is sized from the bounds and
+  // maxRadius, cells grow past 2 * maxRadius when the bounds need more than
+  // MAX_GRID_CELLS of them.
+  void SetSettings(const Settings &newSettings);
+  const Settings &GetSettings() const { return settings; }
+  void SetWalls(const std::vector<Wall> &walls); // At most MAX_WALLS
+
+  // Appends particles after the live ones in one upload. Returns how many
+  // fit under the capacity.
+  size_t Spawn(const Particle *particles, size_t spawnCount);
+  void Clear();
+
+  // One simulation step of dt seconds
+  void Step(float dt);
+  // Draws the particles with the current framebuffer and depth state
+  void Render(const glm::mat4 &viewProjection);
+
+  size_t GetCount() const { return count; }
+  size_t GetCapacity() const { return capacity; }
+  const Stats &GetStats() const { return stats; }
+  // Steps whose stats were dropped because every readback slot was busy
+  int GetSkippedReadbacks() const { return skippedReadbacks; }
+
+  static uint32_t PackColor(const glm::vec3 &color);
+
+private:
+  void UpdateGrid();
+  void SetGridUniforms(ShaderProgram &program);
+  void BindBuffers();
+  void QueueReadback();
+  void CollectReadbacks();
+  static GLuint DispatchGroups(size_t items);
+};
+
+} // namespace Common
+} // namespace Engine
+
+#endif
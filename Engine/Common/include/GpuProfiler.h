@@ -0,0 +1,93 @@
+#ifndef GPU_PROFILER_H
+#define GPU_PROFILER_H
+
+#include "Profiler.h"
+#include <GL/glew.h>
+#include <cstdint>
+
+namespace Engine {
+namespace Common {
+
+// GPU timeline for the profiler. Each zone brackets its commands with two
+// GL_TIMESTAMP queries; results are read back FRAMES_IN_FLIGHT frames later
+// (never waited on, late frames are dropped) and added to the "GPU" track,
+// shifted onto the CPU clock with a GPU/CPU timestamp pair taken at the
+// start of the frame. Needs timer queries (GL 3.3), otherwise every call is
+// a no-op. Use it from the thread that owns the GL context.
+class GpuProfiler {
+public:
+  static constexpr int FRAMES_IN_FLIGHT = 4;
+  static constexpr int MAX_ZONES = 64; // Per frame, more are ignored
+
+private:
+  struct Frame {
+    GLuint queries[MAX_ZONES * 2] = {};
+    const char *names[MAX_ZONES] = {};
+    uint32_t depths[MAX_ZONES] = {};
+    int zoneCount = 0;
+    GLuint lastQuery = 0; // Issued last, so it completes last
+    GLint64 gpuBase = 0;
+    uint64_t cpuBase = 0;
+    bool pending = false;
+  };
+
+  Frame frames[FRAMES_IN_FLIGHT];
+  int current = 0;
+  uint32_t depth = 0;
+  uint32_t track = 0;
+  bool initialized = false;
+  bool supported = false;
+  int droppedFrames = 0;
+
+public:
+  GpuProfiler() = default;
+
+  GpuProfiler(const GpuProfiler &) = delete;
+  GpuProfiler &operator=(const GpuProfiler &) = delete;
+
+  static GpuProfiler &Get();
+
+  // Collects finished frames and starts recording a new one. The first call
+  // creates the queries, so a context must be current.
+  void BeginFrame();
+  // Releases the queries (call while the context is still current)
+  void Shutdown();
+
+  // Returns the zone index for EndZone, -1 if it is not recorded
+  int BeginZone(const char *name);
+  void EndZone(int zone);
+
+  bool IsSupported() const { return supported; }
+  // Frames whose results were not ready when their slot came round again
+  int GetDroppedFrames() const { return droppedFrames; }
+
+private:
+  void Collect(Frame &frame);
+};
+
+// RAII GPU zone, see PROFILE_GPU_SCOPE
+class GpuProfileZone {
+private:
+  int zone;
+
+public:
+  explicit GpuProfileZone(const char *name) : zone(GpuProfiler::Get().BeginZone(name)) {}
+  ~GpuProfileZone() { GpuProfiler::Get().EndZone(zone); }
+
+  GpuProfileZone(const GpuProfileZone &) = delete;
+  GpuProfileZone &operator=(const GpuProfileZone &) = delete;
+};
+
+} // namespace Common
+} // namespace Engine
+
+#ifdef BASIC_ENGINE_PROFILER
+#define PROFILE_GPU_SCOPE(name) \
+  ::Engine::Common::GpuProfileZone PROFILE_CONCAT(gpuProfileZone, __LINE__)(name)
+#define PROFILE_GPU_FRAME() ::Engine::Common::GpuProfiler::Get().BeginFrame()
+#else
+#define PROFILE_GPU_SCOPE(name) ((void)0)
+#define PROFILE_GPU_FRAME() ((void)0)
+#endif
+
+#endif
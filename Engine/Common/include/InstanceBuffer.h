@@ -0,0 +1,69 @@
+#ifndef INSTANCE_BUFFER_H
+#define INSTANCE_BUFFER_H
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+namespace Engine {
+namespace Common {
+
+// Per-instance vertex data. color.a blends between the mesh's vertex colors
+// (0) and color.rgb (1).
+struct InstanceData {
+  glm::mat4 transform;
+  glm::vec4 color;
+};
+
+// Streams instance data to the GPU. With ARB_buffer_storage the buffer is
+// mapped once and split into REGION_COUNT regions used round-robin, one per
+// frame, each guarded by a fence. Without it the buffer is orphaned every
+// frame and filled with glBufferSubData.
+class InstanceBuffer {
+public:
+  static constexpr int REGION_COUNT = 3;
+
+private:
+  GLuint buffer = 0;
+  bool persistent = false;
+  InstanceData *mapped = nullptr; // Start of the whole persistent mapping
+  size_t regionCapacity = 0;      // Instances per region
+  int region = 0;
+  size_t regionUsed = 0;
+  GLsync fences[REGION_COUNT] = {};
+
+public:
+  InstanceBuffer() = default;
+  ~InstanceBuffer() { Destroy(); }
+
+  InstanceBuffer(const InstanceBuffer &) = delete;
+  InstanceBuffer &operator=(const InstanceBuffer &) = delete;
+
+  bool Create(size_t initialCapacity = 4096);
+  void Destroy();
+
+  // Frame boundaries: BeginFrame waits until the GPU is done with the next
+  // region, EndFrame fences everything written this frame
+  void BeginFrame();
+  void EndFrame();
+
+  // Copies count instances and returns the byte offset of the first one
+  size_t Write(const InstanceData *instances, size_t count);
+
+  // Grows every region to at least capacity instances. Between frames
+  // only, like the growth in Write it starts over with fresh storage.
+  void Reserve(size_t capacity);
+
+  GLuint GetID() const { return buffer; }
+  bool IsPersistent() const { return persistent; }
+  size_t GetCapacity() const { return regionCapacity; }
+
+private:
+  void Allocate(size_t capacity);
+  void WaitForRegion(int index);
+};
+
+} // namespace Common
+} // namespace Engine
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Engine {
+namespace Common {
+
+class JobSystem;
+
+// Reference to a scheduled job. Copyable; an empty handle counts as done.
+class JobHandle {
+private:
+  friend class JobSystem;
+  struct Job;
+  std::shared_ptr<Job> job;
+
+  explicit JobHandle(std::shared_ptr<Job> j) : job(std::move(j)) {}
+
+public:
+  JobHandle() = default;
+
+  bool IsValid() const { return job != nullptr; }
+  bool IsDone() const;
+};
+
+// Engine-wide scheduler. Each worker owns a deque: it pushes and pops its own
+// jobs at the back and steals from the front of the other deques when it runs
+// dry. Threads outside the pool submit to a shared queue. Until Start() is
+// called (or after Stop()) every job runs inline on the calling thread, so
+// code using the job system also works in tools that never start it.
+class JobSystem {
+public:
+  using JobFunction = std::function<void()>;
+  using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+private:
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<std::shared_ptr<JobHandle::Job>> jobs;
+  };
+
+  std::vector<std::thread> workers;
+  std::vector<std::unique_ptr<WorkerQueue>> queues; // One per worker, plus the shared queue last
+  std::atomic<bool> running{false};
+
+  // Sleeping workers wait here until something is queued
+  std::mutex sleepMutex;
+  std::condition_variable sleepCondition;
+  std::atomic<size_t> queuedJobs{0};
+  bool stopping = false;
+
+public:
+  JobSystem() = default;
+  ~JobSystem();
+
+  JobSystem(const JobSystem &) = delete;
+  JobSystem &operator=(const JobSystem &) = delete;
+
+  // The scheduler shared by the whole engine
+  static JobSystem &Get();
+
+  // workerCount = 0 uses one worker per hardware thread, minus the caller,
+  // but never fewer than one. Once running, queued jobs always make
+  // progress without anyone calling Wait().
+  void Start(size_t workerCount = 0);
+  void Stop();
+  bool IsRunning() const { return running.load(std::memory_order_acquire); }
+
+  size_t GetWorkerCount() const { return workers.size(); }
+  // Threads that take part in ParallelFor: the workers plus the caller
+  size_t GetThreadCount() const { return workers.size() + 1; }
+  static size_t GetHardwareThreadCount();
+
+  // Runs function once every dependency has finished
+  JobHandle Schedule(JobFunction function,
+                     std::initializer_list<JobHandle> dependencies = {});
+  JobHandle Schedule(JobFunction function,
+                     const std::vector<JobHandle> &dependencies);
+  // Continuation: runs function after parent
+  JobHandle Then(const JobHandle &parent, JobFunction function);
+
+  // Blocks until the job has finished, running other jobs meanwhile
+  void Wait(const JobHandle &handle);
+  void Wait(const std::vector<JobHandle> &handles);
+
+  // Calls body on chunks of [begin, end) of at least grainSize indices and
+  // returns when all are done. maxThreads limits how many threads take part
+  // (0 = all). The caller always works on chunks itself.
+  void ParallelFor(size_t begin, size_t end, size_t grainSize,
+                   const RangeFunction &body, size_t maxThreads = 0);
+
+private:
+  void WorkerLoop(size_t index);
+  void Enqueue(std::shared_ptr<JobHandle::Job> job);
+  std::shared_ptr<JobHandle::Job> PopJob();
+  bool RunOneJob();
+  void Execute(const std::shared_ptr<JobHandle::Job> &job);
+};
+
+} // namespace Common
+} // namespace Engine
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+namespace Engine {
+namespace Common {
+
+// Read-only memory mapping of a whole file (mmap, or a file mapping on
+// Windows). The data stays valid until Close, Open or destruction; bytes
+// appended to the file afterwards are only visible after mapping it again.
+class MappedFile {
+private:
+  const unsigned char *data = nullptr;
+  size_t size = 0;
+#ifdef _WIN32
+  void *fileHandle = nullptr;
+  void *mappingHandle = nullptr;
+#endif
+
+public:
+  MappedFile() = default;
+  ~MappedFile() { Close(); }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  // Maps path, replacing any current mapping. Returns false if the file is
+  // missing, empty or cannot be mapped (errors other than a missing file
+  // go to std::cerr).
+  bool Open(const std::string &path);
+  void Close();
+
+  bool IsOpen() const { return data != nullptr; }
+  const unsigned char *GetData() const { return data; }
+  size_t GetSize() const { return size; }
+};
+
+} // namespace Common
+} // namespace Engine
+
+#endif // MAPPED_FILE_H
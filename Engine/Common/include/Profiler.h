@@ -0,0 +1,144 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace Engine {
+namespace Common {
+
+// One finished zone. Times are nanoseconds on the profiler clock.
+struct ProfileEvent {
+  const char *name = nullptr;
+  uint64_t start = 0;
+  uint64_t end = 0;
+  uint32_t depth = 0; // Nesting level on its track
+  uint32_t track = 0;
+};
+
+// Scoped-zone profiler. Every thread writes finished zones into its own
+// ring buffer (single writer, published with one atomic store), so
+// recording never locks; readers copy the rings and drop whatever was
+// overwritten meanwhile. Tracks are threads, plus extra ones such as the GPU
+// timeline that are fed by one thread on behalf of something else.
+//
+// Zone names are not copied: pass string literals, or Intern() others.
+// Use the PROFILE_* macros below; building without BASIC_ENGINE_PROFILER
+// removes them entirely.
+class Profiler {
+public:
+  static constexpr size_t TRACK_CAPACITY = 1 << 14; // Events per ring
+  static constexpr size_t FRAME_HISTORY = 240;
+
+private:
+  struct Track {
+    std::string name;
+    uint32_t index = 0;
+    std::unique_ptr<ProfileEvent[]> events{new ProfileEvent[TRACK_CAPACITY]};
+    std::atomic<uint64_t> written{0};
+    uint32_t depth = 0; // Open zones of the writing thread
+  };
+
+  mutable std::mutex tracksMutex; // Guards the list, not the rings
+  std::vector<std::unique_ptr<Track>> tracks;
+
+  std::mutex namesMutex;
+  std::unordered_set<std::string> names;
+
+  // Frame starts, written and read by the thread calling BeginFrame
+  uint64_t frameStarts[FRAME_HISTORY] = {};
+  uint64_t frameCount = 0;
+  std::atomic<bool> paused{false};
+
+public:
+  Profiler() = default;
+
+  Profiler(const Profiler &) = delete;
+  Profiler &operator=(const Profiler &) = delete;
+
+  static Profiler &Get();
+
+  // Nanoseconds since the profiler clock started
+  static uint64_t Now();
+
+  // Names the calling thread's track (defaults to "Thread N")
+  void SetThreadName(const char *name);
+  // Track written by the caller on behalf of something else, e.g. the GPU
+  uint32_t CreateTrack(const std::string &name);
+  // Stable copy of a name for zones built at runtime
+  const char *Intern(const std::string &name);
+
+  // Zone bookkeeping for the calling thread, see ProfileZone
+  void EnterZone();
+  void LeaveZone(const char *name, uint64_t start, uint64_t end);
+  // Adds a finished zone to a track from CreateTrack
+  void RecordZone(uint32_t track, const char *name, uint64_t start, uint64_t end,
+                  uint32_t depth);
+
+  // Marks the start of a frame. While paused, neither frames nor zones are
+  // recorded, so the history stays as it was for inspection.
+  void BeginFrame();
+  void SetPaused(bool pause) { paused.store(pause, std::memory_order_relaxed); }
+  bool IsPaused() const { return paused.load(std::memory_order_relaxed); }
+
+  // Completed frames in the history
+  size_t GetFrameCount() const;
+  // [start, end) of a completed frame, 0 = the last one
+  bool GetFrame(size_t framesAgo, uint64_t &start, uint64_t &end) const;
+
+  // Zones overlapping [from, to) on every track, by track and start time
+  void CollectEvents(uint64_t from, uint64_t to, std::vector<ProfileEvent> &out) const;
+  std::vector<std::string> GetTrackNames() const;
+
+  // Writes the last frameCount frames (0 = the whole history) as Chrome
+  // trace JSON, for chrome://tracing or ui.perfetto.dev
+  bool WriteChromeTrace(const std::string &path, size_t frames = 0) const;
+
+private:
+  Track &LocalTrack();
+  static void Write(Track &track, const ProfileEvent &event);
+};
+
+// RAII zone, see PROFILE_SCOPE
+class ProfileZone {
+private:
+  const char *name;
+  uint64_t start;
+
+public:
+  explicit ProfileZone(const char *zoneName) : name(zoneName) {
+    Profiler::Get().EnterZone();
+    start = Profiler::Now();
+  }
+  ~ProfileZone() { Profiler::Get().LeaveZone(name, start, Profiler::Now()); }
+
+  ProfileZone(const ProfileZone &) = delete;
+  ProfileZone &operator=(const ProfileZone &) = delete;
+};
+
+} // namespace Common
+} // namespace Engine
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef BASIC_ENGINE_PROFILER
+#define PROFILE_SCOPE(name) \
+  ::Engine::Common::ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+#define PROFILE_FRAME() ::Engine::Common::Profiler::Get().BeginFrame()
+#define PROFILE_THREAD(name) ::Engine::Common::Profiler::Get().SetThreadName(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef PROFILER_PANEL_H
+#define PROFILER_PANEL_H
+
+#include "Profiler.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Engine {
+namespace Common {
+
+// ImGui window over the profiler history: frame time graph, a flame view
+// of one frame (one band per track, zones stacked by depth), the zones
+// taking the most time in it, and Chrome trace export.
+class ProfilerPanel {
+private:
+  struct ZoneTotal {
+    const char *name;
+    uint64_t total;
+    int count;
+  };
+
+  int framesAgo = 0; // Shown frame, 0 = the last completed one
+  std::vector<float> frameTimes;
+  std::vector<ProfileEvent> events;
+  std::vector<ZoneTotal> totals;
+  std::vector<std::string> trackNames;
+  char exportPath[256] = "profile_trace.json";
+  std::string exportStatus;
+
+public:
+  // Draws the window, open is cleared when it is closed
+  void Draw(bool *open = nullptr);
+
+private:
+  void DrawFrameGraph();
+  void DrawFlame(uint64_t frameStart, uint64_t frameEnd);
+  void DrawTopZones();
+};
+
+} // namespace Common
+} // namespace Engine
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Engine {
+namespace Common {
+
+// Coarse draw order, the most significant part of a sort key. Scene geometry
+// goes first so the floor is mostly rejected by the depth test, the grid
+// goes last because it lies exactly on the floor.
+enum class RenderLayer : uint8_t { SCENE = 0, FLOOR = 1, GRID = 2 };
+
+enum class DrawKind : uint8_t { ELEMENTS, ARRAYS, ELEMENTS_INSTANCED };
+
+struct DrawCommand {
+  DrawKind kind = DrawKind::ELEMENTS;
+  GLenum mode = GL_TRIANGLES;
+  GLuint program = 0;
+  GLuint vao = 0;
+  GLsizei count = 0;         // Indices or vertices
+  GLsizei instanceCount = 0; // ELEMENTS_INSTANCED only
+  size_t firstInstance = 0;  // Into the frame's staged instance data
+  glm::mat4 model = glm::mat4(1.0f); // Per-draw "model" uniform
+};
+
+// Counted per frame while the queue is replayed
+struct RenderStats {
+  size_t commands = 0;
+  size_t drawCalls = 0;
+  size_t instancedDrawCalls = 0;
+  size_t instances = 0;
+  size_t programChanges = 0;
+  size_t vertexArrayChanges = 0;
+  size_t cullTested = 0; // Cubes and instances checked against the frustum
+  size_t culled = 0;
+};
+
+// Draws recorded during a frame. Only (key, index) pairs are sorted, the
+// commands themselves stay where they were recorded.
+class RenderQueue {
+private:
+  std::vector<DrawCommand> commands;
+  std::vector<std::pair<uint64_t, uint32_t>> keys;
+
+public:
+  // layer (4 bits) | program (14) | vao (14) | depth (32). Equal keys keep
+  // their submission order.
+  static uint64_t MakeKey(RenderLayer layer, GLuint program, GLuint vao,
+                          float depth);
+
+  void Submit(uint64_t key, const DrawCommand &command);
+  void Sort();
+  void Clear();
+
+  size_t Size() const { return commands.size(); }
+  bool IsEmpty() const { return commands.empty(); }
+
+  // fn(const DrawCommand&), in key order once sorted
+  template <typename Fn> void ForEach(Fn &&fn) const {
+    for (const auto &entry : keys) {
+      fn(commands[entry.second]);
+    }
+  }
+};
+
+// Shadows the bound program and VAO so redundant binds are skipped, and
+// resolves uniform locations once per program.
+class GLStateCache {
+private:
+  static constexpr GLuint UNKNOWN = 0xFFFFFFFFu;
+
+  GLuint program = UNKNOWN;
+  GLuint vao = UNKNOWN;
+  std::unordered_map<GLuint, std::unordered_map<std::string, GLint>> uniforms;
+
+  size_t programChanges = 0;
+  size_t vaoChanges = 0;
+
+public:
+  // Return true if the binding actually changed
+  bool UseProgram(GLuint id);
+  bool BindVertexArray(GLuint id);
+
+  GLint GetUniformLocation(GLuint programId, const char *name);
+
+  // Someone else (ImGui, a framebuffer pass) may have touched the state
+  void Invalidate();
+  // Drops cached locations, for programs that were deleted or relinked
+  void ForgetProgram(GLuint id) { uniforms.erase(id); }
+
+  size_t GetProgramChanges() const { return programChanges; }
+  size_t GetVertexArrayChanges() const { return vaoChanges; }
+  void ResetCounters() { programChanges = vaoChanges = 0; }
+};
+
+} // namespace Common
+} // namespace Engine
+
+#endif
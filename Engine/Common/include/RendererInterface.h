@@ -6,10 +6,14 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <cstddef>
 
 namespace Engine {
 namespace Common {
 
+// Meshes the renderer can draw instanced
+enum class RenderPrimitive { CUBE };
+
 class RendererInterface {
 public:
   virtual ~RendererInterface() = default;
@@ -24,6 +28,14 @@ public:
                           const glm::vec3 &scale = glm::vec3(1.0f)) = 0;
   virtual void RenderCube(const glm::mat4 &transformMatrix) = 0;
 
+  // Draws count copies of a primitive in one call. colors holds one color
+  // per instance, nullptr keeps the mesh's vertex colors. Renderers may skip
+  // instances that are off screen. Like every matrix a renderer takes, the
+  // transforms are relative to its floating origin, if it has one.
+  virtual void SubmitInstances(RenderPrimitive primitive,
+                               const glm::mat4 *transforms,
+                               const glm::vec3 *colors, size_t count) = 0;
+
   virtual void CreateFloor() = 0;
   virtual void RenderFloor(float size = 20.0f, int gridLines = 20) = 0;
   virtual void SetFloorEnabled(bool enabled) = 0;
@@ -2,6 +2,10 @@
 #define OPENGL_RENDERER_WRAPPER_H
 
 #include "../../../renderer/include/FrameBuffer.h"
+#include "FloatingOrigin.h"
+#include "Frustum.h"
+#include "InstanceBuffer.h"
+#include "RenderQueue.h"
 #include "RendererInterface.h"
 #include <memory>
 #include <vector>
@@ -16,9 +20,16 @@ class Camera;
 namespace Engine {
 namespace Common {
 
+class GpuParticleSystem;
+
 class OpenGLRendererWrapper : public RendererInterface {
 
 private:
+  // Projection used for camMatrix and for culling, they have to agree
+  static constexpr float CAMERA_FOV = 45.0f;
+  static constexpr float CAMERA_NEAR = 0.1f;
+  static constexpr float CAMERA_FAR = 100.0f;
+
   GLFWwindow *window;
 
   // Store references to renderer components
@@ -28,6 +39,7 @@ private:
   std::unique_ptr<EBO> ebo;
   std::unique_ptr<ImGuiManager> imguiManager;
   std::unique_ptr<Camera> camera;
+  FloatingOrigin floatingOrigin; // camera->Position is relative to it
 
   // Viewport rendering
   std::unique_ptr<Framebuffer> viewportFramebuffer;
@@ -44,6 +56,26 @@ private:
   std::unique_ptr<VBO> cubeVBO;
   std::unique_ptr<EBO> cubeEBO;
 
+  // For instanced rendering, the cube mesh plus per-instance attributes
+  std::unique_ptr<Shader> instancedShader;
+  std::unique_ptr<VAO> instancedCubeVAO;
+  InstanceBuffer instanceBuffer;
+
+  // Draws are recorded here and replayed sorted at EndFrame, or when a
+  // viewport pass begins or ends
+  RenderQueue renderQueue;
+  GLStateCache stateCache;
+  std::vector<InstanceData> stagedInstances; // Uploaded once per flush
+  std::vector<GLuint> cameraPrograms;        // Got camMatrix this flush
+  RenderStats frameStats;
+  RenderStats lastFrameStats;
+
+  // Frustum culling of cubes, updated after the camera moves each frame
+  Frustum frustum;
+  bool frustumCullingEnabled = true;
+  std::vector<glm::vec4> cullSpheres;
+  std::vector<uint32_t> cullVisible;
+
   // For floor rendering
   std::unique_ptr<VAO> floorVAO;
   std::unique_ptr<VBO> floorVBO;
@@ -84,6 +116,8 @@ public:
   void RenderCube(const glm::vec3 &position,
                   const glm::vec3 &scale = glm::vec3(1.0f)) override;
   void RenderCube(const glm::mat4 &transformMatrix) override;
+  void SubmitInstances(RenderPrimitive primitive, const glm::mat4 *transforms,
+                       const glm::vec3 *colors, size_t count) override;
 
   void CreateFloor() override;
   void RenderFloor(float size = 20.0f, int gridLines = 20) override;
@@ -96,9 +130,41 @@ public:
   void ResizeViewport(int width, int height);
   void SetMainWindowSize(int width, int height);
 
+  const RenderStats &GetLastFrameStats() const { return lastFrameStats; }
+
+  // Sizes the instance buffer and the per-frame instance arrays for count
+  // instances ahead of time (a scene being loaded), so its first frames
+  // don't reallocate them. Call between frames.
+  void ReserveInstances(size_t count);
+
+  // Model matrices are relative to this origin, which follows the camera in
+  // steps (TransformSystem::BuildRelativeMatrices makes them from doubles)
+  const FloatingOrigin &GetFloatingOrigin() const { return floatingOrigin; }
+  glm::dvec3 GetCameraWorldPosition() const;
+  void SetCameraWorldPosition(const glm::dvec3 &position);
+
+  // Projection times view, as camMatrix (relative to the floating origin)
+  glm::mat4 GetViewProjection() const;
+
+  // Draws simulated particles straight from their buffers. World positions
+  // are taken as absolute and moved to the floating origin here. Call
+  // between BeginFrame and EndFrame.
+  void RenderGpuParticles(GpuParticleSystem &particles);
+
+  void SetFrustumCullingEnabled(bool enabled) {
+    frustumCullingEnabled = enabled;
+  }
+  bool IsFrustumCullingEnabled() const { return frustumCullingEnabled; }
+
 private:
   void CreateFloorPlane(float size);
   void CreateGridLines(float size, int gridLines);
+  void BindInstanceAttributes(size_t offset);
+  void FlushRenderQueue();
+  float GetViewDepth(const glm::mat4 &transformMatrix) const;
+  void UpdateFrustum();
+  static glm::vec4 GetCubeBoundingSphere(const glm::mat4 &transformMatrix);
+  Shader &GetShaderForProgram(GLuint program);
 };
 
 } // namespace Common
@@ -0,0 +1,125 @@
+#ifndef SHADER_PROGRAM_H
+#define SHADER_PROGRAM_H
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine {
+namespace Common {
+
+// GLSL program loaded from files. Unlike the renderer's Shader, sources may
+// pull in shared code with #include "file" (resolved relative to the
+// including file), and failures are reported instead of thrown. Uniform
+// locations are looked up once and cached.
+//
+// Linked programs can be cached on disk as driver binaries (see
+// SetBinaryCacheDirectory), keyed by the expanded sources and the driver
+// strings. Loads can also run in the background: BeginLoad starts the
+// compile (on driver threads with KHR_parallel_shader_compile) and Poll
+// swaps the program in once it is done, so the old one keeps drawing
+// meanwhile. ReloadIfChanged uses the same path for hot reload.
+class ShaderProgram {
+private:
+  struct Build {
+    GLuint program = 0;
+    GLuint vertex = 0;
+    GLuint fragment = 0;
+    bool fromBinary = false;
+    uint64_t key = 0;
+    std::vector<std::string> vertexFiles;
+    std::vector<std::string> fragmentFiles;
+  };
+
+  struct WatchedFile {
+    std::string path;
+    std::filesystem::file_time_type time;
+  };
+
+  GLuint id = 0;
+  std::unordered_map<std::string, GLint> uniforms;
+
+  Build pending;
+  bool isPending = false;
+
+  std::string vertexPath;
+  std::string fragmentPath;
+  std::vector<WatchedFile> watched;
+
+public:
+  ShaderProgram() = default;
+  ~ShaderProgram() { Destroy(); }
+
+  ShaderProgram(const ShaderProgram &) = delete;
+  ShaderProgram &operator=(const ShaderProgram &) = delete;
+
+  // Compiles and links, replacing the current program only on success.
+  // Errors (with file names) go to std::cerr.
+  bool LoadFromFiles(const std::string &vertexPath,
+                     const std::string &fragmentPath);
+
+  // Compute program from a single file (GL 4.3 or ARB_compute_shader).
+  // Compiled and linked right away, without the binary cache or hot reload.
+  bool LoadComputeFromFile(const std::string &computePath);
+
+  // Starts compiling without waiting for the driver. Returns false if a
+  // source could not be read. A load already in flight is abandoned.
+  bool BeginLoad(const std::string &vertexPath,
+                 const std::string &fragmentPath);
+  // Swaps in the pending program if the driver has finished it. Returns
+  // true when a new program was installed; failures are reported and the
+  // current program is kept.
+  bool Poll();
+  // Blocks until the pending program is done. Returns true on success.
+  bool Finish();
+  bool IsPending() const { return isPending; }
+
+  // Starts a background reload when any source file (includes too) changed
+  // since the last load, and polls a reload in flight. Returns true when a
+  // reloaded program was installed.
+  bool ReloadIfChanged();
+
+  void Destroy();
+
+  void Use() const { glUseProgram(id); }
+  GLuint GetID() const { return id; }
+  bool IsValid() const { return id != 0; }
+
+  GLint GetUniformLocation(const char *name);
+
+  // Reads path and expands #include lines in place. Each file gets a #line
+  // directive with its index in files, so compiler messages can be mapped
+  // back. Returns false (with error set) on a missing file or include cycle.
+  static bool LoadSource(const std::string &path, std::string &source,
+                         std::vector<std::string> &files, std::string &error);
+
+  // Directory for cached program binaries; empty (the default) disables
+  // the cache. Shared by all programs.
+  static void SetBinaryCacheDirectory(const std::string &directory);
+
+private:
+  static bool ExpandFile(const std::string &path, std::string &source,
+                         std::vector<std::string> &files,
+                         std::vector<std::string> &stack, std::string &error);
+  static GLuint Compile(GLenum type, const std::string &source);
+  static bool CheckCompiled(GLuint shader, const std::string &path,
+                            const std::vector<std::string> &files);
+  static bool CheckLinked(GLuint program, const std::string &name);
+  bool FinishPending();
+  void CancelPending();
+  void WatchFiles(const std::vector<std::string> &files);
+  bool FilesChanged() const;
+
+  static bool BinaryCacheAvailable();
+  static std::string BinaryCachePath(uint64_t key);
+  static GLuint LoadBinary(uint64_t key);
+  static void SaveBinary(GLuint program, uint64_t key);
+};
+
+} // namespace Common
+} // namespace Engine
+
+#endif
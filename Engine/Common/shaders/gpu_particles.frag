@@ -0,0 +1,16 @@
+#version 430 core
+
+in vec2 corner;
+in vec4 color;
+
+out vec4 FragColor;
+
+void main()
+{
+    float distanceSq = dot(corner, corner);
+    if (distanceSq > 1.0) {
+        discard;
+    }
+    // Darker towards the rim, so touching particles stay apart
+    FragColor = vec4(color.rgb * (1.0 - 0.35 * distanceSq), 1.0);
+}
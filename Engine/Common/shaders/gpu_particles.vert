@@ -0,0 +1,24 @@
+#version 430 core
+
+#include "gpu_particles_common.glsl"
+
+// One quad per instance, corners from gl_VertexID (triangle strip), read
+// straight from the simulation's particle buffer
+
+layout (std430, binding = PARTICLE_BINDING) readonly buffer Particles { Particle particles[]; };
+
+out vec2 corner;
+out vec4 color;
+
+uniform mat4 viewProjection;
+
+const vec2 CORNERS[4] = vec2[](vec2(-1.0, -1.0), vec2(1.0, -1.0),
+                               vec2(-1.0, 1.0), vec2(1.0, 1.0));
+
+void main()
+{
+    Particle particle = particles[gl_InstanceID];
+    corner = CORNERS[gl_VertexID];
+    color = unpackUnorm4x8(particle.color);
+    gl_Position = viewProjection * vec4(particle.position + corner * particle.radius, 0.0, 1.0);
+}
@@ -0,0 +1,50 @@
+// Buffer layouts shared by the GPU particle shaders, they have to match
+// GpuParticleSystem.h (std430)
+
+#define PARTICLE_BINDING 0
+#define PREDICTED_BINDING 1
+#define CELL_BINDING 2
+#define CELL_COUNT_BINDING 3
+#define CELL_START_BINDING 4
+#define SORTED_BINDING 5
+#define WALL_BINDING 6
+#define STATS_BINDING 7
+
+struct Particle {
+    vec2 position;
+    vec2 velocity;
+    float radius;
+    uint color; // packUnorm4x8
+    vec2 padding;
+};
+
+// Capsule: the segment start-end inflated by radius
+struct Wall {
+    vec4 segment; // start.xy, end.xy
+    float radius;
+    float padding0;
+    float padding1;
+    float padding2;
+};
+
+struct Stats {
+    uint contacts;      // Overlapping particle pairs
+    uint wallContacts;  // Particles touching a wall or the bounds
+    uint maxSpeed;      // floatBitsToUint, non-negative floats order as uints
+    uint speedSum;      // Whole units per second
+    uint padding[4];
+};
+
+uniform vec2 gridOrigin;
+uniform float cellSize;
+uniform ivec2 gridSize;
+
+ivec2 CellOf(vec2 position)
+{
+    return clamp(ivec2(floor((position - gridOrigin) / cellSize)), ivec2(0), gridSize - 1);
+}
+
+uint CellIndex(ivec2 cell)
+{
+    return uint(cell.y * gridSize.x + cell.x);
+}
@@ -0,0 +1,19 @@
+#version 330 core
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aColor;
+
+// Per instance
+layout (location = 2) in mat4 aModel;  // Occupies locations 2-5
+layout (location = 6) in vec4 aInstanceColor;
+
+out vec3 color;
+
+uniform mat4 camMatrix;
+
+void main()
+{
+    gl_Position = camMatrix * aModel * vec4(aPos, 1.0);
+    // alpha 0 keeps the mesh colors, 1 replaces them
+    color = mix(aColor, aInstanceColor.rgb, aInstanceColor.a);
+}
@@ -0,0 +1,38 @@
+#include "../include/FloatingOrigin.h"
+#include <cmath>
+
+namespace Engine {
+namespace Common {
+
+FloatingOrigin::FloatingOrigin(double rebaseDistance, double cellSize)
+    : rebaseDistance(rebaseDistance), cellSize(cellSize) {}
+
+bool FloatingOrigin::Update(const glm::dvec3 &cameraWorld) {
+  const glm::dvec3 offset = cameraWorld - origin;
+  if (glm::dot(offset, offset) <= rebaseDistance * rebaseDistance) {
+    return false;
+  }
+
+  Reset(cameraWorld);
+  return true;
+}
+
+void FloatingOrigin::Reset(const glm::dvec3 &world) {
+  const glm::dvec3 previous = origin;
+  glm::vec3 offset;
+  Split(world, cellSize, cell, offset);
+  origin = glm::dvec3(cell) * cellSize;
+  lastShift = origin - previous;
+  generation++;
+}
+
+void FloatingOrigin::Split(const glm::dvec3 &world, double cellSize,
+                           glm::ivec3 &cell, glm::vec3 &offset) {
+  cell = glm::ivec3(static_cast<int>(std::floor(world.x / cellSize)),
+                    static_cast<int>(std::floor(world.y / cellSize)),
+                    static_cast<int>(std::floor(world.z / cellSize)));
+  offset = glm::vec3(world - glm::dvec3(cell) * cellSize);
+}
+
+} // namespace Common
+} // namespace Engine
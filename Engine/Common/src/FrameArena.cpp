@@ -0,0 +1,90 @@
+#include "../include/FrameArena.h"
+
+#include <algorithm>
+
+namespace Engine {
+namespace Common {
+
+FrameArena::FrameArena(size_t capacity, std::pmr::memory_resource *upstreamResource)
+    : initialCapacity(std::max<size_t>(capacity, 1024)), upstream(upstreamResource) {}
+
+FrameArena &FrameArena::Get() {
+  static FrameArena instance;
+  return instance;
+}
+
+void FrameArena::AddBlock(size_t minimumSize) {
+  Block block;
+  block.size = minimumSize;
+  block.data.reset(new unsigned char[block.size]);
+  stats.capacity += block.size;
+  blocks.push_back(std::move(block));
+  offset = 0;
+}
+
+void FrameArena::BeginFrame() {
+  owner.store(std::this_thread::get_id(), std::memory_order_release);
+
+  // One block sized for the busiest frame so far replaces the overflow
+  if (blocks.size() != 1) {
+    const size_t size = std::max(initialCapacity, stats.capacity);
+    blocks.clear();
+    stats.capacity = 0;
+    AddBlock(size);
+  }
+
+  offset = 0;
+  stats.lastFramePeak = stats.peak;
+  stats.used = 0;
+  stats.peak = 0;
+  stats.overflowBlocks = 0;
+  stats.frame++;
+}
+
+bool FrameArena::Contains(const void *pointer) const {
+  const unsigned char *bytes = static_cast<const unsigned char *>(pointer);
+  for (const Block &block : blocks) {
+    if (bytes >= block.data.get() && bytes < block.data.get() + block.size)
+      return true;
+  }
+  return false;
+}
+
+void *FrameArena::do_allocate(size_t bytes, size_t alignment) {
+  if (!OnOwnerThread())
+    return upstream->allocate(bytes, alignment);
+
+  Block *block = &blocks.back();
+  uintptr_t base = reinterpret_cast<uintptr_t>(block->data.get());
+  uintptr_t start = (base + offset + alignment - 1) & ~(uintptr_t(alignment) - 1);
+  if (start + bytes > base + block->size) {
+    AddBlock(std::max(bytes + alignment, block->size));
+    stats.overflowBlocks++;
+    block = &blocks.back();
+    base = reinterpret_cast<uintptr_t>(block->data.get());
+    start = (base + alignment - 1) & ~(uintptr_t(alignment) - 1);
+  }
+
+  const size_t end = static_cast<size_t>(start - base) + bytes;
+  stats.used += end - offset;
+  stats.peak = std::max(stats.peak, stats.used);
+  offset = end;
+  return reinterpret_cast<void *>(start);
+}
+
+void FrameArena::do_deallocate(void *pointer, size_t bytes, size_t alignment) {
+  if (!OnOwnerThread() || !Contains(pointer)) {
+    upstream->deallocate(pointer, bytes, alignment);
+    return;
+  }
+
+  // Only the newest allocation can be given back
+  unsigned char *top = blocks.back().data.get() + offset;
+  if (static_cast<unsigned char *>(pointer) + bytes == top) {
+    offset -= bytes;
+    stats.used -= bytes;
+  }
+}
+
+} // namespace Common
+} // namespace Engine
@@ -0,0 +1,106 @@
+#include "../include/Frustum.h"
+#include <cmath>
+
+#if defined(BASIC_ENGINE_SIMD) &&                                              \
+    (defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__))
+#define FRUSTUM_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace Engine {
+namespace Common {
+
+Frustum::Frustum() {
+  for (int i = 0; i < PADDED_PLANE_COUNT; ++i) {
+    planeX[i] = planeY[i] = planeZ[i] = 0.0f;
+    planeW[i] = 1.0f;
+  }
+}
+
+void Frustum::SetFromMatrix(const glm::mat4 &viewProjection) {
+  // Gribb/Hartmann: each plane is the last row of the matrix plus or minus
+  // one of the others. glm is column major, so row r is m[0..3][r].
+  auto row = [&](int r) {
+    return glm::vec4(viewProjection[0][r], viewProjection[1][r],
+                     viewProjection[2][r], viewProjection[3][r]);
+  };
+  const glm::vec4 planes[PLANE_COUNT] = {
+      row(3) + row(0), // Left
+      row(3) - row(0), // Right
+      row(3) + row(1), // Bottom
+      row(3) - row(1), // Top
+      row(3) + row(2), // Near
+      row(3) - row(2), // Far
+  };
+
+  for (int i = 0; i < PLANE_COUNT; ++i) {
+    // Normalized so the plane distance can be compared with the radius
+    const float length = std::sqrt(planes[i].x * planes[i].x +
+                                   planes[i].y * planes[i].y +
+                                   planes[i].z * planes[i].z);
+    const float scale = length > 0.0f ? 1.0f / length : 0.0f;
+    planeX[i] = planes[i].x * scale;
+    planeY[i] = planes[i].y * scale;
+    planeZ[i] = planes[i].z * scale;
+    planeW[i] = length > 0.0f ? planes[i].w * scale : 1.0f;
+  }
+
+  // Padding planes: distance 1 from everything
+  for (int i = PLANE_COUNT; i < PADDED_PLANE_COUNT; ++i) {
+    planeX[i] = planeY[i] = planeZ[i] = 0.0f;
+    planeW[i] = 1.0f;
+  }
+}
+
+bool Frustum::IntersectsSphere(const glm::vec3 &center, float radius) const {
+#if defined(FRUSTUM_SSE2)
+  const __m128 x = _mm_set1_ps(center.x);
+  const __m128 y = _mm_set1_ps(center.y);
+  const __m128 z = _mm_set1_ps(center.z);
+  const __m128 negRadius = _mm_set1_ps(-radius);
+
+  int outside = 0;
+  for (int group = 0; group < PADDED_PLANE_COUNT; group += 4) {
+    __m128 distance = _mm_mul_ps(_mm_load_ps(planeX + group), x);
+    distance =
+        _mm_add_ps(distance, _mm_mul_ps(_mm_load_ps(planeY + group), y));
+    distance =
+        _mm_add_ps(distance, _mm_mul_ps(_mm_load_ps(planeZ + group), z));
+    distance = _mm_add_ps(distance, _mm_load_ps(planeW + group));
+    outside |= _mm_movemask_ps(_mm_cmplt_ps(distance, negRadius));
+  }
+  return outside == 0;
+#else
+  for (int i = 0; i < PLANE_COUNT; ++i) {
+    const float distance = planeX[i] * center.x + planeY[i] * center.y +
+                           planeZ[i] * center.z + planeW[i];
+    if (distance < -radius) {
+      return false;
+    }
+  }
+  return true;
+#endif
+}
+
+size_t Frustum::CullSpheres(const glm::vec4 *spheres, size_t count,
+                            uint32_t *visible) const {
+  size_t visibleCount = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const glm::vec4 &sphere = spheres[i];
+    // Branch-free append, the index is always written
+    visible[visibleCount] = static_cast<uint32_t>(i);
+    visibleCount += IntersectsSphere(glm::vec3(sphere), sphere.w) ? 1 : 0;
+  }
+  return visibleCount;
+}
+
+bool Frustum::IsSimdEnabled() {
+#if defined(FRUSTUM_SSE2)
+  return true;
+#else
+  return false;
+#endif
+}
+
+} // namespace Common
+} // namespace Engine
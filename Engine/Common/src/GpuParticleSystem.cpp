@@ -0,0 +1,370 @@
+#include "../include/GpuParticleSystem.h"
+#include "../include/GpuProfiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <glm/gtc/type_ptr.hpp>
+#include <iostream>
+
+namespace Engine {
+namespace Common {
+
+bool GpuParticleSystem::IsSupported() {
+  if (!GLEW_VERSION_4_3) {
+    return false;
+  }
+  // The render pass reads the particle buffer from its vertex shader,
+  // which 4.3 allows but doesn't require
+  GLint vertexBlocks = 0;
+  glGetIntegerv(GL_MAX_VERTEX_SHADER_STORAGE_BLOCKS, &vertexBlocks);
+  return vertexBlocks > 0;
+}
+
+bool GpuParticleSystem::Initialize(size_t particleCapacity,
+                                   const std::string &shaderDirectory) {
+  Shutdown();
+  if (!IsSupported()) {
+    std::cerr << "GpuParticleSystem: needs OpenGL 4.3 with vertex shader "
+                 "storage blocks"
+              << std::endl;
+    return false;
+  }
+
+  if (!integrateProgram.LoadComputeFromFile(shaderDirectory +
+                                            "gpu_particles_integrate.comp") ||
+      !scanProgram.LoadComputeFromFile(shaderDirectory +
+                                       "gpu_particles_scan.comp") ||
+      !scatterProgram.LoadComputeFromFile(shaderDirectory +
+                                          "gpu_particles_scatter.comp") ||
+      !collideProgram.LoadComputeFromFile(shaderDirectory +
+                                          "gpu_particles_collide.comp") ||
+      !renderProgram.LoadFromFiles(shaderDirectory + "gpu_particles.vert",
+                                   shaderDirectory + "gpu_particles.frag")) {
+    Shutdown();
+    return false;
+  }
+
+  const size_t sizes[BINDING_COUNT] = {
+      particleCapacity * sizeof(Particle),          // Particles
+      particleCapacity * sizeof(glm::vec4),         // Predicted
+      particleCapacity * sizeof(glm::uvec2),        // Cell, rank
+      MAX_GRID_CELLS * sizeof(uint32_t),            // Cell counts
+      MAX_GRID_CELLS * sizeof(uint32_t),            // Cell starts
+      particleCapacity * sizeof(uint32_t),          // Sorted
+      MAX_WALLS * sizeof(WallData),                 // Walls
+      sizeof(StatsData),                            // Stats
+  };
+  glGenBuffers(BINDING_COUNT, buffers);
+  for (GLuint i = 0; i < BINDING_COUNT; ++i) {
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[i]);
+    glBufferData(GL_SHADER_STORAGE_BUFFER,
+                 static_cast<GLsizeiptr>(std::max<size_t>(sizes[i], 16)),
+                 nullptr, GL_DYNAMIC_COPY);
+  }
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+  for (Readback &readback : readbacks) {
+    glGenBuffers(1, &readback.buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, readback.buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, sizeof(StatsData), nullptr,
+                 GL_STREAM_READ);
+  }
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+  glGenVertexArrays(1, &emptyVAO);
+
+  capacity = particleCapacity;
+  count = 0;
+  stepCount = 0;
+  stats = Stats();
+  skippedReadbacks = 0;
+  initialized = true;
+  UpdateGrid();
+  return true;
+}
+
+void GpuParticleSystem::Shutdown() {
+  integrateProgram.Destroy();
+  scanProgram.Destroy();
+  scatterProgram.Destroy();
+  collideProgram.Destroy();
+  renderProgram.Destroy();
+  if (!initialized) {
+    return;
+  }
+
+  glDeleteBuffers(BINDING_COUNT, buffers);
+  std::fill(std::begin(buffers), std::end(buffers), 0u);
+  for (Readback &readback : readbacks) {
+    if (readback.fence) {
+      glDeleteSync(readback.fence);
+    }
+    glDeleteBuffers(1, &readback.buffer);
+    readback = Readback();
+  }
+  glDeleteVertexArrays(1, &emptyVAO);
+  emptyVAO = 0;
+
+  capacity = 0;
+  count = 0;
+  wallCount = 0;
+  initialized = false;
+}
+
+void GpuParticleSystem::SetSettings(const Settings &newSettings) {
+  settings = newSettings;
+  UpdateGrid();
+}
+
+void GpuParticleSystem::UpdateGrid() {
+  const glm::vec2 extent =
+      glm::max(settings.boundsMax - settings.boundsMin, glm::vec2(1.0f));
+  const auto cellsFor = [&extent](float size) {
+    return glm::ivec2(static_cast<int>(std::ceil(extent.x / size)),
+                      static_cast<int>(std::ceil(extent.y / size)));
+  };
+
+  // No contact reaches past the neighbouring cells while a cell is at least
+  // two radii wide; bigger bounds get bigger cells rather than more of them
+  cellSize = std::max(settings.maxRadius * 2.0f, 1.0f);
+  gridSize = cellsFor(cellSize);
+  while (static_cast<uint32_t>(gridSize.x) * static_cast<uint32_t>(gridSize.y) >
+         MAX_GRID_CELLS) {
+    cellSize *= 1.1f;
+    gridSize = cellsFor(cellSize);
+  }
+  gridOrigin = settings.boundsMin;
+}
+
+void GpuParticleSystem::SetWalls(const std::vector<Wall> &walls) {
+  wallCount = static_cast<uint32_t>(std::min<size_t>(walls.size(), MAX_WALLS));
+  if (!initialized || wallCount == 0) {
+    return;
+  }
+
+  WallData data[MAX_WALLS] = {};
+  for (uint32_t i = 0; i < wallCount; ++i) {
+    data[i].segment[0] = walls[i].start.x;
+    data[i].segment[1] = walls[i].start.y;
+    data[i].segment[2] = walls[i].end.x;
+    data[i].segment[3] = walls[i].end.y;
+    data[i].radius = walls[i].radius;
+  }
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[WALL_BINDING]);
+  glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, wallCount * sizeof(WallData),
+                  data);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+size_t GpuParticleSystem::Spawn(const Particle *particles, size_t spawnCount) {
+  if (!initialized) {
+    return 0;
+  }
+  spawnCount = std::min(spawnCount, capacity - count);
+  if (spawnCount == 0) {
+    return 0;
+  }
+
+  // Ordered after the last step's writes by its barrier
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[PARTICLE_BINDING]);
+  glBufferSubData(GL_SHADER_STORAGE_BUFFER,
+                  static_cast<GLintptr>(count * sizeof(Particle)),
+                  static_cast<GLsizeiptr>(spawnCount * sizeof(Particle)),
+                  particles);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+  count += spawnCount;
+  return spawnCount;
+}
+
+void GpuParticleSystem::Clear() {
+  // The buffers keep their contents, only the live count matters
+  count = 0;
+  stats = Stats();
+  stats.step = stepCount;
+}
+
+GLuint GpuParticleSystem::DispatchGroups(size_t items) {
+  return static_cast<GLuint>((items + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE);
+}
+
+void GpuParticleSystem::SetGridUniforms(ShaderProgram &program) {
+  glUniform2fv(program.GetUniformLocation("gridOrigin"), 1,
+               glm::value_ptr(gridOrigin));
+  glUniform1f(program.GetUniformLocation("cellSize"), cellSize);
+  glUniform2iv(program.GetUniformLocation("gridSize"), 1,
+               glm::value_ptr(gridSize));
+}
+
+void GpuParticleSystem::BindBuffers() {
+  for (GLuint binding = 0; binding < BINDING_COUNT; ++binding) {
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, buffers[binding]);
+  }
+}
+
+void GpuParticleSystem::Step(float dt) {
+  if (!initialized || dt <= 0.0f) {
+    return;
+  }
+  CollectReadbacks();
+  if (count == 0) {
+    return;
+  }
+  PROFILE_SCOPE("GpuParticleSystem::Step");
+  PROFILE_GPU_SCOPE("GPU particles");
+
+  stepCount++;
+  const GLuint particleCount = static_cast<GLuint>(count);
+  const GLuint cellCount = static_cast<GLuint>(gridSize.x * gridSize.y);
+  BindBuffers();
+
+  // Only the cells in use need zeroing
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[CELL_COUNT_BINDING]);
+  glClearBufferSubData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, 0,
+                       cellCount * sizeof(uint32_t), GL_RED_INTEGER,
+                       GL_UNSIGNED_INT, nullptr);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[STATS_BINDING]);
+  glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER,
+                    GL_UNSIGNED_INT, nullptr);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+  // Integrate, and count particles per cell
+  integrateProgram.Use();
+  SetGridUniforms(integrateProgram);
+  glUniform1ui(integrateProgram.GetUniformLocation("particleCount"),
+               particleCount);
+  glUniform1f(integrateProgram.GetUniformLocation("deltaTime"), dt);
+  glUniform2fv(integrateProgram.GetUniformLocation("gravity"), 1,
+               glm::value_ptr(settings.gravity));
+  glUniform1f(integrateProgram.GetUniformLocation("airResistance"),
+              settings.airResistance);
+  glUniform2fv(integrateProgram.GetUniformLocation("boundsMin"), 1,
+               glm::value_ptr(settings.boundsMin));
+  glUniform2fv(integrateProgram.GetUniformLocation("boundsMax"), 1,
+               glm::value_ptr(settings.boundsMax));
+  glDispatchCompute(DispatchGroups(count), 1, 1);
+  glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+  // Cell starts, one workgroup
+  scanProgram.Use();
+  glUniform1ui(scanProgram.GetUniformLocation("cellCount"), cellCount);
+  glDispatchCompute(1, 1, 1);
+  glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+  // Particle indices in cell order
+  scatterProgram.Use();
+  glUniform1ui(scatterProgram.GetUniformLocation("particleCount"),
+               particleCount);
+  glDispatchCompute(DispatchGroups(count), 1, 1);
+  glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+  // Contacts, and this step's stats
+  collideProgram.Use();
+  SetGridUniforms(collideProgram);
+  glUniform1ui(collideProgram.GetUniformLocation("particleCount"),
+               particleCount);
+  glUniform1ui(collideProgram.GetUniformLocation("wallCount"), wallCount);
+  glUniform1f(collideProgram.GetUniformLocation("deltaTime"), dt);
+  glUniform1f(collideProgram.GetUniformLocation("restitution"),
+              settings.restitution);
+  glUniform1f(collideProgram.GetUniformLocation("restitutionThreshold"),
+              settings.restitutionThreshold);
+  glUniform2fv(collideProgram.GetUniformLocation("boundsMin"), 1,
+               glm::value_ptr(settings.boundsMin));
+  glUniform2fv(collideProgram.GetUniformLocation("boundsMax"), 1,
+               glm::value_ptr(settings.boundsMax));
+  glDispatchCompute(DispatchGroups(count), 1, 1);
+
+  // Next step's passes, the draw's vertex shader, and the clears, copies
+  // and spawn uploads all come after these writes
+  glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+  glUseProgram(0);
+
+  QueueReadback();
+}
+
+void GpuParticleSystem::QueueReadback() {
+  Readback &readback = readbacks[nextReadback];
+  if (readback.fence) {
+    // The GPU is READBACK_SLOTS steps behind, these stats are dropped
+    skippedReadbacks++;
+    return;
+  }
+
+  glBindBuffer(GL_COPY_READ_BUFFER, buffers[STATS_BINDING]);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, readback.buffer);
+  glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+                      sizeof(StatsData));
+  glBindBuffer(GL_COPY_READ_BUFFER, 0);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+  readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  readback.step = stepCount;
+  readback.particles = static_cast<uint32_t>(count);
+  nextReadback = (nextReadback + 1) % READBACK_SLOTS;
+}
+
+void GpuParticleSystem::CollectReadbacks() {
+  for (Readback &readback : readbacks) {
+    if (!readback.fence) {
+      continue;
+    }
+    // Zero timeout: only asks whether the copy is done
+    const GLenum status = glClientWaitSync(readback.fence, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+      continue;
+    }
+    glDeleteSync(readback.fence);
+    readback.fence = nullptr;
+    if (readback.step <= stats.step) {
+      continue; // Older than what is shown, or from before a Clear
+    }
+
+    StatsData data;
+    glBindBuffer(GL_COPY_READ_BUFFER, readback.buffer);
+    glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(StatsData), &data);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+    float maxSpeed;
+    static_assert(sizeof(maxSpeed) == sizeof(data.maxSpeed), "float bits");
+    std::memcpy(&maxSpeed, &data.maxSpeed, sizeof(maxSpeed));
+
+    stats.step = readback.step;
+    stats.particles = readback.particles;
+    stats.contacts = data.contacts;
+    stats.wallContacts = data.wallContacts;
+    stats.maxSpeed = maxSpeed;
+    stats.averageSpeed =
+        readback.particles
+            ? static_cast<float>(data.speedSum) / readback.particles
+            : 0.0f;
+  }
+}
+
+void GpuParticleSystem::Render(const glm::mat4 &viewProjection) {
+  if (!initialized || count == 0) {
+    return;
+  }
+  PROFILE_GPU_SCOPE("GPU particles draw");
+
+  renderProgram.Use();
+  glUniformMatrix4fv(renderProgram.GetUniformLocation("viewProjection"), 1,
+                     GL_FALSE, glm::value_ptr(viewProjection));
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, PARTICLE_BINDING,
+                   buffers[PARTICLE_BINDING]);
+  glBindVertexArray(emptyVAO);
+  glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4,
+                        static_cast<GLsizei>(count));
+  glBindVertexArray(0);
+  glUseProgram(0);
+}
+
+uint32_t GpuParticleSystem::PackColor(const glm::vec3 &color) {
+  const auto channel = [](float value) {
+    return static_cast<uint32_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+  };
+  return channel(color.r) | (channel(color.g) << 8) | (channel(color.b) << 16) |
+         (255u << 24);
+}
+
+} // namespace Common
+} // namespace Engine
@@ -0,0 +1,92 @@
+#include "../include/GpuProfiler.h"
+
+namespace Engine {
+namespace Common {
+
+GpuProfiler &GpuProfiler::Get() {
+  static GpuProfiler instance;
+  return instance;
+}
+
+void GpuProfiler::BeginFrame() {
+  if (!initialized) {
+    initialized = true;
+    supported = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+    if (!supported)
+      return;
+    for (Frame &frame : frames) {
+      glGenQueries(MAX_ZONES * 2, frame.queries);
+    }
+    track = Profiler::Get().CreateTrack("GPU");
+  }
+  if (!supported)
+    return;
+
+  current = (current + 1) % FRAMES_IN_FLIGHT;
+  Frame &frame = frames[current];
+  if (frame.pending) {
+    Collect(frame);
+  }
+
+  frame.zoneCount = 0;
+  frame.pending = false;
+  depth = 0;
+  glGetInteger64v(GL_TIMESTAMP, &frame.gpuBase);
+  frame.cpuBase = Profiler::Now();
+}
+
+void GpuProfiler::Collect(Frame &frame) {
+  GLint available = 0;
+  glGetQueryObjectiv(frame.lastQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+  if (!available) {
+    droppedFrames++;
+    return;
+  }
+
+  for (int i = 0; i < frame.zoneCount; ++i) {
+    GLuint64 start = 0, end = 0;
+    glGetQueryObjectui64v(frame.queries[i * 2], GL_QUERY_RESULT, &start);
+    glGetQueryObjectui64v(frame.queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+    const int64_t offset = static_cast<int64_t>(start) - frame.gpuBase;
+    const uint64_t cpuStart = frame.cpuBase + static_cast<uint64_t>(offset > 0 ? offset : 0);
+    Profiler::Get().RecordZone(track, frame.names[i], cpuStart,
+                               cpuStart + (end > start ? end - start : 0), frame.depths[i]);
+  }
+}
+
+int GpuProfiler::BeginZone(const char *name) {
+  Frame &frame = frames[current];
+  if (!supported || frame.zoneCount >= MAX_ZONES)
+    return -1;
+
+  const int zone = frame.zoneCount++;
+  frame.names[zone] = name;
+  frame.depths[zone] = depth++;
+  glQueryCounter(frame.queries[zone * 2], GL_TIMESTAMP);
+  return zone;
+}
+
+void GpuProfiler::EndZone(int zone) {
+  if (zone < 0)
+    return;
+
+  Frame &frame = frames[current];
+  frame.lastQuery = frame.queries[zone * 2 + 1];
+  glQueryCounter(frame.lastQuery, GL_TIMESTAMP);
+  frame.pending = true;
+  depth--;
+}
+
+void GpuProfiler::Shutdown() {
+  if (supported) {
+    for (Frame &frame : frames) {
+      glDeleteQueries(MAX_ZONES * 2, frame.queries);
+      frame = Frame();
+    }
+  }
+  initialized = false;
+  supported = false;
+}
+
+} // namespace Common
+} // namespace Engine
@@ -0,0 +1,168 @@
+#include "../include/InstanceBuffer.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace Engine {
+namespace Common {
+
+bool InstanceBuffer::Create(size_t initialCapacity) {
+  Destroy();
+
+  persistent = GLEW_ARB_buffer_storage != 0;
+  Allocate(std::max<size_t>(initialCapacity, 1));
+
+  std::cout << "Instance buffer: " << regionCapacity << " instances, "
+            << (persistent ? "persistently mapped" : "orphaned per frame")
+            << std::endl;
+  return buffer != 0;
+}
+
+void InstanceBuffer::Destroy() {
+  for (int i = 0; i < REGION_COUNT; ++i) {
+    WaitForRegion(i);
+  }
+
+  if (buffer) {
+    if (mapped) {
+      glBindBuffer(GL_ARRAY_BUFFER, buffer);
+      glUnmapBuffer(GL_ARRAY_BUFFER);
+      glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    glDeleteBuffers(1, &buffer);
+  }
+
+  buffer = 0;
+  mapped = nullptr;
+  regionCapacity = 0;
+  regionUsed = 0;
+  region = 0;
+}
+
+void InstanceBuffer::Allocate(size_t capacity) {
+  if (buffer) {
+    // Draws already queued keep the old storage alive until they're done
+    if (mapped) {
+      glBindBuffer(GL_ARRAY_BUFFER, buffer);
+      glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+    glDeleteBuffers(1, &buffer);
+    mapped = nullptr;
+  }
+
+  for (int i = 0; i < REGION_COUNT; ++i) {
+    if (fences[i]) {
+      glDeleteSync(fences[i]);
+      fences[i] = nullptr;
+    }
+  }
+
+  regionCapacity = capacity;
+  regionUsed = 0;
+  region = 0;
+
+  glGenBuffers(1, &buffer);
+  glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+  if (persistent) {
+    const GLbitfield flags =
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const GLsizeiptr size = static_cast<GLsizeiptr>(
+        sizeof(InstanceData) * regionCapacity * REGION_COUNT);
+    glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+    mapped = static_cast<InstanceData *>(
+        glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+
+    if (!mapped) {
+      std::cerr << "Instance buffer: persistent mapping failed, falling back "
+                   "to glBufferSubData"
+                << std::endl;
+      glDeleteBuffers(1, &buffer);
+      persistent = false;
+      glGenBuffers(1, &buffer);
+      glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    }
+  }
+
+  if (!persistent) {
+    glBufferData(GL_ARRAY_BUFFER,
+                 static_cast<GLsizeiptr>(sizeof(InstanceData) * regionCapacity),
+                 nullptr, GL_STREAM_DRAW);
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstanceBuffer::WaitForRegion(int index) {
+  if (!fences[index])
+    return;
+
+  // Normally signalled long ago, a frame or two of latency is plenty
+  while (glClientWaitSync(fences[index], GL_SYNC_FLUSH_COMMANDS_BIT,
+                          1000000) == GL_TIMEOUT_EXPIRED) {
+  }
+  glDeleteSync(fences[index]);
+  fences[index] = nullptr;
+}
+
+void InstanceBuffer::BeginFrame() {
+  if (!buffer)
+    return;
+
+  regionUsed = 0;
+  if (persistent) {
+    region = (region + 1) % REGION_COUNT;
+    WaitForRegion(region);
+  } else {
+    // Orphan last frame's storage instead of waiting for it
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferData(GL_ARRAY_BUFFER,
+                 static_cast<GLsizeiptr>(sizeof(InstanceData) * regionCapacity),
+                 nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+}
+
+void InstanceBuffer::EndFrame() {
+  if (!buffer || !persistent || regionUsed == 0)
+    return;
+
+  if (fences[region]) {
+    glDeleteSync(fences[region]);
+  }
+  fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void InstanceBuffer::Reserve(size_t capacity) {
+  if (buffer && capacity > regionCapacity) {
+    Allocate(capacity);
+  }
+}
+
+size_t InstanceBuffer::Write(const InstanceData *instances, size_t count) {
+  if (regionUsed + count > regionCapacity) {
+    // Earlier draws this frame still read the old buffer, a fresh one
+    // starts empty
+    Allocate(std::max(regionCapacity * 2, count));
+  }
+
+  const size_t first = regionUsed;
+  regionUsed += count;
+
+  if (persistent) {
+    const size_t index = static_cast<size_t>(region) * regionCapacity + first;
+    std::memcpy(mapped + index, instances, count * sizeof(InstanceData));
+    return index * sizeof(InstanceData);
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, buffer);
+  glBufferSubData(GL_ARRAY_BUFFER,
+                  static_cast<GLintptr>(first * sizeof(InstanceData)),
+                  static_cast<GLsizeiptr>(count * sizeof(InstanceData)),
+                  instances);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  return first * sizeof(InstanceData);
+}
+
+} // namespace Common
+} // namespace Engine
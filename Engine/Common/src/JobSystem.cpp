@@ -0,0 +1,294 @@
+#include "../include/JobSystem.h"
+#include "../include/FrameArena.h"
+#include "../include/Profiler.h"
+
+#include <algorithm>
+
+namespace Engine {
+namespace Common {
+
+struct JobHandle::Job {
+  JobSystem::JobFunction function;
+  // Unfinished dependencies, plus one held by Schedule until it has
+  // registered with all of them
+  std::atomic<int> pendingDependencies{1};
+  std::atomic<bool> finished{false};
+
+  std::mutex mutex; // Guards continuations against a concurrent finish
+  std::vector<std::shared_ptr<Job>> continuations;
+};
+
+namespace {
+constexpr size_t NOT_A_WORKER = static_cast<size_t>(-1);
+
+// Lets Enqueue and PopJob find the calling worker's own deque
+thread_local const JobSystem *currentSystem = nullptr;
+thread_local size_t currentWorker = NOT_A_WORKER;
+} // namespace
+
+bool JobHandle::IsDone() const {
+  return !job || job->finished.load(std::memory_order_acquire);
+}
+
+JobSystem::~JobSystem() { Stop(); }
+
+JobSystem &JobSystem::Get() {
+  static JobSystem instance;
+  return instance;
+}
+
+size_t JobSystem::GetHardwareThreadCount() {
+  unsigned int count = std::thread::hardware_concurrency();
+  return count > 0 ? count : 1;
+}
+
+void JobSystem::Start(size_t workerCount) {
+  if (IsRunning())
+    return;
+
+  // Always at least one worker: fire-and-forget jobs that are only polled
+  // with IsDone() would never run on a single-core machine otherwise
+  if (workerCount == 0) {
+    workerCount = std::max<size_t>(GetHardwareThreadCount() - 1, 1);
+  }
+
+  stopping = false;
+  queues.clear();
+  for (size_t i = 0; i <= workerCount; ++i) {
+    queues.push_back(std::make_unique<WorkerQueue>());
+  }
+
+  running.store(true, std::memory_order_release);
+  workers.reserve(workerCount);
+  for (size_t i = 0; i < workerCount; ++i) {
+    workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+  }
+}
+
+void JobSystem::Stop() {
+  if (!IsRunning())
+    return;
+
+  // Workers drain every queue before they exit
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    stopping = true;
+  }
+  sleepCondition.notify_all();
+
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  workers.clear();
+
+  running.store(false, std::memory_order_release);
+
+  // Jobs queued by a foreign thread while the workers shut down
+  while (RunOneJob()) {
+  }
+  queues.clear();
+}
+
+JobHandle JobSystem::Schedule(JobFunction function,
+                              std::initializer_list<JobHandle> dependencies) {
+  return Schedule(std::move(function),
+                  std::vector<JobHandle>(dependencies.begin(), dependencies.end()));
+}
+
+JobHandle JobSystem::Schedule(JobFunction function,
+                              const std::vector<JobHandle> &dependencies) {
+  auto job = std::make_shared<JobHandle::Job>();
+  job->function = std::move(function);
+
+  for (const JobHandle &dependency : dependencies) {
+    if (!dependency.job)
+      continue;
+
+    std::lock_guard<std::mutex> lock(dependency.job->mutex);
+    if (!dependency.job->finished.load(std::memory_order_acquire)) {
+      job->pendingDependencies.fetch_add(1, std::memory_order_relaxed);
+      dependency.job->continuations.push_back(job);
+    }
+  }
+
+  // Drop the registration guard; whoever brings the count to zero queues it
+  if (job->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    Enqueue(job);
+  }
+
+  return JobHandle(job);
+}
+
+JobHandle JobSystem::Then(const JobHandle &parent, JobFunction function) {
+  return Schedule(std::move(function), {parent});
+}
+
+void JobSystem::Wait(const JobHandle &handle) {
+  while (!handle.IsDone()) {
+    if (!RunOneJob()) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void JobSystem::Wait(const std::vector<JobHandle> &handles) {
+  for (const JobHandle &handle : handles) {
+    Wait(handle);
+  }
+}
+
+void JobSystem::ParallelFor(size_t begin, size_t end, size_t grainSize,
+                            const RangeFunction &body, size_t maxThreads) {
+  if (end <= begin)
+    return;
+
+  // Chunk boundaries only depend on the grain size, so callers can keep one
+  // output buffer per chunk and merge them in order
+  grainSize = std::max<size_t>(grainSize, 1);
+  const size_t chunkCount = (end - begin + grainSize - 1) / grainSize;
+
+  size_t threads = IsRunning() ? GetThreadCount() : 1;
+  if (maxThreads > 0)
+    threads = std::min(threads, maxThreads);
+  threads = std::min(threads, chunkCount);
+
+  std::atomic<size_t> nextChunk{0};
+  auto runChunks = [&]() {
+    for (;;) {
+      size_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+      if (chunk >= chunkCount)
+        break;
+      size_t chunkBegin = begin + chunk * grainSize;
+      PROFILE_SCOPE("ParallelFor chunk");
+      body(chunkBegin, std::min(chunkBegin + grainSize, end));
+    }
+  };
+
+  // Helpers reference this frame, so every one of them is waited on even if
+  // the caller already took the last chunk. Several ParallelFors run per
+  // step, so the list is frame memory (workers calling this get the heap).
+  FrameVector<JobHandle> helpers;
+  helpers.reserve(threads > 0 ? threads - 1 : 0);
+  for (size_t i = 1; i < threads; ++i) {
+    helpers.push_back(Schedule(runChunks));
+  }
+
+  runChunks();
+  for (const JobHandle &helper : helpers) {
+    Wait(helper);
+  }
+}
+
+void JobSystem::Enqueue(std::shared_ptr<JobHandle::Job> job) {
+  if (!IsRunning()) {
+    Execute(job);
+    return;
+  }
+
+  // Workers push to their own deque, everyone else to the shared one
+  const bool onWorker = (currentSystem == this && currentWorker != NOT_A_WORKER);
+  WorkerQueue &queue = *queues[onWorker ? currentWorker : queues.size() - 1];
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.jobs.push_back(std::move(job));
+  }
+  queuedJobs.fetch_add(1, std::memory_order_release);
+
+  // Taking the lock orders the increment before a sleeping worker's check
+  { std::lock_guard<std::mutex> lock(sleepMutex); }
+  sleepCondition.notify_one();
+}
+
+std::shared_ptr<JobHandle::Job> JobSystem::PopJob() {
+  if (queues.empty() || queuedJobs.load(std::memory_order_acquire) == 0)
+    return nullptr;
+
+  const bool onWorker = (currentSystem == this && currentWorker != NOT_A_WORKER);
+  const size_t queueCount = queues.size();
+
+  // Own deque newest first, keeps the working set warm
+  if (onWorker) {
+    WorkerQueue &own = *queues[currentWorker];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.jobs.empty()) {
+      auto job = std::move(own.jobs.back());
+      own.jobs.pop_back();
+      queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+      return job;
+    }
+  }
+
+  // Then the shared queue and every other deque, oldest first. Starting after
+  // our own index spreads thieves over different victims.
+  const size_t start = onWorker ? currentWorker + 1 : 0;
+  for (size_t i = 0; i < queueCount; ++i) {
+    size_t index = (queueCount - 1 + start + i) % queueCount;
+    if (onWorker && index == currentWorker)
+      continue;
+
+    WorkerQueue &victim = *queues[index];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.jobs.empty()) {
+      auto job = std::move(victim.jobs.front());
+      victim.jobs.pop_front();
+      queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+      return job;
+    }
+  }
+
+  return nullptr;
+}
+
+bool JobSystem::RunOneJob() {
+  auto job = PopJob();
+  if (!job)
+    return false;
+
+  Execute(job);
+  return true;
+}
+
+void JobSystem::Execute(const std::shared_ptr<JobHandle::Job> &job) {
+  if (job->function) {
+    PROFILE_SCOPE("Job");
+    job->function();
+    job->function = nullptr; // Release captures as soon as possible
+  }
+
+  std::vector<std::shared_ptr<JobHandle::Job>> ready;
+  {
+    std::lock_guard<std::mutex> lock(job->mutex);
+    job->finished.store(true, std::memory_order_release);
+    ready.swap(job->continuations);
+  }
+
+  for (auto &continuation : ready) {
+    if (continuation->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      Enqueue(std::move(continuation));
+    }
+  }
+}
+
+void JobSystem::WorkerLoop(size_t index) {
+  currentSystem = this;
+  currentWorker = index;
+  PROFILE_THREAD(("Worker " + std::to_string(index)).c_str());
+
+  for (;;) {
+    if (RunOneJob())
+      continue;
+
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    sleepCondition.wait(lock, [this] {
+      return stopping || queuedJobs.load(std::memory_order_acquire) > 0;
+    });
+    if (stopping && queuedJobs.load(std::memory_order_acquire) == 0)
+      break;
+  }
+
+  currentSystem = nullptr;
+  currentWorker = NOT_A_WORKER;
+}
+
+} // namespace Common
+} // namespace Engine
@@ -0,0 +1,117 @@
+#include "../include/MappedFile.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Engine {
+namespace Common {
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string &path) {
+  Close();
+
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  LARGE_INTEGER length;
+  if (!GetFileSizeEx(file, &length) || length.QuadPart == 0) {
+    CloseHandle(file);
+    return false;
+  }
+
+  HANDLE mapping =
+      CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)
+                       : nullptr;
+  if (!view) {
+    std::cerr << "MappedFile: cannot map " << path << " (error "
+              << GetLastError() << ")" << std::endl;
+    if (mapping) {
+      CloseHandle(mapping);
+    }
+    CloseHandle(file);
+    return false;
+  }
+
+  fileHandle = file;
+  mappingHandle = mapping;
+  data = static_cast<const unsigned char *>(view);
+  size = static_cast<size_t>(length.QuadPart);
+  return true;
+}
+
+void MappedFile::Close() {
+  if (data) {
+    UnmapViewOfFile(data);
+  }
+  if (mappingHandle) {
+    CloseHandle(mappingHandle);
+  }
+  if (fileHandle) {
+    CloseHandle(fileHandle);
+  }
+  data = nullptr;
+  size = 0;
+  fileHandle = mappingHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::Open(const std::string &path) {
+  Close();
+
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size == 0) {
+    close(fd);
+    return false;
+  }
+
+  // The mapping keeps its own reference to the file
+  void *view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ,
+                    MAP_SHARED, fd, 0);
+  close(fd);
+  if (view == MAP_FAILED) {
+    std::cerr << "MappedFile: cannot map " << path << " ("
+              << std::strerror(errno) << ")" << std::endl;
+    return false;
+  }
+
+  data = static_cast<const unsigned char *>(view);
+  size = static_cast<size_t>(info.st_size);
+  return true;
+}
+
+void MappedFile::Close() {
+  if (data) {
+    munmap(const_cast<unsigned char *>(data), size);
+  }
+  data = nullptr;
+  size = 0;
+}
+
+#endif
+
+} // namespace Common
+} // namespace Engine
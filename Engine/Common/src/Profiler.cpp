@@ -0,0 +1,247 @@
+#include "../include/Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+namespace Engine {
+namespace Common {
+
+namespace {
+// Track of the calling thread, created on its first zone
+thread_local Profiler *trackOwner = nullptr;
+thread_local void *localTrack = nullptr;
+
+const std::chrono::steady_clock::time_point clockStart = std::chrono::steady_clock::now();
+
+void WriteJsonString(std::ostream &out, const char *text) {
+  out << '"';
+  for (const char *c = text ? text : ""; *c; ++c) {
+    if (*c == '"' || *c == '\\') {
+      out << '\\' << *c;
+    } else if (static_cast<unsigned char>(*c) >= 0x20) {
+      out << *c;
+    }
+  }
+  out << '"';
+}
+} // namespace
+
+Profiler &Profiler::Get() {
+  static Profiler instance;
+  return instance;
+}
+
+uint64_t Profiler::Now() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now() - clockStart)
+                                   .count());
+}
+
+Profiler::Track &Profiler::LocalTrack() {
+  if (trackOwner != this) {
+    std::lock_guard<std::mutex> lock(tracksMutex);
+    auto track = std::make_unique<Track>();
+    track->index = static_cast<uint32_t>(tracks.size());
+    track->name = "Thread " + std::to_string(tracks.size());
+    localTrack = track.get();
+    trackOwner = this;
+    tracks.push_back(std::move(track));
+  }
+  return *static_cast<Track *>(localTrack);
+}
+
+void Profiler::SetThreadName(const char *name) {
+  Track &track = LocalTrack();
+  std::lock_guard<std::mutex> lock(tracksMutex);
+  track.name = name;
+}
+
+uint32_t Profiler::CreateTrack(const std::string &name) {
+  std::lock_guard<std::mutex> lock(tracksMutex);
+  auto track = std::make_unique<Track>();
+  track->index = static_cast<uint32_t>(tracks.size());
+  track->name = name;
+  tracks.push_back(std::move(track));
+  return tracks.back()->index;
+}
+
+const char *Profiler::Intern(const std::string &name) {
+  std::lock_guard<std::mutex> lock(namesMutex);
+  return names.insert(name).first->c_str();
+}
+
+void Profiler::Write(Track &track, const ProfileEvent &event) {
+  // Only the owner writes, readers see the slot once written is published
+  const uint64_t index = track.written.load(std::memory_order_relaxed);
+  track.events[index % TRACK_CAPACITY] = event;
+  track.written.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::EnterZone() { LocalTrack().depth++; }
+
+void Profiler::LeaveZone(const char *name, uint64_t start, uint64_t end) {
+  Track &track = LocalTrack();
+  track.depth--;
+  if (IsPaused())
+    return;
+
+  ProfileEvent event;
+  event.name = name;
+  event.start = start;
+  event.end = end;
+  event.depth = track.depth;
+  event.track = track.index;
+  Write(track, event);
+}
+
+void Profiler::RecordZone(uint32_t trackIndex, const char *name, uint64_t start, uint64_t end,
+                          uint32_t depth) {
+  if (IsPaused())
+    return;
+
+  Track *track = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(tracksMutex);
+    if (trackIndex >= tracks.size())
+      return;
+    track = tracks[trackIndex].get();
+  }
+
+  ProfileEvent event;
+  event.name = name;
+  event.start = start;
+  event.end = end;
+  event.depth = depth;
+  event.track = trackIndex;
+  Write(*track, event);
+}
+
+void Profiler::BeginFrame() {
+  if (IsPaused())
+    return;
+  frameStarts[frameCount % FRAME_HISTORY] = Now();
+  frameCount++;
+}
+
+size_t Profiler::GetFrameCount() const {
+  if (frameCount < 2)
+    return 0;
+  return static_cast<size_t>(std::min<uint64_t>(frameCount - 1, FRAME_HISTORY - 1));
+}
+
+bool Profiler::GetFrame(size_t framesAgo, uint64_t &start, uint64_t &end) const {
+  if (framesAgo >= GetFrameCount())
+    return false;
+  const uint64_t last = frameCount - 1 - framesAgo;
+  end = frameStarts[last % FRAME_HISTORY];
+  start = frameStarts[(last - 1) % FRAME_HISTORY];
+  return true;
+}
+
+void Profiler::CollectEvents(uint64_t from, uint64_t to, std::vector<ProfileEvent> &out) const {
+  out.clear();
+  std::lock_guard<std::mutex> lock(tracksMutex);
+
+  std::vector<uint64_t> slots; // Ring index of every event copied from the current track
+  for (const auto &track : tracks) {
+    const size_t first = out.size();
+    slots.clear();
+    const uint64_t written = track->written.load(std::memory_order_acquire);
+    const uint64_t oldest = written > TRACK_CAPACITY ? written - TRACK_CAPACITY : 0;
+    for (uint64_t i = oldest; i < written; ++i) {
+      const ProfileEvent &event = track->events[i % TRACK_CAPACITY];
+      if (event.end > from && event.start < to) {
+        out.push_back(event);
+        slots.push_back(i);
+      }
+    }
+
+    // The writer may have lapped the copy. It has overwritten at most the
+    // events below after - capacity and may be storing the one at exactly
+    // that index, so drop those (copied first, a prefix) and keep the rest.
+    const uint64_t after = track->written.load(std::memory_order_acquire);
+    if (after - oldest >= TRACK_CAPACITY) {
+      const uint64_t valid = after - TRACK_CAPACITY + 1;
+      const size_t stale = static_cast<size_t>(
+          std::lower_bound(slots.begin(), slots.end(), valid) - slots.begin());
+      out.erase(out.begin() + first, out.begin() + first + stale);
+    }
+    std::sort(out.begin() + first, out.end(), [](const ProfileEvent &a, const ProfileEvent &b) {
+      return a.start != b.start ? a.start < b.start : a.depth < b.depth;
+    });
+  }
+}
+
+std::vector<std::string> Profiler::GetTrackNames() const {
+  std::lock_guard<std::mutex> lock(tracksMutex);
+  std::vector<std::string> result;
+  result.reserve(tracks.size());
+  for (const auto &track : tracks) {
+    result.push_back(track->name);
+  }
+  return result;
+}
+
+bool Profiler::WriteChromeTrace(const std::string &path, size_t frames) const {
+  const size_t available = GetFrameCount();
+  if (available == 0) {
+    std::cerr << "Profiler: No completed frames to export" << std::endl;
+    return false;
+  }
+  if (frames == 0 || frames > available)
+    frames = available;
+
+  uint64_t from = 0, to = 0, unused = 0;
+  GetFrame(frames - 1, from, unused);
+  GetFrame(0, unused, to);
+
+  std::vector<ProfileEvent> events;
+  CollectEvents(from, to, events);
+  const std::vector<std::string> trackNames = GetTrackNames();
+
+  std::ofstream out(path);
+  if (!out) {
+    std::cerr << "Profiler: Cannot write " << path << std::endl;
+    return false;
+  }
+
+  // Complete ("X") events in microseconds; frames get their own row
+  const uint32_t frameTrack = static_cast<uint32_t>(trackNames.size());
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  out.setf(std::ios::fixed);
+  out.precision(3);
+  for (uint32_t i = 0; i < trackNames.size(); ++i) {
+    out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << i << ",\"args\":{\"name\":";
+    WriteJsonString(out, trackNames[i].c_str());
+    out << "}},\n";
+  }
+  out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << frameTrack
+      << ",\"args\":{\"name\":\"Frames\"}}";
+
+  for (size_t i = frames; i-- > 0;) {
+    uint64_t start = 0, end = 0;
+    GetFrame(i, start, end);
+    out << ",\n{\"ph\":\"X\",\"name\":\"Frame\",\"pid\":1,\"tid\":" << frameTrack
+        << ",\"ts\":" << start / 1000.0 << ",\"dur\":" << (end - start) / 1000.0 << "}";
+  }
+  for (const ProfileEvent &event : events) {
+    out << ",\n{\"ph\":\"X\",\"name\":";
+    WriteJsonString(out, event.name);
+    out << ",\"pid\":1,\"tid\":" << event.track << ",\"ts\":" << event.start / 1000.0
+        << ",\"dur\":" << (event.end - event.start) / 1000.0 << "}";
+  }
+  out << "\n]}\n";
+
+  if (!out) {
+    std::cerr << "Profiler: Failed writing " << path << std::endl;
+    return false;
+  }
+  std::cout << "Profiler: Wrote " << events.size() << " zones over " << frames << " frames to "
+            << path << std::endl;
+  return true;
+}
+
+} // namespace Common
+} // namespace Engine
@@ -0,0 +1,179 @@
+#include "../include/ProfilerPanel.h"
+#include "../include/GpuProfiler.h"
+#include "../../../renderer/include/ImGuiManager.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Engine {
+namespace Common {
+
+namespace {
+constexpr float ROW_HEIGHT = 18.0f;
+
+double ToMs(uint64_t nanoseconds) { return nanoseconds / 1000000.0; }
+
+// Same colour for a name in every frame
+ImU32 ZoneColor(const char *name) {
+  uint32_t hash = 2166136261u; // FNV-1a
+  for (const char *c = name ? name : ""; *c; ++c) {
+    hash = (hash ^ static_cast<unsigned char>(*c)) * 16777619u;
+  }
+  return ImColor::HSV((hash % 360) / 360.0f, 0.45f, 0.75f);
+}
+} // namespace
+
+void ProfilerPanel::Draw(bool *open) {
+  if (!ImGui::Begin("Profiler", open)) {
+    ImGui::End();
+    return;
+  }
+
+  Profiler &profiler = Profiler::Get();
+  bool paused = profiler.IsPaused();
+  if (ImGui::Checkbox("Pause", &paused)) {
+    profiler.SetPaused(paused);
+  }
+#ifndef BASIC_ENGINE_PROFILER
+  ImGui::SameLine();
+  ImGui::TextDisabled("(built without BASIC_ENGINE_PROFILER, no zones)");
+#endif
+  if (!GpuProfiler::Get().IsSupported()) {
+    ImGui::SameLine();
+    ImGui::TextDisabled("(no GPU timer queries)");
+  }
+
+  DrawFrameGraph();
+
+  uint64_t frameStart = 0, frameEnd = 0;
+  if (!profiler.GetFrame(static_cast<size_t>(framesAgo), frameStart, frameEnd)) {
+    ImGui::Text("No frames recorded yet");
+    ImGui::End();
+    return;
+  }
+  profiler.CollectEvents(frameStart, frameEnd, events);
+  trackNames = profiler.GetTrackNames();
+
+  ImGui::Text("Frame -%d: %.2f ms, %zu zones", framesAgo, ToMs(frameEnd - frameStart),
+              events.size());
+
+  ImGui::InputText("##path", exportPath, sizeof(exportPath));
+  ImGui::SameLine();
+  if (ImGui::Button("Export Chrome Trace")) {
+    exportStatus = profiler.WriteChromeTrace(exportPath) ? std::string("Wrote ") + exportPath
+                                                         : std::string("Export failed");
+  }
+  if (!exportStatus.empty()) {
+    ImGui::TextDisabled("%s", exportStatus.c_str());
+  }
+
+  ImGui::Separator();
+  DrawFlame(frameStart, frameEnd);
+  ImGui::Separator();
+  DrawTopZones();
+
+  ImGui::End();
+}
+
+void ProfilerPanel::DrawFrameGraph() {
+  Profiler &profiler = Profiler::Get();
+  const size_t count = profiler.GetFrameCount();
+
+  // Oldest first, so the newest frame is on the right
+  frameTimes.resize(count);
+  float slowest = 0.0f;
+  for (size_t i = 0; i < count; ++i) {
+    uint64_t start = 0, end = 0;
+    profiler.GetFrame(count - 1 - i, start, end);
+    frameTimes[i] = static_cast<float>(ToMs(end - start));
+    slowest = std::max(slowest, frameTimes[i]);
+  }
+  if (count == 0)
+    return;
+
+  framesAgo = std::min(framesAgo, static_cast<int>(count) - 1);
+  ImGui::PlotHistogram("##frames", frameTimes.data(), static_cast<int>(count), 0,
+                       "Frame times (click to select)", 0.0f, slowest * 1.1f,
+                       ImVec2(ImGui::GetContentRegionAvail().x, 60.0f));
+  if (ImGui::IsItemClicked()) {
+    const float x = (ImGui::GetMousePos().x - ImGui::GetItemRectMin().x) / ImGui::GetItemRectSize().x;
+    const int index = std::clamp(static_cast<int>(x * count), 0, static_cast<int>(count) - 1);
+    framesAgo = static_cast<int>(count) - 1 - index;
+    profiler.SetPaused(true); // Keep the selection from scrolling away
+  }
+  ImGui::SliderInt("Frame", &framesAgo, 0, static_cast<int>(count) - 1, "-%d");
+}
+
+void ProfilerPanel::DrawFlame(uint64_t frameStart, uint64_t frameEnd) {
+  const double duration = static_cast<double>(std::max<uint64_t>(frameEnd - frameStart, 1));
+  ImDrawList *draw = ImGui::GetWindowDrawList();
+  const float width = ImGui::GetContentRegionAvail().x;
+
+  // Events come grouped by track
+  size_t first = 0;
+  while (first < events.size()) {
+    const uint32_t track = events[first].track;
+    size_t last = first;
+    uint32_t maxDepth = 0;
+    while (last < events.size() && events[last].track == track) {
+      maxDepth = std::max(maxDepth, events[last].depth);
+      last++;
+    }
+
+    ImGui::TextUnformatted(track < trackNames.size() ? trackNames[track].c_str() : "?");
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    const float height = (maxDepth + 1) * ROW_HEIGHT;
+    ImGui::Dummy(ImVec2(width, height));
+    draw->AddRectFilled(origin, ImVec2(origin.x + width, origin.y + height), IM_COL32(30, 30, 30, 255));
+
+    for (size_t i = first; i < last; ++i) {
+      const ProfileEvent &event = events[i];
+      const uint64_t start = std::max(event.start, frameStart);
+      const uint64_t end = std::min(event.end, frameEnd);
+      const ImVec2 min(origin.x + static_cast<float>((start - frameStart) / duration * width),
+                       origin.y + event.depth * ROW_HEIGHT);
+      const ImVec2 max(std::max(min.x + 1.0f,
+                                origin.x + static_cast<float>((end - frameStart) / duration * width)),
+                       min.y + ROW_HEIGHT - 1.0f);
+
+      draw->AddRectFilled(min, max, ZoneColor(event.name));
+      if (max.x - min.x > ImGui::CalcTextSize(event.name).x + 4.0f) {
+        draw->PushClipRect(min, max, true);
+        draw->AddText(ImVec2(min.x + 2.0f, min.y + 1.0f), IM_COL32(0, 0, 0, 255), event.name);
+        draw->PopClipRect();
+      }
+      if (ImGui::IsMouseHoveringRect(min, max)) {
+        ImGui::SetTooltip("%s\n%.3f ms", event.name, ToMs(event.end - event.start));
+      }
+    }
+    first = last;
+  }
+}
+
+void ProfilerPanel::DrawTopZones() {
+  // Self time would need the children; totals are what shows up in the flame
+  totals.clear();
+  for (const ProfileEvent &event : events) {
+    auto it = std::find_if(totals.begin(), totals.end(),
+                           [&event](const ZoneTotal &total) {
+                             return total.name == event.name || std::strcmp(total.name, event.name) == 0;
+                           });
+    if (it == totals.end()) {
+      totals.push_back({event.name, 0, 0});
+      it = totals.end() - 1;
+    }
+    it->total += event.end - event.start;
+    it->count++;
+  }
+  std::sort(totals.begin(), totals.end(),
+            [](const ZoneTotal &a, const ZoneTotal &b) { return a.total > b.total; });
+
+  ImGui::Text("Top zones (all tracks)");
+  const size_t shown = std::min<size_t>(totals.size(), 12);
+  for (size_t i = 0; i < shown; ++i) {
+    ImGui::Text("%8.3f ms  %4dx  %s", ToMs(totals[i].total), totals[i].count, totals[i].name);
+  }
+}
+
+} // namespace Common
+} // namespace Engine
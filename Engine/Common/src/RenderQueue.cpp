@@ -0,0 +1,77 @@
+#include "../include/RenderQueue.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Engine {
+namespace Common {
+
+uint64_t RenderQueue::MakeKey(RenderLayer layer, GLuint program, GLuint vao,
+                              float depth) {
+  // For non-negative floats the bit pattern orders like the value, so
+  // ascending keys draw front to back
+  if (!(depth > 0.0f)) {
+    depth = 0.0f;
+  }
+  uint32_t depthBits;
+  std::memcpy(&depthBits, &depth, sizeof(depthBits));
+
+  return (static_cast<uint64_t>(layer) & 0xFu) << 60 |
+         (static_cast<uint64_t>(program) & 0x3FFFu) << 46 |
+         (static_cast<uint64_t>(vao) & 0x3FFFu) << 32 |
+         static_cast<uint64_t>(depthBits);
+}
+
+void RenderQueue::Submit(uint64_t key, const DrawCommand &command) {
+  keys.emplace_back(key, static_cast<uint32_t>(commands.size()));
+  commands.push_back(command);
+}
+
+void RenderQueue::Sort() {
+  // The index breaks ties, so this is stable without stable_sort
+  std::sort(keys.begin(), keys.end());
+}
+
+void RenderQueue::Clear() {
+  commands.clear();
+  keys.clear();
+}
+
+bool GLStateCache::UseProgram(GLuint id) {
+  if (id == program) {
+    return false;
+  }
+  glUseProgram(id);
+  program = id;
+  programChanges++;
+  return true;
+}
+
+bool GLStateCache::BindVertexArray(GLuint id) {
+  if (id == vao) {
+    return false;
+  }
+  glBindVertexArray(id);
+  vao = id;
+  vaoChanges++;
+  return true;
+}
+
+GLint GLStateCache::GetUniformLocation(GLuint programId, const char *name) {
+  auto &locations = uniforms[programId];
+  auto it = locations.find(name);
+  if (it != locations.end()) {
+    return it->second;
+  }
+
+  const GLint location = glGetUniformLocation(programId, name);
+  locations.emplace(name, location);
+  return location;
+}
+
+void GLStateCache::Invalidate() {
+  program = UNKNOWN;
+  vao = UNKNOWN;
+}
+
+} // namespace Common
+} // namespace Engine
@@ -1,4 +1,6 @@
 #include "../include/RendererWrapper.h"
+#include "../include/GpuParticleSystem.h"
+#include "../include/GpuProfiler.h"
 #include "../../../renderer/include/Camera.h"
 #include "../../../renderer/include/Camera2D.h"
 #include "../../../renderer/include/EBO.h"
@@ -7,6 +9,9 @@
 #include "../../../renderer/include/VAO.h"
 #include "../../../renderer/include/VBO.h"
 #include "../../../renderer/include/shaderClass.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <filesystem>
 #include <iostream>
 #include <vector>
@@ -81,14 +86,22 @@ bool OpenGLRendererWrapper::Initialize(int width, int height,
   }
   std::cout << "DEBUG: GLFW initialized" << std::endl;
 
-  // Set OpenGL version and profile
-  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+  // Set OpenGL version and profile. 4.3 brings compute shaders (GPU
+  // particles), everything else runs on 3.3.
   glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+  const int contextVersions[][2] = {{4, 3}, {3, 3}};
 
   // Create window
   std::cout << "DEBUG: Creating window..." << std::endl;
-  window = glfwCreateWindow(width, height, title, nullptr, nullptr);
+  window = nullptr;
+  for (const auto &version : contextVersions) {
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, version[0]);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, version[1]);
+    window = glfwCreateWindow(width, height, title, nullptr, nullptr);
+    if (window) {
+      break;
+    }
+  }
   if (!window) {
     std::cerr << "Failed to create GLFW window" << std::endl;
     glfwTerminate();
@@ -155,6 +168,18 @@ bool OpenGLRendererWrapper::Initialize(int width, int height,
   }
   std::cout << "DEBUG: Shaders loaded" << std::endl;
 
+  // Instanced path is optional, SubmitInstances falls back to RenderCube
+  try {
+    instancedShader = std::make_unique<Shader>("shaders/instanced.vert",
+                                               "shaders/instanced.frag");
+    instanceBuffer.Create();
+  } catch (...) {
+    std::cerr << "Failed to load shaders/instanced.vert and "
+                 "shaders/instanced.frag, drawing instances one by one"
+              << std::endl;
+    instancedShader.reset();
+  }
+
   std::cout << "DEBUG: Creating VAO, VBO, EBO..." << std::endl;
   vao = std::make_unique<VAO>();
   vao->Bind();
@@ -191,6 +216,9 @@ bool OpenGLRendererWrapper::Initialize(int width, int height,
 }
 
 void OpenGLRendererWrapper::BeginFrame() {
+  PROFILE_GPU_FRAME();
+  PROFILE_SCOPE("Renderer::BeginFrame");
+
   // Update window size
   int width, height;
   glfwGetFramebufferSize(window, &width, &height);
@@ -207,8 +235,15 @@ void OpenGLRendererWrapper::BeginFrame() {
   lastFrameTime = currentTime;
 
   camera->Inputs(window);
+  // The camera stays near the float origin, the origin follows it in steps
+  if (floatingOrigin.Update(floatingOrigin.ToWorld(camera->Position))) {
+    camera->Position -= glm::vec3(floatingOrigin.GetLastShift());
+  }
+  UpdateFrustum();
   imguiManager->BeginFrame();
 
+  instanceBuffer.BeginFrame();
+
   if (floorEnabled) {
     RenderFloor(floorSize, gridLineCount);
   }
@@ -267,24 +302,64 @@ void OpenGLRendererWrapper::BeginFrame() {
   ImGui::Text("Camera Settings");
   ImGui::SliderFloat("Camera Speed", &camera->speed, 0.01f, 0.2f);
   ImGui::SliderFloat("Camera Sensitivity", &camera->sensitivity, 10.0f, 100.0f);
+  const glm::dvec3 cameraWorld = GetCameraWorldPosition();
+  const glm::dvec3 &origin = floatingOrigin.GetOrigin();
+  ImGui::Text("Camera: (%.2f, %.2f, %.2f)", cameraWorld.x, cameraWorld.y,
+              cameraWorld.z);
+  ImGui::Text("Floating origin: (%.0f, %.0f, %.0f), %u rebases", origin.x,
+              origin.y, origin.z, floatingOrigin.GetGeneration());
 
   // Performance
   ImGui::Separator();
   ImGui::Text("Performance");
   ImGui::Text("Application average %.3f ms/frame (%.1f FPS)",
               1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+  ImGui::Text("Draw calls: %zu (%zu commands queued)",
+              lastFrameStats.drawCalls, lastFrameStats.commands);
+  ImGui::Text("Instanced: %zu draw calls, %zu instances (%s)",
+              lastFrameStats.instancedDrawCalls, lastFrameStats.instances,
+              !instancedShader             ? "disabled"
+              : instanceBuffer.IsPersistent() ? "persistent"
+                                              : "orphaned");
+  ImGui::Text("State changes: %zu programs, %zu VAOs",
+              lastFrameStats.programChanges,
+              lastFrameStats.vertexArrayChanges);
+  ImGui::Checkbox("Frustum Culling", &frustumCullingEnabled);
+  ImGui::SameLine();
+  ImGui::Text("%zu visible, %zu culled (%s)",
+              lastFrameStats.cullTested - lastFrameStats.culled,
+              lastFrameStats.culled,
+              Frustum::IsSimdEnabled() ? "SSE2" : "scalar");
   ImGui::End();
 }
 
 void OpenGLRendererWrapper::EndFrame() {
+  PROFILE_SCOPE("Renderer::EndFrame");
+  FlushRenderQueue();
+  instanceBuffer.EndFrame();
+
+  frameStats.programChanges = stateCache.GetProgramChanges();
+  frameStats.vertexArrayChanges = stateCache.GetVertexArrayChanges();
+  stateCache.ResetCounters();
+  lastFrameStats = frameStats;
+  frameStats = RenderStats();
+
   imguiManager->EndFrame();
-  imguiManager->Render();
+  {
+    PROFILE_SCOPE("ImGui");
+    PROFILE_GPU_SCOPE("ImGui");
+    imguiManager->Render();
+  }
 
-  glfwSwapBuffers(window);
+  {
+    PROFILE_SCOPE("SwapBuffers");
+    glfwSwapBuffers(window);
+  }
   glfwPollEvents();
 }
 
 void OpenGLRendererWrapper::Shutdown() {
+  GpuProfiler::Get().Shutdown();
   if (imguiManager) {
     imguiManager->Shutdown();
   }
@@ -305,6 +380,13 @@ void OpenGLRendererWrapper::Shutdown() {
   if (cubeEBO)
     cubeEBO->Delete();
 
+  if (instancedCubeVAO)
+    instancedCubeVAO->Delete();
+  if (instancedShader)
+    instancedShader->Delete();
+  if (window)
+    instanceBuffer.Destroy();
+
   if (floorVAO)
     floorVAO->Delete();
   if (floorVBO)
@@ -369,47 +451,280 @@ void OpenGLRendererWrapper::CreateCube() {
   cubeVAO->Unbind();
   cubeVBO->Unbind();
   cubeEBO->Unbind();
+
+  // Same mesh, attributes 2-5 hold the instance's model matrix columns and 6
+  // its color. All advance once per instance.
+  instancedCubeVAO = std::make_unique<VAO>();
+  instancedCubeVAO->Bind();
+  cubeEBO->Bind();
+  instancedCubeVAO->LinkAttrib(*cubeVBO.get(), 0, 3, GL_FLOAT,
+                               6 * sizeof(float), (void *)0);
+  instancedCubeVAO->LinkAttrib(*cubeVBO.get(), 1, 3, GL_FLOAT,
+                               6 * sizeof(float), (void *)(3 * sizeof(float)));
+  for (GLuint attrib = 2; attrib <= 6; ++attrib) {
+    glEnableVertexAttribArray(attrib);
+    glVertexAttribDivisor(attrib, 1);
+  }
+  instancedCubeVAO->Unbind();
+  cubeVBO->Unbind();
+  cubeEBO->Unbind();
 }
 
 void OpenGLRendererWrapper::RenderCube(const glm::vec3 &position,
                                        const glm::vec3 &scale) {
+  // Create model matrix for the cube
+  glm::mat4 modelMatrix = glm::mat4(1.0f);
+  modelMatrix = glm::translate(modelMatrix, position);
+  modelMatrix = glm::scale(modelMatrix, scale);
+
+  RenderCube(modelMatrix);
+}
+
+void OpenGLRendererWrapper::RenderCube(const glm::mat4 &transformMatrix) {
   if (!cubeVAO) {
     CreateCube();
   }
 
-  // Activate shader
-  shader->Activate();
+  if (frustumCullingEnabled) {
+    const glm::vec4 sphere = GetCubeBoundingSphere(transformMatrix);
+    frameStats.cullTested++;
+    if (!frustum.IntersectsSphere(glm::vec3(sphere), sphere.w)) {
+      frameStats.culled++;
+      return;
+    }
+  }
 
-  // Create model matrix for the cube
-  glm::mat4 modelMatrix = glm::mat4(1.0f);
-  modelMatrix = glm::translate(modelMatrix, position);
-  modelMatrix = glm::scale(modelMatrix, scale);
+  DrawCommand command;
+  command.kind = DrawKind::ELEMENTS;
+  command.program = shader->ID;
+  command.vao = cubeVAO->ID;
+  command.count = 36;
+  command.model = transformMatrix;
+  renderQueue.Submit(RenderQueue::MakeKey(RenderLayer::SCENE, command.program,
+                                          command.vao,
+                                          GetViewDepth(transformMatrix)),
+                     command);
+}
 
-  camera->Matrix(45.0f, 0.1f, 100.0f, *shader.get(), "camMatrix");
+glm::dvec3 OpenGLRendererWrapper::GetCameraWorldPosition() const {
+  return camera ? floatingOrigin.ToWorld(camera->Position)
+                : floatingOrigin.GetOrigin();
+}
 
-  GLuint modelLoc = glGetUniformLocation(shader->ID, "model");
-  glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(modelMatrix));
+void OpenGLRendererWrapper::SetCameraWorldPosition(const glm::dvec3 &position) {
+  floatingOrigin.Reset(position);
+  if (camera) {
+    camera->Position = floatingOrigin.ToRelative(position);
+    UpdateFrustum();
+  }
+}
 
-  // Switch to cube VAO
-  cubeVAO->Bind();
-  glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-  cubeVAO->Unbind();
+glm::mat4 OpenGLRendererWrapper::GetViewProjection() const {
+  if (!camera || camera->width <= 0 || camera->height <= 0) {
+    return glm::mat4(1.0f);
+  }
+
+  // Same matrices Camera::Matrix builds for camMatrix
+  const glm::mat4 view = glm::lookAt(
+      camera->Position, camera->Position + camera->Orientation, camera->Up);
+  const glm::mat4 projection = glm::perspective(
+      glm::radians(CAMERA_FOV),
+      static_cast<float>(camera->width) / static_cast<float>(camera->height),
+      CAMERA_NEAR, CAMERA_FAR);
+  return projection * view;
 }
 
-void OpenGLRendererWrapper::RenderCube(const glm::mat4 &transformMatrix) {
+void OpenGLRendererWrapper::UpdateFrustum() {
+  if (!camera || camera->width <= 0 || camera->height <= 0) {
+    return;
+  }
+  frustum.SetFromMatrix(GetViewProjection());
+}
+
+void OpenGLRendererWrapper::RenderGpuParticles(GpuParticleSystem &particles) {
+  // Immediate: the buffers are already on the GPU, there is nothing for the
+  // queue to sort or batch. Queued draws are flushed later and depth-tested
+  // against these.
+  const glm::mat4 toRelative =
+      glm::translate(glm::mat4(1.0f), floatingOrigin.ToRelative(glm::dvec3(0.0)));
+  particles.Render(GetViewProjection() * toRelative);
+  frameStats.drawCalls++;
+  frameStats.instancedDrawCalls++;
+  frameStats.instances += particles.GetCount();
+}
+
+glm::vec4 OpenGLRendererWrapper::GetCubeBoundingSphere(
+    const glm::mat4 &transformMatrix) {
+  // The unit cube's half diagonal, stretched by the largest axis scale
+  const glm::vec3 axisX(transformMatrix[0]);
+  const glm::vec3 axisY(transformMatrix[1]);
+  const glm::vec3 axisZ(transformMatrix[2]);
+  const float scaleSq = std::max({glm::dot(axisX, axisX), glm::dot(axisY, axisY),
+                                  glm::dot(axisZ, axisZ)});
+  return glm::vec4(glm::vec3(transformMatrix[3]),
+                   0.8660254f * std::sqrt(scaleSq));
+}
+
+float OpenGLRendererWrapper::GetViewDepth(
+    const glm::mat4 &transformMatrix) const {
+  if (!camera) {
+    return 0.0f;
+  }
+  // Squared distance sorts the same as distance
+  const glm::vec3 offset = glm::vec3(transformMatrix[3]) - camera->Position;
+  return glm::dot(offset, offset);
+}
+
+void OpenGLRendererWrapper::BindInstanceAttributes(size_t offset) {
+  // The offset moves every draw and the buffer may be reallocated, so the
+  // pointers are set per draw instead of once in CreateCube
+  const GLsizei stride = sizeof(InstanceData);
+  glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer.GetID());
+  for (GLuint column = 0; column < 4; ++column) {
+    glVertexAttribPointer(
+        2 + column, 4, GL_FLOAT, GL_FALSE, stride,
+        (void *)(offset + offsetof(InstanceData, transform) +
+                 column * sizeof(glm::vec4)));
+  }
+  glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, stride,
+                        (void *)(offset + offsetof(InstanceData, color)));
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void OpenGLRendererWrapper::ReserveInstances(size_t count) {
+  if (instancedShader) {
+    instanceBuffer.Reserve(count);
+  }
+  stagedInstances.reserve(count);
+  cullSpheres.reserve(count);
+  cullVisible.reserve(count);
+}
+
+void OpenGLRendererWrapper::SubmitInstances(RenderPrimitive primitive,
+                                            const glm::mat4 *transforms,
+                                            const glm::vec3 *colors,
+                                            size_t count) {
+  if (count == 0) {
+    return;
+  }
   if (!cubeVAO) {
     CreateCube();
   }
 
-  shader->Activate();
-  camera->Matrix(45.0f, 0.1f, 100.0f, *shader.get(), "camMatrix");
+  if (!instancedShader) {
+    for (size_t i = 0; i < count; ++i) {
+      RenderCube(transforms[i]);
+    }
+    return;
+  }
 
-  GLuint modelLoc = glGetUniformLocation(shader->ID, "model");
-  glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(transformMatrix));
+  // Cubes are the only instanced primitive so far
+  (void)primitive;
+
+  // Only instances that survive culling are staged
+  const size_t first = stagedInstances.size();
+  size_t visibleCount = count;
+  if (frustumCullingEnabled) {
+    cullSpheres.resize(count);
+    cullVisible.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+      cullSpheres[i] = GetCubeBoundingSphere(transforms[i]);
+    }
+    visibleCount =
+        frustum.CullSpheres(cullSpheres.data(), count, cullVisible.data());
+    frameStats.cullTested += count;
+    frameStats.culled += count - visibleCount;
+    if (visibleCount == 0) {
+      return;
+    }
+  }
 
-  cubeVAO->Bind();
-  glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-  cubeVAO->Unbind();
+  stagedInstances.resize(first + visibleCount);
+  for (size_t i = 0; i < visibleCount; ++i) {
+    const size_t source = frustumCullingEnabled ? cullVisible[i] : i;
+    InstanceData &instance = stagedInstances[first + i];
+    instance.transform = transforms[source];
+    instance.color = colors ? glm::vec4(colors[source], 1.0f)
+                            : glm::vec4(1.0f, 1.0f, 1.0f, 0.0f);
+  }
+
+  // One command for the whole batch, it isn't depth sorted
+  DrawCommand command;
+  command.kind = DrawKind::ELEMENTS_INSTANCED;
+  command.program = instancedShader->ID;
+  command.vao = instancedCubeVAO->ID;
+  command.count = 36;
+  command.instanceCount = static_cast<GLsizei>(visibleCount);
+  command.firstInstance = first;
+  renderQueue.Submit(RenderQueue::MakeKey(RenderLayer::SCENE, command.program,
+                                          command.vao, 0.0f),
+                     command);
+}
+
+Shader &OpenGLRendererWrapper::GetShaderForProgram(GLuint program) {
+  if (instancedShader && instancedShader->ID == program) {
+    return *instancedShader.get();
+  }
+  return *shader.get();
+}
+
+void OpenGLRendererWrapper::FlushRenderQueue() {
+  if (renderQueue.IsEmpty()) {
+    return;
+  }
+  PROFILE_SCOPE("FlushRenderQueue");
+  PROFILE_GPU_SCOPE("Scene pass");
+
+  size_t instanceBase = 0;
+  if (!stagedInstances.empty()) {
+    instanceBase =
+        instanceBuffer.Write(stagedInstances.data(), stagedInstances.size());
+  }
+
+  renderQueue.Sort();
+  frameStats.commands += renderQueue.Size();
+
+  // ImGui and framebuffer passes bind their own state in between flushes
+  stateCache.Invalidate();
+  cameraPrograms.clear();
+
+  renderQueue.ForEach([&](const DrawCommand &command) {
+    stateCache.UseProgram(command.program);
+    if (std::find(cameraPrograms.begin(), cameraPrograms.end(),
+                  command.program) == cameraPrograms.end()) {
+      // Uniform values stick to the program, once per flush is enough
+      camera->Matrix(CAMERA_FOV, CAMERA_NEAR, CAMERA_FAR,
+                     GetShaderForProgram(command.program), "camMatrix");
+      cameraPrograms.push_back(command.program);
+    }
+    stateCache.BindVertexArray(command.vao);
+
+    switch (command.kind) {
+    case DrawKind::ELEMENTS:
+      glUniformMatrix4fv(stateCache.GetUniformLocation(command.program, "model"),
+                         1, GL_FALSE, glm::value_ptr(command.model));
+      glDrawElements(command.mode, command.count, GL_UNSIGNED_INT, 0);
+      break;
+    case DrawKind::ARRAYS:
+      glUniformMatrix4fv(stateCache.GetUniformLocation(command.program, "model"),
+                         1, GL_FALSE, glm::value_ptr(command.model));
+      glDrawArrays(command.mode, 0, command.count);
+      break;
+    case DrawKind::ELEMENTS_INSTANCED:
+      BindInstanceAttributes(instanceBase +
+                             command.firstInstance * sizeof(InstanceData));
+      glDrawElementsInstanced(command.mode, command.count, GL_UNSIGNED_INT, 0,
+                              command.instanceCount);
+      frameStats.instancedDrawCalls++;
+      frameStats.instances += command.instanceCount;
+      break;
+    }
+    frameStats.drawCalls++;
+  });
+
+  stateCache.BindVertexArray(0);
+  renderQueue.Clear();
+  stagedInstances.clear();
 }
 
 void OpenGLRendererWrapper::CreateFloor() {
@@ -516,26 +831,36 @@ void OpenGLRendererWrapper::RenderFloor(float size, int gridLines) {
     CreateFloor();
   }
 
-  shader->Activate();
-  camera->Matrix(45.0f, 0.1f, 100.0f, *shader.get(), "camMatrix");
-
-  glm::mat4 modelMatrix = glm::mat4(1.0f);
-  GLuint modelLoc = glGetUniformLocation(shader->ID, "model");
-  glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(modelMatrix));
-
-  floorVAO->Bind();
-  glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-  floorVAO->Unbind();
-
-  gridVAO->Bind();
-  glDrawArrays(
-      GL_LINES, 0,
-      (gridLines + 1) *
-          4); // 2 points per line, (gridLines+1) lines in each direction
-  gridVAO->Unbind();
+  // The floor stays at the world origin while the floating origin moves
+  const glm::mat4 model = glm::translate(
+      glm::mat4(1.0f), floatingOrigin.ToRelative(glm::dvec3(0.0)));
+
+  DrawCommand floor;
+  floor.kind = DrawKind::ELEMENTS;
+  floor.program = shader->ID;
+  floor.vao = floorVAO->ID;
+  floor.count = 6;
+  floor.model = model;
+  renderQueue.Submit(RenderQueue::MakeKey(RenderLayer::FLOOR, floor.program,
+                                          floor.vao, 0.0f),
+                     floor);
+
+  // 2 points per line, (gridLines+1) lines in each direction
+  DrawCommand grid;
+  grid.kind = DrawKind::ARRAYS;
+  grid.mode = GL_LINES;
+  grid.program = shader->ID;
+  grid.vao = gridVAO->ID;
+  grid.count = (gridLines + 1) * 4;
+  grid.model = model;
+  renderQueue.Submit(RenderQueue::MakeKey(RenderLayer::GRID, grid.program,
+                                          grid.vao, 0.0f),
+                     grid);
 }
 
 void OpenGLRendererWrapper::BeginViewportRender() {
+  // Draws recorded so far belong to the main framebuffer
+  FlushRenderQueue();
   isRenderingToViewport = true;
   viewportFramebuffer->Bind();
   glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
@@ -543,6 +868,7 @@ void OpenGLRendererWrapper::BeginViewportRender() {
 }
 
 void OpenGLRendererWrapper::EndViewportRender() {
+  FlushRenderQueue();
   viewportFramebuffer->Unbind();
   isRenderingToViewport = false;
   // Restore main window viewport
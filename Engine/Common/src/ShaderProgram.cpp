@@ -0,0 +1,534 @@
+#include "../include/ShaderProgram.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace Engine {
+namespace Common {
+
+namespace {
+
+std::string DirectoryOf(const std::string &path) {
+  const size_t slash = path.find_last_of("/\\");
+  return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+}
+
+// Returns the quoted file name if line is an #include directive
+bool ParseInclude(const std::string &line, std::string &name) {
+  const size_t start = line.find_first_not_of(" \t");
+  if (start == std::string::npos || line.compare(start, 8, "#include") != 0) {
+    return false;
+  }
+  const size_t open = line.find('"', start + 8);
+  const size_t close =
+      open == std::string::npos ? open : line.find('"', open + 1);
+  if (close == std::string::npos) {
+    return false;
+  }
+  name = line.substr(open + 1, close - open - 1);
+  return true;
+}
+
+bool IsVersionLine(const std::string &line) {
+  const size_t start = line.find_first_not_of(" \t");
+  return start != std::string::npos && line.compare(start, 8, "#version") == 0;
+}
+
+std::string binaryCacheDirectory;
+
+constexpr char BINARY_MAGIC[4] = {'S', 'P', 'B', 'N'};
+constexpr uint32_t BINARY_VERSION = 1;
+
+struct BinaryHeader {
+  char magic[4];
+  uint32_t version;
+  uint64_t key;
+  uint32_t format; // GLenum from glGetProgramBinary
+  uint32_t length;
+};
+
+uint64_t HashBytes(uint64_t hash, const char *data, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+uint64_t HashString(uint64_t hash, const char *text) {
+  // Strings are hashed with their terminator so fields cannot run together
+  return text ? HashBytes(hash, text, std::strlen(text) + 1) : hash;
+}
+
+// FNV-1a over the driver identity and both expanded sources
+uint64_t ProgramKey(const std::string &vertexSource,
+                    const std::string &fragmentSource) {
+  uint64_t hash = 14695981039346656037ull;
+  for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION,
+                      GL_SHADING_LANGUAGE_VERSION}) {
+    hash = HashString(hash, reinterpret_cast<const char *>(glGetString(name)));
+  }
+  hash = HashString(hash, vertexSource.c_str());
+  return HashString(hash, fragmentSource.c_str());
+}
+
+// Lets the driver compile on its own threads; true once enabled
+bool ParallelCompileAvailable() {
+#ifdef GL_KHR_parallel_shader_compile
+  static const bool available = [] {
+    if (!GLEW_KHR_parallel_shader_compile) {
+      return false;
+    }
+    glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+    return true;
+  }();
+  return available;
+#else
+  return false;
+#endif
+}
+
+} // namespace
+
+bool ShaderProgram::LoadSource(const std::string &path, std::string &source,
+                               std::vector<std::string> &files,
+                               std::string &error) {
+  source.clear();
+  files.clear();
+  std::vector<std::string> stack;
+  return ExpandFile(path, source, files, stack, error);
+}
+
+bool ShaderProgram::ExpandFile(const std::string &path, std::string &source,
+                               std::vector<std::string> &files,
+                               std::vector<std::string> &stack,
+                               std::string &error) {
+  if (std::find(stack.begin(), stack.end(), path) != stack.end()) {
+    error = "include cycle through " + path;
+    return false;
+  }
+
+  std::ifstream file(path);
+  if (!file) {
+    error = "cannot open " + path;
+    return false;
+  }
+
+  const int fileIndex = static_cast<int>(files.size());
+  files.push_back(path);
+  stack.push_back(path);
+
+  // The root file's #version has to stay first, included files start with
+  // their own #line
+  if (fileIndex > 0) {
+    source += "#line 1 " + std::to_string(fileIndex) + "\n";
+  }
+
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(file, line)) {
+    lineNumber++;
+
+    std::string includeName;
+    if (ParseInclude(line, includeName)) {
+      if (!ExpandFile(DirectoryOf(path) + includeName, source, files, stack,
+                      error)) {
+        error += " (included from " + path + ":" +
+                 std::to_string(lineNumber) + ")";
+        return false;
+      }
+      source += "#line " + std::to_string(lineNumber + 1) + " " +
+                std::to_string(fileIndex) + "\n";
+      continue;
+    }
+
+    source += line;
+    source += '\n';
+    if (IsVersionLine(line) && fileIndex == 0) {
+      source += "#line " + std::to_string(lineNumber + 1) + " 0\n";
+    }
+  }
+
+  stack.pop_back();
+  return true;
+}
+
+GLuint ShaderProgram::Compile(GLenum type, const std::string &source) {
+  GLuint shader = glCreateShader(type);
+  const char *text = source.c_str();
+  glShaderSource(shader, 1, &text, nullptr);
+  glCompileShader(shader);
+  return shader;
+}
+
+bool ShaderProgram::CheckCompiled(GLuint shader, const std::string &path,
+                                  const std::vector<std::string> &files) {
+  GLint compiled = GL_FALSE;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+  if (compiled == GL_TRUE) {
+    return true;
+  }
+
+  GLint length = 0;
+  glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+  std::string log(std::max(length, 1), '\0');
+  glGetShaderInfoLog(shader, length, nullptr, &log[0]);
+
+  std::cerr << "ShaderProgram: failed to compile " << path << "\n" << log;
+  // Messages name files by index, e.g. "0(12)"
+  for (size_t i = 0; i < files.size(); ++i) {
+    std::cerr << "  source " << i << ": " << files[i] << "\n";
+  }
+  std::cerr << std::flush;
+  return false;
+}
+
+bool ShaderProgram::CheckLinked(GLuint program, const std::string &name) {
+  GLint linked = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  if (linked == GL_TRUE) {
+    return true;
+  }
+
+  GLint length = 0;
+  glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+  std::string log(std::max(length, 1), '\0');
+  glGetProgramInfoLog(program, length, nullptr, &log[0]);
+  std::cerr << "ShaderProgram: failed to link " << name << "\n"
+            << log << std::endl;
+  return false;
+}
+
+bool ShaderProgram::LoadFromFiles(const std::string &vertexPath,
+                                  const std::string &fragmentPath) {
+  return BeginLoad(vertexPath, fragmentPath) && Finish();
+}
+
+bool ShaderProgram::LoadComputeFromFile(const std::string &computePath) {
+  std::string source, error;
+  std::vector<std::string> files;
+  if (!LoadSource(computePath, source, files, error)) {
+    std::cerr << "ShaderProgram: " << error << std::endl;
+    return false;
+  }
+
+  const GLuint shader = Compile(GL_COMPUTE_SHADER, source);
+  if (!CheckCompiled(shader, computePath, files)) {
+    glDeleteShader(shader);
+    return false;
+  }
+
+  const GLuint program = glCreateProgram();
+  glAttachShader(program, shader);
+  glLinkProgram(program);
+  glDeleteShader(shader);
+  if (!CheckLinked(program, computePath)) {
+    glDeleteProgram(program);
+    return false;
+  }
+
+  // Not a vertex/fragment pair, so nothing for ReloadIfChanged to watch
+  CancelPending();
+  vertexPath.clear();
+  fragmentPath.clear();
+  watched.clear();
+  if (id) {
+    glDeleteProgram(id);
+  }
+  id = program;
+  uniforms.clear();
+  return true;
+}
+
+bool ShaderProgram::BeginLoad(const std::string &vertexPath,
+                              const std::string &fragmentPath) {
+  CancelPending();
+  this->vertexPath = vertexPath;
+  this->fragmentPath = fragmentPath;
+
+  Build build;
+  std::string vertexSource, fragmentSource, error;
+  if (!LoadSource(vertexPath, vertexSource, build.vertexFiles, error) ||
+      !LoadSource(fragmentPath, fragmentSource, build.fragmentFiles, error)) {
+    std::cerr << "ShaderProgram: " << error << std::endl;
+    return false;
+  }
+  watched.clear();
+  WatchFiles(build.vertexFiles);
+  WatchFiles(build.fragmentFiles);
+
+  build.key = ProgramKey(vertexSource, fragmentSource);
+  build.program = LoadBinary(build.key);
+  if (build.program) {
+    build.fromBinary = true;
+  } else {
+    ParallelCompileAvailable(); // Hands compiles to driver threads
+    build.vertex = Compile(GL_VERTEX_SHADER, vertexSource);
+    build.fragment = Compile(GL_FRAGMENT_SHADER, fragmentSource);
+
+    // Status queries would wait for the driver, so errors are checked once
+    // the link reports completion
+    build.program = glCreateProgram();
+    glAttachShader(build.program, build.vertex);
+    glAttachShader(build.program, build.fragment);
+    if (BinaryCacheAvailable()) {
+      glProgramParameteri(build.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                          GL_TRUE);
+    }
+    glLinkProgram(build.program);
+  }
+
+  pending = std::move(build);
+  isPending = true;
+  return true;
+}
+
+bool ShaderProgram::Poll() {
+  if (!isPending) {
+    return false;
+  }
+#ifdef GL_KHR_parallel_shader_compile
+  if (!pending.fromBinary && ParallelCompileAvailable()) {
+    GLint done = GL_FALSE;
+    glGetProgramiv(pending.program, GL_COMPLETION_STATUS_KHR, &done);
+    if (done != GL_TRUE) {
+      return false;
+    }
+  }
+#endif
+  return FinishPending();
+}
+
+bool ShaderProgram::Finish() { return isPending && FinishPending(); }
+
+bool ShaderProgram::FinishPending() {
+  Build build = std::move(pending);
+  pending = Build();
+  isPending = false;
+
+  bool ok = true;
+  if (!build.fromBinary) {
+    ok = CheckCompiled(build.vertex, vertexPath, build.vertexFiles) &&
+         CheckCompiled(build.fragment, fragmentPath, build.fragmentFiles);
+    glDeleteShader(build.vertex);
+    glDeleteShader(build.fragment);
+  }
+
+  if (ok) {
+    ok = CheckLinked(build.program, vertexPath + " + " + fragmentPath);
+  }
+
+  if (!ok) {
+    glDeleteProgram(build.program);
+    return false;
+  }
+
+  if (!build.fromBinary) {
+    SaveBinary(build.program, build.key);
+  }
+  if (id) {
+    glDeleteProgram(id);
+  }
+  id = build.program;
+  uniforms.clear();
+  return true;
+}
+
+void ShaderProgram::CancelPending() {
+  if (!isPending) {
+    return;
+  }
+  if (pending.vertex)
+    glDeleteShader(pending.vertex);
+  if (pending.fragment)
+    glDeleteShader(pending.fragment);
+  glDeleteProgram(pending.program);
+  pending = Build();
+  isPending = false;
+}
+
+bool ShaderProgram::ReloadIfChanged() {
+  if (isPending) {
+    return Poll();
+  }
+  if (vertexPath.empty() || !FilesChanged()) {
+    return false;
+  }
+
+  // Taken now, so a file that fails to load is not retried until it is
+  // saved again
+  for (WatchedFile &file : watched) {
+    std::error_code error;
+    const auto time = std::filesystem::last_write_time(file.path, error);
+    if (!error) {
+      file.time = time;
+    }
+  }
+
+  std::cout << "ShaderProgram: reloading " << vertexPath << " + "
+            << fragmentPath << std::endl;
+  return BeginLoad(vertexPath, fragmentPath) && Poll();
+}
+
+void ShaderProgram::WatchFiles(const std::vector<std::string> &files) {
+  for (const std::string &path : files) {
+    const bool known =
+        std::any_of(watched.begin(), watched.end(),
+                    [&path](const WatchedFile &file) { return file.path == path; });
+    if (known) {
+      continue;
+    }
+    std::error_code error;
+    watched.push_back({path, std::filesystem::last_write_time(path, error)});
+  }
+}
+
+bool ShaderProgram::FilesChanged() const {
+  for (const WatchedFile &file : watched) {
+    std::error_code error;
+    const auto time = std::filesystem::last_write_time(file.path, error);
+    // A file missing mid-save counts as unchanged until it is back
+    if (!error && time != file.time) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ShaderProgram::SetBinaryCacheDirectory(const std::string &directory) {
+  binaryCacheDirectory = directory;
+}
+
+bool ShaderProgram::BinaryCacheAvailable() {
+  if (binaryCacheDirectory.empty()) {
+    return false;
+  }
+  static const bool supported = [] {
+    if (!GLEW_ARB_get_program_binary) {
+      return false;
+    }
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+  }();
+  return supported;
+}
+
+std::string ShaderProgram::BinaryCachePath(uint64_t key) {
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.bin",
+                static_cast<unsigned long long>(key));
+  return (std::filesystem::path(binaryCacheDirectory) / name).string();
+}
+
+GLuint ShaderProgram::LoadBinary(uint64_t key) {
+  if (!BinaryCacheAvailable()) {
+    return 0;
+  }
+  std::ifstream file(BinaryCachePath(key), std::ios::binary);
+  if (!file) {
+    return 0;
+  }
+
+  BinaryHeader header;
+  if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+      std::memcmp(header.magic, BINARY_MAGIC, 4) != 0 ||
+      header.version != BINARY_VERSION || header.key != key) {
+    return 0;
+  }
+
+  // The length comes from disk, so a corrupt or truncated entry must not
+  // size the buffer. The entry is the header and exactly length bytes.
+  const std::streampos dataStart = file.tellg();
+  file.seekg(0, std::ios::end);
+  const std::streamoff remaining = file.tellg() - dataStart;
+  if (header.length == 0 || remaining != static_cast<std::streamoff>(header.length)) {
+    return 0;
+  }
+  file.seekg(dataStart);
+
+  std::vector<char> data(header.length);
+  if (!file.read(data.data(), static_cast<std::streamsize>(data.size()))) {
+    return 0;
+  }
+
+  GLuint program = glCreateProgram();
+  glProgramBinary(program, header.format, data.data(),
+                  static_cast<GLsizei>(data.size()));
+  GLint linked = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  if (linked != GL_TRUE) {
+    // Rejected by the driver (e.g. after an update); the source compile
+    // overwrites the entry
+    glDeleteProgram(program);
+    return 0;
+  }
+  return program;
+}
+
+void ShaderProgram::SaveBinary(GLuint program, uint64_t key) {
+  if (!BinaryCacheAvailable()) {
+    return;
+  }
+  GLint length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) {
+    return;
+  }
+
+  BinaryHeader header;
+  std::memcpy(header.magic, BINARY_MAGIC, 4);
+  header.version = BINARY_VERSION;
+  header.key = key;
+  std::vector<char> data(static_cast<size_t>(length));
+  GLenum format = 0;
+  glGetProgramBinary(program, length, &length, &format, data.data());
+  header.format = format;
+  header.length = static_cast<uint32_t>(length);
+
+  std::error_code error;
+  std::filesystem::create_directories(binaryCacheDirectory, error);
+
+  // Written under a temporary name so a crash never leaves a torn entry
+  const std::string path = BinaryCachePath(key);
+  const std::string temporary = path + ".tmp";
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(data.data(), length);
+    if (!file) {
+      std::cerr << "ShaderProgram: cannot write " << temporary << std::endl;
+      return;
+    }
+  }
+  std::filesystem::rename(temporary, path, error);
+  if (error) {
+    std::cerr << "ShaderProgram: cannot write " << path << ": "
+              << error.message() << std::endl;
+  }
+}
+
+void ShaderProgram::Destroy() {
+  CancelPending();
+  if (id) {
+    glDeleteProgram(id);
+    id = 0;
+  }
+  uniforms.clear();
+}
+
+GLint ShaderProgram::GetUniformLocation(const char *name) {
+  auto it = uniforms.find(name);
+  if (it != uniforms.end()) {
+    return it->second;
+  }
+  const GLint location = glGetUniformLocation(id, name);
+  uniforms.emplace(name, location);
+  return location;
+}
+
+} // namespace Common
+} // namespace Engine
@@ -0,0 +1,375 @@
+#ifndef END_BRICK_CACHE_H
+#define END_BRICK_CACHE_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "../../../renderer/include/VAO.h"
+#include "../../Common/include/ShaderProgram.h"
+
+namespace EndViewer {
+
+/**
+ * Density Brick Cache
+ *
+ * Bakes the terrain density of the chunks around the camera into a 3D
+ * texture so the ray marcher can sample it with hardware trilinear filtering
+ * instead of evaluating the noise at every step.
+ *
+ * - One brick per chunk, 16^3 voxels (one per block), R16F
+ * - The atlas is toroidal: chunk c is stored in slot c mod chunksPerAxis, so
+ *   when the camera crosses a chunk boundary only the slab of chunks that
+ *   entered the region is re-baked
+ * - A small brick table texture marks the slots that hold the right chunk;
+ *   everything else falls back to analytic evaluation in the shader
+ * - Bricks are baked by a fragment shader (one draw per texture layer), the
+ *   GL 3.3 context has no compute shaders
+ * - Each baked brick is reduced to its maximum density (one texel per slot)
+ *   so the ray marcher can jump over bricks that are entirely air
+ */
+class EndBrickCache {
+public:
+    static constexpr int BRICK_SIZE = 16;  // Voxels per brick edge (= chunk size)
+
+    struct Stats {
+        int validBricks = 0;
+        int pendingBricks = 0;
+        int bakedLastFrame = 0;
+        int regionMoves = 0;
+    };
+
+private:
+    int chunksPerAxis = 0;
+    GLuint densityTexture = 0;
+    GLuint brickTableTexture = 0;
+    GLuint brickMaxTexture = 0;
+    GLuint framebuffer = 0;
+    GLuint maxFramebuffer = 0;
+    Engine::Common::ShaderProgram bakeShader;
+    Engine::Common::ShaderProgram maxShader;
+
+    glm::ivec3 regionMin = glm::ivec3(0);
+    glm::ivec3 centerChunk = glm::ivec3(0);
+    bool hasRegion = false;
+    int bakedOctaves = -1;
+
+    std::vector<glm::ivec3> slotChunks;  // Chunk each slot is meant to hold
+    std::vector<uint8_t> slotValid;      // CPU copy of the brick table (0 or 255)
+    std::vector<int> pendingSlots;       // Farthest first, baked from the back
+    std::vector<int> bakedSlots;         // Baked this frame, waiting for the max pass
+    bool tableDirty = false;
+
+    Stats stats;
+
+public:
+    /**
+     * Create the atlas, brick table and bake shader
+     * @param chunks Cached chunks per axis (the atlas is chunks * 16 texels wide)
+     */
+    bool initialize(int chunks = 8) {
+        chunksPerAxis = std::max(2, chunks);
+        const int texels = chunksPerAxis * BRICK_SIZE;
+        const size_t slotCount = static_cast<size_t>(chunksPerAxis) * chunksPerAxis * chunksPerAxis;
+
+        if (!bakeShader.LoadFromFiles("shaders/end_bake.vert", "shaders/end_bake.frag")) {
+            std::cerr << "EndBrickCache: Failed to load bake shader" << std::endl;
+            return false;
+        }
+        if (!maxShader.LoadFromFiles("shaders/end_bake.vert", "shaders/end_brick_max.frag")) {
+            std::cerr << "EndBrickCache: Failed to load brick max shader" << std::endl;
+            bakeShader.Destroy();
+            return false;
+        }
+
+        glGenTextures(1, &densityTexture);
+        glBindTexture(GL_TEXTURE_3D, densityTexture);
+        glTexImage3D(GL_TEXTURE_3D, 0, GL_R16F, texels, texels, texels, 0, GL_RED, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_REPEAT);
+
+        slotChunks.assign(slotCount, glm::ivec3(0));
+        slotValid.assign(slotCount, 0);
+
+        glGenTextures(1, &brickTableTexture);
+        glBindTexture(GL_TEXTURE_3D, brickTableTexture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage3D(GL_TEXTURE_3D, 0, GL_R8, chunksPerAxis, chunksPerAxis, chunksPerAxis, 0,
+                     GL_RED, GL_UNSIGNED_BYTE, slotValid.data());
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        glGenTextures(1, &brickMaxTexture);
+        glBindTexture(GL_TEXTURE_3D, brickMaxTexture);
+        glTexImage3D(GL_TEXTURE_3D, 0, GL_R16F, chunksPerAxis, chunksPerAxis, chunksPerAxis, 0,
+                     GL_RED, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindTexture(GL_TEXTURE_3D, 0);
+
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, densityTexture, 0, 0);
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+
+        glGenFramebuffers(1, &maxFramebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, maxFramebuffer);
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, brickMaxTexture, 0, 0);
+        if (status == GL_FRAMEBUFFER_COMPLETE) status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "EndBrickCache: R16F layers are not renderable (status 0x"
+                      << std::hex << status << std::dec << ")" << std::endl;
+            shutdown();
+            return false;
+        }
+
+        std::cout << "EndBrickCache: " << chunksPerAxis << "^3 bricks, "
+                  << texels << "^3 voxels" << std::endl;
+        return true;
+    }
+
+    /**
+     * Release GL objects (call while the context is still current)
+     */
+    void shutdown() {
+        if (framebuffer) glDeleteFramebuffers(1, &framebuffer);
+        if (maxFramebuffer) glDeleteFramebuffers(1, &maxFramebuffer);
+        if (densityTexture) glDeleteTextures(1, &densityTexture);
+        if (brickTableTexture) glDeleteTextures(1, &brickTableTexture);
+        if (brickMaxTexture) glDeleteTextures(1, &brickMaxTexture);
+        framebuffer = maxFramebuffer = densityTexture = brickTableTexture = brickMaxTexture = 0;
+        bakeShader.Destroy();
+        maxShader.Destroy();
+        hasRegion = false;
+    }
+
+    bool isReady() const { return framebuffer != 0; }
+
+    /**
+     * Center the cache on the camera's chunk. Only does work when the chunk
+     * or the octave count changed; chunks that entered the region are queued.
+     */
+    void update(const glm::ivec3& cameraChunk, int octaves) {
+        if (!isReady()) return;
+
+        const glm::ivec3 newMin = cameraChunk - glm::ivec3(chunksPerAxis / 2);
+        const bool octavesChanged = octaves != bakedOctaves;
+        if (hasRegion && newMin == regionMin && !octavesChanged) return;
+
+        if (octavesChanged) {
+            // Every baked brick used the old noise
+            std::fill(slotValid.begin(), slotValid.end(), 0);
+            tableDirty = true;
+            bakedOctaves = octaves;
+        }
+        if (hasRegion && newMin != regionMin) {
+            stats.regionMoves++;
+        }
+
+        regionMin = newMin;
+        centerChunk = cameraChunk;
+        hasRegion = true;
+
+        for (int z = 0; z < chunksPerAxis; z++) {
+            for (int y = 0; y < chunksPerAxis; y++) {
+                for (int x = 0; x < chunksPerAxis; x++) {
+                    const glm::ivec3 chunk = regionMin + glm::ivec3(x, y, z);
+                    const int slot = slotIndex(chunk);
+                    if (slotChunks[slot] != chunk) {
+                        slotChunks[slot] = chunk;
+                        if (slotValid[slot]) {
+                            slotValid[slot] = 0;
+                            tableDirty = true;
+                        }
+                    }
+                }
+            }
+        }
+
+        // Nearest chunks are baked first
+        pendingSlots.clear();
+        for (int slot = 0; slot < static_cast<int>(slotValid.size()); slot++) {
+            if (!slotValid[slot]) pendingSlots.push_back(slot);
+        }
+        std::sort(pendingSlots.begin(), pendingSlots.end(), [this](int a, int b) {
+            return distanceSq(slotChunks[a]) > distanceSq(slotChunks[b]);
+        });
+
+        // Drop stale bricks from the table right away, before any baking
+        uploadTable();
+        updateCounts();
+    }
+
+    /**
+     * Bake up to budget pending bricks. Restores the framebuffer, viewport
+     * and depth test state it changes.
+     * @param quad Fullscreen quad (location 0 = vec2 position)
+     * @return Bricks baked
+     */
+    int bake(VAO& quad, int budget) {
+        stats.bakedLastFrame = 0;
+        if (!isReady() || pendingSlots.empty() || budget <= 0) {
+            updateCounts();
+            return 0;
+        }
+
+        GLint previousFramebuffer = 0;
+        GLint previousViewport[4];
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+        glGetIntegerv(GL_VIEWPORT, previousViewport);
+        const GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+        glDisable(GL_DEPTH_TEST);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        bakeShader.Use();
+        glUniform1i(bakeShader.GetUniformLocation("uOctaves"), bakedOctaves);
+        const GLint brickMinLoc = bakeShader.GetUniformLocation("uBrickMin");
+        const GLint viewportLoc = bakeShader.GetUniformLocation("uViewportOrigin");
+        const GLint layerLoc = bakeShader.GetUniformLocation("uLayer");
+        quad.Bind();
+
+        while (!pendingSlots.empty() && stats.bakedLastFrame < budget) {
+            const int slot = pendingSlots.back();
+            pendingSlots.pop_back();
+
+            const glm::ivec3 slotPos = slotCoords(slot);
+            const glm::ivec3 brickMin = slotChunks[slot] * BRICK_SIZE;
+            glUniform3i(brickMinLoc, brickMin.x, brickMin.y, brickMin.z);
+            glUniform2i(viewportLoc, slotPos.x * BRICK_SIZE, slotPos.y * BRICK_SIZE);
+            glViewport(slotPos.x * BRICK_SIZE, slotPos.y * BRICK_SIZE, BRICK_SIZE, BRICK_SIZE);
+
+            for (int layer = 0; layer < BRICK_SIZE; layer++) {
+                glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, densityTexture, 0,
+                                          slotPos.z * BRICK_SIZE + layer);
+                glUniform1i(layerLoc, layer);
+                glDrawArrays(GL_TRIANGLES, 0, 6);
+            }
+
+            slotValid[slot] = 255;
+            tableDirty = true;
+            bakedSlots.push_back(slot);
+            stats.bakedLastFrame++;
+        }
+
+        reduceBakedSlots();
+
+        quad.Unbind();
+        glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+        glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+        if (depthTest) glEnable(GL_DEPTH_TEST);
+
+        uploadTable();
+        updateCounts();
+        return stats.bakedLastFrame;
+    }
+
+    /**
+     * Bind the atlas, brick table and brick maxima and set the ray
+     * marcher's cache uniforms
+     * @param unit First of the three texture units to use
+     */
+    void bind(Engine::Common::ShaderProgram& program, int unit, bool enabled) {
+        const bool active = enabled && isReady() && hasRegion;
+        glUniform1i(program.GetUniformLocation("uCacheEnabled"), active ? 1 : 0);
+        if (!active) return;
+
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_3D, densityTexture);
+        glActiveTexture(GL_TEXTURE0 + unit + 1);
+        glBindTexture(GL_TEXTURE_3D, brickTableTexture);
+        glActiveTexture(GL_TEXTURE0 + unit + 2);
+        glBindTexture(GL_TEXTURE_3D, brickMaxTexture);
+        glActiveTexture(GL_TEXTURE0);
+
+        glUniform1i(program.GetUniformLocation("uDensityCache"), unit);
+        glUniform1i(program.GetUniformLocation("uBrickTable"), unit + 1);
+        glUniform1i(program.GetUniformLocation("uBrickMax"), unit + 2);
+        glUniform3i(program.GetUniformLocation("uCacheMin"), regionMin.x, regionMin.y, regionMin.z);
+        glUniform1i(program.GetUniformLocation("uCacheChunks"), chunksPerAxis);
+    }
+
+    /**
+     * Mark every brick stale, e.g. after the density function changed
+     */
+    void invalidate() {
+        bakedOctaves = -1;
+    }
+
+    const Stats& getStats() const { return stats; }
+    int getChunksPerAxis() const { return chunksPerAxis; }
+
+private:
+    int wrap(int c) const {
+        const int m = c % chunksPerAxis;
+        return m < 0 ? m + chunksPerAxis : m;
+    }
+
+    int slotIndex(const glm::ivec3& chunk) const {
+        return wrap(chunk.x) + chunksPerAxis * (wrap(chunk.y) + chunksPerAxis * wrap(chunk.z));
+    }
+
+    glm::ivec3 slotCoords(int slot) const {
+        return glm::ivec3(slot % chunksPerAxis,
+                          (slot / chunksPerAxis) % chunksPerAxis,
+                          slot / (chunksPerAxis * chunksPerAxis));
+    }
+
+    int distanceSq(const glm::ivec3& chunk) const {
+        const glm::ivec3 d = chunk - centerChunk;
+        return d.x * d.x + d.y * d.y + d.z * d.z;
+    }
+
+    /**
+     * Write the maximum density of each brick baked this frame into its
+     * slot of the brick max texture (quad and viewport state are the
+     * caller's)
+     */
+    void reduceBakedSlots() {
+        if (bakedSlots.empty()) return;
+
+        glBindFramebuffer(GL_FRAMEBUFFER, maxFramebuffer);
+        maxShader.Use();
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_3D, densityTexture);
+        glUniform1i(maxShader.GetUniformLocation("uDensityAtlas"), 0);
+        const GLint originLoc = maxShader.GetUniformLocation("uSlotOrigin");
+
+        for (int slot : bakedSlots) {
+            const glm::ivec3 slotPos = slotCoords(slot);
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, brickMaxTexture, 0, slotPos.z);
+            glViewport(slotPos.x, slotPos.y, 1, 1);
+            glUniform3i(originLoc, slotPos.x * BRICK_SIZE, slotPos.y * BRICK_SIZE, slotPos.z * BRICK_SIZE);
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+        }
+
+        glBindTexture(GL_TEXTURE_3D, 0);
+        bakedSlots.clear();
+    }
+
+    void uploadTable() {
+        if (!tableDirty) return;
+        glBindTexture(GL_TEXTURE_3D, brickTableTexture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, 0, chunksPerAxis, chunksPerAxis, chunksPerAxis,
+                        GL_RED, GL_UNSIGNED_BYTE, slotValid.data());
+        glBindTexture(GL_TEXTURE_3D, 0);
+        tableDirty = false;
+    }
+
+    void updateCounts() {
+        stats.pendingBricks = static_cast<int>(pendingSlots.size());
+        stats.validBricks = static_cast<int>(std::count(slotValid.begin(), slotValid.end(), 255));
+    }
+};
+
+} // namespace EndViewer
+
+#endif // END_BRICK_CACHE_H
@@ -1,6 +1,7 @@
 #ifndef END_CAMERA_H
 #define END_CAMERA_H
 
+#include "../../Common/include/FloatingOrigin.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -128,21 +129,10 @@ public:
     /**
      * Update chunk-relative coordinates for GPU
      * This splits the high-precision position into integer chunk + float offset
+     * (in [0, 16)), the same split the main renderer's floating origin uses
      */
     void updateChunkRelativePosition() {
-        // Calculate chunk coordinates (integer)
-        chunkOrigin = glm::ivec3(
-            static_cast<int>(std::floor(position.x / 16.0)),
-            static_cast<int>(std::floor(position.y / 16.0)),
-            static_cast<int>(std::floor(position.z / 16.0))
-        );
-        
-        // Calculate local offset within chunk (float, always in range [0, 16))
-        localOffset = glm::vec3(
-            static_cast<float>(position.x - chunkOrigin.x * 16.0),
-            static_cast<float>(position.y - chunkOrigin.y * 16.0),
-            static_cast<float>(position.z - chunkOrigin.z * 16.0)
-        );
+        Engine::Common::FloatingOrigin::Split(position, 16.0, chunkOrigin, localOffset);
     }
     
     /**
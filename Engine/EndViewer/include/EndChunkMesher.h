@@ -0,0 +1,279 @@
+#ifndef END_CHUNK_MESHER_H
+#define END_CHUNK_MESHER_H
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "EndDensity.h"
+
+namespace EndViewer {
+
+/**
+ * Vertex of a chunk mesh, packed to 12 bytes (this is also the payload
+ * format of EndRegionCache, so cached meshes upload without conversion)
+ *
+ * The position is relative to the chunk's corner so it stays small anywhere
+ * in the world, stored in 1/2048 lattice cell steps offset by one cell (the
+ * lattice starts at -1); a cell is one block at LOD 0. The step is a power
+ * of two and the chunk size a multiple of it, so a border vertex lands on
+ * exactly the same world position in both chunks. The normal is snorm8.
+ */
+struct EndChunkVertex {
+    static constexpr int POSITION_STEPS = 2048;  // Per lattice cell
+    static constexpr int POSITION_BIAS = 1;      // Cells
+
+    uint16_t position[3];
+    uint16_t padding;
+    int8_t normal[4];
+
+    /**
+     * @param cell Lattice cell (-1..15 on each axis)
+     * @param fraction Position inside the cell, 0..1
+     */
+    static EndChunkVertex pack(const glm::ivec3& cell, const glm::dvec3& fraction,
+                               const glm::dvec3& normal) {
+        EndChunkVertex vertex{};
+        for (int i = 0; i < 3; i++) {
+            // Fraction quantized on its own, so border vertices match across chunks
+            const long steps = std::lround(std::clamp(fraction[i], 0.0, 1.0) * POSITION_STEPS);
+            vertex.position[i] = static_cast<uint16_t>((cell[i] + POSITION_BIAS) * POSITION_STEPS + steps);
+            vertex.normal[i] = static_cast<int8_t>(std::lround(std::clamp(normal[i], -1.0, 1.0) * 127.0));
+        }
+        return vertex;
+    }
+
+    glm::vec3 getPosition() const {
+        return glm::vec3(position[0], position[1], position[2]) / static_cast<float>(POSITION_STEPS) -
+               static_cast<float>(POSITION_BIAS);
+    }
+
+    glm::vec3 getNormal() const {
+        return glm::vec3(normal[0], normal[1], normal[2]) / 127.0f;
+    }
+};
+
+static_assert(sizeof(EndChunkVertex) == 12, "EndChunkVertex must stay packed");
+
+struct EndChunkMesh {
+    std::vector<EndChunkVertex> vertices;
+    std::vector<uint16_t> indices;  // Triangles
+
+    bool empty() const { return indices.empty(); }
+    size_t vertexBytes() const { return vertices.size() * sizeof(EndChunkVertex); }
+    size_t indexBytes() const { return indices.size() * sizeof(uint16_t); }
+};
+
+/**
+ * Surface Nets Chunk Mesher
+ *
+ * Meshes one chunk of EndDensity (positive = solid) on the CPU. Safe to
+ * call from worker threads.
+ *
+ * - A chunk of LOD level L spans 16 lattice cells of 2^L blocks, so every
+ *   level costs the same per chunk; vertex positions are in lattice units
+ * - Density is sampled at lattice points -1 to 16 on each axis (18^3
+ *   points, one EndDensity::sampleBatch call)
+ * - Every cell with a sign change gets one vertex at the mean of its edge
+ *   crossings, with the normal from the cell's density gradient
+ * - A chunk emits the quads of the lattice edges that start inside it, so
+ *   neighboring chunks share their border vertices exactly and the surface
+ *   is watertight without stitching
+ */
+class EndChunkMesher {
+public:
+    static constexpr int CHUNK_SIZE = 16;
+    static constexpr int SAMPLES = CHUNK_SIZE + 2;  // Lattice points -1..16
+    static constexpr int CELLS = CHUNK_SIZE + 1;    // Cells -1..15
+
+    // Vertical chunk range that can hold terrain (main island tops out near
+    // y = 114, outer islands stay within y 40..88), at level 0
+    static constexpr int MIN_CHUNK_Y = 0;
+    static constexpr int MAX_CHUNK_Y = 7;
+    static constexpr int MAX_LOD = 4;  // 256-block chunks
+
+    /**
+     * Width of a chunk of the given LOD level, in blocks
+     */
+    static int chunkBlocks(int lod) { return CHUNK_SIZE << lod; }
+
+    /**
+     * Highest chunk y of a level that can hold terrain (the terrain's
+     * height range in coarser chunks)
+     */
+    static int maxChunkY(int lod) {
+        return std::max(0, ((MAX_CHUNK_Y + 1) >> lod) - 1);
+    }
+
+    /**
+     * Cheap test before meshing: false when the chunk lies outside the
+     * terrain's height range or entirely inside the exclusion ring
+     */
+    static bool mayContainTerrain(const glm::ivec3& chunk, int lod = 0) {
+        if (chunk.y < MIN_CHUNK_Y || chunk.y > maxChunkY(lod)) return false;
+
+        // Horizontal extent of the sampled lattice (one cell of margin)
+        const double size = chunkBlocks(lod), cell = static_cast<double>(1 << lod);
+        const double minX = chunk.x * size - cell, maxX = chunk.x * size + size;
+        const double minZ = chunk.z * size - cell, maxZ = chunk.z * size + size;
+        const double nearX = std::max({minX, 0.0, -maxX});
+        const double nearZ = std::max({minZ, 0.0, -maxZ});
+        const double farX = std::max(std::abs(minX), std::abs(maxX));
+        const double farZ = std::max(std::abs(minZ), std::abs(maxZ));
+        const double nearest = std::sqrt(nearX * nearX + nearZ * nearZ);
+        const double farthest = std::sqrt(farX * farX + farZ * farZ);
+
+        return !(nearest >= EndDensity::EXCLUSION_ZONE_START &&
+                 farthest < EndDensity::EXCLUSION_ZONE_END);
+    }
+
+    /**
+     * Mesh one chunk into mesh (cleared first); leaves it empty when the
+     * chunk holds no surface
+     * @param chunk Chunk coordinates in chunks of the LOD level
+     */
+    static void build(const EndDensity& density, const glm::ivec3& chunk, EndChunkMesh& mesh, int lod = 0) {
+        mesh.vertices.clear();
+        mesh.indices.clear();
+        if (!mayContainTerrain(chunk, lod)) return;
+
+        // Sample the lattice, x fastest
+        constexpr int pointCount = SAMPLES * SAMPLES * SAMPLES;
+        std::vector<double> xs(pointCount), ys(pointCount), zs(pointCount), values(pointCount);
+        const double cell = static_cast<double>(1 << lod);
+        const glm::dvec3 corner = glm::dvec3(chunk) * static_cast<double>(chunkBlocks(lod)) - cell;
+        int p = 0;
+        for (int z = 0; z < SAMPLES; z++) {
+            for (int y = 0; y < SAMPLES; y++) {
+                for (int x = 0; x < SAMPLES; x++, p++) {
+                    xs[p] = corner.x + x * cell;
+                    ys[p] = corner.y + y * cell;
+                    zs[p] = corner.z + z * cell;
+                }
+            }
+        }
+        density.sampleBatch(xs.data(), ys.data(), zs.data(), values.data(), pointCount);
+
+        // Most chunks are all air (or all solid): nothing to mesh
+        bool anySolid = false, anyAir = false;
+        for (double v : values) {
+            (v > 0.0 ? anySolid : anyAir) = true;
+            if (anySolid && anyAir) break;
+        }
+        if (!anySolid || !anyAir) return;
+
+        Mesher mesher(values, mesh);
+        mesher.run();
+    }
+
+private:
+    /**
+     * Per-chunk working state of build()
+     */
+    class Mesher {
+        const std::vector<double>& densities;
+        EndChunkMesh& mesh;
+        std::vector<int32_t> cellVertex;  // Vertex index per cell, -1 = not created
+
+    public:
+        Mesher(const std::vector<double>& values, EndChunkMesh& output)
+            : densities(values), mesh(output), cellVertex(CELLS * CELLS * CELLS, -1) {}
+
+        void run() {
+            // Lattice edges starting at p in [0, 16)^3, along each axis
+            for (int axis = 0; axis < 3; axis++) {
+                const int b = (axis + 1) % 3;
+                const int c = (axis + 2) % 3;
+                glm::ivec3 step(0);
+                step[axis] = 1;
+
+                for (int z = 0; z < CHUNK_SIZE; z++) {
+                    for (int y = 0; y < CHUNK_SIZE; y++) {
+                        for (int x = 0; x < CHUNK_SIZE; x++) {
+                            const glm::ivec3 p(x, y, z);
+                            const bool solid0 = sample(p) > 0.0;
+                            const bool solid1 = sample(p + step) > 0.0;
+                            if (solid0 == solid1) continue;
+
+                            // The four cells around the edge, counter-clockwise seen from +axis
+                            glm::ivec3 q0 = p, q1 = p, q3 = p;
+                            q0[b] -= 1; q0[c] -= 1;
+                            q1[c] -= 1;
+                            q3[b] -= 1;
+                            const int v0 = vertexFor(q0), v1 = vertexFor(q1);
+                            const int v2 = vertexFor(p), v3 = vertexFor(q3);
+
+                            // Faces point from solid to air
+                            if (solid0) {
+                                emitQuad(v0, v1, v2, v3);
+                            } else {
+                                emitQuad(v0, v3, v2, v1);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+    private:
+        // Density at lattice point p (local lattice coordinates, -1..16)
+        double sample(const glm::ivec3& p) const {
+            return densities[((p.z + 1) * SAMPLES + (p.y + 1)) * SAMPLES + (p.x + 1)];
+        }
+
+        int vertexFor(const glm::ivec3& cell) {
+            int32_t& index = cellVertex[((cell.z + 1) * CELLS + (cell.y + 1)) * CELLS + (cell.x + 1)];
+            if (index >= 0) return index;
+
+            double d[8];
+            for (int i = 0; i < 8; i++) {
+                d[i] = sample(cell + glm::ivec3(i & 1, (i >> 1) & 1, (i >> 2) & 1));
+            }
+
+            // Mean of the edge crossings
+            static const int EDGES[12][2] = {
+                {0, 1}, {2, 3}, {4, 5}, {6, 7},  // x
+                {0, 2}, {1, 3}, {4, 6}, {5, 7},  // y
+                {0, 4}, {1, 5}, {2, 6}, {3, 7}   // z
+            };
+            glm::dvec3 sum(0.0);
+            int crossings = 0;
+            for (const auto& edge : EDGES) {
+                const double a = d[edge[0]], bValue = d[edge[1]];
+                if ((a > 0.0) == (bValue > 0.0)) continue;
+                const double t = a / (a - bValue);
+                const glm::dvec3 ca(edge[0] & 1, (edge[0] >> 1) & 1, (edge[0] >> 2) & 1);
+                const glm::dvec3 cb(edge[1] & 1, (edge[1] >> 1) & 1, (edge[1] >> 2) & 1);
+                sum += ca + (cb - ca) * t;
+                crossings++;
+            }
+            const glm::dvec3 fraction = sum / static_cast<double>(std::max(crossings, 1));
+
+            // Density grows into the solid, so the outward normal is -gradient
+            const glm::dvec3 gradient(
+                (d[1] + d[3] + d[5] + d[7]) - (d[0] + d[2] + d[4] + d[6]),
+                (d[2] + d[3] + d[6] + d[7]) - (d[0] + d[1] + d[4] + d[5]),
+                (d[4] + d[5] + d[6] + d[7]) - (d[0] + d[1] + d[2] + d[3]));
+            const double length = glm::length(gradient);
+            const glm::dvec3 normal = length > 0.0 ? -gradient / length : glm::dvec3(0.0, 1.0, 0.0);
+
+            index = static_cast<int32_t>(mesh.vertices.size());
+            mesh.vertices.push_back(EndChunkVertex::pack(cell, fraction, normal));
+            return index;
+        }
+
+        void emitQuad(int a, int b, int c, int d) {
+            const uint16_t quad[6] = {
+                static_cast<uint16_t>(a), static_cast<uint16_t>(b), static_cast<uint16_t>(c),
+                static_cast<uint16_t>(a), static_cast<uint16_t>(c), static_cast<uint16_t>(d)
+            };
+            mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+        }
+    };
+};
+
+} // namespace EndViewer
+
+#endif // END_CHUNK_MESHER_H
@@ -0,0 +1,812 @@
+#ifndef END_CHUNK_STREAMER_H
+#define END_CHUNK_STREAMER_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../Common/include/Frustum.h"
+#include "../../Common/include/JobSystem.h"
+#include "../../Common/include/ShaderProgram.h"
+#include "EndCamera.h"
+#include "EndChunkMesher.h"
+#include "EndIslandImpostors.h"
+#include "EndRegionCache.h"
+
+namespace EndViewer {
+
+/**
+ * Chunk Mesh Streamer
+ *
+ * Alternative to ray marching: chunk meshes of the CPU density around the
+ * camera, built by EndChunkMesher on the job system.
+ *
+ * - Nested LOD levels: level L has chunks of 16 * 2^L blocks and covers a
+ *   horizontal radius of levelRadius[L] of its chunks, so each level reaches
+ *   twice as far as the one inside it at the same cost per chunk. Chunks
+ *   are requested when the camera changes chunk and released once they are
+ *   well outside their level's ring.
+ * - Neighboring levels overlap by a band of two fine chunks, where a
+ *   dithered crossfade hands over from one to the other. A level keeps
+ *   drawing without its fade while the level that should take over is
+ *   still loading there, so the handover never opens holes.
+ * - Each level has a triangle budget: every BUDGET_INTERVAL frames a level
+ *   over budget gives up a ring of chunks to the coarser level, and one well
+ *   under budget grows back towards the requested radius
+ * - Levels from ISLAND_LEVELS on only mesh the main island: outer islands
+ *   are too small for their lattice and are drawn by EndIslandImpostors
+ *   past the last island level instead
+ * - Requests wait in a priority queue ordered by distance in chunks of
+ *   their level (so coarse coverage arrives early), with chunks outside the
+ *   view frustum pushed back; it is re-sorted when the camera moves to
+ *   another chunk or turns
+ * - Finished meshes are copied into a ring of staging buffers (mapped
+ *   unsynchronized, guarded by fences) and from there into per-chunk buffers
+ *   on the GPU. A staging buffer still in use skips the upload for a frame
+ *   instead of waiting, so the render thread never blocks.
+ * - Vertices are relative to their chunk and each chunk is drawn with its
+ *   offset from the camera's chunkOrigin, so precision does not degrade far
+ *   from the world origin
+ * - With a disk cache, chunks are looked up in EndRegionCache first: empty
+ *   ones are settled without a job, meshed ones are copied from the mapped
+ *   region file into the staging buffer. Mesh jobs store what they build.
+ */
+class EndChunkStreamer {
+public:
+    static constexpr int STAGING_BUFFER_COUNT = 3;
+    static constexpr size_t STAGING_BUFFER_BYTES = 4u << 20;
+    static constexpr int LOD_LEVELS = EndChunkMesher::MAX_LOD + 1;
+    static constexpr int ISLAND_LEVELS = 2;       // Levels that mesh outer islands
+    static constexpr int MIN_LEVEL_RADIUS = 6;    // Chunks; keeps the fade bands apart
+    static constexpr int BUDGET_INTERVAL = 30;    // Frames between radius adjustments
+
+    struct Stats {
+        int residentChunks = 0;     // Requested and not released
+        int meshedChunks = 0;       // With geometry on the GPU
+        int pendingChunks = 0;      // Waiting for a worker
+        int inFlightJobs = 0;
+        int drawnChunks = 0;
+        int culledChunks = 0;
+        size_t trianglesDrawn = 0;
+        size_t gpuBytes = 0;
+        size_t uploadedBytesLastFrame = 0;
+        int stagingStalls = 0;      // Frames that skipped uploading (staging buffer busy)
+        int cachedChunks = 0;       // Settled from the disk cache instead of a mesh job
+        int impostors = 0;
+
+        // Per LOD level
+        int levelRadius[LOD_LEVELS] = {};          // Current ring radius, in chunks of the level
+        int levelChunks[LOD_LEVELS] = {};          // With geometry on the GPU
+        int levelLoading[LOD_LEVELS] = {};         // Queued or meshing
+        size_t levelTriangles[LOD_LEVELS] = {};    // Resident (what the budget limits)
+    };
+
+private:
+    struct ChunkEntry {
+        enum class State { QUEUED, MESHING, EMPTY, READY };
+        State state = State::QUEUED;
+        glm::ivec3 chunk = glm::ivec3(0);  // In chunks of the level
+        int level = 0;
+        uint32_t generation = 0;
+        GLuint vao = 0, vbo = 0, ebo = 0;
+        GLsizei indexCount = 0;
+        size_t bytes = 0;
+    };
+
+    struct PendingChunk {
+        float priority;
+        glm::ivec3 chunk;
+        int level;
+        bool operator>(const PendingChunk& other) const { return priority > other.priority; }
+    };
+
+    struct MeshResult {
+        glm::ivec3 chunk;
+        int level;
+        uint32_t generation;
+        EndChunkMesh mesh;
+        bool cached = false;  // Mesh is read from the disk cache at upload
+    };
+
+    // Written by mesh jobs, drained on the render thread
+    struct CompletedQueue {
+        std::mutex mutex;
+        std::vector<MeshResult> results;
+    };
+
+    struct StagingBuffer {
+        GLuint buffer = 0;
+        GLsync fence = nullptr;
+    };
+
+    const EndDensity* density = nullptr;
+    Engine::Common::ShaderProgram meshShader;
+    std::shared_ptr<EndRegionCache> diskCache;  // Null without a cache directory
+    EndIslandImpostors impostors;
+
+    std::unordered_map<int64_t, ChunkEntry> chunks;
+    std::priority_queue<PendingChunk, std::vector<PendingChunk>, std::greater<PendingChunk>> pending;
+    std::shared_ptr<CompletedQueue> completed;
+    std::vector<Engine::Common::JobHandle> inFlight;
+    std::deque<MeshResult> uploadQueue;
+
+    StagingBuffer staging[STAGING_BUFFER_COUNT];
+    int stagingIndex = 0;
+
+    glm::ivec3 centerChunk = glm::ivec3(0);
+    bool hasCenter = false;
+    int viewRadius = 0;
+    int levelRadius[LOD_LEVELS] = {};
+    size_t residentTriangles[LOD_LEVELS] = {};
+    int framesSinceBudget = 0;
+    bool drawImpostors = false;
+    glm::vec3 queueViewDirection = glm::vec3(0.0f);
+    uint32_t nextGeneration = 1;
+
+    Stats stats;
+
+public:
+    /**
+     * Load the mesh shader and create the staging ring
+     * @param cpuDensity Density to mesh; must outlive shutdown()
+     * @param cacheDirectory Root of the on-disk mesh cache, empty for none
+     */
+    bool initialize(const EndDensity* cpuDensity, const std::string& cacheDirectory = std::string()) {
+        density = cpuDensity;
+        if (!meshShader.LoadFromFiles("shaders/end_mesh.vert", "shaders/end_mesh.frag")) {
+            std::cerr << "EndChunkStreamer: Failed to load mesh shader" << std::endl;
+            return false;
+        }
+
+        for (StagingBuffer& buffer : staging) {
+            glGenBuffers(1, &buffer.buffer);
+            glBindBuffer(GL_COPY_READ_BUFFER, buffer.buffer);
+            glBufferData(GL_COPY_READ_BUFFER, STAGING_BUFFER_BYTES, nullptr, GL_STREAM_DRAW);
+        }
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+        completed = std::make_shared<CompletedQueue>();
+        if (!impostors.initialize(density)) {
+            std::cerr << "EndChunkStreamer: Impostors unavailable, far outer islands not drawn" << std::endl;
+        }
+        if (!cacheDirectory.empty()) {
+            diskCache = std::make_shared<EndRegionCache>();
+            if (!diskCache->open(cacheDirectory, density->getSeed(), density->versionHash())) {
+                diskCache.reset();
+            }
+        }
+        std::cout << "EndChunkStreamer: " << STAGING_BUFFER_COUNT << " x "
+                  << (STAGING_BUFFER_BYTES >> 20) << " MiB staging buffers" << std::endl;
+        return true;
+    }
+
+    /**
+     * Wait for running mesh jobs and release GL objects (call while the
+     * context is still current)
+     */
+    void shutdown() {
+        Engine::Common::JobSystem::Get().Wait(inFlight);
+        inFlight.clear();
+
+        for (auto& item : chunks) {
+            releaseBuffers(item.second);
+        }
+        chunks.clear();
+        pending = {};
+        uploadQueue.clear();
+        if (completed) completed->results.clear();
+
+        for (StagingBuffer& buffer : staging) {
+            if (buffer.fence) glDeleteSync(buffer.fence);
+            if (buffer.buffer) glDeleteBuffers(1, &buffer.buffer);
+            buffer = StagingBuffer();
+        }
+        meshShader.Destroy();
+        impostors.shutdown();
+        if (diskCache) diskCache->close();
+        diskCache.reset();
+        hasCenter = false;
+    }
+
+    bool isReady() const { return meshShader.IsValid() && staging[0].buffer != 0; }
+
+    /**
+     * Hot reload: look for edited shader files when checkFiles is set and
+     * install reloads that finished compiling
+     */
+    void reloadChangedShaders(bool checkFiles) {
+        if (checkFiles || meshShader.IsPending()) meshShader.ReloadIfChanged();
+        impostors.reloadChangedShaders(checkFiles);
+    }
+
+    /**
+     * Request and release chunks around the camera, start mesh jobs and
+     * upload finished meshes (at most one staging buffer per frame)
+     * @param radius Horizontal radius of every level, in chunks of the level
+     * @param triangleBudget Resident triangles per level
+     * @param impostorBudget Maximum island impostors, 0 to draw none
+     */
+    void update(const EndCamera& camera, int radius, size_t triangleBudget, int impostorBudget) {
+        if (!isReady()) return;
+        stats.uploadedBytesLastFrame = 0;
+
+        collectFinished();
+
+        radius = std::max(radius, MIN_LEVEL_RADIUS);
+        bool radiiChanged = false;
+        if (radius != viewRadius) {
+            viewRadius = radius;
+            for (int& levelRange : levelRadius) levelRange = radius;
+            radiiChanged = true;
+        } else if (++framesSinceBudget >= BUDGET_INTERVAL) {
+            framesSinceBudget = 0;
+            radiiChanged = applyBudget(triangleBudget);
+        }
+
+        const glm::vec3 viewDirection = glm::vec3(camera.orientation);
+        if (!hasCenter || camera.chunkOrigin != centerChunk || radiiChanged) {
+            centerChunk = camera.chunkOrigin;
+            hasCenter = true;
+            refreshRegion();
+            rebuildQueue(camera);
+        } else if (glm::dot(viewDirection, queueViewDirection) < 0.9f) {
+            rebuildQueue(camera);
+        }
+
+        dispatch();
+        upload();
+
+        drawImpostors = impostorBudget > 0;
+        if (drawImpostors) {
+            impostors.update(camera, fadeOutBand(ISLAND_LEVELS - 1).x, impostorBudget);
+        }
+
+        stats.pendingChunks = static_cast<int>(pending.size());
+        stats.inFlightJobs = static_cast<int>(inFlight.size());
+        stats.residentChunks = static_cast<int>(chunks.size());
+        stats.impostors = drawImpostors ? impostors.getStats().islands : 0;
+        updateLevelStats();
+    }
+
+    /**
+     * Draw the resident meshes into the bound framebuffer with depth testing
+     */
+    void draw(const EndCamera& camera, const glm::vec3& endStoneColor,
+              const glm::vec3& fogColor, float fogDensity, bool wireframe) {
+        stats.drawnChunks = stats.culledChunks = 0;
+        stats.trianglesDrawn = 0;
+        if (!isReady()) return;
+
+        const glm::mat4 viewProj = camera.getProjectionMatrix() * camera.getViewMatrix();
+        Engine::Common::Frustum frustum;
+        frustum.SetFromMatrix(viewProj);
+
+        meshShader.Use();
+        glUniformMatrix4fv(meshShader.GetUniformLocation("uViewProj"), 1, GL_FALSE, glm::value_ptr(viewProj));
+        glUniform3fv(meshShader.GetUniformLocation("uCameraPos"), 1, glm::value_ptr(camera.localOffset));
+        glUniform3iv(meshShader.GetUniformLocation("uChunkOrigin"), 1, glm::value_ptr(camera.chunkOrigin));
+        glUniform3fv(meshShader.GetUniformLocation("uEndStoneColor"), 1, glm::value_ptr(endStoneColor));
+        glUniform3fv(meshShader.GetUniformLocation("uFogColor"), 1, glm::value_ptr(fogColor));
+        glUniform1f(meshShader.GetUniformLocation("uFogDensity"), fogDensity);
+        const GLint offsetLocation = meshShader.GetUniformLocation("uChunkOffset");
+        const GLint cellSizeLocation = meshShader.GetUniformLocation("uCellSize");
+        const GLint fadeInLocation = meshShader.GetUniformLocation("uFadeIn");
+        const GLint fadeOutLocation = meshShader.GetUniformLocation("uFadeOut");
+
+        const GLboolean cullFace = glIsEnabled(GL_CULL_FACE);
+        glEnable(GL_CULL_FACE);
+        glEnable(GL_DEPTH_TEST);
+        if (wireframe) glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+
+        for (const auto& item : chunks) {
+            const ChunkEntry& entry = item.second;
+            if (entry.state != ChunkEntry::State::READY) continue;
+
+            // Integer difference first: exact at any distance from the origin
+            const int size = EndChunkMesher::chunkBlocks(entry.level);
+            const glm::vec3 offset = glm::vec3(entry.chunk * size - camera.chunkOrigin * 16);
+            const float halfSize = size * 0.5f;
+            if (!frustum.IntersectsSphere(offset + glm::vec3(halfSize), halfSize * 1.7321f)) {
+                stats.culledChunks++;
+                continue;
+            }
+
+            // Fade only where the neighboring level is there to take over
+            const glm::vec2 fadeIn = childrenSettled(entry) ? fadeInBand(entry.level) : glm::vec2(0.0f);
+            const glm::vec2 fadeOut = parentSettled(entry) ? fadeOutBand(entry.level) : glm::vec2(0.0f);
+
+            glUniform3fv(offsetLocation, 1, glm::value_ptr(offset));
+            glUniform1f(cellSizeLocation, static_cast<float>(1 << entry.level));
+            glUniform2fv(fadeInLocation, 1, glm::value_ptr(fadeIn));
+            glUniform2fv(fadeOutLocation, 1, glm::value_ptr(fadeOut));
+            glBindVertexArray(entry.vao);
+            glDrawElements(GL_TRIANGLES, entry.indexCount, GL_UNSIGNED_SHORT, nullptr);
+            stats.drawnChunks++;
+            stats.trianglesDrawn += static_cast<size_t>(entry.indexCount / 3);
+        }
+        glBindVertexArray(0);
+
+        if (drawImpostors) {
+            impostors.draw(camera, viewProj, endStoneColor, fogColor, fogDensity,
+                           fadeOutBand(ISLAND_LEVELS - 1));
+        }
+
+        if (wireframe) glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        if (!cullFace) glDisable(GL_CULL_FACE);
+    }
+
+    /**
+     * Drop every chunk and load it again (from the disk cache if it has
+     * the chunk)
+     */
+    void invalidate() {
+        for (auto& item : chunks) {
+            releaseBuffers(item.second);
+        }
+        chunks.clear();
+        pending = {};
+        uploadQueue.clear();
+        hasCenter = false;
+    }
+
+    const Stats& getStats() const { return stats; }
+
+    bool hasDiskCache() const { return diskCache != nullptr; }
+    EndRegionCache::Stats getCacheStats() const {
+        return diskCache ? diskCache->getStats() : EndRegionCache::Stats();
+    }
+    const EndIslandImpostors::Stats& getImpostorStats() const { return impostors.getStats(); }
+
+private:
+    static int64_t chunkKey(const glm::ivec3& chunk, int level) {
+        // 24 bits for x and z, 13 for y, 3 for the level
+        return (static_cast<int64_t>(chunk.x & 0xFFFFFF) << 40) |
+               (static_cast<int64_t>(chunk.z & 0xFFFFFF) << 16) |
+               (static_cast<int64_t>(chunk.y & 0x1FFF) << 3) |
+               static_cast<int64_t>(level & 0x7);
+    }
+
+    static int floorHalf(int value) {
+        return value >= 0 ? value / 2 : (value - 1) / 2;
+    }
+
+    /**
+     * Nearest and farthest horizontal distance from point to a chunk's
+     * columns (blocks)
+     */
+    static glm::dvec2 horizontalRange(const glm::ivec3& chunk, int level, const glm::dvec2& point) {
+        const double size = EndChunkMesher::chunkBlocks(level);
+        const double minX = chunk.x * size - point.x, maxX = minX + size;
+        const double minZ = chunk.z * size - point.y, maxZ = minZ + size;
+        const double nearX = std::max({minX, 0.0, -maxX});
+        const double nearZ = std::max({minZ, 0.0, -maxZ});
+        const double farX = std::max(std::abs(minX), std::abs(maxX));
+        const double farZ = std::max(std::abs(minZ), std::abs(maxZ));
+        return glm::dvec2(std::sqrt(nearX * nearX + nearZ * nearZ), std::sqrt(farX * farX + farZ * farZ));
+    }
+
+    double outerRadius(int level) const {
+        return static_cast<double>(levelRadius[level]) * EndChunkMesher::chunkBlocks(level);
+    }
+
+    /**
+     * Band (start, end distance in blocks) where a level hands over to the
+     * next coarser one; (0, 0) for the last level
+     */
+    glm::vec2 fadeOutBand(int level) const {
+        if (level >= LOD_LEVELS - 1) return glm::vec2(0.0f);
+        const double outer = outerRadius(level);
+        return glm::vec2(static_cast<float>(outer - 2.0 * EndChunkMesher::chunkBlocks(level)),
+                         static_cast<float>(outer));
+    }
+
+    glm::vec2 fadeInBand(int level) const {
+        return level > 0 ? fadeOutBand(level - 1) : glm::vec2(0.0f);
+    }
+
+    /**
+     * Whether a level's ring (with margin in blocks around it) reaches the
+     * chunk, seen from the center of the camera's chunk
+     */
+    bool inRing(const glm::ivec3& chunk, int level, double margin) const {
+        const glm::dvec2 anchor(centerChunk.x * 16.0 + 8.0, centerChunk.z * 16.0 + 8.0);
+        const glm::dvec2 range = horizontalRange(chunk, level, anchor);
+        if (range.x > outerRadius(level) + margin) return false;
+        return level == 0 || range.y >= fadeInBand(level).x - margin;
+    }
+
+    /**
+     * Whether a chunk is meshed at all: terrain can be there, and coarse
+     * levels leave the outer islands to the impostors
+     */
+    static bool meshesChunk(const glm::ivec3& chunk, int level) {
+        if (!EndChunkMesher::mayContainTerrain(chunk, level)) return false;
+        return level < ISLAND_LEVELS ||
+               horizontalRange(chunk, level, glm::dvec2(0.0)).x < EndDensity::EXCLUSION_ZONE_START;
+    }
+
+    /**
+     * Release chunks well outside their level's ring and request the new
+     * ones. The margin covers the camera's offset inside its chunk.
+     */
+    void refreshRegion() {
+        constexpr double margin = 16.0;
+        for (auto it = chunks.begin(); it != chunks.end();) {
+            if (!inRing(it->second.chunk, it->second.level, margin * 2.0)) {
+                releaseBuffers(it->second);
+                it = chunks.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        for (int level = 0; level < LOD_LEVELS; level++) {
+            const double size = EndChunkMesher::chunkBlocks(level);
+            const double reach = outerRadius(level) + margin;
+            const double anchorX = centerChunk.x * 16.0 + 8.0, anchorZ = centerChunk.z * 16.0 + 8.0;
+            const int minX = static_cast<int>(std::floor((anchorX - reach) / size));
+            const int maxX = static_cast<int>(std::floor((anchorX + reach) / size));
+            const int minZ = static_cast<int>(std::floor((anchorZ - reach) / size));
+            const int maxZ = static_cast<int>(std::floor((anchorZ + reach) / size));
+
+            for (int z = minZ; z <= maxZ; z++) {
+                for (int x = minX; x <= maxX; x++) {
+                    for (int y = EndChunkMesher::MIN_CHUNK_Y; y <= EndChunkMesher::maxChunkY(level); y++) {
+                        const glm::ivec3 chunk(x, y, z);
+                        if (!inRing(chunk, level, margin)) continue;
+                        auto inserted = chunks.emplace(chunkKey(chunk, level), ChunkEntry());
+                        if (!inserted.second) continue;
+
+                        ChunkEntry& entry = inserted.first->second;
+                        entry.chunk = chunk;
+                        entry.level = level;
+                        entry.generation = nextGeneration++;
+                        entry.state = meshesChunk(chunk, level) ? ChunkEntry::State::QUEUED
+                                                                : ChunkEntry::State::EMPTY;
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Shrink levels over their triangle budget and grow those well under
+     * it; true if a radius changed
+     */
+    bool applyBudget(size_t triangleBudget) {
+        bool changed = false;
+        for (int level = 0; level < LOD_LEVELS; level++) {
+            int& radius = levelRadius[level];
+            if (residentTriangles[level] > triangleBudget && radius > MIN_LEVEL_RADIUS) {
+                radius--;
+                changed = true;
+            } else if (residentTriangles[level] < triangleBudget * 6 / 10 && radius < viewRadius &&
+                       stats.levelLoading[level] == 0) {
+                radius++;
+                changed = true;
+            }
+        }
+
+        // Each level's fade-in band must stay outside the previous level's
+        for (int level = 1; level < LOD_LEVELS; level++) {
+            const int minimum = (levelRadius[level - 1] + 4) / 2 + 1;
+            if (levelRadius[level] < minimum) {
+                levelRadius[level] = minimum;
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    bool isSettled(const glm::ivec3& chunk, int level) const {
+        auto it = chunks.find(chunkKey(chunk, level));
+        return it == chunks.end() || it->second.state == ChunkEntry::State::EMPTY ||
+               it->second.state == ChunkEntry::State::READY;
+    }
+
+    /**
+     * The finer level is done wherever it is requested inside this chunk
+     */
+    bool childrenSettled(const ChunkEntry& entry) const {
+        if (entry.level == 0) return true;
+        const int childLevel = entry.level - 1;
+        for (int i = 0; i < 8; i++) {
+            const glm::ivec3 child = entry.chunk * 2 + glm::ivec3(i & 1, (i >> 1) & 1, (i >> 2) & 1);
+            if (child.y > EndChunkMesher::maxChunkY(childLevel)) continue;
+            if (!isSettled(child, childLevel)) return false;
+        }
+        return true;
+    }
+
+    /**
+     * The coarser level (or the impostors, past the island levels) is done
+     * around this chunk
+     */
+    bool parentSettled(const ChunkEntry& entry) const {
+        if (entry.level >= LOD_LEVELS - 1) return true;
+        const glm::ivec3 parent(floorHalf(entry.chunk.x), floorHalf(entry.chunk.y), floorHalf(entry.chunk.z));
+        return isSettled(parent, entry.level + 1);
+    }
+
+    void updateLevelStats() {
+        for (int level = 0; level < LOD_LEVELS; level++) {
+            stats.levelRadius[level] = levelRadius[level];
+            stats.levelChunks[level] = stats.levelLoading[level] = 0;
+            stats.levelTriangles[level] = residentTriangles[level];
+        }
+        for (const auto& item : chunks) {
+            const ChunkEntry& entry = item.second;
+            if (entry.state == ChunkEntry::State::READY) {
+                stats.levelChunks[entry.level]++;
+            } else if (entry.state == ChunkEntry::State::QUEUED || entry.state == ChunkEntry::State::MESHING) {
+                stats.levelLoading[entry.level]++;
+            }
+        }
+    }
+
+    /**
+     * Re-sort the queued chunks for the current camera
+     */
+    void rebuildQueue(const EndCamera& camera) {
+        queueViewDirection = glm::vec3(camera.orientation);
+        Engine::Common::Frustum frustum;
+        frustum.SetFromMatrix(camera.getProjectionMatrix() * camera.getViewMatrix());
+
+        std::vector<PendingChunk> queued;
+        for (const auto& item : chunks) {
+            const ChunkEntry& entry = item.second;
+            if (entry.state != ChunkEntry::State::QUEUED) continue;
+
+            const int size = EndChunkMesher::chunkBlocks(entry.level);
+            const float halfSize = size * 0.5f;
+            const glm::vec3 center = glm::vec3(entry.chunk * size - centerChunk * 16) + glm::vec3(halfSize);
+            const glm::vec3 toChunk = (center - camera.localOffset) / static_cast<float>(size);
+            float priority = glm::dot(toChunk, toChunk);
+            if (!frustum.IntersectsSphere(center, halfSize * 1.7321f)) {
+                priority *= 4.0f;  // Behind the camera: after visible chunks twice as far away
+            }
+            queued.push_back({priority, entry.chunk, entry.level});
+        }
+        pending = decltype(pending)(std::greater<PendingChunk>(), std::move(queued));
+    }
+
+    /**
+     * Settle the closest queued chunks from the disk cache and start mesh
+     * jobs for the rest
+     */
+    void dispatch() {
+        Engine::Common::JobSystem& jobs = Engine::Common::JobSystem::Get();
+        const size_t maxInFlight = std::max<size_t>(2, jobs.GetThreadCount() * 2);
+
+        while (inFlight.size() < maxInFlight && !pending.empty()) {
+            const glm::ivec3 chunk = pending.top().chunk;
+            const int level = pending.top().level;
+            pending.pop();
+
+            auto it = chunks.find(chunkKey(chunk, level));
+            if (it == chunks.end() || it->second.state != ChunkEntry::State::QUEUED) continue;
+            ChunkEntry& entry = it->second;
+
+            if (diskCache) {
+                const EndRegionCache::Status status = diskCache->lookup(chunk, level).status;
+                if (status == EndRegionCache::Status::EMPTY) {
+                    entry.state = ChunkEntry::State::EMPTY;
+                    stats.cachedChunks++;
+                    continue;
+                }
+                if (status == EndRegionCache::Status::MESH) {
+                    entry.state = ChunkEntry::State::MESHING;
+                    uploadQueue.push_back({chunk, level, entry.generation, EndChunkMesh(), true});
+                    continue;
+                }
+            }
+            startMeshJob(entry);
+        }
+    }
+
+    /**
+     * Mesh a chunk on the job system; the job also stores the result in
+     * the disk cache
+     */
+    void startMeshJob(ChunkEntry& entry) {
+        entry.state = ChunkEntry::State::MESHING;
+
+        const EndDensity* source = density;
+        std::shared_ptr<CompletedQueue> output = completed;
+        std::shared_ptr<EndRegionCache> cache = diskCache;
+        const glm::ivec3 chunk = entry.chunk;
+        const int level = entry.level;
+        const uint32_t generation = entry.generation;
+        inFlight.push_back(Engine::Common::JobSystem::Get().Schedule([source, output, cache, chunk, level, generation]() {
+            MeshResult result{chunk, level, generation, EndChunkMesh()};
+            EndChunkMesher::build(*source, chunk, result.mesh, level);
+            if (cache) cache->store(chunk, level, result.mesh);
+            std::lock_guard<std::mutex> lock(output->mutex);
+            output->results.push_back(std::move(result));
+        }));
+    }
+
+    /**
+     * Move finished meshes to the upload queue and forget finished jobs
+     */
+    void collectFinished() {
+        inFlight.erase(std::remove_if(inFlight.begin(), inFlight.end(),
+                                      [](const Engine::Common::JobHandle& job) { return job.IsDone(); }),
+                       inFlight.end());
+
+        std::vector<MeshResult> results;
+        {
+            std::lock_guard<std::mutex> lock(completed->mutex);
+            results.swap(completed->results);
+        }
+        for (MeshResult& result : results) {
+            uploadQueue.push_back(std::move(result));
+        }
+    }
+
+    /**
+     * Copy queued meshes through the next staging buffer into their chunks'
+     * GPU buffers. Skips the frame if that staging buffer is still being read.
+     */
+    void upload() {
+        if (uploadQueue.empty()) return;
+
+        StagingBuffer& buffer = staging[stagingIndex];
+        if (buffer.fence) {
+            const GLenum status = glClientWaitSync(buffer.fence, 0, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+                stats.stagingStalls++;
+                return;
+            }
+            glDeleteSync(buffer.fence);
+            buffer.fence = nullptr;
+        }
+
+        struct Copy {
+            ChunkEntry* entry;
+            size_t vertexOffset, vertexBytes;
+            size_t indexOffset, indexBytes;
+            GLsizei indexCount;
+        };
+        std::vector<Copy> copies;
+
+        glBindBuffer(GL_COPY_READ_BUFFER, buffer.buffer);
+        char* mapped = static_cast<char*>(glMapBufferRange(
+            GL_COPY_READ_BUFFER, 0, STAGING_BUFFER_BYTES,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+        if (!mapped) {
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+            return;
+        }
+
+        size_t offset = 0;
+        while (!uploadQueue.empty()) {
+            MeshResult& result = uploadQueue.front();
+            auto it = chunks.find(chunkKey(result.chunk, result.level));
+            if (it == chunks.end() || it->second.generation != result.generation) {
+                uploadQueue.pop_front();  // Released while meshing
+                continue;
+            }
+
+            ChunkEntry& entry = it->second;
+            const void* vertexData = result.mesh.vertices.data();
+            const void* indexData = result.mesh.indices.data();
+            size_t vertexBytes = result.mesh.vertexBytes();
+            size_t indexBytes = result.mesh.indexBytes();
+            if (result.cached) {
+                // Straight from the mapped region file
+                const EndRegionCache::CachedMesh cached = diskCache->read(result.chunk, result.level);
+                if (cached.status != EndRegionCache::Status::MESH) {
+                    startMeshJob(entry);  // Lost since dispatch (I/O error)
+                    uploadQueue.pop_front();
+                    continue;
+                }
+                vertexData = cached.vertices;
+                indexData = cached.indices;
+                vertexBytes = cached.vertexBytes();
+                indexBytes = cached.indexBytes();
+            }
+            if (indexBytes == 0) {
+                entry.state = ChunkEntry::State::EMPTY;
+                uploadQueue.pop_front();
+                continue;
+            }
+
+            const size_t indexOffset = alignUp(offset + vertexBytes);
+            const size_t end = alignUp(indexOffset + indexBytes);
+            if (end > STAGING_BUFFER_BYTES) {
+                if (offset == 0) {
+                    // Larger than a whole staging buffer: cannot happen for a
+                    // 16^3 chunk, but never let the queue get stuck
+                    std::cerr << "EndChunkStreamer: Chunk mesh exceeds staging size, dropped" << std::endl;
+                    entry.state = ChunkEntry::State::EMPTY;
+                    uploadQueue.pop_front();
+                    continue;
+                }
+                break;  // Next frame
+            }
+
+            std::memcpy(mapped + offset, vertexData, vertexBytes);
+            std::memcpy(mapped + indexOffset, indexData, indexBytes);
+            copies.push_back({&entry, offset, vertexBytes, indexOffset, indexBytes,
+                              static_cast<GLsizei>(indexBytes / sizeof(uint16_t))});
+            if (result.cached) stats.cachedChunks++;
+            offset = end;
+            uploadQueue.pop_front();
+        }
+        glUnmapBuffer(GL_COPY_READ_BUFFER);
+
+        for (const Copy& copy : copies) {
+            ChunkEntry& entry = *copy.entry;
+            releaseBuffers(entry);
+
+            glGenVertexArrays(1, &entry.vao);
+            glGenBuffers(1, &entry.vbo);
+            glGenBuffers(1, &entry.ebo);
+            glBindVertexArray(entry.vao);
+
+            glBindBuffer(GL_ARRAY_BUFFER, entry.vbo);
+            glBufferData(GL_ARRAY_BUFFER, copy.vertexBytes, nullptr, GL_STATIC_DRAW);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_ARRAY_BUFFER, copy.vertexOffset, 0, copy.vertexBytes);
+            glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_FALSE, sizeof(EndChunkVertex),
+                                  reinterpret_cast<void*>(offsetof(EndChunkVertex, position)));
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(1, 3, GL_BYTE, GL_TRUE, sizeof(EndChunkVertex),
+                                  reinterpret_cast<void*>(offsetof(EndChunkVertex, normal)));
+            glEnableVertexAttribArray(1);
+
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, entry.ebo);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, copy.indexBytes, nullptr, GL_STATIC_DRAW);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_ELEMENT_ARRAY_BUFFER, copy.indexOffset, 0, copy.indexBytes);
+
+            glBindVertexArray(0);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+            entry.indexCount = copy.indexCount;
+            entry.bytes = copy.vertexBytes + copy.indexBytes;
+            entry.state = ChunkEntry::State::READY;
+            stats.meshedChunks++;
+            stats.gpuBytes += entry.bytes;
+            residentTriangles[entry.level] += static_cast<size_t>(entry.indexCount / 3);
+        }
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+        stats.uploadedBytesLastFrame = offset;
+        buffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        stagingIndex = (stagingIndex + 1) % STAGING_BUFFER_COUNT;
+    }
+
+    static size_t alignUp(size_t bytes) {
+        return (bytes + 15) & ~static_cast<size_t>(15);
+    }
+
+    void releaseBuffers(ChunkEntry& entry) {
+        if (entry.vao) {
+            glDeleteVertexArrays(1, &entry.vao);
+            glDeleteBuffers(1, &entry.vbo);
+            glDeleteBuffers(1, &entry.ebo);
+            stats.meshedChunks--;
+            stats.gpuBytes -= entry.bytes;
+            residentTriangles[entry.level] -= static_cast<size_t>(entry.indexCount / 3);
+        }
+        entry.vao = entry.vbo = entry.ebo = 0;
+        entry.indexCount = 0;
+        entry.bytes = 0;
+    }
+};
+
+} // namespace EndViewer
+
+#endif // END_CHUNK_STREAMER_H
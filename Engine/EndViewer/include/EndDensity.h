@@ -3,7 +3,10 @@
 
 #include "SimplexNoise.h"
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <algorithm>
+#include <vector>
 
 namespace EndViewer {
 
@@ -37,13 +40,20 @@ public:
     static constexpr double DETAIL_NOISE_SCALE = 0.05;
     static constexpr double ISLAND_CHECK_SCALE = 0.5;  // Chunk-level
     
+    // Bump when the formulas change in a way the probes of versionHash()
+    // might miss
+    static constexpr uint32_t FORMULA_REVISION = 1;
+    
     /**
      * Initialize with world seed
      */
     EndDensity(int64_t seed) 
         : islandNoise(seed), 
           detailNoise(seed + 1), 
-          erosionNoise(seed + 2) {}
+          erosionNoise(seed + 2),
+          worldSeed(seed) {}
+    
+    int64_t getSeed() const { return worldSeed; }
     
     /**
      * Main density function
@@ -67,6 +77,44 @@ public:
         return outerIslandDensity(x, y, z, horizontalDist);
     }
     
+    /**
+     * Batch density: out[i] = sample(xs[i], ys[i], zs[i]), bit-identical
+     * to the scalar path
+     * 
+     * Points are sorted by region per block; the main island octaves and
+     * the (point, nearby island) noise evaluations then run across SIMD
+     * lanes, and island descriptors are shared between points of a block.
+     * The float overload widens to double.
+     */
+    void sampleBatch(const double* xs, const double* ys, const double* zs,
+                     double* out, size_t n) const {
+        BatchScratch scratch;
+        for (size_t base = 0; base < n; base += SimplexNoise::BATCH_BLOCK) {
+            const size_t count = std::min(SimplexNoise::BATCH_BLOCK, n - base);
+            sampleBlock(xs + base, ys + base, zs + base, out + base, count, scratch);
+        }
+    }
+    
+    void sampleBatch(const float* xs, const float* ys, const float* zs,
+                     float* out, size_t n) const {
+        constexpr size_t BLOCK = SimplexNoise::BATCH_BLOCK;
+        double bx[BLOCK], by[BLOCK], bz[BLOCK], result[BLOCK];
+        BatchScratch scratch;
+        
+        for (size_t base = 0; base < n; base += BLOCK) {
+            const size_t count = std::min(BLOCK, n - base);
+            for (size_t i = 0; i < count; i++) {
+                bx[i] = xs[base + i];
+                by[i] = ys[base + i];
+                bz[i] = zs[base + i];
+            }
+            sampleBlock(bx, by, bz, result, count, scratch);
+            for (size_t i = 0; i < count; i++) {
+                out[base + i] = static_cast<float>(result[i]);
+            }
+        }
+    }
+    
     /**
      * Check if a chunk should generate an outer island
      * Used for LOD and optimization
@@ -124,16 +172,73 @@ public:
         
         return info;
     }
+    
+    /**
+     * Hash identifying the terrain this density produces, for caches of
+     * derived data (EndRegionCache)
+     * 
+     * Covers the seed, the constants above and FORMULA_REVISION, plus the
+     * density at fixed probe points on the main island and at outer island
+     * centers, so editing a literal inside the formulas changes it too.
+     */
+    uint64_t versionHash() const {
+        uint64_t hash = 14695981039346656037ull;  // FNV-1a
+        auto mix = [&hash](const void* data, size_t bytes) {
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < bytes; i++) {
+                hash = (hash ^ p[i]) * 1099511628211ull;
+            }
+        };
+        
+        const double constants[] = {
+            MAIN_ISLAND_RADIUS, EXCLUSION_ZONE_START, EXCLUSION_ZONE_END, SEA_LEVEL,
+            MAIN_NOISE_SCALE, DETAIL_NOISE_SCALE, ISLAND_CHECK_SCALE
+        };
+        mix(&FORMULA_REVISION, sizeof(FORMULA_REVISION));
+        mix(&worldSeed, sizeof(worldSeed));
+        mix(constants, sizeof(constants));
+        
+        std::vector<double> xs, ys, zs;
+        auto probe = [&](double x, double y, double z) {
+            xs.push_back(x);
+            ys.push_back(y);
+            zs.push_back(z);
+        };
+        
+        // Main island: golden-angle spiral, heights through the dome
+        for (int i = 0; i < 128; i++) {
+            const double radius = 480.0 * std::sqrt((i + 0.5) / 128.0);
+            const double angle = i * 2.399963229728653;
+            probe(radius * std::cos(angle), 2.0 + (i * 37) % 112, radius * std::sin(angle));
+        }
+        
+        // Outer islands: the first ones found along a diagonal, probed
+        // around their centers (elsewhere the outer region is plain air)
+        int islands = 0;
+        for (int step = 0; step < 4096 && islands < 32; step++) {
+            const int chunkX = 70 + step, chunkZ = 70 + step / 2;
+            const IslandInfo island = getIslandInfo(chunkX, chunkZ);
+            if (!island.exists) continue;
+            islands++;
+            for (int k = 0; k < 4; k++) {
+                probe(island.centerX + island.radius * 0.3 * k, SEA_LEVEL - 6.0 + 4.0 * k,
+                      island.centerZ - island.radius * 0.2 * k);
+            }
+        }
+        
+        std::vector<double> values(xs.size());
+        sampleBatch(xs.data(), ys.data(), zs.data(), values.data(), values.size());
+        mix(values.data(), values.size() * sizeof(double));
+        return hash;
+    }
 
 private:
+    int64_t worldSeed;
+    
     /**
      * Density for the main central island
      */
     double mainIslandDensity(double x, double y, double z, double horizontalDist) const {
-        // Base shape: dome that falls off with distance
-        double heightAtDist = getMainIslandHeight(horizontalDist);
-        double baseDensity = heightAtDist - (y - SEA_LEVEL);
-        
         // Add noise for natural surface variation
         double noiseVal = islandNoise.octave3D(
             x * MAIN_NOISE_SCALE,
@@ -144,8 +249,6 @@ private:
             2.0  // lacunarity
         );
         
-        baseDensity += noiseVal * 8.0;
-        
         // Add detail noise for small-scale features
         double detailVal = detailNoise.octave3D(
             x * DETAIL_NOISE_SCALE,
@@ -156,6 +259,18 @@ private:
             2.0
         );
         
+        return combineMainIsland(y, horizontalDist, noiseVal, detailVal);
+    }
+    
+    /**
+     * Main island shape from its two noise values (shared with sampleBlock)
+     */
+    double combineMainIsland(double y, double horizontalDist, double noiseVal, double detailVal) const {
+        // Base shape: dome that falls off with distance
+        double heightAtDist = getMainIslandHeight(horizontalDist);
+        double baseDensity = heightAtDist - (y - SEA_LEVEL);
+        
+        baseDensity += noiseVal * 8.0;
         baseDensity += detailVal * 2.0;
         
         // Floor cutoff (prevent terrain below a certain Y)
@@ -222,6 +337,23 @@ private:
             return -1.0;
         }
         
+        // Add noise for organic shape
+        double noiseVal = detailNoise.octave3D(
+            x * 0.08 + island.centerX * 0.01,
+            y * 0.1,
+            z * 0.08 + island.centerZ * 0.01,
+            3,
+            0.5,
+            2.0
+        );
+        
+        return combineIsland(y, horizDist, island, noiseVal);
+    }
+    
+    /**
+     * Island shape from its noise value (shared with sampleBlock)
+     */
+    double combineIsland(double y, double horizDist, const IslandInfo& island, double noiseVal) const {
         // Vertical distance from sea level
         double dy = y - SEA_LEVEL;
         
@@ -233,16 +365,6 @@ private:
         // Base density
         double density = maxHeight - std::abs(dy);
         
-        // Add noise for organic shape
-        double noiseVal = detailNoise.octave3D(
-            x * 0.08 + island.centerX * 0.01,
-            y * 0.1,
-            z * 0.08 + island.centerZ * 0.01,
-            3,
-            0.5,
-            2.0
-        );
-        
         density += noiseVal * 4.0;
         
         // Smooth falloff at edges
@@ -252,6 +374,131 @@ private:
         return density;
     }
     
+    /**
+     * Scratch for sampleBlock, reused across the blocks of one batch
+     */
+    struct BatchScratch {
+        static constexpr int CACHE_SIZE = 64;  // Direct-mapped island descriptor cache
+        
+        struct CachedIsland {
+            int chunkX = 0, chunkZ = 0;
+            bool valid = false;
+            IslandInfo info;
+        };
+        CachedIsland islands[CACHE_SIZE];
+        
+        // Main island lanes
+        std::vector<size_t> mainIndex;
+        std::vector<double> ax, ay, az, noise, detail;
+        
+        // One lane per (point, nearby island) pair
+        std::vector<size_t> pairIndex;
+        std::vector<double> pairDist;
+        std::vector<IslandInfo> pairIsland;
+        std::vector<double> px, py, pz, pairNoise;
+        
+        const IslandInfo& island(const EndDensity& density, int chunkX, int chunkZ) {
+            const unsigned hash = (static_cast<unsigned>(chunkX) * 73856093u) ^
+                                  (static_cast<unsigned>(chunkZ) * 19349663u);
+            CachedIsland& entry = islands[hash % CACHE_SIZE];
+            if (!entry.valid || entry.chunkX != chunkX || entry.chunkZ != chunkZ) {
+                entry.chunkX = chunkX;
+                entry.chunkZ = chunkZ;
+                entry.valid = true;
+                entry.info = density.getIslandInfo(chunkX, chunkZ);
+            }
+            return entry.info;
+        }
+    };
+    
+    /**
+     * Batch path for at most BATCH_BLOCK points
+     */
+    void sampleBlock(const double* xs, const double* ys, const double* zs, double* out,
+                     size_t count, BatchScratch& scratch) const {
+        scratch.mainIndex.clear();
+        scratch.ax.clear(); scratch.ay.clear(); scratch.az.clear();
+        scratch.pairIndex.clear();
+        scratch.pairDist.clear();
+        scratch.pairIsland.clear();
+        scratch.px.clear(); scratch.py.clear(); scratch.pz.clear();
+        
+        // Classify points; outer points queue one lane per island in reach
+        for (size_t i = 0; i < count; i++) {
+            const double x = xs[i], y = ys[i], z = zs[i];
+            const double horizontalDist = std::sqrt(x * x + z * z);
+            
+            if (horizontalDist < EXCLUSION_ZONE_START) {
+                scratch.mainIndex.push_back(i);
+                scratch.ax.push_back(x * MAIN_NOISE_SCALE);
+                scratch.ay.push_back(y * MAIN_NOISE_SCALE * 2.0);
+                scratch.az.push_back(z * MAIN_NOISE_SCALE);
+                continue;
+            }
+            
+            out[i] = -1.0;
+            if (horizontalDist < EXCLUSION_ZONE_END) continue;
+            
+            const int chunkX = static_cast<int>(std::floor(x / 16.0));
+            const int chunkZ = static_cast<int>(std::floor(z / 16.0));
+            for (int dx = -1; dx <= 1; dx++) {
+                for (int dz = -1; dz <= 1; dz++) {
+                    const IslandInfo& island = scratch.island(*this, chunkX + dx, chunkZ + dz);
+                    if (!island.exists) continue;
+                    
+                    // Same reach test as sampleIsland; lanes outside it would return -1
+                    const double ix = x - island.centerX;
+                    const double iz = z - island.centerZ;
+                    const double horizDist = std::sqrt(ix * ix + iz * iz);
+                    if (horizDist > island.radius * 1.5) continue;
+                    
+                    scratch.pairIndex.push_back(i);
+                    scratch.pairDist.push_back(horizDist);
+                    scratch.pairIsland.push_back(island);
+                    scratch.px.push_back(x * 0.08 + island.centerX * 0.01);
+                    scratch.py.push_back(y * 0.1);
+                    scratch.pz.push_back(z * 0.08 + island.centerZ * 0.01);
+                }
+            }
+        }
+        
+        // Main island: both octave sums across lanes
+        const size_t mainCount = scratch.mainIndex.size();
+        if (mainCount > 0) {
+            scratch.noise.resize(mainCount);
+            scratch.detail.resize(mainCount);
+            islandNoise.octave3DBatch(scratch.ax.data(), scratch.ay.data(), scratch.az.data(),
+                                      scratch.noise.data(), mainCount, 4, 0.5, 2.0);
+            for (size_t m = 0; m < mainCount; m++) {
+                const size_t i = scratch.mainIndex[m];
+                scratch.ax[m] = xs[i] * DETAIL_NOISE_SCALE;
+                scratch.ay[m] = ys[i] * DETAIL_NOISE_SCALE;
+                scratch.az[m] = zs[i] * DETAIL_NOISE_SCALE;
+            }
+            detailNoise.octave3DBatch(scratch.ax.data(), scratch.ay.data(), scratch.az.data(),
+                                      scratch.detail.data(), mainCount, 2, 0.5, 2.0);
+            for (size_t m = 0; m < mainCount; m++) {
+                const size_t i = scratch.mainIndex[m];
+                const double horizontalDist = std::sqrt(xs[i] * xs[i] + zs[i] * zs[i]);
+                out[i] = combineMainIsland(ys[i], horizontalDist, scratch.noise[m], scratch.detail[m]);
+            }
+        }
+        
+        // Outer islands: max over each point's lanes
+        const size_t pairCount = scratch.pairIndex.size();
+        if (pairCount > 0) {
+            scratch.pairNoise.resize(pairCount);
+            detailNoise.octave3DBatch(scratch.px.data(), scratch.py.data(), scratch.pz.data(),
+                                      scratch.pairNoise.data(), pairCount, 3, 0.5, 2.0);
+            for (size_t p = 0; p < pairCount; p++) {
+                const size_t i = scratch.pairIndex[p];
+                const double islandDensity = combineIsland(ys[i], scratch.pairDist[p],
+                                                           scratch.pairIsland[p], scratch.pairNoise[p]);
+                out[i] = std::max(out[i], islandDensity);
+            }
+        }
+    }
+    
     /**
      * Smooth interpolation (hermite)
      */
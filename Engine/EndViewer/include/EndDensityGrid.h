@@ -0,0 +1,69 @@
+#ifndef END_DENSITY_GRID_H
+#define END_DENSITY_GRID_H
+
+#include <cstddef>
+#include <vector>
+
+#include "../../Common/include/JobSystem.h"
+#include "EndDensity.h"
+
+namespace EndViewer {
+
+/**
+ * Regular lattice of density samples
+ * Point (ix, iy, iz) is origin + spacing * (ix, iy, iz); storage is x-fastest.
+ */
+struct DensityGridDesc {
+    double originX = 0.0, originY = 0.0, originZ = 0.0;
+    double spacing = 1.0;
+    int sizeX = 0, sizeY = 0, sizeZ = 0;
+
+    size_t pointCount() const {
+        return static_cast<size_t>(sizeX) * sizeY * sizeZ;
+    }
+};
+
+/**
+ * Fill a lattice with EndDensity::sampleBatch on the job system
+ *
+ * Rows of x are split across workers; each job builds the coordinates of
+ * its rows and samples them in one batch. Runs inline when the job system
+ * was never started. Results are identical to sampling point by point.
+ *
+ * @param out At least grid.pointCount() floats
+ * @param rowsPerJob Rows (of sizeX points) per job
+ */
+inline void sampleDensityGrid(const EndDensity& density, const DensityGridDesc& grid,
+                              float* out, size_t rowsPerJob = 8) {
+    if (grid.sizeX <= 0 || grid.sizeY <= 0 || grid.sizeZ <= 0) return;
+
+    const size_t rowLength = static_cast<size_t>(grid.sizeX);
+    const size_t rowCount = static_cast<size_t>(grid.sizeY) * grid.sizeZ;
+
+    Engine::Common::JobSystem::Get().ParallelFor(0, rowCount, rowsPerJob,
+        [&](size_t begin, size_t end) {
+            const size_t count = (end - begin) * rowLength;
+            std::vector<double> xs(count), ys(count), zs(count), values(count);
+
+            size_t p = 0;
+            for (size_t row = begin; row < end; row++) {
+                const double y = grid.originY + grid.spacing * static_cast<double>(row % grid.sizeY);
+                const double z = grid.originZ + grid.spacing * static_cast<double>(row / grid.sizeY);
+                for (size_t ix = 0; ix < rowLength; ix++, p++) {
+                    xs[p] = grid.originX + grid.spacing * static_cast<double>(ix);
+                    ys[p] = y;
+                    zs[p] = z;
+                }
+            }
+
+            density.sampleBatch(xs.data(), ys.data(), zs.data(), values.data(), count);
+            float* dst = out + begin * rowLength;
+            for (size_t i = 0; i < count; i++) {
+                dst[i] = static_cast<float>(values[i]);
+            }
+        });
+}
+
+} // namespace EndViewer
+
+#endif // END_DENSITY_GRID_H
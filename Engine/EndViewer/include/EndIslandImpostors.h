@@ -0,0 +1,263 @@
+#ifndef END_ISLAND_IMPOSTORS_H
+#define END_ISLAND_IMPOSTORS_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../../Common/include/JobSystem.h"
+#include "../../Common/include/ShaderProgram.h"
+#include "EndCamera.h"
+#include "EndDensity.h"
+
+namespace EndViewer {
+
+/**
+ * Outer Island Impostors
+ *
+ * Far outer islands drawn as one camera-facing quad each, with the island
+ * traced as an ellipsoid (radius and height from EndDensity::getIslandInfo)
+ * in the fragment shader, which also writes its depth. Beyond the chunk
+ * levels that can resolve islands this keeps the ring visible at any scale
+ * for one instanced draw.
+ *
+ * - The instance list covers RANGE blocks around an anchor chunk and is
+ *   rebuilt on the job system when the camera moves REBUILD_DISTANCE away
+ * - Only islands past the inner radius (where meshes still show them) are
+ *   kept, the nearest first up to the budget
+ * - Positions are relative to the anchor chunk, so they stay exact in float
+ */
+class EndIslandImpostors {
+public:
+    static constexpr double RANGE = 8192.0;             // Blocks
+    static constexpr double REBUILD_DISTANCE = 512.0;   // Blocks
+
+    struct Stats {
+        int islands = 0;        // Uploaded instances
+        float buildMs = 0.0f;   // Last instance list build (worker time)
+        bool building = false;
+    };
+
+private:
+    struct Instance {
+        float x, z;             // Center relative to the anchor chunk corner
+        float radius, height;
+    };
+
+    struct BuildResult {
+        std::mutex mutex;
+        bool ready = false;
+        glm::ivec3 anchor = glm::ivec3(0);
+        std::vector<Instance> instances;
+        float milliseconds = 0.0f;
+    };
+
+    const EndDensity* density = nullptr;
+    Engine::Common::ShaderProgram shader;
+    GLuint vao = 0, cornerBuffer = 0, instanceBuffer = 0;
+
+    std::shared_ptr<BuildResult> result;
+    Engine::Common::JobHandle build;
+    bool building = false;
+
+    glm::ivec3 anchorChunk = glm::ivec3(0);   // Of the uploaded list
+    glm::ivec3 buildAnchor = glm::ivec3(0);   // Of the running build
+    double builtInnerRadius = -1.0;
+    int builtBudget = 0;
+    bool hasList = false;
+
+    Stats stats;
+
+public:
+    /**
+     * Load the impostor shader and create the quad and instance buffers
+     * @param cpuDensity Island source; must outlive shutdown()
+     */
+    bool initialize(const EndDensity* cpuDensity) {
+        density = cpuDensity;
+        if (!shader.LoadFromFiles("shaders/end_impostor.vert", "shaders/end_impostor.frag")) {
+            std::cerr << "EndIslandImpostors: Failed to load impostor shader" << std::endl;
+            return false;
+        }
+
+        const float corners[] = { -1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f };
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &cornerBuffer);
+        glGenBuffers(1, &instanceBuffer);
+        glBindVertexArray(vao);
+
+        glBindBuffer(GL_ARRAY_BUFFER, cornerBuffer);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
+        glEnableVertexAttribArray(0);
+
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), nullptr);
+        glEnableVertexAttribArray(1);
+        glVertexAttribDivisor(1, 1);
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        result = std::make_shared<BuildResult>();
+        return true;
+    }
+
+    /**
+     * Wait for a running build and release GL objects (call while the
+     * context is still current)
+     */
+    void shutdown() {
+        if (building) Engine::Common::JobSystem::Get().Wait(build);
+        building = false;
+        if (vao) glDeleteVertexArrays(1, &vao);
+        if (cornerBuffer) glDeleteBuffers(1, &cornerBuffer);
+        if (instanceBuffer) glDeleteBuffers(1, &instanceBuffer);
+        vao = cornerBuffer = instanceBuffer = 0;
+        shader.Destroy();
+        result.reset();
+        hasList = false;
+        stats = Stats();
+    }
+
+    bool isReady() const { return shader.IsValid() && vao != 0; }
+
+    /**
+     * Hot reload, see EndChunkStreamer::reloadChangedShaders
+     */
+    void reloadChangedShaders(bool checkFiles) {
+        if (checkFiles || shader.IsPending()) shader.ReloadIfChanged();
+    }
+
+    /**
+     * Upload a finished instance list and start a new build when the camera
+     * moved far enough or the inner radius / budget changed
+     * @param innerRadius Distance (blocks) inside which meshes show the islands
+     * @param budget Maximum number of impostors
+     */
+    void update(const EndCamera& camera, double innerRadius, int budget) {
+        if (!isReady()) return;
+
+        if (building && build.IsDone()) {
+            building = false;
+            std::lock_guard<std::mutex> lock(result->mutex);
+            if (result->ready) {
+                upload(*result);
+                result->ready = false;
+            }
+        }
+        stats.building = building;
+        if (building) return;
+
+        const glm::dvec2 moved = glm::dvec2(camera.chunkOrigin.x - anchorChunk.x,
+                                            camera.chunkOrigin.z - anchorChunk.z) * 16.0;
+        const bool stale = !hasList || glm::length(moved) > REBUILD_DISTANCE || budget != builtBudget ||
+                           std::abs(innerRadius - builtInnerRadius) > REBUILD_DISTANCE * 0.5;
+        // Anchored at chunk y 0, so island heights are plain world heights
+        if (stale) startBuild(glm::ivec3(camera.chunkOrigin.x, 0, camera.chunkOrigin.z), innerRadius, budget);
+    }
+
+    /**
+     * Draw the impostors into the bound framebuffer (depth tested)
+     * @param fadeIn Distance band where impostors take over from the meshes
+     */
+    void draw(const EndCamera& camera, const glm::mat4& viewProj, const glm::vec3& endStoneColor,
+              const glm::vec3& fogColor, float fogDensity, const glm::vec2& fadeIn) {
+        if (!isReady() || stats.islands == 0) return;
+
+        const glm::vec3 anchorOffset = glm::vec3((anchorChunk - camera.chunkOrigin) * 16);
+        shader.Use();
+        glUniformMatrix4fv(shader.GetUniformLocation("uViewProj"), 1, GL_FALSE, glm::value_ptr(viewProj));
+        glUniform3fv(shader.GetUniformLocation("uCameraPos"), 1, glm::value_ptr(camera.localOffset));
+        glUniform3iv(shader.GetUniformLocation("uChunkOrigin"), 1, glm::value_ptr(camera.chunkOrigin));
+        glUniform3fv(shader.GetUniformLocation("uAnchorOffset"), 1, glm::value_ptr(anchorOffset));
+        glUniform1f(shader.GetUniformLocation("uSeaLevel"), static_cast<float>(EndDensity::SEA_LEVEL));
+        glUniform3fv(shader.GetUniformLocation("uEndStoneColor"), 1, glm::value_ptr(endStoneColor));
+        glUniform3fv(shader.GetUniformLocation("uFogColor"), 1, glm::value_ptr(fogColor));
+        glUniform1f(shader.GetUniformLocation("uFogDensity"), fogDensity);
+        glUniform2fv(shader.GetUniformLocation("uFadeIn"), 1, glm::value_ptr(fadeIn));
+
+        glEnable(GL_DEPTH_TEST);
+        glBindVertexArray(vao);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, stats.islands);
+        glBindVertexArray(0);
+    }
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    void startBuild(const glm::ivec3& anchor, double innerRadius, int budget) {
+        buildAnchor = anchor;
+        builtInnerRadius = innerRadius;
+        builtBudget = budget;
+        building = true;
+
+        const EndDensity* source = density;
+        std::shared_ptr<BuildResult> output = result;
+        // The list is used until the camera moves REBUILD_DISTANCE
+        const double inner = std::max(0.0, innerRadius - REBUILD_DISTANCE);
+        build = Engine::Common::JobSystem::Get().Schedule([source, output, anchor, inner, budget]() {
+            const auto start = std::chrono::steady_clock::now();
+            std::vector<Instance> instances;
+            std::vector<float> distances;
+
+            const int range = static_cast<int>(RANGE / 16.0);
+            const double anchorX = anchor.x * 16.0, anchorZ = anchor.z * 16.0;
+            for (int dz = -range; dz <= range; dz++) {
+                for (int dx = -range; dx <= range; dx++) {
+                    const double distance = std::sqrt(static_cast<double>(dx * dx + dz * dz)) * 16.0;
+                    if (distance > RANGE || distance < inner) continue;
+
+                    const EndDensity::IslandInfo island = source->getIslandInfo(anchor.x + dx, anchor.z + dz);
+                    if (!island.exists) continue;
+                    instances.push_back({static_cast<float>(island.centerX - anchorX),
+                                         static_cast<float>(island.centerZ - anchorZ),
+                                         static_cast<float>(island.radius),
+                                         static_cast<float>(std::max(island.height, 2.0))});
+                    distances.push_back(static_cast<float>(distance));
+                }
+            }
+
+            // Nearest islands first when over budget
+            if (instances.size() > static_cast<size_t>(budget)) {
+                std::vector<size_t> order(instances.size());
+                for (size_t i = 0; i < order.size(); i++) order[i] = i;
+                std::nth_element(order.begin(), order.begin() + budget, order.end(),
+                                 [&distances](size_t a, size_t b) { return distances[a] < distances[b]; });
+                std::vector<Instance> kept(static_cast<size_t>(budget));
+                for (int i = 0; i < budget; i++) kept[i] = instances[order[i]];
+                instances.swap(kept);
+            }
+
+            std::lock_guard<std::mutex> lock(output->mutex);
+            output->anchor = anchor;
+            output->instances = std::move(instances);
+            output->milliseconds = std::chrono::duration<float, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+            output->ready = true;
+        });
+    }
+
+    void upload(const BuildResult& built) {
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        glBufferData(GL_ARRAY_BUFFER, built.instances.size() * sizeof(Instance),
+                     built.instances.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        anchorChunk = built.anchor;
+        hasList = true;
+        stats.islands = static_cast<int>(built.instances.size());
+        stats.buildMs = built.milliseconds;
+    }
+};
+
+} // namespace EndViewer
+
+#endif // END_ISLAND_IMPOSTORS_H
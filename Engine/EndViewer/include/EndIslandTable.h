@@ -0,0 +1,221 @@
+#ifndef END_ISLAND_TABLE_H
+#define END_ISLAND_TABLE_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+#include "../../../renderer/include/VAO.h"
+#include "../../Common/include/ShaderProgram.h"
+
+namespace EndViewer {
+
+/**
+ * Outer Island Table
+ *
+ * Island existence, center, radius and height depend only on the chunk
+ * column, so they are baked once into a 2D texture around the camera and
+ * the ray marcher's 3x3 neighborhood test becomes nine texel fetches
+ * instead of 27 simplex evaluations per density sample.
+ *
+ * - One RGBA32F texel per chunk column: center offset (x, z) from the
+ *   chunk corner, radius, height; radius 0 means no island. Offsets keep
+ *   the values small so they stay exact far from the origin.
+ * - Toroidal like EndBrickCache: chunk c lives in texel c mod chunksPerAxis,
+ *   so when the camera crosses a chunk boundary only the rows and columns
+ *   that entered the region are re-baked
+ * - Baked with a fragment pass (end_islands.frag) that shares computeIsland()
+ *   with the analytic path, so both give the same islands. Chunks outside
+ *   the table fall back to analytic evaluation.
+ */
+class EndIslandTable {
+public:
+    struct Stats {
+        int columnsBakedLastUpdate = 0;
+        int regionMoves = 0;
+    };
+
+private:
+    int chunksPerAxis = 0;
+    GLuint tableTexture = 0;
+    GLuint framebuffer = 0;
+    Engine::Common::ShaderProgram bakeShader;
+
+    glm::ivec2 regionMin = glm::ivec2(0);
+    bool hasRegion = false;
+
+    Stats stats;
+
+public:
+    /**
+     * Create the table texture and bake shader
+     * @param chunks Chunk columns per axis (512 covers 8192 blocks)
+     */
+    bool initialize(int chunks = 512) {
+        chunksPerAxis = std::max(4, chunks);
+
+        if (!bakeShader.LoadFromFiles("shaders/end_bake.vert", "shaders/end_islands.frag")) {
+            std::cerr << "EndIslandTable: Failed to load bake shader" << std::endl;
+            return false;
+        }
+
+        glGenTextures(1, &tableTexture);
+        glBindTexture(GL_TEXTURE_2D, tableTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, chunksPerAxis, chunksPerAxis, 0,
+                     GL_RGBA, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tableTexture, 0);
+        const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "EndIslandTable: RGBA32F is not renderable (status 0x"
+                      << std::hex << status << std::dec << ")" << std::endl;
+            shutdown();
+            return false;
+        }
+
+        std::cout << "EndIslandTable: " << chunksPerAxis << "^2 chunk columns" << std::endl;
+        return true;
+    }
+
+    /**
+     * Release GL objects (call while the context is still current)
+     */
+    void shutdown() {
+        if (framebuffer) glDeleteFramebuffers(1, &framebuffer);
+        if (tableTexture) glDeleteTextures(1, &tableTexture);
+        framebuffer = tableTexture = 0;
+        bakeShader.Destroy();
+        hasRegion = false;
+    }
+
+    bool isReady() const { return framebuffer != 0; }
+
+    /**
+     * Center the table on the camera's chunk column, baking the columns
+     * that entered it. Restores the framebuffer, viewport and depth test.
+     * @param quad Fullscreen quad (location 0 = vec2 position)
+     */
+    void update(const glm::ivec3& cameraChunk, VAO& quad) {
+        if (!isReady()) return;
+
+        const glm::ivec2 newMin = glm::ivec2(cameraChunk.x, cameraChunk.z) - glm::ivec2(chunksPerAxis / 2);
+        if (hasRegion && newMin == regionMin) return;
+
+        const glm::ivec2 previousMin = regionMin;
+        const bool fullBake = !hasRegion ||
+                              std::abs(newMin.x - previousMin.x) >= chunksPerAxis ||
+                              std::abs(newMin.y - previousMin.y) >= chunksPerAxis;
+        if (hasRegion) stats.regionMoves++;
+        regionMin = newMin;
+        hasRegion = true;
+        stats.columnsBakedLastUpdate = 0;
+
+        GLint previousFramebuffer = 0;
+        GLint previousViewport[4];
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFramebuffer);
+        glGetIntegerv(GL_VIEWPORT, previousViewport);
+        const GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+        glDisable(GL_DEPTH_TEST);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        bakeShader.Use();
+        glUniform2i(bakeShader.GetUniformLocation("uRegionMin"), regionMin.x, regionMin.y);
+        glUniform2i(bakeShader.GetUniformLocation("uRegionSlot"), wrap(regionMin.x), wrap(regionMin.y));
+        glUniform1i(bakeShader.GetUniformLocation("uTableSize"), chunksPerAxis);
+        quad.Bind();
+
+        if (fullBake) {
+            bakeRect(0, 0, chunksPerAxis, chunksPerAxis);
+        } else {
+            // Columns (x) and rows (z) that entered; the corner they share is baked twice
+            bakeEntered(previousMin.x, newMin.x, true);
+            bakeEntered(previousMin.y, newMin.y, false);
+        }
+
+        quad.Unbind();
+        glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+        glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+        if (depthTest) glEnable(GL_DEPTH_TEST);
+    }
+
+    /**
+     * Bind the table and set the island uniforms of a shader that includes
+     * end_density.glsl. The sampler unit is set even when disabled so it
+     * never aliases a 3D sampler on unit 0.
+     */
+    void bind(Engine::Common::ShaderProgram& program, int unit, bool enabled) {
+        const bool active = enabled && isReady() && hasRegion;
+        glUniform1i(program.GetUniformLocation("uIslandTableEnabled"), active ? 1 : 0);
+        glUniform1i(program.GetUniformLocation("uIslandTable"), unit);
+        if (!active) return;
+
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, tableTexture);
+        glActiveTexture(GL_TEXTURE0);
+
+        glUniform2i(program.GetUniformLocation("uIslandTableMin"), regionMin.x, regionMin.y);
+        glUniform1i(program.GetUniformLocation("uIslandTableSize"), chunksPerAxis);
+    }
+
+    /**
+     * Re-bake the whole table on the next update, e.g. after the island
+     * rules changed
+     */
+    void invalidate() {
+        hasRegion = false;
+    }
+
+    const Stats& getStats() const { return stats; }
+    int getChunksPerAxis() const { return chunksPerAxis; }
+
+private:
+    int wrap(int c) const {
+        const int m = c % chunksPerAxis;
+        return m < 0 ? m + chunksPerAxis : m;
+    }
+
+    /**
+     * Bake the chunks that entered along one axis when its region start
+     * moved from previous to current
+     */
+    void bakeEntered(int previous, int current, bool xAxis) {
+        if (current == previous) return;
+
+        // Entered chunks are [first, first + count) on this axis
+        const int first = current > previous ? previous + chunksPerAxis : current;
+        const int count = std::abs(current - previous);
+
+        // The span may wrap around the texture edge
+        const int start = wrap(first);
+        const int head = std::min(count, chunksPerAxis - start);
+        bakeSpan(start, head, xAxis);
+        if (head < count) bakeSpan(0, count - head, xAxis);
+    }
+
+    void bakeSpan(int start, int count, bool xAxis) {
+        if (xAxis) {
+            bakeRect(start, 0, count, chunksPerAxis);
+        } else {
+            bakeRect(0, start, chunksPerAxis, count);
+        }
+    }
+
+    void bakeRect(int x, int y, int w, int h) {
+        glViewport(x, y, w, h);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        stats.columnsBakedLastUpdate += w * h;
+    }
+};
+
+} // namespace EndViewer
+
+#endif // END_ISLAND_TABLE_H
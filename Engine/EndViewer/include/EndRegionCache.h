@@ -0,0 +1,403 @@
+#ifndef END_REGION_CACHE_H
+#define END_REGION_CACHE_H
+
+#include <glm/glm.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../Common/include/MappedFile.h"
+#include "EndChunkMesher.h"
+
+namespace EndViewer {
+
+/**
+ * Persistent Chunk Mesh Cache
+ *
+ * Keeps EndChunkMesher output on disk so warm starts and revisits skip the
+ * density sampling. Keys are (seed, chunk x/y/z, LOD).
+ *
+ * - One region file per 16^3 chunks and LOD, under <directory>/seed_<seed>/:
+ *   a 64-byte header (seed, LOD, region, EndDensity::versionHash()) and a
+ *   fixed index of 4096 entries, followed by the payloads
+ * - A payload is the packed mesh exactly as it is uploaded (EndChunkVertex
+ *   is quantized to 12 bytes, half of float vertices); chunks known to be
+ *   empty only have their index entry
+ * - Reads go through a read-only mapping of the region file and return
+ *   pointers into it, so a hit is copied straight into the staging buffer
+ * - store() appends the payload and then rewrites the index entry, from the
+ *   mesh workers; an interrupted write leaves the entry missing
+ * - A region whose header does not match (another density version, format
+ *   or seed) is discarded and rewritten, so changing EndDensity's constants
+ *   invalidates the cache without any cleanup
+ *
+ * lookup() and read() belong to one thread (the render thread); store()
+ * may be called from any number of threads.
+ */
+class EndRegionCache {
+public:
+    static constexpr int REGION_SIZE = 16;  // Chunks per axis
+    static constexpr int ENTRY_COUNT = REGION_SIZE * REGION_SIZE * REGION_SIZE;
+    static constexpr uint32_t FORMAT_VERSION = 1;
+    static constexpr uint64_t MAX_REGION_BYTES = (1ull << 31) - 1;  // Offsets fit fseek's long
+
+    enum class Status { MISSING, EMPTY, MESH };
+
+    /**
+     * Result of lookup(); the pointers stay valid until the next lookup(),
+     * read() or close()
+     */
+    struct CachedMesh {
+        Status status = Status::MISSING;
+        const EndChunkVertex* vertices = nullptr;
+        const uint16_t* indices = nullptr;
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+
+        size_t vertexBytes() const { return vertexCount * sizeof(EndChunkVertex); }
+        size_t indexBytes() const { return indexCount * sizeof(uint16_t); }
+    };
+
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t writes = 0;
+        size_t bytesWritten = 0;
+        size_t staleRegions = 0;   // Rewritten because their header did not match
+        size_t openRegions = 0;
+    };
+
+private:
+    struct RegionHeader {
+        char magic[4];
+        uint32_t formatVersion;
+        uint64_t versionHash;
+        int64_t seed;
+        int32_t lod;
+        int32_t regionX, regionY, regionZ;
+        uint32_t reserved[6];
+    };
+    static_assert(sizeof(RegionHeader) == 64, "RegionHeader layout changed");
+
+    struct IndexEntry {
+        uint32_t offset;       // Payload position in the file
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t status;       // Status
+    };
+    static_assert(sizeof(IndexEntry) == 16, "IndexEntry layout changed");
+
+    static constexpr uint64_t PAYLOAD_START = sizeof(RegionHeader) + ENTRY_COUNT * sizeof(IndexEntry);
+
+    struct Region {
+        std::mutex mutex;
+        glm::ivec3 coords = glm::ivec3(0);
+        int lod = 0;
+        std::string path;
+        bool opened = false;       // First use happened (usable or not)
+        std::FILE* file = nullptr; // Null if the region could not be opened
+        Engine::Common::MappedFile mapping;
+        std::vector<IndexEntry> index;
+        uint64_t fileSize = 0;
+    };
+
+    std::string directory;
+    int64_t seed = 0;
+    uint64_t versionHash = 0;
+    bool opened = false;
+
+    std::mutex regionsMutex;
+    std::unordered_map<int64_t, std::unique_ptr<Region>> regions;
+
+    // lookup() counters are only touched by its thread
+    size_t hits = 0, misses = 0;
+    std::atomic<size_t> writes{0}, bytesWritten{0}, staleRegions{0};
+
+public:
+    EndRegionCache() = default;
+    ~EndRegionCache() { close(); }
+
+    EndRegionCache(const EndRegionCache&) = delete;
+    EndRegionCache& operator=(const EndRegionCache&) = delete;
+
+    /**
+     * Use <rootDirectory>/seed_<worldSeed>/ for the region files
+     * @param densityVersion EndDensity::versionHash() of the meshed density
+     * @return False (cache disabled) if the directory cannot be created
+     */
+    bool open(const std::string& rootDirectory, int64_t worldSeed, uint64_t densityVersion) {
+        close();
+
+        const std::filesystem::path path =
+            std::filesystem::path(rootDirectory) / ("seed_" + std::to_string(worldSeed));
+        std::error_code error;
+        std::filesystem::create_directories(path, error);
+        if (error) {
+            std::cerr << "EndRegionCache: Cannot create " << path.string() << " ("
+                      << error.message() << "), disk cache disabled" << std::endl;
+            return false;
+        }
+
+        directory = path.string();
+        seed = worldSeed;
+        versionHash = densityVersion;
+        opened = true;
+        return true;
+    }
+
+    /**
+     * Close every region file (no store() may be running)
+     */
+    void close() {
+        std::lock_guard<std::mutex> lock(regionsMutex);
+        for (auto& item : regions) {
+            if (item.second->file) std::fclose(item.second->file);
+        }
+        regions.clear();
+        opened = false;
+    }
+
+    bool isOpen() const { return opened; }
+
+    /**
+     * Find a chunk; for Status::MESH the result points into the mapping
+     */
+    CachedMesh lookup(const glm::ivec3& chunk, int lod) {
+        const CachedMesh result = read(chunk, lod);
+        (result.status == Status::MISSING ? misses : hits)++;
+        return result;
+    }
+
+    /**
+     * lookup() without counting it (for fetching the payload of a chunk
+     * that was already looked up)
+     */
+    CachedMesh read(const glm::ivec3& chunk, int lod) {
+        CachedMesh result;
+        if (!opened) return result;
+
+        Region& region = getRegion(chunk, lod);
+        std::lock_guard<std::mutex> lock(region.mutex);
+        if (!ensureOpened(region)) return result;
+
+        const IndexEntry& entry = region.index[entryIndex(chunk)];
+        if (entry.status == static_cast<uint32_t>(Status::MISSING)) return result;
+        if (entry.status == static_cast<uint32_t>(Status::EMPTY)) {
+            result.status = Status::EMPTY;
+            return result;
+        }
+
+        // Written after the file was mapped: map it again
+        const uint64_t end = entry.offset + payloadBytes(entry.vertexCount, entry.indexCount);
+        if (end > region.mapping.GetSize()) {
+            std::fflush(region.file);
+            if (!region.mapping.Open(region.path) || end > region.mapping.GetSize()) {
+                return result;
+            }
+        }
+
+        const unsigned char* payload = region.mapping.GetData() + entry.offset;
+        result.status = Status::MESH;
+        result.vertexCount = entry.vertexCount;
+        result.indexCount = entry.indexCount;
+        result.vertices = reinterpret_cast<const EndChunkVertex*>(payload);
+        result.indices = reinterpret_cast<const uint16_t*>(payload + result.vertexBytes());
+        return result;
+    }
+
+    /**
+     * Record a chunk's mesh (an empty mesh marks the chunk as empty).
+     * Thread-safe; writes go to the region's file under its lock.
+     */
+    void store(const glm::ivec3& chunk, int lod, const EndChunkMesh& mesh) {
+        if (!opened) return;
+
+        Region& region = getRegion(chunk, lod);
+        std::lock_guard<std::mutex> lock(region.mutex);
+        if (!ensureOpened(region)) return;
+
+        IndexEntry entry{};
+        entry.status = static_cast<uint32_t>(Status::EMPTY);
+        if (!mesh.empty()) {
+            const uint64_t bytes = payloadBytes(static_cast<uint32_t>(mesh.vertices.size()),
+                                                static_cast<uint32_t>(mesh.indices.size()));
+            const uint64_t offset = alignUp(region.fileSize);
+            if (offset + bytes > MAX_REGION_BYTES) return;  // Region full: leave the chunk uncached
+
+            static const unsigned char zeros[16] = {};
+            bool ok = std::fseek(region.file, static_cast<long>(offset), SEEK_SET) == 0;
+            ok = ok && std::fwrite(mesh.vertices.data(), 1, mesh.vertexBytes(), region.file) == mesh.vertexBytes();
+            ok = ok && std::fwrite(mesh.indices.data(), 1, mesh.indexBytes(), region.file) == mesh.indexBytes();
+            const size_t padding = static_cast<size_t>(bytes - mesh.vertexBytes() - mesh.indexBytes());
+            ok = ok && std::fwrite(zeros, 1, padding, region.file) == padding;
+            if (!ok) {
+                reportWriteError(region);
+                return;
+            }
+
+            region.fileSize = offset + bytes;
+            entry.offset = static_cast<uint32_t>(offset);
+            entry.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+            entry.indexCount = static_cast<uint32_t>(mesh.indices.size());
+            entry.status = static_cast<uint32_t>(Status::MESH);
+            bytesWritten += bytes;
+        }
+
+        // Payload first, then the entry that points at it
+        const int index = entryIndex(chunk);
+        const long entryOffset = static_cast<long>(sizeof(RegionHeader) + index * sizeof(IndexEntry));
+        if (std::fflush(region.file) != 0 ||
+            std::fseek(region.file, entryOffset, SEEK_SET) != 0 ||
+            std::fwrite(&entry, sizeof(entry), 1, region.file) != 1 ||
+            std::fflush(region.file) != 0) {
+            reportWriteError(region);
+            return;
+        }
+        region.index[index] = entry;
+        writes++;
+    }
+
+    Stats getStats() {
+        Stats result;
+        result.hits = hits;
+        result.misses = misses;
+        result.writes = writes;
+        result.bytesWritten = bytesWritten;
+        result.staleRegions = staleRegions;
+        std::lock_guard<std::mutex> lock(regionsMutex);
+        result.openRegions = regions.size();
+        return result;
+    }
+
+private:
+    static int floorDiv(int value, int divisor) {
+        return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+    }
+
+    static glm::ivec3 regionOf(const glm::ivec3& chunk) {
+        return glm::ivec3(floorDiv(chunk.x, REGION_SIZE), floorDiv(chunk.y, REGION_SIZE),
+                          floorDiv(chunk.z, REGION_SIZE));
+    }
+
+    static int entryIndex(const glm::ivec3& chunk) {
+        const glm::ivec3 local = chunk - regionOf(chunk) * REGION_SIZE;
+        return (local.z * REGION_SIZE + local.y) * REGION_SIZE + local.x;
+    }
+
+    static uint64_t alignUp(uint64_t bytes) {
+        return (bytes + 15) & ~static_cast<uint64_t>(15);
+    }
+
+    static uint64_t payloadBytes(uint32_t vertexCount, uint32_t indexCount) {
+        return alignUp(static_cast<uint64_t>(vertexCount) * sizeof(EndChunkVertex) +
+                       static_cast<uint64_t>(indexCount) * sizeof(uint16_t));
+    }
+
+    Region& getRegion(const glm::ivec3& chunk, int lod) {
+        const glm::ivec3 coords = regionOf(chunk);
+        // 20 bits for x and z, 12 for y, 8 for the LOD
+        const int64_t key = (static_cast<int64_t>(coords.x & 0xFFFFF) << 40) |
+                            (static_cast<int64_t>(coords.z & 0xFFFFF) << 20) |
+                            (static_cast<int64_t>(coords.y & 0xFFF) << 8) |
+                            static_cast<int64_t>(lod & 0xFF);
+
+        std::lock_guard<std::mutex> lock(regionsMutex);
+        std::unique_ptr<Region>& region = regions[key];
+        if (!region) {
+            region = std::make_unique<Region>();
+            region->coords = coords;
+            region->lod = lod;
+            region->path = directory + "/r." + std::to_string(lod) + "." + std::to_string(coords.x) +
+                           "." + std::to_string(coords.y) + "." + std::to_string(coords.z) + ".endr";
+        }
+        return *region;
+    }
+
+    RegionHeader makeHeader(const Region& region) const {
+        RegionHeader header{};
+        std::memcpy(header.magic, "ENDR", 4);
+        header.formatVersion = FORMAT_VERSION;
+        header.versionHash = versionHash;
+        header.seed = seed;
+        header.lod = region.lod;
+        header.regionX = region.coords.x;
+        header.regionY = region.coords.y;
+        header.regionZ = region.coords.z;
+        return header;
+    }
+
+    /**
+     * Map an existing region file, or (re)create it when missing or stale.
+     * Called with the region's lock held; false if it cannot be used.
+     */
+    bool ensureOpened(Region& region) {
+        if (region.opened) return region.file != nullptr;
+        region.opened = true;
+
+        const RegionHeader expected = makeHeader(region);
+        bool existed = false;
+        if (region.mapping.Open(region.path)) {
+            existed = true;
+            if (region.mapping.GetSize() >= PAYLOAD_START &&
+                std::memcmp(region.mapping.GetData(), &expected, sizeof(expected)) == 0) {
+                region.index.resize(ENTRY_COUNT);
+                std::memcpy(region.index.data(), region.mapping.GetData() + sizeof(RegionHeader),
+                            ENTRY_COUNT * sizeof(IndexEntry));
+                region.fileSize = region.mapping.GetSize();
+
+                // Drop entries past the end (file cut short)
+                for (IndexEntry& entry : region.index) {
+                    if (entry.status == static_cast<uint32_t>(Status::MESH) &&
+                        entry.offset + payloadBytes(entry.vertexCount, entry.indexCount) > region.fileSize) {
+                        entry = IndexEntry{};
+                    }
+                }
+
+                region.file = std::fopen(region.path.c_str(), "r+b");
+                if (!region.file) {
+                    std::cerr << "EndRegionCache: Cannot open " << region.path << " for writing" << std::endl;
+                }
+                return region.file != nullptr;
+            }
+            region.mapping.Close();
+        }
+
+        // New or stale: start over with an empty index
+        if (existed) staleRegions++;
+        region.file = std::fopen(region.path.c_str(), "w+b");
+        region.index.assign(ENTRY_COUNT, IndexEntry{});
+        if (!region.file ||
+            std::fwrite(&expected, sizeof(expected), 1, region.file) != 1 ||
+            std::fwrite(region.index.data(), sizeof(IndexEntry), ENTRY_COUNT, region.file) != ENTRY_COUNT ||
+            std::fflush(region.file) != 0) {
+            reportWriteError(region);
+            return false;
+        }
+        region.fileSize = PAYLOAD_START;
+        return true;
+    }
+
+    /**
+     * Stop using a region after an I/O error (its lock is held). The
+     * mapping stays until close(): the reader may still be copying from it.
+     */
+    void reportWriteError(Region& region) {
+        std::cerr << "EndRegionCache: Write to " << region.path
+                  << " failed, region no longer cached" << std::endl;
+        if (region.file) std::fclose(region.file);
+        region.file = nullptr;
+    }
+};
+
+} // namespace EndViewer
+
+#endif // END_REGION_CACHE_H
@@ -10,11 +10,17 @@
 #include <iostream>
 
 // Include the existing renderer components we'll reuse
-#include "../../../renderer/include/shaderClass.h"
 #include "../../../renderer/include/VAO.h"
 #include "../../../renderer/include/VBO.h"
 #include "../../../renderer/include/ImGuiManager.h"
+#include "../../Common/include/GpuProfiler.h"
+#include "../../Common/include/ProfilerPanel.h"
+#include "../../Common/include/ShaderProgram.h"
 
+#include "EndBrickCache.h"
+#include "EndChunkStreamer.h"
+#include "EndIslandTable.h"
+#include "EndTemporalTarget.h"
 #include "EndCamera.h"
 #include "EndDensity.h"
 
@@ -28,22 +34,46 @@ namespace EndViewer {
  * of the ring structure.
  * 
  * Integrates with BasicEngine's existing infrastructure:
- * - Uses the Shader class for GLSL loading
+ * - Uses Common's ShaderProgram for GLSL loading (shaders share
+ *   end_density.glsl through #include); linked programs are cached in
+ *   shader_cache/ and edited shaders are hot-reloaded in the background
  * - Uses VAO/VBO for the fullscreen quad
  * - Uses ImGuiManager for debug UI
+ * - Alternatively draws CPU-meshed chunks streamed in by EndChunkStreamer
  */
 class EndRenderer {
 public:
     // Render settings
     struct Settings {
+        // 0 = ray march, 1 = chunk meshes of the CPU density
+        int renderMode = 0;
+        int meshViewRadius = 12;   // Chunks of each LOD level around the camera in mesh mode
+        int meshTriangleBudget = 400;   // Thousands of resident triangles per LOD level
+        int impostorBudget = 32768;     // Far outer islands drawn as impostors
+        
         // Ray marching parameters
         int maxSteps = 256;
         float maxDistance = 50000.0f;
         float stepMultiplier = 1.0f;
+        bool safeStepping = true;  // Jump over provably empty space
         
         // Quality settings (adjusted by LOD)
         int baseOctaves = 4;
         
+        // Density brick cache around the camera
+        bool useBrickCache = true;
+        int brickBakeBudget = 32;  // Bricks baked per frame
+        
+        // Precomputed outer island descriptors per chunk column
+        bool useIslandTable = true;
+        
+        // Temporal reprojection at a dynamic internal resolution
+        bool temporalRendering = true;
+        bool dynamicResolution = true;
+        float traceBudgetMs = 12.0f;       // GPU time the ray march may take
+        float minResolutionScale = 0.5f;
+        float resolutionScale = 1.0f;      // Internal / window size (driven when dynamic)
+        
         // Colors
         glm::vec3 endStoneColor = glm::vec3(0.85f, 0.85f, 0.65f);  // Pale yellow
         glm::vec3 skyColor = glm::vec3(0.0f, 0.0f, 0.05f);         // Near black
@@ -52,7 +82,10 @@ public:
         
         // Debug
         bool showDebugUI = true;
+        bool showProfiler = false;
         bool wireframeMode = false;
+        bool hotReloadShaders = true;  // Recompile shaders whose files changed
+        int debugView = 0;  // 0 = shaded, 1 = step heatmap, 2 = steps saved
     };
     
 private:
@@ -61,7 +94,23 @@ private:
     int width, height;
     
     // Shader
-    std::unique_ptr<Shader> rayMarchShader;
+    std::unique_ptr<Engine::Common::ShaderProgram> rayMarchShader;
+    
+    // Baked density near the camera (optional, ray marching works without it)
+    EndBrickCache brickCache;
+    
+    // Baked island placement around the camera (same fallback rules)
+    EndIslandTable islandTable;
+    
+    // Chunk meshes for the mesh render mode
+    EndChunkStreamer chunkStreamer;
+    
+    // Offscreen history for temporal reprojection
+    EndTemporalTarget temporalTarget;
+    bool temporalLastFrame = false;
+    glm::dvec3 prevCameraPosition = glm::dvec3(0.0);
+    glm::dvec3 prevCameraOrientation = glm::dvec3(0.0, 0.0, -1.0);
+    glm::dvec3 prevCameraUp = glm::dvec3(0.0, 1.0, 0.0);
     
     // Fullscreen quad geometry
     std::unique_ptr<VAO> quadVAO;
@@ -76,6 +125,8 @@ private:
     // ImGui manager (owned externally, just a reference)
     ImGuiManager* imguiManager;
     
+    Engine::Common::ProfilerPanel profilerPanel;
+    
     // Settings
     Settings settings;
     
@@ -84,6 +135,9 @@ private:
     float frameTimeAccum = 0.0f;
     int frameCount = 0;
     float averageFPS = 0.0f;
+    float smoothedTraceMs = -1.0f;
+    int framesSinceScaleChange = 0;
+    double lastShaderCheck = 0.0;
     
 public:
     /**
@@ -115,11 +169,32 @@ public:
         }
         std::cout << "EndRenderer: Fullscreen quad created" << std::endl;
         
-        // Load ray marching shader
+        // Start the ray marching shader first: the driver compiles it in the
+        // background (with KHR_parallel_shader_compile) while the other
+        // components load theirs
+        Engine::Common::ShaderProgram::SetBinaryCacheDirectory("shader_cache");
         if (!loadShaders()) {
             std::cerr << "EndRenderer: Failed to load shaders" << std::endl;
             return false;
         }
+        
+        if (!brickCache.initialize()) {
+            std::cerr << "EndRenderer: Brick cache unavailable, using analytic density only" << std::endl;
+        }
+        if (!islandTable.initialize()) {
+            std::cerr << "EndRenderer: Island table unavailable, using analytic islands only" << std::endl;
+        }
+        if (!temporalTarget.initialize()) {
+            std::cerr << "EndRenderer: Temporal rendering unavailable, tracing at full resolution" << std::endl;
+        }
+        if (!chunkStreamer.initialize(cpuDensity.get(), "end_cache")) {
+            std::cerr << "EndRenderer: Chunk meshes unavailable, ray marching only" << std::endl;
+        }
+        
+        if (!rayMarchShader->Finish()) {
+            std::cerr << "EndRenderer: Failed to load shaders" << std::endl;
+            return false;
+        }
         std::cout << "EndRenderer: Shaders loaded" << std::endl;
         
         // Verify density function at known coordinates
@@ -133,12 +208,18 @@ public:
      * Update and render frame
      */
     void renderFrame(float deltaTime) {
+        PROFILE_SCOPE("EndRenderer::renderFrame");
+        
         // Update performance metrics
         updatePerformanceMetrics(deltaTime);
         
         // Handle input
         camera->handleInput(window, deltaTime);
         
+        if (settings.hotReloadShaders) {
+            reloadChangedShaders();
+        }
+        
         // Update window size
         int newWidth, newHeight;
         glfwGetFramebufferSize(window, &newWidth, &newHeight);
@@ -153,17 +234,86 @@ public:
         int octaves = std::max(1, settings.baseOctaves - static_cast<int>(lod));
         float stepMult = settings.stepMultiplier * std::pow(2.0f, lod);
         
+        // Mesh mode: stream chunks instead of ray marching
+        if (settings.renderMode == 1 && chunkStreamer.isReady()) {
+            {
+                PROFILE_SCOPE("Chunk streaming");
+                chunkStreamer.update(*camera, settings.meshViewRadius,
+                                     static_cast<size_t>(settings.meshTriangleBudget) * 1000,
+                                     settings.impostorBudget);
+            }
+            
+            glClearColor(settings.skyColor.r, settings.skyColor.g, settings.skyColor.b, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            {
+                PROFILE_SCOPE("Mesh pass");
+                PROFILE_GPU_SCOPE("Mesh pass");
+                chunkStreamer.draw(*camera, settings.endStoneColor, settings.fogColor,
+                                   settings.fogDensity, settings.wireframeMode);
+            }
+            
+            temporalLastFrame = false;  // History is stale when ray marching resumes
+            if (settings.showDebugUI) {
+                renderDebugUI();
+            }
+            return;
+        }
+        
+        // Re-bake island columns and bricks that entered their regions
+        // (only after chunk changes)
+        if (settings.useIslandTable) {
+            PROFILE_SCOPE("Island table");
+            PROFILE_GPU_SCOPE("Island table bake");
+            islandTable.update(camera->chunkOrigin, *quadVAO);
+        }
+        if (settings.useBrickCache) {
+            PROFILE_SCOPE("Brick cache");
+            PROFILE_GPU_SCOPE("Brick bake");
+            brickCache.update(camera->chunkOrigin, octaves);
+            brickCache.bake(*quadVAO, settings.brickBakeBudget);
+        }
+        
         // Clear screen
         glClearColor(settings.skyColor.r, settings.skyColor.g, settings.skyColor.b, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         
+        // Temporal path: trace into the offscreen target at the internal
+        // resolution, then upscale. Debug views always trace every pixel.
+        bool temporal = settings.temporalRendering && settings.debugView == 0 &&
+                        temporalTarget.isReady();
+        if (temporal) {
+            const int traceWidth = static_cast<int>(width * settings.resolutionScale + 0.5f);
+            const int traceHeight = static_cast<int>(height * settings.resolutionScale + 0.5f);
+            temporal = temporalTarget.resize(traceWidth, traceHeight);
+        }
+        if (temporal && !temporalLastFrame) {
+            temporalTarget.invalidate();
+        }
+        
         // Render terrain
-        rayMarchShader->Activate();
+        rayMarchShader->Use();
         setShaderUniforms(octaves, stepMult);
+        setTemporalUniforms(temporal);
         
-        quadVAO->Bind();
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        quadVAO->Unbind();
+        if (temporal) {
+            temporalTarget.beginTrace();
+        }
+        {
+            PROFILE_GPU_SCOPE("Raymarch");
+            quadVAO->Bind();
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+            quadVAO->Unbind();
+        }
+        if (temporal) {
+            temporalTarget.endTrace();
+            PROFILE_GPU_SCOPE("Temporal resolve");
+            temporalTarget.resolve(*quadVAO, width, height);
+        }
+        
+        temporalLastFrame = temporal;
+        prevCameraPosition = camera->position;
+        prevCameraOrientation = camera->orientation;
+        prevCameraUp = camera->up;
         
         // Render debug UI
         if (settings.showDebugUI) {
@@ -177,7 +327,12 @@ public:
     void shutdown() {
         if (quadVAO) quadVAO->Delete();
         if (quadVBO) quadVBO->Delete();
-        if (rayMarchShader) rayMarchShader->Delete();
+        if (rayMarchShader) rayMarchShader->Destroy();
+        chunkStreamer.shutdown();
+        brickCache.shutdown();
+        islandTable.shutdown();
+        temporalTarget.shutdown();
+        Engine::Common::GpuProfiler::Get().Shutdown();
     }
     
     /**
@@ -221,61 +376,104 @@ private:
     }
     
     /**
-     * Load and compile the ray marching shaders
+     * Start compiling the ray marching shaders (finished in initialize)
      */
     bool loadShaders() {
-        try {
-            rayMarchShader = std::make_unique<Shader>(
-                "shaders/end_raymarch.vert",
-                "shaders/end_raymarch.frag"
-            );
-            return true;
-        } catch (const std::exception& e) {
-            std::cerr << "EndRenderer: Shader loading failed: " << e.what() << std::endl;
-            return false;
-        } catch (int errnum) {
-            std::cerr << "EndRenderer: Shader file not found, errno: " << errnum << std::endl;
-            return false;
+        rayMarchShader = std::make_unique<Engine::Common::ShaderProgram>();
+        return rayMarchShader->BeginLoad(
+            "shaders/end_raymarch.vert",
+            "shaders/end_raymarch.frag"
+        );
+    }
+    
+    /**
+     * Reload edited shaders without stalling the frame: files are checked
+     * twice a second, reloads in flight every frame. The old programs keep
+     * drawing until the new ones link, and also if they fail to.
+     */
+    void reloadChangedShaders() {
+        const double now = glfwGetTime();
+        const bool check = now - lastShaderCheck >= 0.5;
+        if (check) lastShaderCheck = now;
+        
+        if (check || rayMarchShader->IsPending()) {
+            if (rayMarchShader->ReloadIfChanged()) {
+                std::cout << "EndRenderer: Ray march shader reloaded" << std::endl;
+            }
         }
+        chunkStreamer.reloadChangedShaders(check);
     }
     
     /**
      * Set all shader uniforms for current frame
      */
     void setShaderUniforms(int octaves, float stepMult) {
-        GLuint program = rayMarchShader->ID;
+        Engine::Common::ShaderProgram& program = *rayMarchShader;
         
         // Camera uniforms
-        glUniform3fv(glGetUniformLocation(program, "uCameraPos"), 1, 
+        glUniform3fv(program.GetUniformLocation("uCameraPos"), 1, 
                      glm::value_ptr(camera->localOffset));
-        glUniform3iv(glGetUniformLocation(program, "uChunkOrigin"), 1, 
+        glUniform3iv(program.GetUniformLocation("uChunkOrigin"), 1, 
                      glm::value_ptr(camera->chunkOrigin));
-        glUniform1f(glGetUniformLocation(program, "uCameraAltitude"), 
+        glUniform1f(program.GetUniformLocation("uCameraAltitude"), 
                     static_cast<float>(camera->getAltitude()));
         
         // View matrices
         glm::mat4 invViewProj = camera->getInverseViewProjection();
-        glUniformMatrix4fv(glGetUniformLocation(program, "uInvViewProj"), 1, GL_FALSE,
+        glUniformMatrix4fv(program.GetUniformLocation("uInvViewProj"), 1, GL_FALSE,
                           glm::value_ptr(invViewProj));
         
         // Rendering settings
-        glUniform1f(glGetUniformLocation(program, "uMaxDistance"), settings.maxDistance);
-        glUniform1i(glGetUniformLocation(program, "uMaxSteps"), settings.maxSteps);
-        glUniform1f(glGetUniformLocation(program, "uTime"), 
+        glUniform1f(program.GetUniformLocation("uMaxDistance"), settings.maxDistance);
+        glUniform1i(program.GetUniformLocation("uMaxSteps"), settings.maxSteps);
+        glUniform1f(program.GetUniformLocation("uTime"), 
                     static_cast<float>(glfwGetTime()));
         
         // Quality settings
-        glUniform1i(glGetUniformLocation(program, "uOctaves"), octaves);
-        glUniform1f(glGetUniformLocation(program, "uStepMultiplier"), stepMult);
+        glUniform1i(program.GetUniformLocation("uOctaves"), octaves);
+        glUniform1f(program.GetUniformLocation("uStepMultiplier"), stepMult);
+        glUniform1i(program.GetUniformLocation("uSafeStepping"), settings.safeStepping ? 1 : 0);
+        glUniform1i(program.GetUniformLocation("uDebugView"), settings.debugView);
         
         // Colors
-        glUniform3fv(glGetUniformLocation(program, "uEndStoneColor"), 1,
+        glUniform3fv(program.GetUniformLocation("uEndStoneColor"), 1,
                      glm::value_ptr(settings.endStoneColor));
-        glUniform3fv(glGetUniformLocation(program, "uSkyColor"), 1,
+        glUniform3fv(program.GetUniformLocation("uSkyColor"), 1,
                      glm::value_ptr(settings.skyColor));
-        glUniform3fv(glGetUniformLocation(program, "uFogColor"), 1,
+        glUniform3fv(program.GetUniformLocation("uFogColor"), 1,
                      glm::value_ptr(settings.fogColor));
-        glUniform1f(glGetUniformLocation(program, "uFogDensity"), settings.fogDensity);
+        glUniform1f(program.GetUniformLocation("uFogDensity"), settings.fogDensity);
+        
+        // Brick cache on texture units 0-2, island table on unit 3
+        brickCache.bind(program, 0, settings.useBrickCache);
+        islandTable.bind(program, 3, settings.useIslandTable);
+    }
+    
+    /**
+     * Set the reprojection uniforms: history on texture unit 4 and the
+     * previous camera, expressed relative to this frame's chunk origin
+     */
+    void setTemporalUniforms(bool temporal) {
+        Engine::Common::ShaderProgram& program = *rayMarchShader;
+        glUniform1i(program.GetUniformLocation("uTemporal"), temporal ? 1 : 0);
+        if (!temporal) return;
+        
+        temporalTarget.bindHistory(program, 4);
+        
+        const glm::vec3 prevPos = glm::vec3(prevCameraPosition - glm::dvec3(camera->chunkOrigin) * 16.0);
+        const glm::mat4 prevView = glm::lookAt(prevPos, prevPos + glm::vec3(prevCameraOrientation),
+                                               glm::vec3(prevCameraUp));
+        const glm::mat4 prevViewProj = camera->getProjectionMatrix() * prevView;
+        const glm::mat4 prevInvViewProj = glm::inverse(prevViewProj);
+        glUniformMatrix4fv(program.GetUniformLocation("uPrevViewProj"), 1, GL_FALSE,
+                           glm::value_ptr(prevViewProj));
+        glUniformMatrix4fv(program.GetUniformLocation("uPrevInvViewProj"), 1, GL_FALSE,
+                           glm::value_ptr(prevInvViewProj));
+        glUniform3fv(program.GetUniformLocation("uPrevCameraPos"), 1, glm::value_ptr(prevPos));
+        
+        const float pixelSpread = 2.0f * std::tan(glm::radians(camera->fov) * 0.5f) /
+                                  static_cast<float>(temporalTarget.getHeight());
+        glUniform1f(program.GetUniformLocation("uPixelSpread"), pixelSpread);
     }
     
     /**
@@ -320,6 +518,51 @@ private:
         
         ImGui::Separator();
         
+        // Render mode
+        const char* renderModes[] = { "Ray March", "Chunk Meshes" };
+        if (chunkStreamer.isReady()) {
+            ImGui::Combo("Render Mode", &settings.renderMode, renderModes, IM_ARRAYSIZE(renderModes));
+        }
+        if (settings.renderMode == 1 && chunkStreamer.isReady()) {
+            const EndChunkStreamer::Stats& meshStats = chunkStreamer.getStats();
+            ImGui::SliderInt("View Radius (chunks)", &settings.meshViewRadius,
+                             EndChunkStreamer::MIN_LEVEL_RADIUS, 32);
+            ImGui::SliderInt("Triangle Budget (k/level)", &settings.meshTriangleBudget, 50, 2000);
+            ImGui::SliderInt("Impostor Budget", &settings.impostorBudget, 0, 131072);
+            ImGui::Checkbox("Wireframe", &settings.wireframeMode);
+            ImGui::Text("Chunks: %d resident, %d meshed, %d pending, %d meshing",
+                        meshStats.residentChunks, meshStats.meshedChunks,
+                        meshStats.pendingChunks, meshStats.inFlightJobs);
+            ImGui::Text("Drawn: %d chunks (%d culled), %zu triangles",
+                        meshStats.drawnChunks, meshStats.culledChunks, meshStats.trianglesDrawn);
+            for (int level = 0; level < EndChunkStreamer::LOD_LEVELS; level++) {
+                ImGui::Text("  LOD %d (%d blocks): radius %d, %d chunks, %zuk tris, %d loading",
+                            level, EndChunkMesher::chunkBlocks(level), meshStats.levelRadius[level],
+                            meshStats.levelChunks[level], meshStats.levelTriangles[level] / 1000,
+                            meshStats.levelLoading[level]);
+            }
+            ImGui::Text("Impostors: %d islands (list built in %.1f ms)",
+                        meshStats.impostors, chunkStreamer.getImpostorStats().buildMs);
+            ImGui::Text("GPU: %.1f MiB, uploaded %.1f KiB last frame, %d staging stalls",
+                        meshStats.gpuBytes / (1024.0 * 1024.0),
+                        meshStats.uploadedBytesLastFrame / 1024.0, meshStats.stagingStalls);
+            if (chunkStreamer.hasDiskCache()) {
+                const EndRegionCache::Stats diskStats = chunkStreamer.getCacheStats();
+                ImGui::Text("Disk cache: %d chunks loaded, %zu hits, %zu misses",
+                            meshStats.cachedChunks, diskStats.hits, diskStats.misses);
+                ImGui::Text("  %zu writes (%.1f MiB), %zu regions, %zu stale rewritten",
+                            diskStats.writes, diskStats.bytesWritten / (1024.0 * 1024.0),
+                            diskStats.openRegions, diskStats.staleRegions);
+            } else {
+                ImGui::TextDisabled("Disk cache unavailable");
+            }
+            if (ImGui::Button("Rebuild Meshes")) {
+                chunkStreamer.invalidate();
+            }
+        }
+        
+        ImGui::Separator();
+        
         // Quality settings
         ImGui::Text("Quality Settings");
         ImGui::SliderInt("Max Steps", &settings.maxSteps, 32, 512);
@@ -327,6 +570,60 @@ private:
                           ImGuiSliderFlags_Logarithmic);
         ImGui::SliderFloat("Step Multiplier", &settings.stepMultiplier, 0.1f, 4.0f);
         ImGui::SliderInt("Base Octaves", &settings.baseOctaves, 1, 6);
+        ImGui::Checkbox("Empty Space Skipping", &settings.safeStepping);
+        const char* debugViews[] = { "Shaded", "Step Heatmap", "Steps Saved" };
+        ImGui::Combo("Debug View", &settings.debugView, debugViews, IM_ARRAYSIZE(debugViews));
+        ImGui::Checkbox("Hot Reload Shaders", &settings.hotReloadShaders);
+        ImGui::Checkbox("Show Profiler", &settings.showProfiler);
+        
+        ImGui::Separator();
+        
+        // Temporal rendering
+        ImGui::Text("Temporal Rendering");
+        if (temporalTarget.isReady()) {
+            ImGui::Checkbox("Reproject Previous Frame", &settings.temporalRendering);
+            ImGui::Checkbox("Dynamic Resolution", &settings.dynamicResolution);
+            if (settings.dynamicResolution) {
+                ImGui::SliderFloat("Trace Budget (ms)", &settings.traceBudgetMs, 2.0f, 33.0f);
+                ImGui::SliderFloat("Min Resolution Scale", &settings.minResolutionScale, 0.25f, 1.0f);
+            } else {
+                ImGui::SliderFloat("Resolution Scale", &settings.resolutionScale, 0.25f, 1.0f);
+            }
+            ImGui::Text("Internal: %dx%d (%.0f%%), trace %.2f ms",
+                        temporalTarget.getWidth(), temporalTarget.getHeight(),
+                        settings.resolutionScale * 100.0f, temporalTarget.getLastTraceMs());
+        } else {
+            ImGui::TextDisabled("Unavailable, tracing at full resolution");
+        }
+        
+        ImGui::Separator();
+        
+        // Brick cache
+        ImGui::Text("Density Brick Cache");
+        if (brickCache.isReady()) {
+            const EndBrickCache::Stats& cacheStats = brickCache.getStats();
+            ImGui::Checkbox("Use Brick Cache", &settings.useBrickCache);
+            ImGui::SliderInt("Bake Budget (bricks/frame)", &settings.brickBakeBudget, 1, 256);
+            ImGui::Text("Bricks: %d valid, %d pending (%d^3 region)",
+                        cacheStats.validBricks, cacheStats.pendingBricks,
+                        brickCache.getChunksPerAxis());
+            ImGui::Text("Baked last frame: %d, region moves: %d",
+                        cacheStats.bakedLastFrame, cacheStats.regionMoves);
+        } else {
+            ImGui::TextDisabled("Unavailable, using analytic density");
+        }
+        
+        // Island table
+        ImGui::Text("Outer Island Table");
+        if (islandTable.isReady()) {
+            const EndIslandTable::Stats& tableStats = islandTable.getStats();
+            ImGui::Checkbox("Use Island Table", &settings.useIslandTable);
+            ImGui::Text("Columns: %d^2, baked last move: %d, region moves: %d",
+                        islandTable.getChunksPerAxis(), tableStats.columnsBakedLastUpdate,
+                        tableStats.regionMoves);
+        } else {
+            ImGui::TextDisabled("Unavailable, using analytic islands");
+        }
         
         ImGui::Separator();
         
@@ -368,11 +665,42 @@ private:
             static float testCoord[3] = {0.0f, 64.0f, 0.0f};
             ImGui::InputFloat3("Test Coordinate", testCoord);
             
+            // Probe the point and its whole column in one batch
+            static bool probed = false;
+            static double probeDensity = 0.0;
+            static int probeSurface = -1;  // Highest solid y in the column, -1 if none
+            constexpr int columnHeight = 256;
+            
             if (ImGui::Button("Sample Density")) {
-                double density = cpuDensity->sample(testCoord[0], testCoord[1], testCoord[2]);
+                double xs[columnHeight + 1], ys[columnHeight + 1], zs[columnHeight + 1];
+                double densities[columnHeight + 1];
+                for (int y = 0; y <= columnHeight; y++) {
+                    xs[y] = testCoord[0];
+                    ys[y] = y < columnHeight ? static_cast<double>(y) : testCoord[1];
+                    zs[y] = testCoord[2];
+                }
+                cpuDensity->sampleBatch(xs, ys, zs, densities, columnHeight + 1);
+                
+                probeDensity = densities[columnHeight];
+                probeSurface = -1;
+                for (int y = columnHeight - 1; y >= 0; y--) {
+                    if (densities[y] > 0.0) {
+                        probeSurface = y;
+                        break;
+                    }
+                }
+                probed = true;
+            }
+            
+            if (probed) {
                 ImGui::Text("Density at (%.1f, %.1f, %.1f): %.4f %s", 
                            testCoord[0], testCoord[1], testCoord[2],
-                           density, density > 0 ? "(SOLID)" : "(AIR)");
+                           probeDensity, probeDensity > 0 ? "(SOLID)" : "(AIR)");
+                if (probeSurface >= 0) {
+                    ImGui::Text("Column top: y = %d", probeSurface);
+                } else {
+                    ImGui::Text("Column top: none (void)");
+                }
             }
         }
         
@@ -387,6 +715,10 @@ private:
         ImGui::Text("F - Reset to origin");
         ImGui::Text("Tab - Toggle UI");
         ImGui::End();
+        
+        if (settings.showProfiler) {
+            profilerPanel.Draw(&settings.showProfiler);
+        }
     }
     
     /**
@@ -401,6 +733,37 @@ private:
             frameTimeAccum = 0.0f;
             frameCount = 0;
         }
+        
+        updateResolutionScale(deltaTime);
+    }
+    
+    /**
+     * Dynamic resolution controller: moves the internal resolution scale
+     * toward the trace budget in 5% steps
+     */
+    void updateResolutionScale(float deltaTime) {
+        if (!settings.temporalRendering || !settings.dynamicResolution) return;
+        
+        // GPU time of the trace when known; the frame time includes vsync waits
+        const float traceMs = temporalTarget.getLastTraceMs();
+        const float sampleMs = traceMs >= 0.0f ? traceMs : deltaTime * 1000.0f;
+        smoothedTraceMs = smoothedTraceMs < 0.0f ? sampleMs
+                                                 : smoothedTraceMs + (sampleMs - smoothedTraceMs) * 0.1f;
+        
+        // Give the smoothed time a moment to settle after each change
+        if (++framesSinceScaleChange < 15) return;
+        
+        // Cost follows the pixel count (scale^2); drop quickly, recover slowly
+        const float current = settings.resolutionScale;
+        float next = current * std::sqrt(settings.traceBudgetMs / std::max(smoothedTraceMs, 0.01f));
+        next = std::clamp(next, current - 0.1f, current + 0.05f);
+        next = std::round(next * 20.0f) / 20.0f;
+        next = std::clamp(next, settings.minResolutionScale, 1.0f);
+        
+        if (next != current) {
+            settings.resolutionScale = next;
+            framesSinceScaleChange = 0;
+        }
     }
     
     /**
@@ -423,8 +786,19 @@ private:
             {3000.0, 64.0, 0.0, "Ring sweet spot", true},  // Should have islands nearby
         };
         
-        for (const auto& test : tests) {
-            double density = cpuDensity->sample(test.x, test.y, test.z);
+        // One batch for all cases; sampleBatch matches sample() exactly
+        constexpr size_t testCount = sizeof(tests) / sizeof(tests[0]);
+        double xs[testCount], ys[testCount], zs[testCount], densities[testCount];
+        for (size_t i = 0; i < testCount; i++) {
+            xs[i] = tests[i].x;
+            ys[i] = tests[i].y;
+            zs[i] = tests[i].z;
+        }
+        cpuDensity->sampleBatch(xs, ys, zs, densities, testCount);
+        
+        for (size_t i = 0; i < testCount; i++) {
+            const TestCase& test = tests[i];
+            double density = densities[i];
             bool isSolid = density > 0.0;
             const char* result = (isSolid == test.expectSolid) ? "PASS" : "UNEXPECTED";
             
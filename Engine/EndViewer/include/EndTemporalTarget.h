@@ -0,0 +1,200 @@
+#ifndef END_TEMPORAL_TARGET_H
+#define END_TEMPORAL_TARGET_H
+
+#include <GL/glew.h>
+#include <algorithm>
+#include <iostream>
+
+#include "../../../renderer/include/VAO.h"
+#include "../../Common/include/ShaderProgram.h"
+
+namespace EndViewer {
+
+/**
+ * Temporal Render Target
+ *
+ * Offscreen targets for rendering the ray march at an internal resolution
+ * and reusing the previous frame.
+ *
+ * - Two RGBA32F targets ping-pong: rgb = color, a = hit distance (< 0 for
+ *   sky). The one written last frame is this frame's history.
+ * - Every frame one 8x8 tile of each 2x2 group of tiles (the frame phase)
+ *   is re-traced; the shader reprojects the others from history and
+ *   re-traces them only when disoccluded, so no pixel is older than 4 frames
+ * - A resolve pass upscales the result to the window with bilinear filtering
+ * - The trace is timed with GL_TIME_ELAPSED queries (read back two frames
+ *   later so they never stall) to drive the dynamic resolution controller
+ */
+class EndTemporalTarget {
+public:
+    static constexpr int PHASE_COUNT = 4;  // 2x2 checkerboard of tiles
+
+private:
+    GLuint textures[2] = {0, 0};
+    GLuint framebuffers[2] = {0, 0};
+    GLuint timerQueries[2] = {0, 0};
+    bool timerPending[2] = {false, false};
+    int width = 0, height = 0;
+    int current = 0;             // Target written this frame
+    bool historyValid = false;
+    int framePhase = 0;
+    float lastTraceMs = -1.0f;   // GPU time of the last finished trace, < 0 if unknown
+    Engine::Common::ShaderProgram resolveShader;
+
+public:
+    /**
+     * Load the resolve shader and create the timer queries. Targets are
+     * allocated by resize().
+     */
+    bool initialize() {
+        if (!resolveShader.LoadFromFiles("shaders/end_bake.vert", "shaders/end_resolve.frag")) {
+            std::cerr << "EndTemporalTarget: Failed to load resolve shader" << std::endl;
+            return false;
+        }
+        glGenQueries(2, timerQueries);
+        return true;
+    }
+
+    /**
+     * Release GL objects (call while the context is still current)
+     */
+    void shutdown() {
+        releaseTargets();
+        if (timerQueries[0]) glDeleteQueries(2, timerQueries);
+        timerQueries[0] = timerQueries[1] = 0;
+        resolveShader.Destroy();
+    }
+
+    bool isReady() const { return resolveShader.IsValid(); }
+
+    /**
+     * (Re)allocate both targets at the internal resolution; a size change
+     * drops the history
+     */
+    bool resize(int newWidth, int newHeight) {
+        newWidth = std::max(1, newWidth);
+        newHeight = std::max(1, newHeight);
+        if (newWidth == width && newHeight == height && framebuffers[0]) return true;
+
+        releaseTargets();
+        width = newWidth;
+        height = newHeight;
+
+        glGenTextures(2, textures);
+        glGenFramebuffers(2, framebuffers);
+        for (int i = 0; i < 2; i++) {
+            glBindTexture(GL_TEXTURE_2D, textures[i]);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[i]);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textures[i], 0);
+        }
+        const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "EndTemporalTarget: RGBA32F is not renderable (status 0x"
+                      << std::hex << status << std::dec << ")" << std::endl;
+            releaseTargets();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Bind this frame's target and start timing the trace
+     */
+    void beginTrace() {
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[current]);
+        glViewport(0, 0, width, height);
+        readTimer(current);
+        glBeginQuery(GL_TIME_ELAPSED, timerQueries[current]);
+    }
+
+    /**
+     * Stop timing; the frame becomes the next frame's history
+     */
+    void endTrace() {
+        glEndQuery(GL_TIME_ELAPSED);
+        timerPending[current] = true;
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    /**
+     * Set the history uniforms of the ray march shader
+     * @param unit Texture unit for the previous frame
+     */
+    void bindHistory(Engine::Common::ShaderProgram& program, int unit) {
+        const int history = 1 - current;
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, textures[history]);
+        glActiveTexture(GL_TEXTURE0);
+
+        glUniform1i(program.GetUniformLocation("uHistory"), unit);
+        glUniform1i(program.GetUniformLocation("uHistoryValid"), historyValid ? 1 : 0);
+        glUniform1i(program.GetUniformLocation("uFramePhase"), framePhase);
+    }
+
+    /**
+     * Upscale this frame's target into the bound (window) framebuffer and
+     * advance to the next frame
+     */
+    void resolve(VAO& quad, int outputWidth, int outputHeight) {
+        glViewport(0, 0, outputWidth, outputHeight);
+        resolveShader.Use();
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textures[current]);
+        glUniform1i(resolveShader.GetUniformLocation("uFrame"), 0);
+        glUniform2f(resolveShader.GetUniformLocation("uOutputSize"),
+                    static_cast<float>(outputWidth), static_cast<float>(outputHeight));
+
+        const GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+        glDisable(GL_DEPTH_TEST);
+        quad.Bind();
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        quad.Unbind();
+        if (depthTest) glEnable(GL_DEPTH_TEST);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        current = 1 - current;
+        historyValid = true;
+        framePhase = (framePhase + 1) % PHASE_COUNT;
+    }
+
+    /**
+     * Trace every pixel next frame (camera cut, settings change)
+     */
+    void invalidate() { historyValid = false; }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    bool hasHistory() const { return historyValid; }
+    float getLastTraceMs() const { return lastTraceMs; }
+
+private:
+    void readTimer(int index) {
+        if (!timerPending[index]) return;
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(timerQueries[index], GL_QUERY_RESULT, &nanoseconds);
+        lastTraceMs = static_cast<float>(nanoseconds) * 1e-6f;
+        timerPending[index] = false;
+    }
+
+    void releaseTargets() {
+        if (framebuffers[0]) glDeleteFramebuffers(2, framebuffers);
+        if (textures[0]) glDeleteTextures(2, textures);
+        framebuffers[0] = framebuffers[1] = 0;
+        textures[0] = textures[1] = 0;
+        width = height = 0;
+        historyValid = false;
+    }
+};
+
+} // namespace EndViewer
+
+#endif // END_TEMPORAL_TARGET_H
@@ -2,8 +2,12 @@
 #define SIMPLEX_NOISE_H
 
 #include <cstdint>
+#include <cstddef>
 #include <cmath>
 #include <array>
+#include <algorithm>
+
+#include "SimplexNoiseSimd.h"
 
 namespace EndViewer {
 
@@ -55,6 +59,33 @@ public:
     
     double octave3D(double x, double y, double z, int octaves,
                     double persistence = 0.5, double lacunarity = 2.0) const;
+    
+    /**
+     * Batch 3D noise: out[i] = sample3D(xs[i], ys[i], zs[i])
+     * Runs the SIMD kernel when built with BASIC_ENGINE_SIMD and the CPU
+     * supports it; results are bit-identical to the scalar path.
+     * The float overload widens to double, so it matches the double path.
+     */
+    void sample3DBatch(const double* xs, const double* ys, const double* zs,
+                       double* out, size_t n) const;
+    void sample3DBatch(const float* xs, const float* ys, const float* zs,
+                       float* out, size_t n) const;
+    
+    /**
+     * Batch octave noise: out[i] = octave3D(xs[i], ys[i], zs[i], ...)
+     * Each octave runs across all lanes before the next one starts.
+     */
+    void octave3DBatch(const double* xs, const double* ys, const double* zs,
+                       double* out, size_t n, int octaves,
+                       double persistence = 0.5, double lacunarity = 2.0) const;
+    
+    /**
+     * Kernel used by the batch functions on this CPU
+     */
+    static NoiseSimdLevel simdLevel();
+    
+    // Points processed per block by the batch functions (stack scratch size)
+    static constexpr size_t BATCH_BLOCK = 256;
 
 private:
     // Gradient vectors for 3D
@@ -338,6 +369,76 @@ inline double SimplexNoise::octave3D(double x, double y, double z, int octaves,
     return total / maxValue;
 }
 
+inline NoiseSimdLevel SimplexNoise::simdLevel() {
+    static const NoiseSimdLevel level = SimplexSimd::detectLevel();
+    return level;
+}
+
+inline void SimplexNoise::sample3DBatch(const double* xs, const double* ys, const double* zs,
+                                        double* out, size_t n) const {
+    const SimplexSimd::Tables tables = {perm.data(), permMod12.data(), GRAD3, xo, yo, zo};
+    if (SimplexSimd::sample3D(simdLevel(), tables, xs, ys, zs, out, n)) {
+        return;
+    }
+    
+    for (size_t i = 0; i < n; i++) {
+        out[i] = sample3D(xs[i], ys[i], zs[i]);
+    }
+}
+
+inline void SimplexNoise::sample3DBatch(const float* xs, const float* ys, const float* zs,
+                                        float* out, size_t n) const {
+    double bx[BATCH_BLOCK], by[BATCH_BLOCK], bz[BATCH_BLOCK], result[BATCH_BLOCK];
+    
+    for (size_t base = 0; base < n; base += BATCH_BLOCK) {
+        const size_t count = std::min(BATCH_BLOCK, n - base);
+        for (size_t i = 0; i < count; i++) {
+            bx[i] = xs[base + i];
+            by[i] = ys[base + i];
+            bz[i] = zs[base + i];
+        }
+        sample3DBatch(bx, by, bz, result, count);
+        for (size_t i = 0; i < count; i++) {
+            out[base + i] = static_cast<float>(result[i]);
+        }
+    }
+}
+
+inline void SimplexNoise::octave3DBatch(const double* xs, const double* ys, const double* zs,
+                                        double* out, size_t n, int octaves,
+                                        double persistence, double lacunarity) const {
+    double sx[BATCH_BLOCK], sy[BATCH_BLOCK], sz[BATCH_BLOCK];
+    double value[BATCH_BLOCK], total[BATCH_BLOCK];
+    
+    for (size_t base = 0; base < n; base += BATCH_BLOCK) {
+        const size_t count = std::min(BATCH_BLOCK, n - base);
+        double amplitude = 1.0;
+        double frequency = 1.0;
+        double maxValue = 0.0;
+        std::fill(total, total + count, 0.0);
+        
+        // Same operation order as octave3D, so the sums match exactly
+        for (int octave = 0; octave < octaves; octave++) {
+            for (size_t i = 0; i < count; i++) {
+                sx[i] = xs[base + i] * frequency;
+                sy[i] = ys[base + i] * frequency;
+                sz[i] = zs[base + i] * frequency;
+            }
+            sample3DBatch(sx, sy, sz, value, count);
+            for (size_t i = 0; i < count; i++) {
+                total[i] += value[i] * amplitude;
+            }
+            maxValue += amplitude;
+            amplitude *= persistence;
+            frequency *= lacunarity;
+        }
+        
+        for (size_t i = 0; i < count; i++) {
+            out[base + i] = total[i] / maxValue;
+        }
+    }
+}
+
 // Define the static constexpr arrays
 constexpr double SimplexNoise::GRAD3[12][3];
 constexpr double SimplexNoise::GRAD2[8][2];
@@ -0,0 +1,367 @@
+#ifndef SIMPLEX_NOISE_SIMD_H
+#define SIMPLEX_NOISE_SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * SIMD kernels for SimplexNoise::sample3DBatch
+ *
+ * Each lane evaluates one point with exactly the operations of the scalar
+ * sample3D (same order, no fused multiply-add), so batch and scalar results
+ * are bit-identical. Only the permutation lookups stay scalar per lane:
+ * the tables are bytes, and a handful of L1 loads beats hardware gathers.
+ *
+ * - AVX2: 4 doubles per step, picked at runtime (compiled with a target
+ *   attribute, no global -mavx2 needed)
+ * - NEON (AArch64): 2 doubles per step
+ * - Scalar fallback when BASIC_ENGINE_SIMD is not defined
+ */
+
+#if defined(BASIC_ENGINE_SIMD)
+    #if defined(__x86_64__) || defined(_M_X64)
+        #define SIMPLEX_NOISE_X86 1
+        #include <immintrin.h>
+        #if defined(_MSC_VER) && !defined(__clang__)
+            #include <intrin.h>
+            #define SIMPLEX_NOISE_TARGET_AVX2
+        #else
+            #define SIMPLEX_NOISE_TARGET_AVX2 __attribute__((target("avx2")))
+        #endif
+    #elif defined(__aarch64__) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+        #define SIMPLEX_NOISE_NEON 1
+        #include <arm_neon.h>
+    #endif
+#endif
+
+namespace EndViewer {
+
+enum class NoiseSimdLevel {
+    SCALAR,
+    AVX2,
+    NEON
+};
+
+namespace SimplexSimd {
+
+/**
+ * What a kernel needs from a SimplexNoise instance
+ */
+struct Tables {
+    const uint8_t* perm;       // 512 entries
+    const uint8_t* permMod12;  // 512 entries
+    const double (*grad3)[3];  // 12 gradients
+    double xo, yo, zo;         // Origin offset
+};
+
+constexpr double F3 = 1.0 / 3.0;
+constexpr double G3 = 1.0 / 6.0;
+
+/**
+ * Gradient index of the four simplex corners of `width` lanes.
+ * ii/jj/kk are the cell coordinates masked to 255, the rest corner offsets.
+ */
+inline void hashCorners(const Tables& t, int width,
+                        const int32_t* ii, const int32_t* jj, const int32_t* kk,
+                        const int32_t* i1, const int32_t* j1, const int32_t* k1,
+                        const int32_t* i2, const int32_t* j2, const int32_t* k2,
+                        int32_t (*gi)[4]) {
+    for (int l = 0; l < width; l++) {
+        const int i = ii[l], j = jj[l], k = kk[l];
+        gi[0][l] = t.permMod12[i + t.perm[j + t.perm[k]]];
+        gi[1][l] = t.permMod12[i + i1[l] + t.perm[j + j1[l] + t.perm[k + k1[l]]]];
+        gi[2][l] = t.permMod12[i + i2[l] + t.perm[j + j2[l] + t.perm[k + k2[l]]]];
+        gi[3][l] = t.permMod12[i + 1 + t.perm[j + 1 + t.perm[k + 1]]];
+    }
+}
+
+#if defined(SIMPLEX_NOISE_X86)
+
+inline bool cpuHasAVX2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx) return false;
+    if ((_xgetbv(0) & 0x6) != 0x6) return false;  // OS saves YMM state
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+// SimplexNoise::GRAD3 padded to one 32-byte row per gradient
+alignas(32) inline constexpr double GRAD3_ROWS[12][4] = {
+    {1, 1, 0, 0}, {-1, 1, 0, 0}, {1, -1, 0, 0}, {-1, -1, 0, 0},
+    {1, 0, 1, 0}, {-1, 0, 1, 0}, {1, 0, -1, 0}, {-1, 0, -1, 0},
+    {0, 1, 1, 0}, {0, -1, 1, 0}, {0, 1, -1, 0}, {0, -1, -1, 0}
+};
+
+/**
+ * Transposed gradients of one corner: a row load per lane and a 4x4
+ * shuffle (scalar stores reloaded as a vector would stall store forwarding)
+ */
+SIMPLEX_NOISE_TARGET_AVX2
+inline void gradientsAVX2(const int32_t* gi, __m256d& gx, __m256d& gy, __m256d& gz) {
+    __m256d r0 = _mm256_load_pd(GRAD3_ROWS[gi[0]]);
+    __m256d r1 = _mm256_load_pd(GRAD3_ROWS[gi[1]]);
+    __m256d r2 = _mm256_load_pd(GRAD3_ROWS[gi[2]]);
+    __m256d r3 = _mm256_load_pd(GRAD3_ROWS[gi[3]]);
+    __m256d lo01 = _mm256_unpacklo_pd(r0, r1);  // x0 x1 z0 z1
+    __m256d hi01 = _mm256_unpackhi_pd(r0, r1);  // y0 y1 - -
+    __m256d lo23 = _mm256_unpacklo_pd(r2, r3);
+    __m256d hi23 = _mm256_unpackhi_pd(r2, r3);
+    gx = _mm256_permute2f128_pd(lo01, lo23, 0x20);
+    gy = _mm256_permute2f128_pd(hi01, hi23, 0x20);
+    gz = _mm256_permute2f128_pd(lo01, lo23, 0x31);
+}
+
+SIMPLEX_NOISE_TARGET_AVX2
+inline __m256d contributionAVX2(__m256d x, __m256d y, __m256d z, const int32_t* gi) {
+    __m256d gx, gy, gz;
+    gradientsAVX2(gi, gx, gy, gz);
+    const __m256d zero = _mm256_setzero_pd();
+    __m256d t = _mm256_sub_pd(_mm256_sub_pd(_mm256_sub_pd(_mm256_set1_pd(0.6), _mm256_mul_pd(x, x)),
+                                            _mm256_mul_pd(y, y)),
+                              _mm256_mul_pd(z, z));
+    __m256d inside = _mm256_cmp_pd(t, zero, _CMP_GE_OQ);
+    __m256d dot = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(gx, x), _mm256_mul_pd(gy, y)),
+                                _mm256_mul_pd(gz, z));
+    t = _mm256_mul_pd(t, t);
+    return _mm256_and_pd(inside, _mm256_mul_pd(_mm256_mul_pd(t, t), dot));
+}
+
+SIMPLEX_NOISE_TARGET_AVX2
+inline void sample3DAVX2(const Tables& t, const double* xs, const double* ys, const double* zs,
+                         double* out, size_t n) {
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d allSet = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    const __m256d g3 = _mm256_set1_pd(G3);
+
+    const __m128i cellMask = _mm_set1_epi32(255);
+
+    alignas(16) int32_t ii[4], jj[4], kk[4], i1[4], j1[4], k1[4], i2[4], j2[4], k2[4];
+    alignas(16) int32_t gi[4][4];
+    alignas(32) double px[4], py[4], pz[4], result[4];
+
+    for (size_t base = 0; base < n; base += 4) {
+        const int width = n - base < 4 ? static_cast<int>(n - base) : 4;
+        for (int l = 0; l < 4; l++) {
+            const size_t src = base + (l < width ? l : 0);  // Pad with a valid point
+            px[l] = xs[src];
+            py[l] = ys[src];
+            pz[l] = zs[src];
+        }
+
+        // Apply origin offset and skew
+        __m256d x = _mm256_add_pd(_mm256_load_pd(px), _mm256_set1_pd(t.xo));
+        __m256d y = _mm256_add_pd(_mm256_load_pd(py), _mm256_set1_pd(t.yo));
+        __m256d z = _mm256_add_pd(_mm256_load_pd(pz), _mm256_set1_pd(t.zo));
+        __m256d s = _mm256_mul_pd(_mm256_add_pd(_mm256_add_pd(x, y), z), _mm256_set1_pd(F3));
+        __m256d i = _mm256_floor_pd(_mm256_add_pd(x, s));
+        __m256d j = _mm256_floor_pd(_mm256_add_pd(y, s));
+        __m256d k = _mm256_floor_pd(_mm256_add_pd(z, s));
+
+        // Unskew
+        __m256d u = _mm256_mul_pd(_mm256_add_pd(_mm256_add_pd(i, j), k), g3);
+        __m256d x0 = _mm256_sub_pd(x, _mm256_sub_pd(i, u));
+        __m256d y0 = _mm256_sub_pd(y, _mm256_sub_pd(j, u));
+        __m256d z0 = _mm256_sub_pd(z, _mm256_sub_pd(k, u));
+
+        // Simplex corner offsets, the scalar branch tree as masks
+        __m256d a = _mm256_cmp_pd(x0, y0, _CMP_GE_OQ);
+        __m256d b = _mm256_cmp_pd(y0, z0, _CMP_GE_OQ);
+        __m256d c = _mm256_cmp_pd(x0, z0, _CMP_GE_OQ);
+        __m256d notA = _mm256_xor_pd(a, allSet);
+        __m256d notB = _mm256_xor_pd(b, allSet);
+        __m256d notC = _mm256_xor_pd(c, allSet);
+        __m256d mi1 = _mm256_and_pd(a, _mm256_or_pd(b, c));
+        __m256d mj1 = _mm256_and_pd(notA, b);
+        __m256d mk1 = _mm256_blendv_pd(notB, _mm256_and_pd(notB, notC), a);
+        __m256d mi2 = _mm256_or_pd(a, _mm256_and_pd(b, c));
+        __m256d mj2 = _mm256_or_pd(notA, b);
+        __m256d mk2 = _mm256_or_pd(notB, _mm256_and_pd(notA, notC));
+
+        __m256d di1 = _mm256_and_pd(mi1, one), dj1 = _mm256_and_pd(mj1, one), dk1 = _mm256_and_pd(mk1, one);
+        __m256d di2 = _mm256_and_pd(mi2, one), dj2 = _mm256_and_pd(mj2, one), dk2 = _mm256_and_pd(mk2, one);
+
+        // Hash inputs as int32 (cells are already floored, so truncation is exact)
+        _mm_store_si128(reinterpret_cast<__m128i*>(ii), _mm_and_si128(_mm256_cvttpd_epi32(i), cellMask));
+        _mm_store_si128(reinterpret_cast<__m128i*>(jj), _mm_and_si128(_mm256_cvttpd_epi32(j), cellMask));
+        _mm_store_si128(reinterpret_cast<__m128i*>(kk), _mm_and_si128(_mm256_cvttpd_epi32(k), cellMask));
+        _mm_store_si128(reinterpret_cast<__m128i*>(i1), _mm256_cvttpd_epi32(di1));
+        _mm_store_si128(reinterpret_cast<__m128i*>(j1), _mm256_cvttpd_epi32(dj1));
+        _mm_store_si128(reinterpret_cast<__m128i*>(k1), _mm256_cvttpd_epi32(dk1));
+        _mm_store_si128(reinterpret_cast<__m128i*>(i2), _mm256_cvttpd_epi32(di2));
+        _mm_store_si128(reinterpret_cast<__m128i*>(j2), _mm256_cvttpd_epi32(dj2));
+        _mm_store_si128(reinterpret_cast<__m128i*>(k2), _mm256_cvttpd_epi32(dk2));
+        hashCorners(t, 4, ii, jj, kk, i1, j1, k1, i2, j2, k2, gi);
+
+        // Remaining corners
+        __m256d x1 = _mm256_add_pd(_mm256_sub_pd(x0, di1), g3);
+        __m256d y1 = _mm256_add_pd(_mm256_sub_pd(y0, dj1), g3);
+        __m256d z1 = _mm256_add_pd(_mm256_sub_pd(z0, dk1), g3);
+        __m256d x2 = _mm256_add_pd(_mm256_sub_pd(x0, di2), _mm256_set1_pd(2.0 * G3));
+        __m256d y2 = _mm256_add_pd(_mm256_sub_pd(y0, dj2), _mm256_set1_pd(2.0 * G3));
+        __m256d z2 = _mm256_add_pd(_mm256_sub_pd(z0, dk2), _mm256_set1_pd(2.0 * G3));
+        __m256d x3 = _mm256_add_pd(_mm256_sub_pd(x0, one), _mm256_set1_pd(3.0 * G3));
+        __m256d y3 = _mm256_add_pd(_mm256_sub_pd(y0, one), _mm256_set1_pd(3.0 * G3));
+        __m256d z3 = _mm256_add_pd(_mm256_sub_pd(z0, one), _mm256_set1_pd(3.0 * G3));
+
+        __m256d sum = contributionAVX2(x0, y0, z0, gi[0]);
+        sum = _mm256_add_pd(sum, contributionAVX2(x1, y1, z1, gi[1]));
+        sum = _mm256_add_pd(sum, contributionAVX2(x2, y2, z2, gi[2]));
+        sum = _mm256_add_pd(sum, contributionAVX2(x3, y3, z3, gi[3]));
+        _mm256_store_pd(result, _mm256_mul_pd(_mm256_set1_pd(32.0), sum));
+
+        for (int l = 0; l < width; l++) {
+            out[base + l] = result[l];
+        }
+    }
+}
+
+#endif  // SIMPLEX_NOISE_X86
+
+#if defined(SIMPLEX_NOISE_NEON)
+
+inline float64x2_t contributionNEON(const Tables& t, float64x2_t x, float64x2_t y, float64x2_t z,
+                                    const int32_t* gi) {
+    const double* g0 = t.grad3[gi[0]];
+    const double* g1 = t.grad3[gi[1]];
+    float64x2_t gx = vcombine_f64(vld1_f64(g0 + 0), vld1_f64(g1 + 0));
+    float64x2_t gy = vcombine_f64(vld1_f64(g0 + 1), vld1_f64(g1 + 1));
+    float64x2_t gz = vcombine_f64(vld1_f64(g0 + 2), vld1_f64(g1 + 2));
+
+    float64x2_t r = vsubq_f64(vsubq_f64(vsubq_f64(vdupq_n_f64(0.6), vmulq_f64(x, x)),
+                                        vmulq_f64(y, y)),
+                              vmulq_f64(z, z));
+    uint64x2_t inside = vcgeq_f64(r, vdupq_n_f64(0.0));
+    float64x2_t dot = vaddq_f64(vaddq_f64(vmulq_f64(gx, x), vmulq_f64(gy, y)), vmulq_f64(gz, z));
+    r = vmulq_f64(r, r);
+    float64x2_t n = vmulq_f64(vmulq_f64(r, r), dot);
+    return vreinterpretq_f64_u64(vandq_u64(inside, vreinterpretq_u64_f64(n)));
+}
+
+inline void sample3DNEON(const Tables& t, const double* xs, const double* ys, const double* zs,
+                         double* out, size_t n) {
+    const float64x2_t one = vdupq_n_f64(1.0);
+    const float64x2_t g3 = vdupq_n_f64(G3);
+    const int32x2_t cellMask = vdup_n_s32(255);
+
+    int32_t ii[2], jj[2], kk[2], i1[2], j1[2], k1[2], i2[2], j2[2], k2[2];
+    int32_t gi[4][4];
+    double px[2], py[2], pz[2], result[2];
+
+    auto toOne = [&](uint64x2_t mask) {
+        return vreinterpretq_f64_u64(vandq_u64(mask, vreinterpretq_u64_f64(one)));
+    };
+    auto toInt = [](float64x2_t v) { return vmovn_s64(vcvtq_s64_f64(v)); };
+
+    for (size_t base = 0; base < n; base += 2) {
+        const int width = n - base < 2 ? static_cast<int>(n - base) : 2;
+        for (int l = 0; l < 2; l++) {
+            const size_t src = base + (l < width ? l : 0);
+            px[l] = xs[src];
+            py[l] = ys[src];
+            pz[l] = zs[src];
+        }
+
+        float64x2_t x = vaddq_f64(vld1q_f64(px), vdupq_n_f64(t.xo));
+        float64x2_t y = vaddq_f64(vld1q_f64(py), vdupq_n_f64(t.yo));
+        float64x2_t z = vaddq_f64(vld1q_f64(pz), vdupq_n_f64(t.zo));
+        float64x2_t s = vmulq_f64(vaddq_f64(vaddq_f64(x, y), z), vdupq_n_f64(F3));
+        float64x2_t i = vrndmq_f64(vaddq_f64(x, s));
+        float64x2_t j = vrndmq_f64(vaddq_f64(y, s));
+        float64x2_t k = vrndmq_f64(vaddq_f64(z, s));
+
+        float64x2_t u = vmulq_f64(vaddq_f64(vaddq_f64(i, j), k), g3);
+        float64x2_t x0 = vsubq_f64(x, vsubq_f64(i, u));
+        float64x2_t y0 = vsubq_f64(y, vsubq_f64(j, u));
+        float64x2_t z0 = vsubq_f64(z, vsubq_f64(k, u));
+
+        uint64x2_t a = vcgeq_f64(x0, y0);
+        uint64x2_t b = vcgeq_f64(y0, z0);
+        uint64x2_t c = vcgeq_f64(x0, z0);
+        uint64x2_t notA = vreinterpretq_u64_u32(vmvnq_u32(vreinterpretq_u32_u64(a)));
+        uint64x2_t notB = vreinterpretq_u64_u32(vmvnq_u32(vreinterpretq_u32_u64(b)));
+        uint64x2_t notC = vreinterpretq_u64_u32(vmvnq_u32(vreinterpretq_u32_u64(c)));
+        float64x2_t di1 = toOne(vandq_u64(a, vorrq_u64(b, c)));
+        float64x2_t dj1 = toOne(vandq_u64(notA, b));
+        float64x2_t dk1 = toOne(vbslq_u64(a, vandq_u64(notB, notC), notB));
+        float64x2_t di2 = toOne(vorrq_u64(a, vandq_u64(b, c)));
+        float64x2_t dj2 = toOne(vorrq_u64(notA, b));
+        float64x2_t dk2 = toOne(vorrq_u64(notB, vandq_u64(notA, notC)));
+
+        vst1_s32(ii, vand_s32(toInt(i), cellMask));
+        vst1_s32(jj, vand_s32(toInt(j), cellMask));
+        vst1_s32(kk, vand_s32(toInt(k), cellMask));
+        vst1_s32(i1, toInt(di1));
+        vst1_s32(j1, toInt(dj1));
+        vst1_s32(k1, toInt(dk1));
+        vst1_s32(i2, toInt(di2));
+        vst1_s32(j2, toInt(dj2));
+        vst1_s32(k2, toInt(dk2));
+        hashCorners(t, 2, ii, jj, kk, i1, j1, k1, i2, j2, k2, gi);
+
+        float64x2_t x1 = vaddq_f64(vsubq_f64(x0, di1), g3);
+        float64x2_t y1 = vaddq_f64(vsubq_f64(y0, dj1), g3);
+        float64x2_t z1 = vaddq_f64(vsubq_f64(z0, dk1), g3);
+        float64x2_t x2 = vaddq_f64(vsubq_f64(x0, di2), vdupq_n_f64(2.0 * G3));
+        float64x2_t y2 = vaddq_f64(vsubq_f64(y0, dj2), vdupq_n_f64(2.0 * G3));
+        float64x2_t z2 = vaddq_f64(vsubq_f64(z0, dk2), vdupq_n_f64(2.0 * G3));
+        float64x2_t x3 = vaddq_f64(vsubq_f64(x0, one), vdupq_n_f64(3.0 * G3));
+        float64x2_t y3 = vaddq_f64(vsubq_f64(y0, one), vdupq_n_f64(3.0 * G3));
+        float64x2_t z3 = vaddq_f64(vsubq_f64(z0, one), vdupq_n_f64(3.0 * G3));
+
+        float64x2_t sum = contributionNEON(t, x0, y0, z0, gi[0]);
+        sum = vaddq_f64(sum, contributionNEON(t, x1, y1, z1, gi[1]));
+        sum = vaddq_f64(sum, contributionNEON(t, x2, y2, z2, gi[2]));
+        sum = vaddq_f64(sum, contributionNEON(t, x3, y3, z3, gi[3]));
+        vst1q_f64(result, vmulq_f64(vdupq_n_f64(32.0), sum));
+
+        for (int l = 0; l < width; l++) {
+            out[base + l] = result[l];
+        }
+    }
+}
+
+#endif  // SIMPLEX_NOISE_NEON
+
+/**
+ * Best kernel this CPU can run
+ */
+inline NoiseSimdLevel detectLevel() {
+#if defined(SIMPLEX_NOISE_X86)
+    return cpuHasAVX2() ? NoiseSimdLevel::AVX2 : NoiseSimdLevel::SCALAR;
+#elif defined(SIMPLEX_NOISE_NEON)
+    return NoiseSimdLevel::NEON;
+#else
+    return NoiseSimdLevel::SCALAR;
+#endif
+}
+
+/**
+ * Run the kernel for level; returns false if it is not compiled in (the
+ * caller then falls back to scalar sample3D)
+ */
+inline bool sample3D(NoiseSimdLevel level, const Tables& t,
+                     const double* xs, const double* ys, const double* zs, double* out, size_t n) {
+    switch (level) {
+#if defined(SIMPLEX_NOISE_X86)
+        case NoiseSimdLevel::AVX2: sample3DAVX2(t, xs, ys, zs, out, n); return true;
+#endif
+#if defined(SIMPLEX_NOISE_NEON)
+        case NoiseSimdLevel::NEON: sample3DNEON(t, xs, ys, zs, out, n); return true;
+#endif
+        default:
+            (void)t; (void)xs; (void)ys; (void)zs; (void)out; (void)n;
+            return false;
+    }
+}
+
+}  // namespace SimplexSimd
+}  // namespace EndViewer
+
+#endif  // SIMPLEX_NOISE_SIMD_H
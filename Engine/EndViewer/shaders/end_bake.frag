@@ -0,0 +1,19 @@
+#version 330 core
+
+// Bakes one 16x16 layer of a density brick into the EndBrickCache atlas.
+// The viewport covers the brick's slot, so each fragment is one voxel.
+
+layout(location = 0) out float Density;
+
+uniform ivec3 uBrickMin;        // World block coordinates of the brick's corner
+uniform ivec2 uViewportOrigin;  // Slot corner in the atlas layer
+uniform int uLayer;             // Voxel z inside the brick
+
+#include "end_density.glsl"
+
+void main() {
+    // gl_FragCoord sits on texel centers, so voxels sample block centers
+    vec2 local = gl_FragCoord.xy - vec2(uViewportOrigin);
+    vec3 worldPos = vec3(uBrickMin) + vec3(local, float(uLayer) + 0.5);
+    Density = endDensity(worldPos);
+}
@@ -0,0 +1,10 @@
+#version 330 core
+
+// Pass-through quad for the offscreen passes (density bricks, island table,
+// temporal resolve)
+
+layout(location = 0) in vec2 aPos;  // Clip-space position (-1 to 1)
+
+void main() {
+    gl_Position = vec4(aPos, 0.0, 1.0);
+}
@@ -0,0 +1,21 @@
+#version 330 core
+
+// Reduces one freshly baked EndBrickCache brick to its maximum density. The
+// ray marcher skips bricks whose maximum is <= 0 (all air).
+
+layout(location = 0) out float MaxDensity;
+
+uniform sampler3D uDensityAtlas;
+uniform ivec3 uSlotOrigin;  // First texel of the brick in the atlas
+
+void main() {
+    float maxDensity = -65504.0;
+    for (int z = 0; z < 16; z++) {
+        for (int y = 0; y < 16; y++) {
+            for (int x = 0; x < 16; x++) {
+                maxDensity = max(maxDensity, texelFetch(uDensityAtlas, uSlotOrigin + ivec3(x, y, z), 0).r);
+            }
+        }
+    }
+    MaxDensity = maxDensity;
+}
@@ -0,0 +1,331 @@
+// end_density.glsl
+// End terrain density shared by the ray marcher and the brick cache and
+// island table bakers.
+// Pulled in with #include "end_density.glsl" (see Engine::Common::ShaderProgram).
+
+uniform int uOctaves;             // Noise octaves (LOD-adjusted)
+
+// ============================================================================
+// NOISE FUNCTIONS
+// ============================================================================
+
+// Skewing factors
+const float F2 = 0.36602540378;
+const float G2 = 0.21132486540;
+const float F3 = 0.33333333333;
+const float G3 = 0.16666666667;
+
+// Hash function for gradient generation
+vec3 hash3(vec3 p) {
+    p = vec3(dot(p, vec3(127.1, 311.7, 74.7)),
+             dot(p, vec3(269.5, 183.3, 246.1)),
+             dot(p, vec3(113.5, 271.9, 124.6)));
+    return -1.0 + 2.0 * fract(sin(p) * 43758.5453);
+}
+
+vec2 hash2(vec2 p) {
+    p = vec2(dot(p, vec2(127.1, 311.7)),
+             dot(p, vec2(269.5, 183.3)));
+    return -1.0 + 2.0 * fract(sin(p) * 43758.5453);
+}
+
+// 3D Simplex noise
+float simplex3D(vec3 p) {
+    // Skew
+    float s = (p.x + p.y + p.z) * F3;
+    vec3 i = floor(p + s);
+    float t = (i.x + i.y + i.z) * G3;
+    vec3 x0 = p - (i - t);
+    
+    // Simplex corners
+    vec3 i1, i2;
+    if (x0.x >= x0.y) {
+        if (x0.y >= x0.z) { i1 = vec3(1,0,0); i2 = vec3(1,1,0); }
+        else if (x0.x >= x0.z) { i1 = vec3(1,0,0); i2 = vec3(1,0,1); }
+        else { i1 = vec3(0,0,1); i2 = vec3(1,0,1); }
+    } else {
+        if (x0.y < x0.z) { i1 = vec3(0,0,1); i2 = vec3(0,1,1); }
+        else if (x0.x < x0.z) { i1 = vec3(0,1,0); i2 = vec3(0,1,1); }
+        else { i1 = vec3(0,1,0); i2 = vec3(1,1,0); }
+    }
+    
+    vec3 x1 = x0 - i1 + G3;
+    vec3 x2 = x0 - i2 + 2.0*G3;
+    vec3 x3 = x0 - 1.0 + 3.0*G3;
+    
+    // Gradients
+    vec3 g0 = hash3(i);
+    vec3 g1 = hash3(i + i1);
+    vec3 g2 = hash3(i + i2);
+    vec3 g3 = hash3(i + 1.0);
+    
+    // Contributions
+    vec4 w = max(0.6 - vec4(dot(x0,x0), dot(x1,x1), dot(x2,x2), dot(x3,x3)), 0.0);
+    w = w * w * w * w;
+    
+    return 32.0 * (w.x * dot(g0, x0) + w.y * dot(g1, x1) + 
+                   w.z * dot(g2, x2) + w.w * dot(g3, x3));
+}
+
+// 2D Simplex noise
+float simplex2D(vec2 p) {
+    float s = (p.x + p.y) * F2;
+    vec2 i = floor(p + s);
+    float t = (i.x + i.y) * G2;
+    vec2 x0 = p - (i - t);
+    
+    vec2 i1 = (x0.x > x0.y) ? vec2(1.0, 0.0) : vec2(0.0, 1.0);
+    vec2 x1 = x0 - i1 + G2;
+    vec2 x2 = x0 - 1.0 + 2.0 * G2;
+    
+    vec2 g0 = hash2(i);
+    vec2 g1 = hash2(i + i1);
+    vec2 g2 = hash2(i + 1.0);
+    
+    vec3 w = max(0.5 - vec3(dot(x0,x0), dot(x1,x1), dot(x2,x2)), 0.0);
+    w = w * w * w * w;
+    
+    return 70.0 * (w.x * dot(g0, x0) + w.y * dot(g1, x1) + w.z * dot(g2, x2));
+}
+
+// Octave noise (FBM)
+float fbm3D(vec3 p, int octaves) {
+    float value = 0.0;
+    float amplitude = 1.0;
+    float frequency = 1.0;
+    float maxValue = 0.0;
+    
+    for (int i = 0; i < octaves; i++) {
+        value += simplex3D(p * frequency) * amplitude;
+        maxValue += amplitude;
+        amplitude *= 0.5;
+        frequency *= 2.0;
+    }
+    
+    return value / maxValue;
+}
+
+// ============================================================================
+// END TERRAIN DENSITY FUNCTION
+// ============================================================================
+
+const float MAIN_ISLAND_RADIUS = 500.0;
+const float EXCLUSION_ZONE_START = 500.0;
+const float EXCLUSION_ZONE_END = 1024.0;
+const float SEA_LEVEL = 64.0;
+
+// Height profile for main island
+float mainIslandHeight(float dist) {
+    if (dist > MAIN_ISLAND_RADIUS) return -100.0;
+    
+    float t = dist / MAIN_ISLAND_RADIUS;
+    float falloff = cos(t * 3.14159265 * 0.5);
+    falloff = falloff * falloff;
+    
+    return 40.0 * falloff;
+}
+
+// Main island density
+float mainIslandDensity(vec3 pos, float horizDist) {
+    float heightAtDist = mainIslandHeight(horizDist);
+    float baseDensity = heightAtDist - (pos.y - SEA_LEVEL);
+    
+    // Add terrain noise
+    float noise = fbm3D(pos * 0.02, uOctaves);
+    baseDensity += noise * 8.0;
+    
+    // Detail noise
+    float detail = simplex3D(pos * 0.05) * 2.0;
+    baseDensity += detail;
+    
+    // Floor cutoff
+    if (pos.y < 4.0) {
+        baseDensity -= (4.0 - pos.y) * 2.0;
+    }
+    
+    return baseDensity;
+}
+
+// Check if position is in outer island region
+bool shouldHaveIsland(vec2 chunkPos) {
+    float dist = length(chunkPos * 16.0);
+    if (dist <= EXCLUSION_ZONE_END) return false;
+    
+    float noise = simplex2D(chunkPos * 0.5);
+    float threshold = -0.8 + (dist / 3000.0);
+    threshold = clamp(threshold, -0.8, -0.5);
+    
+    return noise < threshold;
+}
+
+// Island descriptor for a chunk: xy = center offset from the chunk's corner,
+// z = radius, w = height. Radius 0 means the chunk has no island.
+vec4 computeIsland(vec2 chunkPos) {
+    if (!shouldHaveIsland(chunkPos)) return vec4(0.0);
+    
+    // Island center with variation
+    vec2 offset = vec2(
+        simplex2D(chunkPos * 0.7 + vec2(0.0, 100.0)) * 6.0,
+        simplex2D(chunkPos * 0.3 + vec2(100.0, 0.0)) * 6.0
+    );
+    
+    // Island properties
+    float sizeNoise = simplex2D(chunkPos * 0.5);
+    float radius = 20.0 + sizeNoise * 15.0;
+    float height = 10.0 + sizeNoise * 10.0;
+    
+    return vec4(offset + 8.0, radius, height);
+}
+
+// ============================================================================
+// ISLAND TABLE
+// ============================================================================
+
+// computeIsland() baked per chunk by EndIslandTable around the camera. The
+// table is toroidal like the brick cache: chunk c lives in texel
+// mod(c, uIslandTableSize). Shaders that leave uIslandTableEnabled unset
+// (false) always evaluate the noise.
+uniform bool uIslandTableEnabled;
+uniform sampler2D uIslandTable;   // RGBA32F, one texel per chunk column
+uniform ivec2 uIslandTableMin;    // First chunk (x, z) in the table
+uniform int uIslandTableSize;     // Chunks per axis
+
+vec4 islandDescriptor(vec2 chunkPos) {
+    if (uIslandTableEnabled) {
+        vec2 local = chunkPos - vec2(uIslandTableMin);
+        float size = float(uIslandTableSize);
+        if (all(greaterThanEqual(local, vec2(0.0))) && all(lessThan(local, vec2(size)))) {
+            return texelFetch(uIslandTable, ivec2(mod(chunkPos, size)), 0);
+        }
+    }
+    return computeIsland(chunkPos);
+}
+
+// Outer island density
+float outerIslandDensity(vec3 pos, float horizDist) {
+    // Quick rejection
+    if (horizDist < EXCLUSION_ZONE_END) return -1.0;
+    
+    vec2 chunkPos = floor(pos.xz / 16.0);
+    float maxDensity = -1.0;
+    
+    // Check 3x3 chunk neighborhood
+    for (int dx = -1; dx <= 1; dx++) {
+        for (int dz = -1; dz <= 1; dz++) {
+            vec2 checkChunk = chunkPos + vec2(dx, dz);
+            vec4 island = islandDescriptor(checkChunk);
+            
+            if (island.z > 0.0) {
+                vec2 islandCenter = checkChunk * 16.0 + island.xy;
+                float radius = island.z;
+                float height = island.w;
+                
+                // Distance to this island
+                vec2 toIsland = pos.xz - islandCenter;
+                float islandDist = length(toIsland);
+                
+                if (islandDist < radius * 1.5) {
+                    float normDist = islandDist / radius;
+                    float maxH = height * max(0.0, 1.0 - normDist * normDist);
+                    
+                    float density = maxH - abs(pos.y - SEA_LEVEL);
+                    
+                    // Add noise
+                    density += fbm3D(pos * 0.08 + vec3(islandCenter.x, 0.0, islandCenter.y) * 0.01, 
+                                     max(1, uOctaves - 1)) * 4.0;
+                    
+                    // Edge falloff
+                    float edge = 1.0 - smoothstep(0.7, 1.0, normDist);
+                    density *= edge;
+                    
+                    maxDensity = max(maxDensity, density);
+                }
+            }
+        }
+    }
+    
+    return maxDensity;
+}
+
+// Main density function
+float endDensity(vec3 worldPos) {
+    float horizDist = length(worldPos.xz);
+    
+    if (horizDist < EXCLUSION_ZONE_START) {
+        return mainIslandDensity(worldPos, horizDist);
+    }
+    
+    if (horizDist < EXCLUSION_ZONE_END) {
+        return -1.0;  // Exclusion zone
+    }
+    
+    return outerIslandDensity(worldPos, horizDist);
+}
+
+// ============================================================================
+// EMPTY SPACE BOUNDS
+// ============================================================================
+
+// Conservative distance along a ray that is guaranteed to be air, derived from
+// the structure of endDensity() rather than its value (the density is not a
+// distance field). Keep in sync with the functions above. The noise margins
+// cover simplex peaks with non-unit gradients (|simplex3D| < 1.75,
+// |simplex2D| < 1.45).
+
+const float MAIN_NOISE_MARGIN = 18.0;     // fbm3D * 8 + simplex3D * 2
+const float MAIN_FLOOR_Y = -120.0;        // Lowest solid y under the dome
+const float MAIN_DOME_LIPSCHITZ = 1.008;  // sqrt(1 + max|d height / d dist|^2)
+const float ISLAND_NOISE_MARGIN = 7.0;    // fbm3D * 4
+const float ISLAND_BAND = 32.0;           // Max island height + noise margin
+
+// Main island: solid only inside r < 500, MAIN_FLOOR_Y < y < dome top. The
+// dome top has a bounded slope, so dividing by its Lipschitz constant turns
+// the height difference into a distance.
+float mainIslandBound(vec3 pos, float horizDist) {
+    float top = SEA_LEVEL + mainIslandHeight(min(horizDist, MAIN_ISLAND_RADIUS)) + MAIN_NOISE_MARGIN;
+    float side = horizDist - MAIN_ISLAND_RADIUS;
+    float above = (pos.y - top) / MAIN_DOME_LIPSCHITZ;
+    float below = MAIN_FLOOR_Y - pos.y;
+    return max(side, max(above, below));
+}
+
+// Outer islands: the exclusion ring and everything outside the island band
+// is air; inside it, only the capped cylinders of the islands in the 3x3
+// chunk neighborhood can be solid. That neighborhood is only fixed while the
+// ray stays in its chunk column, so the per-island bound is clamped to the
+// column's exit.
+float outerIslandBound(vec3 pos, vec3 rayDir, float horizDist) {
+    float band = max(EXCLUSION_ZONE_END - horizDist, abs(pos.y - SEA_LEVEL) - ISLAND_BAND);
+    if (band > 0.0) return band;
+    
+    vec2 chunkPos = floor(pos.xz / 16.0);
+    vec2 cellMin = chunkPos * 16.0;
+    vec2 dir = rayDir.xz;
+    vec2 exitT = (cellMin + step(0.0, dir) * 16.0 - pos.xz) / max(abs(dir), vec2(1e-6)) * sign(dir);
+    exitT = mix(vec2(1e9), exitT, greaterThan(abs(dir), vec2(1e-6)));
+    float bound = min(exitT.x, exitT.y) + 0.01;
+    
+    for (int dx = -1; dx <= 1; dx++) {
+        for (int dz = -1; dz <= 1; dz++) {
+            vec2 checkChunk = chunkPos + vec2(dx, dz);
+            vec4 island = islandDescriptor(checkChunk);
+            if (island.z > 0.0) {
+                vec2 toIsland = pos.xz - (checkChunk * 16.0 + island.xy);
+                vec2 outside = vec2(length(toIsland) - island.z,
+                                    abs(pos.y - SEA_LEVEL) - (island.w + ISLAND_NOISE_MARGIN));
+                bound = min(bound, length(max(outside, 0.0)));
+            }
+        }
+    }
+    
+    return max(band, bound);
+}
+
+// Distance the ray can advance from worldPos without entering terrain
+// (0 when worldPos may be solid)
+float emptySpaceBound(vec3 worldPos, vec3 rayDir) {
+    float horizDist = length(worldPos.xz);
+    float bound = min(mainIslandBound(worldPos, horizDist),
+                      outerIslandBound(worldPos, rayDir, horizDist));
+    return max(bound, 0.0);
+}
@@ -0,0 +1,61 @@
+#version 330 core
+
+// Outer island impostor fragment shader (EndIslandImpostors)
+// Traces an ellipsoid with the island's radius and height, writes its
+// depth, and shades it like end_mesh.frag
+
+in vec3 vLocalPos;
+flat in vec3 vCenter;
+flat in vec2 vRadii;
+
+out vec4 FragColor;
+
+uniform mat4 uViewProj;
+uniform vec3 uCameraPos;          // Camera position (chunk-relative)
+uniform ivec3 uChunkOrigin;       // Camera chunk, for the world-space color variation
+uniform vec3 uEndStoneColor;
+uniform vec3 uFogColor;
+uniform float uFogDensity;
+uniform vec2 uFadeIn;             // Where impostors take over from meshes (end_lod_fade.glsl)
+
+#include "end_density.glsl"
+#include "end_lod_fade.glsl"
+
+void main() {
+    // Ray against the ellipsoid, in the space where it is a unit sphere
+    vec3 radii = vec3(vRadii.x, vRadii.y, vRadii.x);
+    vec3 rayDir = normalize(vLocalPos - uCameraPos);
+    vec3 origin = (uCameraPos - vCenter) / radii;
+    vec3 dir = rayDir / radii;
+    float a = dot(dir, dir);
+    float b = dot(origin, dir);
+    float c = dot(origin, origin) - 1.0;
+    float discriminant = b * b - a * c;
+    if (discriminant < 0.0) discard;
+    float t = (-b - sqrt(discriminant)) / a;
+    if (t < 0.0) discard;
+
+    vec3 hit = uCameraPos + rayDir * t;
+    if (lodFadeDiscard(length(hit.xz - uCameraPos.xz), uFadeIn, vec2(0.0))) discard;
+
+    vec4 clip = uViewProj * vec4(hit, 1.0);
+    gl_FragDepth = clamp(clip.z / clip.w * 0.5 + 0.5, 0.0, 1.0);
+
+    vec3 normal = normalize((hit - vCenter) / (radii * radii));
+    vec3 worldPos = hit + vec3(uChunkOrigin) * 16.0;
+
+    // Simple directional lighting from above
+    vec3 lightDir = normalize(vec3(0.3, 1.0, 0.2));
+    float diffuse = max(dot(normal, lightDir), 0.0);
+
+    vec3 color = uEndStoneColor;
+    float variation = simplex3D(worldPos * 0.03) * 0.1;
+    color += vec3(variation, variation * 0.5, 0.0);
+    color *= 0.3 + diffuse * 0.7;
+
+    // Distance fog
+    float fogFactor = 1.0 - exp(-t * uFogDensity * 0.0001);
+    color = mix(color, uFogColor, fogFactor);
+
+    FragColor = vec4(color, 1.0);
+}
@@ -0,0 +1,32 @@
+#version 330 core
+
+// Outer island impostor vertex shader (EndIslandImpostors)
+// One camera-facing quad per island, large enough to hold its ellipsoid;
+// the fragment shader traces the ellipsoid itself
+
+layout(location = 0) in vec2 aCorner;   // Quad corner, -1..1
+layout(location = 1) in vec4 aIsland;   // Center x, z (relative to the anchor), radius, height
+
+uniform mat4 uViewProj;      // Projection * view (EndCamera, relative to uChunkOrigin)
+uniform vec3 uCameraPos;     // Camera position (chunk-relative)
+uniform vec3 uAnchorOffset;  // Instance anchor minus the camera's chunk origin, in blocks
+uniform float uSeaLevel;     // Island centers sit at sea level
+
+out vec3 vLocalPos;          // Quad point relative to the camera's chunk origin
+flat out vec3 vCenter;
+flat out vec2 vRadii;        // Horizontal radius, half height
+
+void main() {
+    vec3 center = vec3(aIsland.x, uSeaLevel, aIsland.y) + uAnchorOffset;
+    vec3 toCamera = normalize(uCameraPos - center);
+    vec3 side = abs(toCamera.y) > 0.99 ? vec3(1.0, 0.0, 0.0) : vec3(0.0, 1.0, 0.0);
+    vec3 right = normalize(cross(side, toCamera));
+    vec3 up = cross(toCamera, right);
+
+    // Bounding sphere of the ellipsoid, slightly enlarged for perspective
+    float extent = max(aIsland.z, aIsland.w) * 1.15;
+    vLocalPos = center + (right * aCorner.x + up * aCorner.y) * extent;
+    vCenter = center;
+    vRadii = aIsland.zw;
+    gl_Position = uViewProj * vec4(vLocalPos, 1.0);
+}
@@ -0,0 +1,20 @@
+#version 330 core
+
+// Bakes outer island descriptors into the EndIslandTable texture. The
+// viewport covers the texels being refreshed; each fragment is one chunk
+// column (x, z).
+
+layout(location = 0) out vec4 Island;
+
+uniform ivec2 uRegionMin;   // First chunk of the table region
+uniform ivec2 uRegionSlot;  // uRegionMin mod table size (texel of uRegionMin)
+uniform int uTableSize;     // Chunks per axis
+
+#include "end_density.glsl"
+
+void main() {
+    // Walk from the region's first texel to this one, wrapping around
+    ivec2 offset = ivec2(gl_FragCoord.xy) - uRegionSlot;
+    offset += ivec2(lessThan(offset, ivec2(0))) * uTableSize;
+    Island = computeIsland(vec2(uRegionMin + offset));
+}
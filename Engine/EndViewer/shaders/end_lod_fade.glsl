@@ -0,0 +1,24 @@
+// Dithered crossfade between LOD levels (EndChunkStreamer)
+// Within a band of horizontal distance from the camera, the finer level
+// keeps a pixel exactly where the coarser one drops it (same threshold),
+// so the handover shows neither holes nor double surfaces
+
+// Ordered 4x4 dither threshold in (0, 1)
+float lodDitherThreshold() {
+    const float bayer[16] = float[16](
+         0.0,  8.0,  2.0, 10.0,
+        12.0,  4.0, 14.0,  6.0,
+         3.0, 11.0,  1.0,  9.0,
+        15.0,  7.0, 13.0,  5.0);
+    ivec2 p = ivec2(gl_FragCoord.xy) & 3;
+    return (bayer[p.y * 4 + p.x] + 0.5) / 16.0;
+}
+
+// fadeIn / fadeOut: distance band (start, end) where the level takes over
+// from the finer one / hands over to the coarser one; end <= 0 disables it
+bool lodFadeDiscard(float distance, vec2 fadeIn, vec2 fadeOut) {
+    float keepAbove = 1.0 - lodDitherThreshold();
+    if (fadeOut.y > 0.0 && smoothstep(fadeOut.x, fadeOut.y, distance) >= keepAbove) return true;
+    if (fadeIn.y > 0.0 && smoothstep(fadeIn.x, fadeIn.y, distance) <= keepAbove) return true;
+    return false;
+}
@@ -0,0 +1,44 @@
+#version 330 core
+
+// End chunk mesh fragment shader (EndChunkStreamer)
+// Lighting and fog follow shade() in end_raymarch.frag so both render modes
+// look alike
+
+in vec3 vLocalPos;
+in vec3 vNormal;
+
+out vec4 FragColor;
+
+uniform vec3 uCameraPos;          // Camera position (chunk-relative)
+uniform ivec3 uChunkOrigin;       // Camera chunk, for the world-space color variation
+uniform vec3 uEndStoneColor;
+uniform vec3 uFogColor;
+uniform float uFogDensity;
+uniform vec2 uFadeIn;             // LOD crossfade bands (end_lod_fade.glsl)
+uniform vec2 uFadeOut;
+
+#include "end_density.glsl"
+#include "end_lod_fade.glsl"
+
+void main() {
+    if (lodFadeDiscard(length(vLocalPos.xz - uCameraPos.xz), uFadeIn, uFadeOut)) discard;
+    
+    vec3 normal = normalize(vNormal);
+    vec3 worldPos = vLocalPos + vec3(uChunkOrigin) * 16.0;
+    
+    // Simple directional lighting from above
+    vec3 lightDir = normalize(vec3(0.3, 1.0, 0.2));
+    float diffuse = max(dot(normal, lightDir), 0.0);
+    
+    vec3 color = uEndStoneColor;
+    float variation = simplex3D(worldPos * 0.03) * 0.1;
+    color += vec3(variation, variation * 0.5, 0.0);
+    color *= 0.3 + diffuse * 0.7;
+    
+    // Distance fog
+    float t = length(vLocalPos - uCameraPos);
+    float fogFactor = 1.0 - exp(-t * uFogDensity * 0.0001);
+    color = mix(color, uFogColor, fogFactor);
+    
+    FragColor = vec4(color, 1.0);
+}
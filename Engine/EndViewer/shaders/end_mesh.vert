@@ -0,0 +1,22 @@
+#version 330 core
+
+// End chunk mesh vertex shader (EndChunkStreamer)
+// Vertices are relative to their chunk; uChunkOffset moves them into the
+// camera's chunk-relative space, the same space the ray marcher uses
+
+layout(location = 0) in vec3 aPos;     // Relative to the chunk corner, packed (EndChunkVertex)
+layout(location = 1) in vec3 aNormal;  // snorm8
+
+uniform mat4 uViewProj;      // Projection * view (EndCamera, relative to uChunkOrigin)
+uniform vec3 uChunkOffset;   // Chunk corner minus the camera's chunk origin, in blocks
+uniform float uCellSize;     // Blocks per lattice cell (2^LOD)
+
+out vec3 vLocalPos;          // Position relative to the camera's chunk origin
+out vec3 vNormal;
+
+void main() {
+    // 1/2048 cell steps, offset by one cell
+    vLocalPos = (aPos * (1.0 / 2048.0) - 1.0) * uCellSize + uChunkOffset;
+    vNormal = aNormal;
+    gl_Position = uViewProj * vec4(vLocalPos, 1.0);
+}
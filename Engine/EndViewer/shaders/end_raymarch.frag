@@ -22,9 +22,21 @@ uniform float uCameraAltitude;    // For LOD calculations
 uniform float uMaxDistance;       // Maximum ray march distance
 uniform int uMaxSteps;            // Maximum ray march steps
 uniform float uTime;              // For subtle animation effects
+uniform bool uSafeStepping;       // Skip empty space using emptySpaceDistance()
+uniform int uDebugView;           // 0 = shaded, 1 = step heatmap, 2 = steps saved
 
-// Quality settings
-uniform int uOctaves;             // Noise octaves (LOD-adjusted)
+// Temporal reprojection (EndTemporalTarget); alpha of the output is the hit
+// distance when enabled
+uniform bool uTemporal;
+uniform bool uHistoryValid;
+uniform sampler2D uHistory;       // Previous frame: rgb = color, a = hit distance (< 0 = sky)
+uniform mat4 uPrevViewProj;       // Previous camera, in the current chunk-relative space
+uniform mat4 uPrevInvViewProj;
+uniform vec3 uPrevCameraPos;      // Previous camera position, same space as uCameraPos
+uniform int uFramePhase;          // Tile of each 2x2 group of 8x8 tiles re-traced this frame
+uniform float uPixelSpread;       // Pixel footprint per block of distance
+
+// Quality settings (uOctaves is declared in end_density.glsl)
 uniform float uStepMultiplier;    // Step size multiplier (LOD-adjusted)
 
 // Colors
@@ -33,225 +45,81 @@ uniform vec3 uSkyColor;           // Background color (dark void)
 uniform vec3 uFogColor;           // Distance fog color
 uniform float uFogDensity;        // Fog density factor
 
+#include "end_density.glsl"
+
 // ============================================================================
-// NOISE FUNCTIONS
+// DENSITY BRICK CACHE
 // ============================================================================
 
-// Skewing factors
-const float F2 = 0.36602540378;
-const float G2 = 0.21132486540;
-const float F3 = 0.33333333333;
-const float G3 = 0.16666666667;
-
-// Hash function for gradient generation
-vec3 hash3(vec3 p) {
-    p = vec3(dot(p, vec3(127.1, 311.7, 74.7)),
-             dot(p, vec3(269.5, 183.3, 246.1)),
-             dot(p, vec3(113.5, 271.9, 124.6)));
-    return -1.0 + 2.0 * fract(sin(p) * 43758.5453);
-}
-
-vec2 hash2(vec2 p) {
-    p = vec2(dot(p, vec2(127.1, 311.7)),
-             dot(p, vec2(269.5, 183.3)));
-    return -1.0 + 2.0 * fract(sin(p) * 43758.5453);
-}
+// Chunks around the camera baked into a 3D texture by EndBrickCache. The
+// atlas is toroidal: chunk c lives in slot mod(c, uCacheChunks), and a brick
+// table says which slots currently hold the right chunk.
+uniform bool uCacheEnabled;
+uniform sampler3D uDensityCache;  // One texel per block, GL_REPEAT
+uniform sampler3D uBrickTable;    // One texel per slot, > 0.5 when baked
+uniform sampler3D uBrickMax;      // One texel per slot, max density in the brick
+uniform ivec3 uCacheMin;          // First cached chunk
+uniform int uCacheChunks;         // Cached chunks per axis
 
-// 3D Simplex noise
-float simplex3D(vec3 p) {
-    // Skew
-    float s = (p.x + p.y + p.z) * F3;
-    vec3 i = floor(p + s);
-    float t = (i.x + i.y + i.z) * G3;
-    vec3 x0 = p - (i - t);
-    
-    // Simplex corners
-    vec3 i1, i2;
-    if (x0.x >= x0.y) {
-        if (x0.y >= x0.z) { i1 = vec3(1,0,0); i2 = vec3(1,1,0); }
-        else if (x0.x >= x0.z) { i1 = vec3(1,0,0); i2 = vec3(1,0,1); }
-        else { i1 = vec3(0,0,1); i2 = vec3(1,0,1); }
-    } else {
-        if (x0.y < x0.z) { i1 = vec3(0,0,1); i2 = vec3(0,1,1); }
-        else if (x0.x < x0.z) { i1 = vec3(0,1,0); i2 = vec3(0,1,1); }
-        else { i1 = vec3(0,1,0); i2 = vec3(1,1,0); }
+float sceneDensity(vec3 worldPos) {
+    if (uCacheEnabled) {
+        // Half a texel of margin keeps trilinear filtering inside the region
+        vec3 local = worldPos - vec3(uCacheMin) * 16.0;
+        float size = float(uCacheChunks) * 16.0;
+        if (all(greaterThanEqual(local, vec3(0.5))) &&
+            all(lessThan(local, vec3(size - 0.5)))) {
+            ivec3 slot = ivec3(mod(floor(worldPos / 16.0), float(uCacheChunks)));
+            if (texelFetch(uBrickTable, slot, 0).r > 0.5) {
+                return texture(uDensityCache, worldPos / size).r;
+            }
+        }
     }
-    
-    vec3 x1 = x0 - i1 + G3;
-    vec3 x2 = x0 - i2 + 2.0*G3;
-    vec3 x3 = x0 - 1.0 + 3.0*G3;
-    
-    // Gradients
-    vec3 g0 = hash3(i);
-    vec3 g1 = hash3(i + i1);
-    vec3 g2 = hash3(i + i2);
-    vec3 g3 = hash3(i + 1.0);
-    
-    // Contributions
-    vec4 w = max(0.6 - vec4(dot(x0,x0), dot(x1,x1), dot(x2,x2), dot(x3,x3)), 0.0);
-    w = w * w * w * w;
-    
-    return 32.0 * (w.x * dot(g0, x0) + w.y * dot(g1, x1) + 
-                   w.z * dot(g2, x2) + w.w * dot(g3, x3));
-}
-
-// 2D Simplex noise
-float simplex2D(vec2 p) {
-    float s = (p.x + p.y) * F2;
-    vec2 i = floor(p + s);
-    float t = (i.x + i.y) * G2;
-    vec2 x0 = p - (i - t);
-    
-    vec2 i1 = (x0.x > x0.y) ? vec2(1.0, 0.0) : vec2(0.0, 1.0);
-    vec2 x1 = x0 - i1 + G2;
-    vec2 x2 = x0 - 1.0 + 2.0 * G2;
-    
-    vec2 g0 = hash2(i);
-    vec2 g1 = hash2(i + i1);
-    vec2 g2 = hash2(i + 1.0);
-    
-    vec3 w = max(0.5 - vec3(dot(x0,x0), dot(x1,x1), dot(x2,x2)), 0.0);
-    w = w * w * w * w;
-    
-    return 70.0 * (w.x * dot(g0, x0) + w.y * dot(g1, x1) + w.z * dot(g2, x2));
-}
 
-// Octave noise (FBM)
-float fbm3D(vec3 p, int octaves) {
-    float value = 0.0;
-    float amplitude = 1.0;
-    float frequency = 1.0;
-    float maxValue = 0.0;
-    
-    for (int i = 0; i < octaves; i++) {
-        value += simplex3D(p * frequency) * amplitude;
-        maxValue += amplitude;
-        amplitude *= 0.5;
-        frequency *= 2.0;
-    }
-    
-    return value / maxValue;
+    // Outside the cache (or not baked yet): evaluate analytically
+    return endDensity(worldPos);
 }
 
 // ============================================================================
-// END TERRAIN DENSITY FUNCTION
+// EMPTY SPACE SKIPPING
 // ============================================================================
 
-const float MAIN_ISLAND_RADIUS = 500.0;
-const float EXCLUSION_ZONE_START = 500.0;
-const float EXCLUSION_ZONE_END = 1024.0;
-const float SEA_LEVEL = 64.0;
+// Cached densities interpolate analytic values up to a texel away, so the
+// analytic bounds give up this much when the cache may be in use
+const float CACHE_BOUND_MARGIN = 1.0;
 
-// Height profile for main island
-float mainIslandHeight(float dist) {
-    if (dist > MAIN_ISLAND_RADIUS) return -100.0;
-    
-    float t = dist / MAIN_ISLAND_RADIUS;
-    float falloff = cos(t * 3.14159265 * 0.5);
-    falloff = falloff * falloff;
-    
-    return 40.0 * falloff;
+// Distance to where the ray leaves the box [lo, hi] (p inside)
+float rayBoxExit(vec3 p, vec3 dir, vec3 lo, vec3 hi) {
+    vec3 safeDir = mix(vec3(1e-6), dir, greaterThan(abs(dir), vec3(1e-6)));
+    vec3 exitT = (mix(lo, hi, step(0.0, safeDir)) - p) / safeDir;
+    return min(exitT.x, min(exitT.y, exitT.z));
 }
 
-// Main island density
-float mainIslandDensity(vec3 pos, float horizDist) {
-    float heightAtDist = mainIslandHeight(horizDist);
-    float baseDensity = heightAtDist - (pos.y - SEA_LEVEL);
-    
-    // Add terrain noise
-    float noise = fbm3D(pos * 0.02, uOctaves);
-    baseDensity += noise * 8.0;
-    
-    // Detail noise
-    float detail = simplex3D(pos * 0.05) * 2.0;
-    baseDensity += detail;
-    
-    // Floor cutoff
-    if (pos.y < 4.0) {
-        baseDensity -= (4.0 - pos.y) * 2.0;
+// A baked brick whose densities are all <= 0 is air, as long as filtering
+// only reads that brick: half a texel inside its faces
+float brickEmptyBound(vec3 worldPos, vec3 rayDir) {
+    if (!uCacheEnabled) return 0.0;
+    
+    vec3 chunk = floor(worldPos / 16.0);
+    vec3 local = chunk - vec3(uCacheMin);
+    if (any(lessThan(local, vec3(0.0))) || any(greaterThanEqual(local, vec3(float(uCacheChunks))))) {
+        return 0.0;
     }
     
-    return baseDensity;
-}
-
-// Check if position is in outer island region
-bool shouldHaveIsland(vec2 chunkPos) {
-    float dist = length(chunkPos * 16.0);
-    if (dist <= EXCLUSION_ZONE_END) return false;
-    
-    float noise = simplex2D(chunkPos * 0.5);
-    float threshold = -0.8 + (dist / 3000.0);
-    threshold = clamp(threshold, -0.8, -0.5);
-    
-    return noise < threshold;
-}
-
-// Outer island density
-float outerIslandDensity(vec3 pos, float horizDist) {
-    // Quick rejection
-    if (horizDist < EXCLUSION_ZONE_END) return -1.0;
-    
-    vec2 chunkPos = floor(pos.xz / 16.0);
-    float maxDensity = -1.0;
-    
-    // Check 3x3 chunk neighborhood
-    for (int dx = -1; dx <= 1; dx++) {
-        for (int dz = -1; dz <= 1; dz++) {
-            vec2 checkChunk = chunkPos + vec2(dx, dz);
-            
-            if (shouldHaveIsland(checkChunk)) {
-                // Island center with variation
-                vec2 offset = vec2(
-                    simplex2D(checkChunk * 0.7 + vec2(0.0, 100.0)) * 6.0,
-                    simplex2D(checkChunk * 0.3 + vec2(100.0, 0.0)) * 6.0
-                );
-                vec2 islandCenter = checkChunk * 16.0 + 8.0 + offset;
-                
-                // Island properties
-                float sizeNoise = simplex2D(checkChunk * 0.5);
-                float radius = 20.0 + sizeNoise * 15.0;
-                float height = 10.0 + sizeNoise * 10.0;
-                
-                // Distance to this island
-                vec2 toIsland = pos.xz - islandCenter;
-                float islandDist = length(toIsland);
-                
-                if (islandDist < radius * 1.5) {
-                    float normDist = islandDist / radius;
-                    float maxH = height * max(0.0, 1.0 - normDist * normDist);
-                    
-                    float density = maxH - abs(pos.y - SEA_LEVEL);
-                    
-                    // Add noise
-                    density += fbm3D(pos * 0.08 + vec3(islandCenter.x, 0.0, islandCenter.y) * 0.01, 
-                                     max(1, uOctaves - 1)) * 4.0;
-                    
-                    // Edge falloff
-                    float edge = 1.0 - smoothstep(0.7, 1.0, normDist);
-                    density *= edge;
-                    
-                    maxDensity = max(maxDensity, density);
-                }
-            }
-        }
+    ivec3 slot = ivec3(mod(chunk, float(uCacheChunks)));
+    if (texelFetch(uBrickTable, slot, 0).r < 0.5 || texelFetch(uBrickMax, slot, 0).r > 0.0) {
+        return 0.0;
     }
     
-    return maxDensity;
+    vec3 lo = chunk * 16.0 + 0.5;
+    vec3 hi = chunk * 16.0 + 15.5;
+    if (any(lessThan(worldPos, lo)) || any(greaterThan(worldPos, hi))) return 0.0;
+    return rayBoxExit(worldPos, rayDir, lo, hi);
 }
 
-// Main density function
-float endDensity(vec3 worldPos) {
-    float horizDist = length(worldPos.xz);
-    
-    if (horizDist < EXCLUSION_ZONE_START) {
-        return mainIslandDensity(worldPos, horizDist);
-    }
-    
-    if (horizDist < EXCLUSION_ZONE_END) {
-        return -1.0;  // Exclusion zone
-    }
-    
-    return outerIslandDensity(worldPos, horizDist);
+// Distance the ray can safely advance without testing the density
+float emptySpaceDistance(vec3 worldPos, vec3 rayDir) {
+    float analytic = emptySpaceBound(worldPos, rayDir) - (uCacheEnabled ? CACHE_BOUND_MARGIN : 0.0);
+    return max(analytic, brickEmptyBound(worldPos, rayDir));
 }
 
 // ============================================================================
@@ -262,9 +130,9 @@ vec3 calculateNormal(vec3 pos) {
     const float eps = 0.5;  // Epsilon for gradient sampling
     
     return normalize(vec3(
-        endDensity(pos + vec3(eps, 0, 0)) - endDensity(pos - vec3(eps, 0, 0)),
-        endDensity(pos + vec3(0, eps, 0)) - endDensity(pos - vec3(0, eps, 0)),
-        endDensity(pos + vec3(0, 0, eps)) - endDensity(pos - vec3(0, 0, eps))
+        sceneDensity(pos + vec3(eps, 0, 0)) - sceneDensity(pos - vec3(eps, 0, 0)),
+        sceneDensity(pos + vec3(0, eps, 0)) - sceneDensity(pos - vec3(0, eps, 0)),
+        sceneDensity(pos + vec3(0, 0, eps)) - sceneDensity(pos - vec3(0, 0, eps))
     ));
 }
 
@@ -299,18 +167,34 @@ vec3 shade(vec3 pos, vec3 normal) {
 // RAY MARCHING
 // ============================================================================
 
-vec4 rayMarch(vec3 rayOrigin, vec3 rayDir) {
+int gSteps;    // Iterations taken by the last rayMarch() call
+float gHitT;   // Hit distance of the last rayMarch() call, -1 for sky
+
+vec4 rayMarch(vec3 rayOrigin, vec3 rayDir, bool safeStepping) {
     float t = 0.0;
     float maxDist = uMaxDistance;
     float baseStep = 1.0 * uStepMultiplier;
+    gSteps = 0;
+    gHitT = -1.0;
     
     for (int i = 0; i < uMaxSteps; i++) {
+        gSteps = i + 1;
         vec3 pos = rayOrigin + rayDir * t;
         
         // Convert to world coordinates (add chunk origin)
         vec3 worldPos = pos + vec3(uChunkOrigin) * 16.0;
         
-        float density = endDensity(worldPos);
+        // Jump over space that is provably empty
+        if (safeStepping) {
+            float skip = emptySpaceDistance(worldPos, rayDir);
+            if (skip > baseStep) {
+                t += skip;
+                if (t > maxDist) break;
+                continue;
+            }
+        }
+        
+        float density = sceneDensity(worldPos);
         
         if (density > 0.0) {
             // Hit! Refine position with binary search
@@ -322,7 +206,7 @@ vec4 rayMarch(vec3 rayOrigin, vec3 rayDir) {
                 vec3 midPos = rayOrigin + rayDir * tMid;
                 vec3 midWorld = midPos + vec3(uChunkOrigin) * 16.0;
                 
-                if (endDensity(midWorld) > 0.0) {
+                if (sceneDensity(midWorld) > 0.0) {
                     tHigh = tMid;
                 } else {
                     tLow = tMid;
@@ -341,6 +225,7 @@ vec4 rayMarch(vec3 rayOrigin, vec3 rayDir) {
             float fogFactor = 1.0 - exp(-t * uFogDensity * 0.0001);
             color = mix(color, uFogColor, fogFactor);
             
+            gHitT = t;
             return vec4(color, 1.0);
         }
         
@@ -361,6 +246,69 @@ vec4 rayMarch(vec3 rayOrigin, vec3 rayDir) {
     return vec4(uSkyColor, 1.0);
 }
 
+// ============================================================================
+// TEMPORAL REPROJECTION
+// ============================================================================
+
+// Find this pixel's ray in the previous frame. Starts from the distance the
+// same pixel had last frame, projects that point into the previous camera
+// and checks the texel it lands on actually saw a point on this ray (with
+// one refinement). Fails on disocclusion or when the point was off screen.
+bool reproject(vec3 rayOrigin, vec3 rayDir, out vec4 result) {
+    vec2 historySize = vec2(textureSize(uHistory, 0));
+    float t = texelFetch(uHistory, ivec2(gl_FragCoord.xy), 0).a;
+    
+    for (int i = 0; i < 2; i++) {
+        // Sky is a direction, hits are points
+        vec4 clip = t < 0.0 ? uPrevViewProj * vec4(rayDir, 0.0)
+                            : uPrevViewProj * vec4(rayOrigin + rayDir * t, 1.0);
+        if (clip.w <= 0.0) return false;
+        vec2 ndc = clip.xy / clip.w;
+        if (any(greaterThan(abs(ndc), vec2(1.0)))) return false;
+        
+        // Nearest texel, blending across silhouettes would smear edges
+        ivec2 texel = ivec2((ndc * 0.5 + 0.5) * historySize);
+        vec4 previous = texelFetch(uHistory, texel, 0);
+        
+        if (t < 0.0 || previous.a < 0.0) {
+            if (t < 0.0 && previous.a < 0.0) {
+                result = previous;
+                return true;
+            }
+            t = previous.a;
+            continue;
+        }
+        
+        // Point the previous camera saw through that texel's center
+        vec2 texelNdc = (vec2(texel) + 0.5) / historySize * 2.0 - 1.0;
+        vec4 farPoint = uPrevInvViewProj * vec4(texelNdc, 1.0, 1.0);
+        vec3 prevDir = normalize(farPoint.xyz / farPoint.w - uPrevCameraPos);
+        vec3 seen = uPrevCameraPos + prevDir * previous.a;
+        
+        // Accept if it lies on this ray within a couple of pixel footprints
+        float along = dot(seen - rayOrigin, rayDir);
+        float offRay = length(seen - rayOrigin - rayDir * along);
+        if (along > 0.0 && offRay < max(0.05, along * uPixelSpread * 2.0)) {
+            result = vec4(previous.rgb, along);
+            return true;
+        }
+        t = along;
+    }
+    return false;
+}
+
+// ============================================================================
+// DEBUG VIEWS
+// ============================================================================
+
+// Blue (0) through green to red (1)
+vec3 heatmap(float x) {
+    x = clamp(x, 0.0, 1.0);
+    return clamp(vec3(1.5 - abs(4.0 * x - 3.0),
+                      1.5 - abs(4.0 * x - 2.0),
+                      1.5 - abs(4.0 * x - 1.0)), 0.0, 1.0);
+}
+
 // ============================================================================
 // MAIN
 // ============================================================================
@@ -371,8 +319,34 @@ void main() {
     // Start ray at camera position
     vec3 rayOrigin = uCameraPos;
     
+    // Reuse last frame where possible, except for this frame's checkerboard
+    // phase. The checkerboard is made of 8x8 tiles so neighbouring pixels
+    // (which the GPU shades together) take the same path.
+    if (uTemporal && uHistoryValid) {
+        ivec2 tile = (ivec2(gl_FragCoord.xy) / 8) & 1;
+        vec4 reprojected;
+        if (tile.x + 2 * tile.y != uFramePhase && reproject(rayOrigin, rayDir, reprojected)) {
+            FragColor = reprojected;
+            return;
+        }
+    }
+    
     // Ray march through the scene
-    FragColor = rayMarch(rayOrigin, rayDir);
+    FragColor = rayMarch(rayOrigin, rayDir, uSafeStepping);
+    
+    if (uDebugView == 1) {
+        FragColor = vec4(heatmap(float(gSteps) / float(uMaxSteps)), 1.0);
+        return;
+    }
+    if (uDebugView == 2) {
+        // Green where safe stepping saves iterations over the plain marcher,
+        // red where it costs more
+        int steps = gSteps;
+        rayMarch(rayOrigin, rayDir, false);
+        float saved = float(gSteps - steps) / float(max(gSteps, 1));
+        FragColor = vec4(max(-saved, 0.0), max(saved, 0.0), 0.0, 1.0);
+        return;
+    }
     
     // Optional: Add subtle star effect for deep void
     if (FragColor.rgb == uSkyColor) {
@@ -380,4 +354,6 @@ void main() {
         float star = step(0.998, simplex2D(starCoord));
         FragColor.rgb += vec3(star * 0.3);
     }
+    
+    if (uTemporal) FragColor.a = gHitT;
 }
@@ -0,0 +1,13 @@
+#version 330 core
+
+// Upscales the EndTemporalTarget frame to the window (bilinear)
+
+out vec4 FragColor;
+
+uniform sampler2D uFrame;   // rgb = color, a = hit distance
+uniform vec2 uOutputSize;   // Window size in pixels
+
+void main() {
+    vec2 uv = gl_FragCoord.xy / uOutputSize;
+    FragColor = vec4(texture(uFrame, uv).rgb, 1.0);
+}
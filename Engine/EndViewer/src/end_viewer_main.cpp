@@ -20,6 +20,7 @@
 // BasicEngine components we reuse
 #include "../../../renderer/include/ImGuiManager.h"
 #include "../../../renderer/include/Logger.h"
+#include "../../Common/include/JobSystem.h"
 
 // End viewer components
 #include "../../EndViewer/include/EndRenderer.h"
@@ -47,6 +48,11 @@ int main() {
     LOG_INFO("=== End Dimension Viewer ===");
     LOG_INFO("Initializing...");
     
+    // Worker threads for CPU-side terrain work (stopped again at exit)
+    Engine::Common::JobSystem::Get().Start();
+    LOG_INFO("Job system running on " +
+             std::to_string(Engine::Common::JobSystem::Get().GetThreadCount()) + " threads");
+    
     // Initialize GLFW
     if (!glfwInit()) {
         LOG_FATAL("Failed to initialize GLFW");
@@ -118,7 +124,11 @@ int main() {
     bool showUI = true;
     bool wasTabPressed = false;
     
+    PROFILE_THREAD("Main");
     while (!glfwWindowShouldClose(window)) {
+        PROFILE_FRAME();
+        PROFILE_GPU_FRAME();
+        
         // Calculate delta time
         float currentTime = static_cast<float>(glfwGetTime());
         float deltaTime = currentTime - lastFrameTime;
@@ -151,7 +161,10 @@ int main() {
         imguiManager.Render();
         
         // Swap buffers
-        glfwSwapBuffers(window);
+        {
+            PROFILE_SCOPE("SwapBuffers");
+            glfwSwapBuffers(window);
+        }
     }
     
     LOG_INFO("Shutting down...");
@@ -161,6 +174,7 @@ int main() {
     imguiManager.Shutdown();
     glfwDestroyWindow(window);
     glfwTerminate();
+    Engine::Common::JobSystem::Get().Stop();
     
     LOG_INFO("Application terminated normally");
     return 0;
@@ -0,0 +1,165 @@
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+#include "../../Common/include/FrameArena.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Engine {
+namespace Logic {
+
+
+enum class BroadphaseType {
+    BRUTE_FORCE,      // Tests every pair of bounds (reference path)
+    SPATIAL_HASH,     // Uniform grid sized from the largest collider
+    SWEEP_AND_PRUNE   // Sorted interval sweep along the X axis
+};
+
+// World-space bounds of one collider, rebuilt by the collision system every
+// frame, with the collider's layer filter
+struct BroadphaseProxy {
+    glm::vec2 min = glm::vec2(0.0f);
+    glm::vec2 max = glm::vec2(0.0f);
+    uint32_t category = 1;          // Layer bit of the collider
+    uint32_t mask = 0xFFFFFFFFu;    // Layers it collides with
+    bool isStatic = false;
+};
+
+// Candidate pair of proxy indices, always stored with first < second
+struct BroadphasePair {
+    uint32_t first;
+    uint32_t second;
+
+    BroadphasePair(uint32_t a = 0, uint32_t b = 0) : first(a), second(b) {}
+
+    bool operator<(const BroadphasePair& other) const {
+        return first < other.first || (first == other.first && second < other.second);
+    }
+    bool operator==(const BroadphasePair& other) const {
+        return first == other.first && second == other.second;
+    }
+};
+
+// Finds pairs of proxies whose bounds overlap and whose filters accept each
+// other. Every implementation emits the same set of pairs, sorted by
+// (first, second), so the narrowphase visits them in exactly the order the
+// old all-pairs loop did.
+class Broadphase {
+public:
+    virtual ~Broadphase() = default;
+
+    virtual void FindPairs(const std::vector<BroadphaseProxy>& proxies,
+                           std::vector<BroadphasePair>& outPairs) = 0;
+
+    // Same result as FindPairs, spreading the work over up to maxThreads job
+    // system threads (0 = all) where the implementation supports it
+    virtual void FindPairsParallel(const std::vector<BroadphaseProxy>& proxies,
+                                   std::vector<BroadphasePair>& outPairs, size_t maxThreads) {
+        (void)maxThreads;
+        FindPairs(proxies, outPairs);
+    }
+
+    virtual BroadphaseType GetType() const = 0;
+    virtual std::string GetTypeName() const = 0;
+    virtual Common::FrameString GetDebugInfo() const { return GetTypeName().c_str(); }
+
+    static bool Overlaps(const BroadphaseProxy& a, const BroadphaseProxy& b) {
+        return a.min.x <= b.max.x && b.min.x <= a.max.x &&
+               a.min.y <= b.max.y && b.min.y <= a.max.y;
+    }
+
+    // Static colliders never collide with each other, others only when each
+    // one's mask has the other's layer
+    static bool CanCollide(const BroadphaseProxy& a, const BroadphaseProxy& b) {
+        return !(a.isStatic && b.isStatic) && (a.category & b.mask) != 0 && (b.category & a.mask) != 0;
+    }
+};
+
+class BruteForceBroadphase : public Broadphase {
+public:
+    void FindPairs(const std::vector<BroadphaseProxy>& proxies,
+                   std::vector<BroadphasePair>& outPairs) override;
+
+    BroadphaseType GetType() const override { return BroadphaseType::BRUTE_FORCE; }
+    std::string GetTypeName() const override { return "Brute Force"; }
+};
+
+class SpatialHashBroadphase : public Broadphase {
+private:
+    struct CellEntry {
+        uint64_t cellKey;
+        uint32_t proxy;
+
+        bool operator<(const CellEntry& other) const {
+            return cellKey < other.cellKey || (cellKey == other.cellKey && proxy < other.proxy);
+        }
+    };
+
+    float cellSize = 0.0f;         // 0 = derive from the largest proxy each frame
+    float lastCellSize = 1.0f;     // Cell size used by the last FindPairs call
+    int maxCellsPerProxy = 64;     // Larger proxies are tested against everything instead
+
+    // Scratch storage kept between frames to avoid reallocating
+    std::vector<CellEntry> entries;
+    std::vector<size_t> runStarts;  // First entry of each occupied cell, plus entries.size()
+    std::vector<uint32_t> oversized;
+    std::vector<uint8_t> isOversized;
+    std::vector<std::vector<BroadphasePair>> taskPairs; // Per-task output of FindPairsParallel
+
+public:
+    explicit SpatialHashBroadphase(float fixedCellSize = 0.0f) : cellSize(fixedCellSize) {}
+
+    void FindPairs(const std::vector<BroadphaseProxy>& proxies,
+                   std::vector<BroadphasePair>& outPairs) override;
+
+    // Occupied cells are split into ranges and processed on the job system
+    void FindPairsParallel(const std::vector<BroadphaseProxy>& proxies,
+                           std::vector<BroadphasePair>& outPairs, size_t maxThreads) override;
+
+    BroadphaseType GetType() const override { return BroadphaseType::SPATIAL_HASH; }
+    std::string GetTypeName() const override { return "Spatial Hash"; }
+    Common::FrameString GetDebugInfo() const override;
+
+    // 0 = automatic (smaller side of the largest proxy)
+    void SetCellSize(float size) { cellSize = size; }
+    float GetCellSize() const { return lastCellSize; }
+
+    void SetMaxCellsPerProxy(int cells) { maxCellsPerProxy = cells; }
+    int GetMaxCellsPerProxy() const { return maxCellsPerProxy; }
+
+private:
+    float ComputeCellSize(const std::vector<BroadphaseProxy>& proxies) const;
+
+    // FindPairs stages: bin proxies into cells, test pairs within a range of
+    // occupied cells, test the oversized proxies against everything
+    void BuildCells(const std::vector<BroadphaseProxy>& proxies);
+    void FindCellPairs(const std::vector<BroadphaseProxy>& proxies, size_t firstRun, size_t lastRun,
+                       std::vector<BroadphasePair>& outPairs) const;
+    void FindOversizedPairs(const std::vector<BroadphaseProxy>& proxies,
+                            std::vector<BroadphasePair>& outPairs) const;
+};
+
+class SweepAndPruneBroadphase : public Broadphase {
+private:
+    // Proxy order sorted by min.x, kept between frames so the insertion sort
+    // only has to fix up the few proxies that moved past their neighbours
+    std::vector<uint32_t> order;
+
+public:
+    void FindPairs(const std::vector<BroadphaseProxy>& proxies,
+                   std::vector<BroadphasePair>& outPairs) override;
+
+    BroadphaseType GetType() const override { return BroadphaseType::SWEEP_AND_PRUNE; }
+    std::string GetTypeName() const override { return "Sweep and Prune"; }
+};
+
+std::unique_ptr<Broadphase> CreateBroadphase(BroadphaseType type);
+const char* GetBroadphaseTypeName(BroadphaseType type);
+
+} // namespace Logic
+} // namespace Engine
+
+#endif
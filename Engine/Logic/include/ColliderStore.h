@@ -0,0 +1,79 @@
+#ifndef COLLIDER_STORE_H
+#define COLLIDER_STORE_H
+
+#include "Broadphase.h"
+#include "CollisionComponent.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Engine {
+namespace Logic {
+
+class Entity;
+class TransformComponent;
+class SimplePhysicsComponent;
+
+// Packed structure-of-arrays mirror of every active collider. The collision
+// system syncs it once per frame, runs detection and resolution on the arrays
+// and writes changed positions and velocities back to the components at the end.
+struct ColliderStore {
+    enum Flags : uint8_t {
+        STATIC          = 1 << 0,
+        TRIGGER         = 1 << 1,
+        HAS_TRANSFORM   = 1 << 2, // Positions can be corrected
+        HAS_PHYSICS     = 1 << 3, // Velocities can be resolved
+        POSITION_DIRTY  = 1 << 4,
+        VELOCITY_DIRTY  = 1 << 5,
+        SLEEPING        = 1 << 6  // Body was asleep at sync (or was put to sleep since)
+    };
+
+    // Shape data
+    std::vector<CollisionShape> shape;
+    std::vector<float> posX, posY;       // Owner position (x/y of the TransformComponent)
+    std::vector<float> offsetX, offsetY; // Shape center relative to the owner
+    std::vector<float> radius;           // Circle radius
+    std::vector<float> halfX, halfY;     // AABB half extents
+    std::vector<glm::vec2> lineStart, lineEnd; // Line endpoints (world space)
+    std::vector<float> lineThickness;
+    std::vector<uint8_t> flags;
+    std::vector<uint32_t> category, mask; // Layer filter (see CollisionSystem::GetLayerBit)
+    std::vector<uint32_t> entityIndex;   // Index into the collision system's entity list
+
+    // Physics data (only meaningful with HAS_PHYSICS)
+    std::vector<float> velX, velY;
+    std::vector<float> mass;
+    std::vector<float> bounceDamping;
+
+    // Back references used for collision results and the final write-back
+    std::vector<Entity*> entities;
+    std::vector<CollisionComponent*> colliders;
+    std::vector<TransformComponent*> transforms;
+    std::vector<SimplePhysicsComponent*> physics;
+
+    // Rebuild from the registered entities (inactive ones and ones without a collider are skipped)
+    void Sync(const std::vector<std::shared_ptr<Entity>>& registered);
+    uint32_t Add(Entity* entity, CollisionComponent* collider, uint32_t ownerIndex);
+    void Clear();
+
+    // Push corrected positions and velocities back to the components
+    void WriteBack();
+
+    size_t Size() const { return shape.size(); }
+    bool HasFlag(uint32_t index, uint8_t flag) const { return (flags[index] & flag) != 0; }
+    bool IsStatic(uint32_t index) const { return HasFlag(index, STATIC); }
+    bool IsTrigger(uint32_t index) const { return HasFlag(index, TRIGGER); }
+
+    glm::vec2 GetCenter(uint32_t index) const {
+        return glm::vec2(posX[index], posY[index]) + glm::vec2(offsetX[index], offsetY[index]);
+    }
+
+    // World-space bounds as seen by the broadphase
+    BroadphaseProxy ComputeBounds(uint32_t index, float margin = 0.0f) const;
+};
+
+} // namespace Logic
+} // namespace Engine
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "Component.h"
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -46,7 +47,7 @@ struct LineCollider {
 struct CollisionInfo {
     bool hasCollision = false;
     glm::vec2 contactPoint = glm::vec2(0.0f);
-    glm::vec2 normal = glm::vec2(0.0f);      // Direction to separate objects
+    glm::vec2 normal = glm::vec2(0.0f);      // Direction to separate objects (toward the other one)
     float penetration = 0.0f;                // How much objects overlap
     Entity* otherEntity = nullptr;
 
@@ -55,20 +56,84 @@ struct CollisionInfo {
         : hasCollision(collision), contactPoint(point), normal(norm), penetration(pen), otherEntity(other) {}
 };
 
+// One contact of the frame, stored once for both colliders by the CollisionSystem
+struct ContactRecord {
+    Entity* entityA = nullptr;
+    Entity* entityB = nullptr;
+    glm::vec2 point = glm::vec2(0.0f);
+    glm::vec2 normal = glm::vec2(0.0f); // From A toward B
+    float penetration = 0.0f;
+    bool isTrigger = false;
+
+    // The contact as seen from one side, normal toward the other collider
+    CollisionInfo GetInfo(bool fromB) const {
+        return CollisionInfo(true, point, fromB ? -normal : normal, penetration, fromB ? entityA : entityB);
+    }
+};
+
+// Contacts of one collider from the last CollisionSystem::Update: a view into
+// the system's frame buffer, valid until its next Update. Each entry is a
+// contact index times two, plus one where the collider is side B.
+class ContactList {
+public:
+    class Iterator {
+    private:
+        const ContactRecord* records;
+        const uint32_t* entry;
+
+    public:
+        Iterator(const ContactRecord* contactRecords, const uint32_t* position)
+            : records(contactRecords), entry(position) {}
+
+        CollisionInfo operator*() const { return records[*entry >> 1].GetInfo((*entry & 1) != 0); }
+        Iterator& operator++() { ++entry; return *this; }
+        bool operator==(const Iterator& other) const { return entry == other.entry; }
+        bool operator!=(const Iterator& other) const { return entry != other.entry; }
+    };
+
+private:
+    const ContactRecord* records = nullptr;
+    const uint32_t* first = nullptr;
+    const uint32_t* last = nullptr;
+
+public:
+    ContactList() = default;
+    ContactList(const ContactRecord* contactRecords, const uint32_t* firstEntry, const uint32_t* lastEntry)
+        : records(contactRecords), first(firstEntry), last(lastEntry) {}
+
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+
+    CollisionInfo operator[](size_t index) const { return records[first[index] >> 1].GetInfo((first[index] & 1) != 0); }
+    const ContactRecord& GetRecord(size_t index) const { return records[first[index] >> 1]; }
+
+    Iterator begin() const { return Iterator(records, first); }
+    Iterator end() const { return Iterator(records, last); }
+};
+
+class CollisionSystem;
+
 class CollisionComponent : public Component {
 private:
+    friend class CollisionSystem;
     CollisionShape shape;
     bool isTrigger;           // If true, detects collision but doesn't resolve
     bool isStatic;            // If true, object doesn't move from collisions
     std::string collisionLayer; // For filtering collisions
 
+    // Layer filter resolved from collisionLayer by the CollisionSystem at
+    // registration (until then the collider is on layer bit 0, colliding with all)
+    uint32_t categoryBits = 1;
+    uint32_t maskBits = 0xFFFFFFFFu;
+
     // Shape data (only one will be used based on shape type)
     CircleCollider circleData;
     AABBCollider aabbData;
     LineCollider lineData;
 
-    // Collision results from last frame
-    std::vector<CollisionInfo> collisions;
+    // Registration slot, lets CollisionSystem find the entity without a search
+    CollisionSystem* registeredSystem = nullptr;
+    uint32_t registeredSlot = 0;
 
 public:
     CollisionComponent(CollisionShape shapeType = CollisionShape::CIRCLE,
@@ -77,7 +142,6 @@ public:
                       const std::string& layer = "default");
 
     // Component interface
-    void Update(float deltaTime) override;
     std::string GetTypeName() const override { return "CollisionComponent"; }
     std::string GetDebugInfo() const override;
 
@@ -104,14 +168,15 @@ public:
     void SetStatic(bool staticObj) { isStatic = staticObj; }
     bool IsStatic() const { return isStatic; }
 
-    void SetLayer(const std::string& layer) { collisionLayer = layer; }
+    void SetLayer(const std::string& layer); // Re-resolved right away when registered
     const std::string& GetLayer() const { return collisionLayer; }
+    uint32_t GetCategoryBits() const { return categoryBits; }
+    uint32_t GetMaskBits() const { return maskBits; }
 
-    // Collision results
-    const std::vector<CollisionInfo>& GetCollisions() const { return collisions; }
-    bool HasCollisions() const { return !collisions.empty(); }
-    void ClearCollisions() { collisions.clear(); }
-    void AddCollision(const CollisionInfo& collision) { collisions.push_back(collision); }
+    // Collision results from the last Update of the system this collider is
+    // registered with (see ContactList)
+    ContactList GetCollisions() const;
+    bool HasCollisions() const { return !GetCollisions().empty(); }
 
     // World position helpers (combines entity position with collider offset)
     glm::vec2 GetWorldPosition() const;
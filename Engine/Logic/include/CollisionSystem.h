@@ -1,23 +1,137 @@
 #ifndef COLLISION_SYSTEM_H
 #define COLLISION_SYSTEM_H
 
+#include "Broadphase.h"
+#include "ColliderStore.h"
 #include "CollisionComponent.h"
+#include "ContactSolver.h"
 #include "Entity.h"
+#include "NarrowphaseBatch.h"
+#include <string>
 #include <vector>
 #include <memory>
 
 namespace Engine {
 namespace Logic {
 
+enum class CollisionMode {
+    SEQUENTIAL, // Detect and resolve pair by pair in registration order (reference behaviour)
+    PARALLEL    // Detect every contact on the job system first, then resolve them in pair order
+};
+
+enum class ContactResolution {
+    PER_PAIR,   // One correction and bounce per contact (ResolveCollision)
+    ITERATIVE   // ContactSolver over the whole contact list, with warm starting and sleeping
+};
+
+// Wall-clock time of each Update phase, in milliseconds
+struct CollisionTimings {
+    float syncMs = 0.0f;        // Store sync and proxy build
+    float broadphaseMs = 0.0f;
+    float narrowphaseMs = 0.0f; // Sequential mode resolves during this phase
+    float resolveMs = 0.0f;     // Resolution and write-back
+    float totalMs = 0.0f;
+};
+
+// A pair of entities in one of the begin/stay/end contact streams
+struct ContactEvent {
+    static constexpr uint32_t NO_CONTACT = UINT32_MAX;
+
+    EntityHandle handleA;
+    EntityHandle handleB;
+    Entity* entityA = nullptr; // nullptr in end events once the entity is destroyed
+    Entity* entityB = nullptr;
+    uint32_t contact = NO_CONTACT; // Index into GetContacts(), NO_CONTACT in end events
+};
+
 class CollisionSystem {
+public:
+    static constexpr uint32_t MAX_LAYERS = 32;
+
 private:
     std::vector<std::shared_ptr<Entity>> entities;
+    size_t pendingRemovals = 0; // Unregistered entries left as nullptr until the next Update
+
+    // Packed collider data, synced from the components every Update
+    ColliderStore store;
+
+    // Collision layers: name of each bit and the bits it collides with
+    std::vector<std::string> layerNames;
+    uint32_t layerMasks[MAX_LAYERS];
+
+    // Broadphase state (rebuilt every Update, proxy i belongs to store slot i)
+    std::unique_ptr<Broadphase> broadphase;
+    float broadphaseMargin = 2.0f; // Bounds padding, saves re-queries for small corrections
+    std::vector<BroadphaseProxy> proxies;
+    std::vector<BroadphaseProxy> initialProxies; // Proxies the broadphase saw this frame
+    std::vector<glm::vec2> proxyCenters; // Collider centers the proxies were built from
+    std::vector<float> proxyMargins;     // Padding of each proxy, grown when it gets refreshed
+    std::vector<BroadphasePair> candidatePairs;
+    std::vector<BroadphasePair> pendingPairs; // Min-heap of pairs found by proxy refreshes
+
+    // Batch circle-circle rejection ahead of the scalar narrowphase
+    CircleBatchKernel circleKernel;
+    uint8_t blockMayOverlap[CircleBatchKernel::BLOCK_SIZE];
+    std::vector<uint32_t> lastMovedBlock; // Block in which each slot was last resolved
+
+    // Full contact list (parallel mode and the iterative solver)
+    struct Contact {
+        BroadphasePair pair;
+        CollisionInfo info;
+    };
+
+    CollisionMode mode = CollisionMode::SEQUENTIAL;
+    size_t threadCount = 0; // Most job system threads used per Update, 0 = all
+    std::vector<std::vector<Contact>> taskContacts; // Contacts found by each narrowphase task
+    std::vector<size_t> taskCulled;
+    CollisionTimings timings;
+
+    ContactResolution resolution = ContactResolution::ITERATIVE;
+    ContactSolver solver;
+    SolverSettings solverSettings;
+    std::vector<SolverContact> solverContacts; // Non-trigger contacts of the last Update
+    bool skipRestingPairs = false; // Pairs without an awake body are not tested
+
+    // Contacts of the last Update, stored once per pair. Buffers keep their
+    // capacity, so a steady frame allocates nothing.
+    struct TouchingPair {
+        uint64_t key; // Handle pair, smaller first
+        EntityHandle handleA;
+        EntityHandle handleB;
+        Registry* registryA;
+        Registry* registryB;
+        uint32_t contact;
+
+        bool operator<(const TouchingPair& other) const { return key < other.key; }
+    };
+
+    std::vector<ContactRecord> frameContacts;
+    std::vector<BroadphasePair> contactSlots;  // Store slots of each contact
+    std::vector<uint32_t> contactOffsets;      // Per entity index into contactEntries, plus the end
+    std::vector<uint32_t> contactEntries;      // ContactList entries grouped by entity
+    std::vector<uint32_t> contactCursor;
+    std::vector<TouchingPair> touching;        // Sorted by key
+    std::vector<TouchingPair> previousTouching;
+    std::vector<ContactEvent> beginEvents;
+    std::vector<ContactEvent> stayEvents;
+    std::vector<ContactEvent> endEvents;
+
+    // Counters from the last Update
+    size_t pairsTested = 0;
+    size_t pairsHit = 0;
+    size_t proxyRefreshes = 0; // Colliders pushed out of their padded bounds in the last pass
+    size_t pairsCulled = 0;    // Pairs rejected by the batch kernel
 
 public:
-    CollisionSystem() = default;
-    ~CollisionSystem() = default;
+    CollisionSystem();
+    ~CollisionSystem();
 
-    // Entity management
+    CollisionSystem(const CollisionSystem&) = delete;
+    CollisionSystem& operator=(const CollisionSystem&) = delete;
+
+    // Entity management. Both are O(1); an unregistered entry is dropped at the
+    // start of the next Update, so later entities keep their order.
+    // Registration resolves the collider's layer name to its filter bits.
     void RegisterEntity(std::shared_ptr<Entity> entity);
     void UnregisterEntity(std::shared_ptr<Entity> entity);
     void Clear();
@@ -25,17 +139,74 @@ public:
     // Main collision detection and resolution
     void Update(float deltaTime);
 
-    // Static collision detection functions
+    // Threading. Parallel results don't depend on the thread count, but they
+    // differ from sequential mode, where later pairs see earlier corrections.
+    // Parallel mode runs on the engine job system, which must be started for
+    // it to use more than the calling thread.
+    void SetMode(CollisionMode newMode) { mode = newMode; }
+    CollisionMode GetMode() const { return mode; }
+    void SetThreadCount(size_t count); // 0 = every job system thread
+    size_t GetThreadCount() const { return threadCount; }
+    const CollisionTimings& GetTimings() const { return timings; }
+
+    // Contact resolution. The iterative solver works on the complete contact
+    // list, so in sequential mode corrections no longer feed later pairs of
+    // the same pass. Sleeping (see SolverSettings) only happens with it.
+    void SetResolution(ContactResolution newResolution) { resolution = newResolution; }
+    ContactResolution GetResolution() const { return resolution; }
+    SolverSettings& GetSolverSettings() { return solverSettings; }
+    const SolverSettings& GetSolverSettings() const { return solverSettings; }
+    const ContactSolver& GetSolver() const { return solver; }
+
+    // Collision layers. Names get bits on first use ("default" is bit 0) and
+    // every layer collides with every other until told otherwise. Filtered
+    // pairs, like static-static ones, are dropped by the broadphase.
+    uint32_t GetLayerBit(const std::string& name); // Bit index, MAX_LAYERS when out of bits
+    void SetLayersCollide(const std::string& layerA, const std::string& layerB, bool collide);
+    bool DoLayersCollide(const std::string& layerA, const std::string& layerB);
+    void ResolveLayer(CollisionComponent& collider);
+
+    // Broadphase configuration
+    void SetBroadphase(BroadphaseType type);
+    void SetBroadphase(std::unique_ptr<Broadphase> newBroadphase);
+    BroadphaseType GetBroadphaseType() const { return broadphase->GetType(); }
+    Broadphase* GetBroadphase() const { return broadphase.get(); }
+
+    void SetBroadphaseMargin(float margin) { broadphaseMargin = margin; }
+    float GetBroadphaseMargin() const { return broadphaseMargin; }
+
+    // Narrowphase kernel (defaults to the widest one the CPU supports)
+    void SetSimdLevel(SimdLevel level) { circleKernel = CircleBatchKernel(level); }
+    SimdLevel GetSimdLevel() const { return circleKernel.GetLevel(); }
+
+    const ColliderStore& GetColliderStore() const { return store; }
+
+    // Contacts of the last Update (triggers included), in pair order. Views
+    // and events index into it and stay valid until the next Update.
+    const std::vector<ContactRecord>& GetContacts() const { return frameContacts; }
+    ContactList GetContactList(uint32_t entityIndex) const; // By registration slot, see CollisionComponent::GetCollisions
+
+    // Pairs that started touching this Update, kept touching, or stopped
+    // (found by diffing against the last Update's pairs, sorted by handle pair)
+    const std::vector<ContactEvent>& GetBeginEvents() const { return beginEvents; }
+    const std::vector<ContactEvent>& GetStayEvents() const { return stayEvents; }
+    const std::vector<ContactEvent>& GetEndEvents() const { return endEvents; }
+
+    // Static collision detection functions (component versions load both
+    // colliders into a per-thread two-slot store, use them for one-off
+    // queries). The normal points from a to b.
     static CollisionInfo CheckCollision(CollisionComponent* colliderA, CollisionComponent* colliderB);
+    static CollisionInfo CheckCollision(const ColliderStore& colliders, uint32_t a, uint32_t b);
 
     // Specific collision detection algorithms
-    static CollisionInfo CheckCircleCircle(const CollisionComponent* circleA, const CollisionComponent* circleB);
-    static CollisionInfo CheckCircleLine(const CollisionComponent* circle, const CollisionComponent* line);
-    static CollisionInfo CheckCircleAABB(const CollisionComponent* circle, const CollisionComponent* aabb);
-    static CollisionInfo CheckAABBAABB(const CollisionComponent* aabbA, const CollisionComponent* aabbB);
+    static CollisionInfo CheckCircleCircle(const ColliderStore& colliders, uint32_t circleA, uint32_t circleB);
+    static CollisionInfo CheckCircleLine(const ColliderStore& colliders, uint32_t circle, uint32_t line);
+    static CollisionInfo CheckCircleAABB(const ColliderStore& colliders, uint32_t circle, uint32_t aabb);
+    static CollisionInfo CheckAABBAABB(const ColliderStore& colliders, uint32_t aabbA, uint32_t aabbB);
 
     // Collision response
     static void ResolveCollision(const CollisionInfo& collision, CollisionComponent* colliderA, CollisionComponent* colliderB);
+    static void ResolveCollision(const CollisionInfo& collision, ColliderStore& colliders, uint32_t a, uint32_t b);
 
     // Utility functions
     static float Distance(const glm::vec2& a, const glm::vec2& b);
@@ -44,8 +215,25 @@ public:
     static glm::vec2 ClosestPointOnLine(const glm::vec2& point, const glm::vec2& lineStart, const glm::vec2& lineEnd);
 
     // Debug
-    size_t GetEntityCount() const { return entities.size(); }
-    std::string GetDebugInfo() const;
+    size_t GetEntityCount() const { return entities.size() - pendingRemovals; }
+    size_t GetPairsTested() const { return pairsTested; }
+    size_t GetPairsHit() const { return pairsHit; }
+    size_t GetProxyRefreshes() const { return proxyRefreshes; }
+    size_t GetPairsCulled() const { return pairsCulled; }
+    Common::FrameString GetDebugInfo() const;
+
+private:
+    void ResolveAllLayers();
+    void RecordContact(uint32_t a, uint32_t b, const CollisionInfo& collision);
+    void BuildContactViews();
+    void UpdateContactEvents();
+    void CompactEntities();
+    void RunSequentialPass();
+    void WakeAll();
+    bool IsAwake(uint32_t index) const;
+    void DetectContacts(size_t maxThreads);
+    void ResolveContacts();
+    void RefreshEscapedProxy(uint32_t index, const BroadphasePair& currentPair);
 };
 
 } // namespace Logic
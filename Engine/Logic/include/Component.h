@@ -17,9 +17,11 @@ protected:
 public:
     virtual ~Component() = default;
 
-    // Core lifecycle methods
+    // Core lifecycle methods. Entity::Update only visits components whose
+    // type overrides Update, per-frame work on many components belongs in a
+    // Scene system instead.
     virtual void Initialize() {}
-    virtual void Update(float deltaTime) = 0;
+    virtual void Update(float deltaTime) { (void)deltaTime; }
     virtual void Destroy() {}
 
     // Component state management
@@ -0,0 +1,169 @@
+#ifndef COMPONENT_POOL_H
+#define COMPONENT_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace Engine {
+namespace Logic {
+
+// Fixed-size slots carved out of large pages. Components of one type are
+// allocated here together with their shared_ptr control block, so a pool's
+// components sit next to each other instead of all over the heap.
+class SlabArena {
+private:
+    static constexpr size_t SLOTS_PER_PAGE = 256;
+
+    std::mutex mutex; // The last reference to a component may drop on any thread
+    std::vector<std::unique_ptr<unsigned char[]>> pages;
+    std::vector<void*> freeSlots;
+    size_t slotSize = 0;
+    size_t usedInPage = SLOTS_PER_PAGE;
+
+public:
+    void* Allocate(size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // The first request fixes the slot size, anything else goes to the heap
+        if (slotSize == 0) {
+            const size_t align = alignof(std::max_align_t);
+            slotSize = (bytes + align - 1) / align * align;
+        }
+        if (bytes > slotSize) return ::operator new(bytes);
+
+        if (!freeSlots.empty()) {
+            void* slot = freeSlots.back();
+            freeSlots.pop_back();
+            return slot;
+        }
+
+        if (usedInPage == SLOTS_PER_PAGE) {
+            pages.emplace_back(new unsigned char[slotSize * SLOTS_PER_PAGE]);
+            usedInPage = 0;
+        }
+        return pages.back().get() + slotSize * usedInPage++;
+    }
+
+    void Deallocate(void* slot, size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (bytes > slotSize) {
+            ::operator delete(slot);
+            return;
+        }
+        freeSlots.push_back(slot);
+    }
+
+    size_t GetPageCount() const { return pages.size(); }
+};
+
+// Allocator handed to std::allocate_shared. Every copy keeps the arena alive,
+// so components that outlive their registry still free into valid memory.
+template<typename T>
+class SlabAllocator {
+public:
+    using value_type = T;
+
+    std::shared_ptr<SlabArena> arena;
+
+    explicit SlabAllocator(std::shared_ptr<SlabArena> slabArena) : arena(std::move(slabArena)) {}
+
+    template<typename U>
+    SlabAllocator(const SlabAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(arena->Allocate(n * sizeof(T))); }
+    void deallocate(T* p, size_t n) { arena->Deallocate(p, n * sizeof(T)); }
+
+    template<typename U>
+    bool operator==(const SlabAllocator<U>& other) const { return arena == other.arena; }
+    template<typename U>
+    bool operator!=(const SlabAllocator<U>& other) const { return arena != other.arena; }
+};
+
+// Type-erased interface so the registry can drop every component of an entity
+class ComponentPoolBase {
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    virtual ~ComponentPoolBase() = default;
+
+    virtual bool Has(uint32_t entityIndex) const = 0;
+    virtual bool Remove(uint32_t entityIndex) = 0;
+    virtual size_t Size() const = 0;
+};
+
+// Sparse set of the components of type T. dense arrays are packed (removal
+// swaps the last element in), sparse maps an entity index to its dense slot.
+template<typename T>
+class ComponentPool : public ComponentPoolBase {
+private:
+    std::vector<uint32_t> sparse;
+    std::vector<uint32_t> denseEntities;
+    std::vector<std::shared_ptr<T>> denseComponents;
+    std::shared_ptr<SlabArena> arena = std::make_shared<SlabArena>();
+
+public:
+    template<typename... Args>
+    std::shared_ptr<T> Emplace(uint32_t entityIndex, Args&&... args) {
+        if (entityIndex >= sparse.size()) {
+            sparse.resize(entityIndex + 1, NONE);
+        }
+        if (sparse[entityIndex] != NONE) {
+            return denseComponents[sparse[entityIndex]];
+        }
+
+        auto component = std::allocate_shared<T>(SlabAllocator<T>(arena), std::forward<Args>(args)...);
+        sparse[entityIndex] = static_cast<uint32_t>(denseEntities.size());
+        denseEntities.push_back(entityIndex);
+        denseComponents.push_back(component);
+        return component;
+    }
+
+    bool Has(uint32_t entityIndex) const override {
+        return entityIndex < sparse.size() && sparse[entityIndex] != NONE;
+    }
+
+    T* Get(uint32_t entityIndex) const {
+        return Has(entityIndex) ? denseComponents[sparse[entityIndex]].get() : nullptr;
+    }
+
+    std::shared_ptr<T> GetShared(uint32_t entityIndex) const {
+        return Has(entityIndex) ? denseComponents[sparse[entityIndex]] : nullptr;
+    }
+
+    bool Remove(uint32_t entityIndex) override {
+        if (!Has(entityIndex)) return false;
+
+        const uint32_t slot = sparse[entityIndex];
+        const uint32_t last = static_cast<uint32_t>(denseEntities.size() - 1);
+        if (slot != last) {
+            denseEntities[slot] = denseEntities[last];
+            denseComponents[slot] = std::move(denseComponents[last]);
+            sparse[denseEntities[slot]] = slot;
+        }
+        denseEntities.pop_back();
+        denseComponents.pop_back();
+        sparse[entityIndex] = NONE;
+        return true;
+    }
+
+    size_t Size() const override { return denseEntities.size(); }
+
+    // Room for count components in total, before a bulk load
+    void Reserve(size_t count) {
+        denseEntities.reserve(count);
+        denseComponents.reserve(count);
+    }
+
+    // Packed arrays, element i of both belongs to the same entity
+    const std::vector<uint32_t>& GetEntityIndices() const { return denseEntities; }
+    const std::vector<std::shared_ptr<T>>& GetComponents() const { return denseComponents; }
+};
+
+} // namespace Logic
+} // namespace Engine
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef CONTACT_SOLVER_H
+#define CONTACT_SOLVER_H
+
+#include "ColliderStore.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine {
+namespace Logic {
+
+// Tuning for the contact solver. Speeds and distances are in world units, so
+// scenes working in pixels need larger thresholds than the defaults.
+struct SolverSettings {
+    int velocityIterations = 8;
+    int positionIterations = 3;
+    bool warmStarting = true;           // Start from last step's impulses
+    float friction = 0.2f;
+    float restitutionThreshold = 1.0f;  // Closing speed below which contacts don't bounce
+    float slop = 0.01f;                 // Penetration left alone so resting contacts stay touching
+    float positionCorrection = 0.4f;    // Fraction of the remaining penetration removed per iteration
+
+    bool sleeping = true;
+    float sleepVelocity = 0.05f;        // Bodies slower than this count as resting
+    float timeToSleep = 0.5f;           // Seconds a whole island has to rest before it sleeps
+};
+
+// One contact between two store slots, normal pointing from a to b
+struct SolverContact {
+    uint32_t a;
+    uint32_t b;
+    glm::vec2 normal;
+    float penetration;
+};
+
+// Sequential impulse solver over one step's contact list. Velocities are
+// solved first (accumulated normal and friction impulses, clamped per
+// contact, warm started from the previous step by entity pair), then
+// positions are pushed apart in a few separate iterations so the correction
+// never adds energy. Works on the collision system's packed store; touched
+// slots are flagged dirty for the write-back.
+//
+// Sleeping: bodies joined by contacts form islands, and an island whose
+// bodies all stayed below the sleep velocity for timeToSleep is put to sleep
+// as a whole (SimplePhysicsComponent::Sleep). Any contact with an awake body
+// wakes a sleeping one.
+class ContactSolver {
+private:
+    struct Constraint {
+        uint32_t a;
+        uint32_t b;
+        glm::vec2 normal;
+        glm::vec2 tangent;
+        float penetration;
+        float normalMass;   // 1 / (inverse mass a + b), for velocities
+        float positionMass; // Same for position correction
+        float bounce;       // Target separating speed
+        float normalImpulse;
+        float tangentImpulse;
+        uint64_t key;
+    };
+
+    struct CachedImpulse {
+        float normal;
+        float tangent;
+    };
+
+    std::vector<Constraint> constraints;
+    std::vector<float> velocityInvMass; // Per store slot, 0 for bodies the solver can't push
+    std::vector<float> positionInvMass;
+    std::vector<glm::vec2> startPositions;
+
+    // Impulses of the last step, keyed by entity handle pair
+    std::unordered_map<uint64_t, CachedImpulse> cache;
+    std::unordered_map<uint64_t, CachedImpulse> nextCache;
+
+    // Island search
+    std::vector<uint32_t> parent;
+    std::vector<float> islandRest;
+
+    // Counters from the last step
+    size_t warmStarted = 0;
+    size_t sleepingBodies = 0;
+    size_t islandCount = 0;
+
+public:
+    // Solves the contacts in list order (keep it sorted for reproducible
+    // results). Sleeping bodies in the list are woken first.
+    void Solve(ColliderStore& store, const std::vector<SolverContact>& contacts,
+               const SolverSettings& settings);
+
+    // Updates the rest timers of the solved bodies and puts resting islands
+    // to sleep. Call after the store has been written back.
+    void UpdateSleep(ColliderStore& store, const std::vector<SolverContact>& contacts,
+                     const SolverSettings& settings, float deltaTime);
+
+    // Drops cached impulses (e.g. after teleporting bodies)
+    void Clear();
+
+    size_t GetWarmStartedCount() const { return warmStarted; }
+    size_t GetSleepingBodyCount() const { return sleepingBodies; }
+    size_t GetIslandCount() const { return islandCount; }
+
+    // Dynamic slots take part in islands and can be put to sleep
+    static bool IsDynamic(const ColliderStore& store, uint32_t index);
+
+private:
+    uint32_t FindRoot(uint32_t index);
+    static uint64_t PairKey(const ColliderStore& store, uint32_t a, uint32_t b);
+    void ApplyImpulse(ColliderStore& store, const Constraint& constraint, const glm::vec2& impulse);
+};
+
+} // namespace Logic
+} // namespace Engine
+
+#endif
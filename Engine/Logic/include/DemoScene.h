@@ -6,6 +6,7 @@
 #include "TransformComponent.h"
 #include "RenderComponent.h"
 #include <memory>
+#include <string>
 
 namespace Engine {
 namespace Logic {
@@ -31,6 +32,11 @@ public:
     void Update(float deltaTime);
     void Destroy();
 
+    // Binary snapshots (SceneSerializer). Loading replaces every entity;
+    // if the file can't be loaded the scene is built from scratch again.
+    bool SaveSnapshot(const std::string& path) const;
+    bool LoadSnapshot(const std::string& path);
+
     // Access to the underlying scene
     std::shared_ptr<Scene> GetScene() const { return scene; }
 
@@ -1,32 +1,50 @@
 #ifndef ENTITY_H
 #define ENTITY_H
 
-#include <unordered_map>
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
 #include <vector>
 #include <memory>
-#include <typeindex>
 #include <string>
 #include "Component.h"
+#include "../../Common/include/FrameArena.h"
+#include "Registry.h"
 
 namespace Engine {
 namespace Logic {
 
+class Scene;
+
+// Components live in the pools of the entity's registry, the entity only
+// keeps its handle and the components in the order they were added.
 class Entity {
 private:
-    std::unordered_map<std::type_index, std::shared_ptr<Component>> components;
+    std::shared_ptr<Registry> registry;
+    EntityHandle handle;
     std::vector<std::shared_ptr<Component>> componentsVector; // For iteration
+    std::vector<Component*> updatableComponents; // Components whose type overrides Update
     int id;
     bool active;
     std::string name;
+    Scene* scene = nullptr; // Scene listing this entity, keeps its name index current
+
+    static std::atomic<int> nextId; // Scenes may be built on a loader thread
 
-    static int nextId;
+    friend class Scene;
 
 public:
-    // Constructors
+    // Constructors (without a registry the entity uses Registry::GetDefault())
     Entity();
     Entity(const std::string& entityName);
     Entity(int entityId, const std::string& entityName = "");
-    ~Entity() = default;
+    Entity(std::shared_ptr<Registry> entityRegistry, const std::string& entityName);
+    Entity(std::shared_ptr<Registry> entityRegistry, int entityId, const std::string& entityName = "");
+    ~Entity();
+
+    // The registry keeps a pointer to this object
+    Entity(const Entity&) = delete;
+    Entity& operator=(const Entity&) = delete;
 
     // Component Management
     template<typename T, typename... Args>
@@ -34,19 +52,18 @@ public:
         static_assert(std::is_base_of<Component, T>::value, "T must derive from Component");
 
         // Check if component already exists
-        std::type_index typeIndex(typeid(T));
-        if (components.find(typeIndex) != components.end()) {
-            // Return existing component
-            return std::dynamic_pointer_cast<T>(components[typeIndex]);
+        if (auto existing = registry->GetShared<T>(handle)) {
+            return existing;
         }
 
-        // Create new component
-        auto component = std::make_shared<T>(std::forward<Args>(args)...);
+        // Create new component in the registry's pool
+        auto component = registry->Emplace<T>(handle, std::forward<Args>(args)...);
+        if (!component) return nullptr;
         component->SetOwner(this);
-
-        // Store in both containers
-        components[typeIndex] = component;
         componentsVector.push_back(component);
+        if constexpr (OverridesUpdate<T>()) {
+            updatableComponents.push_back(component.get());
+        }
 
         // Initialize the component
         component->Initialize();
@@ -57,66 +74,77 @@ public:
     template<typename T>
     std::shared_ptr<T> GetComponent() {
         static_assert(std::is_base_of<Component, T>::value, "T must derive from Component");
-
-        auto it = components.find(std::type_index(typeid(T)));
-        if (it != components.end()) {
-            return std::dynamic_pointer_cast<T>(it->second);
-        }
-        return nullptr;
+        return registry->GetShared<T>(handle);
     }
 
     template<typename T>
     bool HasComponent() const {
         static_assert(std::is_base_of<Component, T>::value, "T must derive from Component");
-        return components.find(std::type_index(typeid(T))) != components.end();
+        return registry->Has<T>(handle);
     }
 
     template<typename T>
     bool RemoveComponent() {
         static_assert(std::is_base_of<Component, T>::value, "T must derive from Component");
 
-        std::type_index typeIndex(typeid(T));
-        auto it = components.find(typeIndex);
-        if (it != components.end()) {
-            // Call destroy on component
-            it->second->Destroy();
-
-            // Remove from both containers
-            components.erase(it);
-            componentsVector.erase(
-                std::__remove_if(componentsVector.begin(), componentsVector.end(),
-                    [&typeIndex](const std::shared_ptr<Component>& comp) {
-                        return std::type_index(typeid(*comp)) == typeIndex;
-                    }),
-                componentsVector.end()
-            );
-            return true;
-        }
-        return false;
+        auto component = registry->GetShared<T>(handle);
+        if (!component) return false;
+
+        // Call destroy on component
+        component->Destroy();
+
+        // Remove from both containers
+        componentsVector.erase(
+            std::remove(componentsVector.begin(), componentsVector.end(),
+                        std::static_pointer_cast<Component>(component)),
+            componentsVector.end()
+        );
+        updatableComponents.erase(
+            std::remove(updatableComponents.begin(), updatableComponents.end(), component.get()),
+            updatableComponents.end()
+        );
+        registry->Remove<T>(handle);
+        return true;
     }
 
     // Entity lifecycle
     void Update(float deltaTime);
+    bool NeedsUpdate() const { return !updatableComponents.empty(); }
     void Destroy();
 
     // Entity properties
     int GetID() const { return id; }
     const std::string& GetName() const { return name; }
-    void SetName(const std::string& newName) { name = newName; }
+    void SetName(const std::string& newName);
 
     bool IsActive() const { return active; }
     void SetActive(bool isActive) { active = isActive; }
 
+    // Scene currently listing this entity, nullptr while detached
+    Scene* GetScene() const { return scene; }
+
     // Component iteration
     const std::vector<std::shared_ptr<Component>>& GetAllComponents() const {
         return componentsVector;
     }
 
-    size_t GetComponentCount() const { return components.size(); }
+    size_t GetComponentCount() const { return componentsVector.size(); }
+    void ReserveComponents(size_t count) { componentsVector.reserve(count); }
+
+    // Storage
+    EntityHandle GetHandle() const { return handle; }
+    Registry& GetRegistry() const { return *registry; }
 
     // Debug/inspection
-    std::string GetDebugInfo() const;
+    Common::FrameString GetDebugInfo() const;
     void PrintComponentList() const;
+
+private:
+    // &T::Update only names Component::Update when T inherits it unchanged
+    template<typename T>
+    static constexpr bool OverridesUpdate() {
+        return !std::is_same<decltype(&T::Update), decltype(&Component::Update)>::value;
+    }
 };
 
 } // namespace Logic
@@ -0,0 +1,51 @@
+#ifndef FIXED_TIMESTEP_H
+#define FIXED_TIMESTEP_H
+
+namespace Engine {
+namespace Logic {
+
+// Fixed-rate stepping for the simulation. Frame time goes into an
+// accumulator that is drained in whole steps, so physics costs the same and
+// behaves the same whatever the frame rate. A step can be split into
+// substeps for fast objects. Steps per frame are capped: after a hitch the
+// backlog is dropped instead of simulated, since catching up would make the
+// next frame slower still.
+class FixedTimestep {
+private:
+    float stepSize;
+    int substeps;
+    int maxStepsPerFrame;
+    float accumulator = 0.0f;
+
+    int lastStepCount = 0;
+    float droppedTime = 0.0f; // Total simulation time skipped by the cap
+
+public:
+    FixedTimestep(float step = 1.0f / 60.0f, int substepCount = 1, int maxSteps = 8);
+
+    // Adds frame time and returns the number of whole steps to run now
+    int Advance(float deltaTime);
+    void Reset();
+
+    // How far the accumulator is into the next step, in [0, 1). Renderers
+    // blend the previous and current step's state by this much.
+    float GetAlpha() const { return accumulator / stepSize; }
+
+    void SetStepSize(float seconds);
+    float GetStepSize() const { return stepSize; }
+    float GetSubstepSize() const { return stepSize / static_cast<float>(substeps); }
+
+    void SetSubsteps(int count);
+    int GetSubsteps() const { return substeps; }
+
+    void SetMaxStepsPerFrame(int count);
+    int GetMaxStepsPerFrame() const { return maxStepsPerFrame; }
+
+    int GetLastStepCount() const { return lastStepCount; }
+    float GetDroppedTime() const { return droppedTime; }
+};
+
+} // namespace Logic
+} // namespace Engine
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef NARROWPHASE_BATCH_H
+#define NARROWPHASE_BATCH_H
+
+#include "Broadphase.h"
+#include "ColliderStore.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace Engine {
+namespace Logic {
+
+enum class SimdLevel {
+    SCALAR,
+    SSE2,   // 4 pairs per step
+    AVX2,   // 8 pairs per step
+    NEON    // 4 pairs per step
+};
+
+// Rejects circle-circle pairs that clearly don't overlap, several pairs at a
+// time, before the exact scalar check runs. The test is conservative: a
+// squared center distance is only rejected when it is well clear of the
+// combined radius, so every pair the scalar CheckCircleCircle would report
+// still reaches it. That keeps results identical whichever kernel runs.
+class CircleBatchKernel {
+public:
+    static constexpr size_t BLOCK_SIZE = 64; // Pairs filtered per call from the collision loop
+
+    using FilterFunc = void (*)(const ColliderStore& store, const BroadphasePair* pairs,
+                                size_t count, uint8_t* mayOverlap);
+
+private:
+    SimdLevel level;
+    FilterFunc filter;
+
+public:
+    // Unsupported levels fall back to the best one this CPU and build can run
+    explicit CircleBatchKernel(SimdLevel requested = DetectSimdLevel());
+
+    // mayOverlap[i] = 0 only if pairs[i] is two circles that cannot collide.
+    // Pairs of any other shape combination always get 1.
+    void Filter(const ColliderStore& store, const BroadphasePair* pairs,
+                size_t count, uint8_t* mayOverlap) const {
+        filter(store, pairs, count, mayOverlap);
+    }
+
+    SimdLevel GetLevel() const { return level; }
+    const char* GetLevelName() const { return GetSimdLevelName(level); }
+
+    static SimdLevel DetectSimdLevel();
+    static bool IsSimdLevelSupported(SimdLevel level);
+    static const char* GetSimdLevelName(SimdLevel level);
+};
+
+} // namespace Logic
+} // namespace Engine
+
+#endif
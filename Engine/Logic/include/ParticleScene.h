@@ -6,14 +6,32 @@
 #include "TransformComponent.h"
 #include "RenderComponent.h"
 #include "CollisionComponent.h"
+#include <functional>
 #include <memory>
 #include <vector>
 #include <random>
+#include <string>
 
 namespace Engine {
 namespace Logic {
 
 class ParticleScene {
+public:
+    // Cup wall as a capsule, the segment inflated by radius
+    struct WallSegment {
+        glm::vec2 start;
+        glm::vec2 end;
+        float radius;
+    };
+
+    // A particle to be simulated outside the scene (GPU mode)
+    struct ParticleSpawn {
+        glm::vec2 position;
+        glm::vec2 velocity;
+        float radius;
+        glm::vec3 color;
+    };
+
 private:
     std::shared_ptr<Scene> scene;
     std::unique_ptr<CollisionSystem> collisionSystem;
@@ -23,8 +41,12 @@ private:
     std::shared_ptr<Entity> rightWall;
     std::shared_ptr<Entity> bottomWall;
 
-    // Particle management
+    // Particle management. Dead particles keep their components and wait in
+    // freeParticles, so steady-state spawning doesn't touch the heap.
     std::vector<std::shared_ptr<Entity>> particles;
+    std::vector<uint32_t> particleSlots; // Registry index -> position in particles
+    std::vector<std::shared_ptr<Entity>> freeParticles;
+    size_t initialPoolSize = 256;
 
     // Scene parameters
     float cupWidth = 200.0f;           // Width of the cup opening
@@ -44,8 +66,8 @@ private:
     float particleMass = 1.0f;         // Base mass for particles
     glm::vec2 gravity = glm::vec2(0.0f, -500.0f); // 2D gravity
 
-    // Random generation
-    std::random_device rd;
+    // Random generation, fixed by the seed so runs can be replayed
+    uint32_t seed;
     std::mt19937 gen;
     std::uniform_real_distribution<float> colorDist;
     std::uniform_real_distribution<float> positionDist;
@@ -54,9 +76,16 @@ private:
     // Scene state
     bool physicsEnabled = true;
     float timeScale = 1.0f;
+    bool verbose = true; // Log every spawned particle
+    int particleCounter = 0; // Numbers particle names
+    uint32_t cupRevision = 0; // Bumped whenever the walls are rebuilt
+
+    // GPU mode: the particles live in the app's Common::GpuParticleSystem
+    // (Logic stays free of GL), the scene's fixed steps only call gpuStep
+    std::function<void(float)> gpuStep;
 
 public:
-    ParticleScene();
+    explicit ParticleScene(uint32_t randomSeed = std::random_device{}());
     ~ParticleScene() = default;
 
     void Initialize();
@@ -64,6 +93,12 @@ public:
     void Destroy();
     void Reset(); // Clear all particles
 
+    // Binary snapshots (SceneSerializer) of the cup and the live particles.
+    // Loading replaces both; if the file can't be loaded only the cup is
+    // built again.
+    bool SaveSnapshot(const std::string& path) const;
+    bool LoadSnapshot(const std::string& path);
+
     // Access to the underlying scene
     std::shared_ptr<Scene> GetScene() const { return scene; }
 
@@ -83,6 +118,9 @@ public:
     void SetTimeScale(float scale) { timeScale = scale; }
     float GetTimeScale() const { return timeScale; }
 
+    uint32_t GetSeed() const { return seed; }
+    void SetVerbose(bool enabled) { verbose = enabled; }
+
     void SetParticleBounciness(float bounce) { particleBounciness = bounce; }
     float GetParticleBounciness() const { return particleBounciness; }
 
@@ -93,11 +131,32 @@ public:
 
     // Particle management
     size_t GetParticleCount() const { return particles.size(); }
+    size_t GetPooledParticleCount() const { return freeParticles.size(); }
+    void ReserveParticles(size_t count); // Grows the pool to at least count particles
     void ClearAllParticles();
 
     // Collision system access
     CollisionSystem* GetCollisionSystem() const { return collisionSystem.get(); }
 
+    // GPU simulation. While a step is set the CPU particles are cleared,
+    // gravity and collisions are off, and every fixed step (substeps
+    // included, scaled by the time scale) calls step instead. An empty
+    // function returns to the CPU path.
+    void SetGpuStep(std::function<void(float)> step);
+    bool IsGpuSimulation() const { return static_cast<bool>(gpuStep); }
+
+    // What a GPU simulation needs to match the CPU one
+    std::vector<WallSegment> GetWallSegments() const;
+    uint32_t GetCupRevision() const { return cupRevision; }
+    glm::vec2 GetGravity() const { return gravity; }
+    glm::vec2 GetCupCenter() const { return cupCenter; }
+
+    // count particles of the current radius, in rows of the given width
+    // centred over the cup starting at the usual spawn height, jittered so
+    // they don't land in columns. Colors and velocities are drawn like
+    // SpawnParticle's. Appends to spawns.
+    void GenerateSpawns(size_t count, float width, std::vector<ParticleSpawn>& spawns);
+
 private:
     void CreateCupBoundaries();
     void CreateWall(std::shared_ptr<Entity>& wall, const std::string& name,
@@ -109,6 +168,10 @@ private:
 
     void UpdatePhysics(float deltaTime);
     void CleanupDestroyedParticles();
+
+    std::shared_ptr<Entity> CreateParticleEntity();
+    std::shared_ptr<Entity> AcquireParticle();
+    void ReleaseParticle(size_t slot); // Moves particles[slot] back to the pool
 };
 
 } // namespace Logic
@@ -5,51 +5,15 @@
 #include "Scene.h"
 #include "TransformComponent.h"
 #include "RenderComponent.h"
+#include "SimplePhysicsComponent.h"
 #include <memory>
+#include <random>
+#include <string>
 #include <vector>
 
 namespace Engine {
 namespace Logic {
 
-// Simple physics component for testing - moved to a separate header if needed
-class SimplePhysicsComponent : public Component {
-private:
-    glm::vec3 velocity = glm::vec3(0.0f);
-    glm::vec3 acceleration = glm::vec3(0.0f, -9.81f, 0.0f); // Gravity
-    float mass = 1.0f;
-    float bounceDamping = 0.7f; // Energy loss on bounce
-    bool affectedByGravity = true;
-
-public:
-    SimplePhysicsComponent(float m = 1.0f, bool gravity = true)
-        : mass(m), affectedByGravity(gravity) {}
-
-    void Update(float deltaTime) override;
-    std::string GetTypeName() const override { return "SimplePhysicsComponent"; }
-    std::string GetDebugInfo() const override;
-
-    // Physics properties
-    void SetVelocity(const glm::vec3& vel) { velocity = vel; }
-    const glm::vec3& GetVelocity() const { return velocity; }
-    void AddVelocity(const glm::vec3& vel) { velocity += vel; }
-
-    void SetAcceleration(const glm::vec3& acc) { acceleration = acc; }
-    const glm::vec3& GetAcceleration() const { return acceleration; }
-
-    void SetMass(float m) { mass = m; }
-    float GetMass() const { return mass; }
-
-    void SetBounceDamping(float damping) { bounceDamping = damping; }
-    float GetBounceDamping() const { return bounceDamping; }
-
-    void SetAffectedByGravity(bool affected) { affectedByGravity = affected; }
-    bool IsAffectedByGravity() const { return affectedByGravity; }
-
-    // Physics actions
-    void ApplyForce(const glm::vec3& force) { velocity += force / mass; }
-    void ApplyImpulse(const glm::vec3& impulse) { velocity += impulse; }
-};
-
 class PhysicsTestScene {
 private:
     std::shared_ptr<Scene> scene;
@@ -64,9 +28,15 @@ private:
     float floorY = 0.0f;
     bool physicsEnabled = true;
     float timeScale = 1.0f;
+    bool verbose = true; // Log every spawned cube
+
+    // Random cubes, fixed by the seed so runs can be replayed
+    uint32_t seed;
+    std::mt19937 gen;
+    int cubeCounter = 0;
 
 public:
-    PhysicsTestScene();
+    explicit PhysicsTestScene(uint32_t randomSeed = std::random_device{}());
     ~PhysicsTestScene() = default;
 
     void Initialize();
@@ -74,6 +44,11 @@ public:
     void Destroy();
     void Reset(); // Reset all physics objects
 
+    // Binary snapshots (SceneSerializer). Loading replaces every entity;
+    // if the file can't be loaded the scene is built from scratch again.
+    bool SaveSnapshot(const std::string& path) const;
+    bool LoadSnapshot(const std::string& path);
+
     // Access to the underlying scene
     std::shared_ptr<Scene> GetScene() const { return scene; }
 
@@ -84,6 +59,9 @@ public:
     void SetTimeScale(float scale) { timeScale = scale; }
     float GetTimeScale() const { return timeScale; }
 
+    uint32_t GetSeed() const { return seed; }
+    void SetVerbose(bool enabled) { verbose = enabled; }
+
     void SpawnRandomCube(); // Add a new falling cube
 };
 
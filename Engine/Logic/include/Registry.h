@@ -0,0 +1,202 @@
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+#include "ComponentPool.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace Engine {
+namespace Logic {
+
+class Entity;
+
+// 32-bit entity id: slot index in the low bits, generation in the high bits.
+// A destroyed entity's slot is reused with the next generation, so stale
+// handles stop resolving instead of pointing at the new occupant.
+struct EntityHandle {
+    static constexpr uint32_t INDEX_BITS = 20;
+    static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static constexpr uint32_t GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+    static constexpr uint32_t INVALID = UINT32_MAX;
+
+    uint32_t value = INVALID;
+
+    EntityHandle() = default;
+    EntityHandle(uint32_t index, uint32_t generation)
+        : value(((generation & GENERATION_MASK) << INDEX_BITS) | (index & INDEX_MASK)) {}
+
+    uint32_t GetIndex() const { return value & INDEX_MASK; }
+    uint32_t GetGeneration() const { return value >> INDEX_BITS; }
+    bool IsValid() const { return value != INVALID; }
+
+    bool operator==(const EntityHandle& other) const { return value == other.value; }
+    bool operator!=(const EntityHandle& other) const { return value != other.value; }
+};
+
+class Registry;
+
+// Entities that have every component in Ts. Iterates the smallest of the
+// pools and looks the rest up, components must not be added to or removed
+// from those pools inside Each.
+template<typename... Ts>
+class View {
+private:
+    const Registry& registry;
+    std::tuple<ComponentPool<Ts>*...> pools;
+
+public:
+    View(const Registry& owner, ComponentPool<Ts>*... componentPools)
+        : registry(owner), pools(componentPools...) {}
+
+    // fn(EntityHandle, Ts&...)
+    template<typename Fn>
+    void Each(Fn&& fn) const;
+
+    // Upper bound on the number of entities Each visits
+    size_t SizeHint() const;
+
+private:
+    const std::vector<uint32_t>* GetLeadIndices() const;
+};
+
+// Owns the component pools of a set of entities. Every Scene has one, entities
+// created outside a scene share the default registry.
+class Registry {
+private:
+    std::vector<uint32_t> generations;  // Current generation of each slot
+    std::vector<Entity*> owners;        // Entity object of each live slot
+    std::vector<uint32_t> freeIndices;
+    std::vector<std::unique_ptr<ComponentPoolBase>> pools; // Indexed by component type id
+
+    static size_t NextTypeId();
+
+public:
+    Registry() = default;
+    ~Registry() = default;
+
+    Registry(const Registry&) = delete;
+    Registry& operator=(const Registry&) = delete;
+
+    static std::shared_ptr<Registry> GetDefault();
+
+    // Small dense id per component type, shared by all registries
+    template<typename T>
+    static size_t TypeId() {
+        static const size_t id = NextTypeId();
+        return id;
+    }
+
+    // Entity lifetime (returns an invalid handle once all index bits are used)
+    EntityHandle Create(Entity* owner = nullptr);
+    void Destroy(EntityHandle handle);
+    void RemoveAll(EntityHandle handle); // Drops the components, keeps the entity
+    bool IsAlive(EntityHandle handle) const;
+    Entity* GetEntity(EntityHandle handle) const;
+    EntityHandle GetHandle(uint32_t index) const { return EntityHandle(index, generations[index]); }
+    size_t GetEntityCount() const { return generations.size() - freeIndices.size(); }
+    void Reserve(size_t entityCount); // Room for entityCount slots in total
+
+    // Components. Emplace returns the existing component if there is one.
+    template<typename T, typename... Args>
+    std::shared_ptr<T> Emplace(EntityHandle handle, Args&&... args) {
+        if (!IsAlive(handle)) return nullptr;
+        return GetPool<T>().Emplace(handle.GetIndex(), std::forward<Args>(args)...);
+    }
+
+    template<typename T>
+    T* Get(EntityHandle handle) const {
+        ComponentPool<T>* pool = FindPool<T>();
+        return (pool && IsAlive(handle)) ? pool->Get(handle.GetIndex()) : nullptr;
+    }
+
+    template<typename T>
+    std::shared_ptr<T> GetShared(EntityHandle handle) const {
+        ComponentPool<T>* pool = FindPool<T>();
+        return (pool && IsAlive(handle)) ? pool->GetShared(handle.GetIndex()) : nullptr;
+    }
+
+    template<typename T>
+    bool Has(EntityHandle handle) const {
+        ComponentPool<T>* pool = FindPool<T>();
+        return pool && IsAlive(handle) && pool->Has(handle.GetIndex());
+    }
+
+    template<typename T>
+    bool Remove(EntityHandle handle) {
+        ComponentPool<T>* pool = FindPool<T>();
+        return pool && IsAlive(handle) && pool->Remove(handle.GetIndex());
+    }
+
+    template<typename... Ts>
+    View<Ts...> GetView() const {
+        return View<Ts...>(*this, FindPool<Ts>()...);
+    }
+
+    // nullptr until the first component of type T is added
+    template<typename T>
+    ComponentPool<T>* FindPool() const {
+        const size_t id = TypeId<T>();
+        return id < pools.size() ? static_cast<ComponentPool<T>*>(pools[id].get()) : nullptr;
+    }
+
+    template<typename T>
+    ComponentPool<T>& GetPool() {
+        const size_t id = TypeId<T>();
+        if (id >= pools.size()) {
+            pools.resize(id + 1);
+        }
+        if (!pools[id]) {
+            pools[id] = std::make_unique<ComponentPool<T>>();
+        }
+        return *static_cast<ComponentPool<T>*>(pools[id].get());
+    }
+};
+
+template<typename... Ts>
+const std::vector<uint32_t>* View<Ts...>::GetLeadIndices() const {
+    const std::vector<uint32_t>* lead = nullptr;
+    bool missing = false;
+    auto consider = [&](const ComponentPoolBase* pool, const std::vector<uint32_t>* indices) {
+        if (!pool) {
+            missing = true;
+        } else if (!lead || indices->size() < lead->size()) {
+            lead = indices;
+        }
+    };
+    std::apply([&](auto*... pool) {
+        (consider(pool, pool ? &pool->GetEntityIndices() : nullptr), ...);
+    }, pools);
+    return missing ? nullptr : lead;
+}
+
+template<typename... Ts>
+template<typename Fn>
+void View<Ts...>::Each(Fn&& fn) const {
+    const std::vector<uint32_t>* lead = GetLeadIndices();
+    if (!lead) return;
+
+    for (uint32_t index : *lead) {
+        const bool hasAll = std::apply([index](auto*... pool) {
+            return (pool->Has(index) && ...);
+        }, pools);
+        if (!hasAll) continue;
+
+        std::apply([&](auto*... pool) {
+            fn(registry.GetHandle(index), *pool->Get(index)...);
+        }, pools);
+    }
+}
+
+template<typename... Ts>
+size_t View<Ts...>::SizeHint() const {
+    const std::vector<uint32_t>* lead = GetLeadIndices();
+    return lead ? lead->size() : 0;
+}
+
+} // namespace Logic
+} // namespace Engine
+
+#endif
@@ -29,7 +29,6 @@ public:
                    bool isVisible = true);
 
     // Component interface
-    void Update(float deltaTime) override;
     std::string GetTypeName() const override { return "RenderComponent"; }
     std::string GetDebugInfo() const override;
 
@@ -2,35 +2,132 @@
 #define SCENE_H
 
 #include "Entity.h"
+#include "FixedTimestep.h"
+#include "TransformSystem.h"
+#include "../../Common/include/FrameArena.h"
+#include <functional>
 #include <vector>
 #include <memory>
 #include <string>
+#include <tuple>
+#include <unordered_map>
 
 namespace Engine {
 namespace Logic {
 
+// Per-frame pass over the scene, typically one loop over a component view
+struct SceneSystem {
+    std::string name;
+    std::function<void(float)> update;
+    bool enabled = true;
+    const char* zoneName = nullptr; // Interned name for profiler zones
+};
+
 class Scene {
 private:
+    TransformSystem transformSystem; // Before registry: transforms unqueue themselves when destroyed
+    std::shared_ptr<Registry> registry; // Component storage of every entity in the scene
     std::vector<std::shared_ptr<Entity>> entities;
+    std::vector<uint32_t> entitySlots; // Registry index -> position in entities, for O(1) removal
+    std::unordered_map<int, uint32_t> idIndex; // Entity ID -> registry index
+    std::unordered_multimap<std::string, uint32_t> nameIndex; // Name -> registry index, unnamed entities left out
+    std::vector<std::shared_ptr<Entity>> pendingDestroy; // Removed, destroyed at the end of Update
+    std::vector<SceneSystem> systems;
     std::string name;
     bool active;
 
+    FixedTimestep timestep;
+    bool interpolationEnabled = true;
+
 public:
     Scene(const std::string& sceneName = "Untitled Scene");
-    ~Scene() = default;
+    ~Scene();
+
+    // Systems capture the scene
+    Scene(const Scene&) = delete;
+    Scene& operator=(const Scene&) = delete;
 
     // Entity management
     std::shared_ptr<Entity> CreateEntity(const std::string& name = "");
     std::shared_ptr<Entity> CreateEntity(int id, const std::string& name = "");
+    void Reserve(size_t entityCount); // Room for entityCount more entities, before a bulk load
+
+    // Removal takes the entity out of the scene (and deactivates it) right
+    // away; Entity::Destroy runs with the other removals at the end of the
+    // next Update, so systems may remove entities while iterating
     void RemoveEntity(int entityId);
     void RemoveEntity(std::shared_ptr<Entity> entity);
+    void FlushRemovals(); // Destroys removed entities now
+
+    // Takes an entity out of the scene without destroying it, and puts it
+    // back later. Only entities created by this scene's registry qualify.
+    // Removal swaps the last entity into the gap, so entity order changes.
+    bool DetachEntity(const std::shared_ptr<Entity>& entity);
+    bool AddEntity(std::shared_ptr<Entity> entity);
+    bool ContainsEntity(const Entity* entity) const { return FindSlot(entity) != ComponentPoolBase::NONE; }
+
+    // Hashed lookups. IDs should be unique (the first one attached wins);
+    // with a shared name any of the entities may be returned, and unnamed
+    // entities are not indexed.
     std::shared_ptr<Entity> FindEntity(int entityId);
     std::shared_ptr<Entity> FindEntity(const std::string& name);
 
-    // Scene lifecycle
+    // Systems run in order at the start of Update, before the entities whose
+    // components have their own Update. Every scene starts with "Physics"
+    // (integrates SimplePhysicsComponents).
+    void AddSystem(const std::string& systemName, std::function<void(float)> update);
+    bool InsertSystem(const std::string& beforeName, const std::string& systemName,
+                      std::function<void(float)> update);
+    bool RemoveSystem(const std::string& systemName);
+    bool SetSystemEnabled(const std::string& systemName, bool enabled);
+    bool HasSystem(const std::string& systemName) const;
+    const std::vector<SceneSystem>& GetSystems() const { return systems; }
+
+    // fn(deltaTime, Ts&...) for every active entity that has all of Ts enabled
+    template<typename... Ts, typename Fn>
+    void AddComponentSystem(const std::string& systemName, Fn fn) {
+        AddSystem(systemName, MakeComponentSystem<Ts...>(std::move(fn)));
+    }
+
+    template<typename... Ts, typename Fn>
+    std::function<void(float)> MakeComponentSystem(Fn fn) {
+        return [this, fn](float deltaTime) {
+            GetView<Ts...>().Each([&](EntityHandle, Ts&... components) {
+                // Same skip rules as Entity::Update
+                if (!(components.IsEnabled() && ...)) return;
+                Entity* owner = std::get<0>(std::tie(components...)).GetOwner();
+                if (owner && !owner->IsActive()) return;
+                fn(deltaTime, components...);
+            });
+        };
+    }
+
+    // Scene lifecycle. Update ends by rebuilding the dirty world matrices.
     void Update(float deltaTime);
     void Destroy();
 
+    // Fixed-step simulation: runs the systems and entities once per substep
+    // of every whole step the timestep has accumulated, storing each
+    // transform's previous state before a step, then rebuilds the dirty
+    // world matrices once. Returns the number of steps run.
+    int UpdateFixed(float deltaTime);
+    FixedTimestep& GetTimestep() { return timestep; }
+    const FixedTimestep& GetTimestep() const { return timestep; }
+
+    // Blend factor for TransformComponent::GetInterpolatedMatrix, 1 when
+    // interpolation is off
+    float GetInterpolationAlpha() const { return interpolationEnabled ? timestep.GetAlpha() : 1.0f; }
+    void SetInterpolationEnabled(bool enabled) { interpolationEnabled = enabled; }
+    bool IsInterpolationEnabled() const { return interpolationEnabled; }
+
+    // Snaps every transform's previous state to the current one, e.g. after
+    // a reset moved everything
+    void StorePreviousTransforms();
+
+    // Dirty list of this scene's transforms
+    TransformSystem& GetTransformSystem() { return transformSystem; }
+    const TransformSystem& GetTransformSystem() const { return transformSystem; }
+
     // Scene properties
     const std::string& GetName() const { return name; }
     void SetName(const std::string& newName) { name = newName; }
@@ -41,9 +138,29 @@ public:
     const std::vector<std::shared_ptr<Entity>>& GetEntities() const { return entities; }
     size_t GetEntityCount() const { return entities.size(); }
 
+    // Component storage, use GetView<...>() for typed iteration
+    Registry& GetRegistry() const { return *registry; }
+    template<typename... Ts>
+    View<Ts...> GetView() const { return registry->GetView<Ts...>(); }
+
     // Debug
     void PrintEntityList() const;
-    std::string GetDebugInfo() const;
+    Common::FrameString GetDebugInfo() const;
+
+private:
+    friend class Entity;
+
+    void Step(float deltaTime); // Update without the matrix rebuild
+
+    void Attach(std::shared_ptr<Entity> entity);
+    void DetachAt(uint32_t slot);
+    void RemoveAt(uint32_t slot);
+    uint32_t FindSlot(const Entity* entity) const;
+    uint32_t FindSlot(int entityId) const;
+
+    void IndexName(const std::string& entityName, uint32_t index);
+    void UnindexName(const std::string& entityName, uint32_t index);
+    void OnEntityRenamed(Entity& entity, const std::string& oldName);
 };
 
 } // namespace Logic
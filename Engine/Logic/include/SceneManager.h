@@ -2,13 +2,49 @@
 #define SCENE_MANAGER_H
 
 #include "Scene.h"
+#include "../../Common/include/FrameArena.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace Engine {
 namespace Logic {
 
+// Handed to a SceneBuilder while it runs on the loader thread
+class SceneLoadContext {
+private:
+    std::atomic<float> progress{0.0f};
+    std::atomic<bool> cancelled{false};
+    std::vector<std::function<void()>> mainThreadSteps; // Builder writes, main thread runs after the build
+
+    friend class SceneManager;
+
+public:
+    // Fraction of the build done so far, 0 to 1
+    void SetProgress(float fraction) { progress.store(fraction, std::memory_order_relaxed); }
+    float GetProgress() const { return progress.load(std::memory_order_relaxed); }
+
+    // Set when the load is cancelled; the result is dropped, so long
+    // builds may return early
+    bool IsCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+    // Work that must happen on the main thread once the build is done (GPU
+    // uploads, handing the scene's owner to the app). Steps run in order,
+    // spread over frames by the manager's staging budget.
+    void AddMainThreadStep(std::function<void()> step) { mainThreadSteps.push_back(std::move(step)); }
+};
+
+// Builds a scene away from the main thread. It may only touch the new
+// scene and thread-safe state, everything else goes in main thread steps.
+// Returning nullptr fails the load.
+using SceneBuilder = std::function<std::shared_ptr<Scene>(SceneLoadContext&)>;
+
 class SceneManager {
 private:
     std::unordered_map<std::string, std::shared_ptr<Scene>> scenes;
@@ -17,15 +53,59 @@ private:
     std::shared_ptr<Scene> nextScene; // For scene transitions
     bool sceneTransitionPending = false;
 
+    // Asynchronous loads: one scene at a time is built on the loader thread,
+    // staged on the main thread, then registered and swapped in. The loader
+    // is a thread of its own, not a job: JobSystem::Wait runs queued jobs on
+    // the waiting thread, which could pull a whole build onto the main thread.
+    std::unordered_map<std::string, SceneBuilder> builders;
+    std::thread loaderThread;
+    std::mutex loaderMutex;
+    std::condition_variable loaderWake;
+    bool loaderStopping = false;                  // Guarded by loaderMutex
+    SceneBuilder queuedBuild;                     // Guarded, taken by the loader
+    std::shared_ptr<SceneLoadContext> queuedContext; // Guarded
+    std::shared_ptr<Scene> builtScene;            // Guarded, result of the last build
+    bool buildFinished = false;                   // Guarded
+
+    std::string loadingSceneName; // Empty when no load is in flight
+    std::shared_ptr<SceneLoadContext> loadContext;
+    bool staging = false;          // Build done, running main thread steps
+    size_t stagedSteps = 0;
+    bool activateWhenLoaded = true; // Cleared when another scene is picked meanwhile
+    float stagingBudgetMs = 2.0f;
+
 public:
     SceneManager() = default;
-    ~SceneManager() = default;
+    ~SceneManager();
+
+    SceneManager(const SceneManager&) = delete;
+    SceneManager& operator=(const SceneManager&) = delete;
 
     // Scene management
     void RegisterScene(const std::string& name, std::shared_ptr<Scene> scene);
     bool LoadScene(const std::string& name);
     void UnloadCurrentScene();
 
+    // Asynchronous loading. A registered scene is swapped in as by
+    // LoadScene; otherwise its builder runs on the loader thread while the
+    // current scene keeps going, and the new scene becomes current in the
+    // ProcessSceneTransition that finishes its main thread steps. Fails for
+    // unknown names and while another scene is loading. Picking another
+    // scene meanwhile still finishes the load, but only registers it.
+    void RegisterSceneBuilder(const std::string& name, SceneBuilder builder);
+    bool LoadSceneAsync(const std::string& name);
+    void CancelLoad(); // Waits for the builder to return and drops its scene
+
+    bool IsLoading() const { return !loadingSceneName.empty(); }
+    const std::string& GetLoadingSceneName() const { return loadingSceneName; }
+    // The build counts for the first 90%, main thread steps for the rest
+    float GetLoadProgress() const;
+
+    // Main thread time spent on staged steps per ProcessSceneTransition (at
+    // least one step always runs)
+    void SetStagingBudget(float milliseconds) { stagingBudgetMs = milliseconds; }
+    float GetStagingBudget() const { return stagingBudgetMs; }
+
     // Scene access
     std::shared_ptr<Scene> GetCurrentScene() const { return currentScene; }
     const std::string& GetCurrentSceneName() const { return currentSceneName; }
@@ -40,8 +120,14 @@ public:
     void ProcessSceneTransition(); // Call this in your main loop
 
     // Debug
-    std::string GetDebugInfo() const;
+    // Frame arena string, valid until the next frame starts
+    Common::FrameString GetDebugInfo() const;
     void PrintSceneList() const;
+
+private:
+    void LoaderLoop();
+    void UpdateAsyncLoad();
+    void StopLoader();
 };
 
 } // namespace Logic
@@ -0,0 +1,142 @@
+#ifndef SCENE_SERIALIZER_H
+#define SCENE_SERIALIZER_H
+
+#include "Scene.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Engine {
+namespace Logic {
+
+// Binary snapshot of a scene's entities and their Transform, Render,
+// SimplePhysics and Collision components. The file is a header and a table
+// directory followed by flat tables of fixed-size records, one table per
+// component type plus one of strings, so loading maps the file once and
+// builds every entity straight from the records without parsing.
+//
+// Records refer to entities by row (position in the entity table) and to
+// names, layers and mesh paths by string index. Each table stores its
+// record stride: a later version may append fields to a record and older
+// fields keep their place, so readers accept files written before a field
+// was appended (it reads as zero) and skip fields appended after them.
+// Files are little-endian, the header's byte order mark rejects anything
+// else.
+class SceneSerializer {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    // Writes every entity listed by the scene (detached ones are left out)
+    // and its timestep settings. Transform parents outside the saved set
+    // are saved as roots.
+    static bool Save(const Scene& scene, const std::string& path);
+
+    // Adds the file's entities to scene, with their saved IDs, names and
+    // hierarchy, and applies the timestep settings. The whole file is
+    // checked before anything is created, so a damaged file leaves the
+    // scene untouched. created receives the new entities in file order.
+    static bool Load(Scene& scene, const std::string& path,
+                     std::vector<std::shared_ptr<Entity>>* created = nullptr);
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX; // No string / no parent
+    static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304u;
+
+    enum TableType : uint32_t {
+        TABLE_ENTITIES,
+        TABLE_TRANSFORMS,
+        TABLE_RENDERS,
+        TABLE_PHYSICS,
+        TABLE_COLLIDERS,
+        TABLE_STRINGS,
+        TABLE_TYPE_COUNT
+    };
+
+    // Record flag bits
+    static constexpr uint32_t FLAG_ACTIVE = 1u << 0;    // Entity
+    static constexpr uint32_t FLAG_ENABLED = 1u << 0;   // Components
+    static constexpr uint32_t FLAG_VISIBLE = 1u << 1;   // Render
+    static constexpr uint32_t FLAG_GRAVITY = 1u << 1;   // Physics
+    static constexpr uint32_t FLAG_BOUNDS = 1u << 2;
+    static constexpr uint32_t FLAG_SLEEPING = 1u << 3;
+    static constexpr uint32_t FLAG_TRIGGER = 1u << 1;   // Collision
+    static constexpr uint32_t FLAG_STATIC = 1u << 2;
+
+    struct FileHeader {
+        char magic[4];          // "BESC"
+        uint32_t formatVersion;
+        uint32_t byteOrder;     // BYTE_ORDER_MARK as written
+        uint32_t tableCount;    // TableInfo entries right after the header
+        uint32_t reserved;
+        float stepSize;
+        int32_t substeps;
+        int32_t maxStepsPerFrame;
+    };
+    static_assert(sizeof(FileHeader) == 32, "FileHeader layout changed");
+
+    struct TableInfo {
+        uint32_t type;          // TableType, unknown types are skipped
+        uint32_t count;         // Records (strings for the string table)
+        uint32_t stride;        // Bytes per record, 0 for the string table
+        uint32_t reserved;
+        uint64_t offset;        // From the start of the file, 8-byte aligned
+        uint64_t bytes;
+    };
+    static_assert(sizeof(TableInfo) == 32, "TableInfo layout changed");
+
+    struct EntityRecord {
+        int32_t id;
+        uint32_t name;
+        uint32_t flags;
+    };
+    static_assert(sizeof(EntityRecord) == 12, "EntityRecord layout changed");
+
+    struct TransformRecord {
+        uint32_t entity;
+        uint32_t parent;        // Row of the parent's entity, NONE for roots
+        uint32_t flags;
+        float position[3];
+        float orientation[4];   // w, x, y, z
+        float rotation[3];      // Euler cache, so editing angles round-trips
+        float scale[3];
+        double precisePosition[3]; // Appended; position rounded to float stays for older readers
+    };
+    static_assert(sizeof(TransformRecord) == 88, "TransformRecord layout changed");
+
+    struct RenderRecord {
+        uint32_t entity;
+        uint32_t primitive;
+        uint32_t meshPath;
+        uint32_t flags;
+        float color[3];
+    };
+    static_assert(sizeof(RenderRecord) == 28, "RenderRecord layout changed");
+
+    struct PhysicsRecord {
+        uint32_t entity;
+        uint32_t flags;
+        float velocity[3];
+        float acceleration[3];
+        float mass;
+        float bounceDamping;
+        float sleepTime;
+    };
+    static_assert(sizeof(PhysicsRecord) == 44, "PhysicsRecord layout changed");
+
+    struct ColliderRecord {
+        uint32_t entity;
+        uint32_t shape;
+        uint32_t layer;
+        uint32_t flags;
+        float circle[3];        // Radius, offset
+        float aabb[4];          // Size, offset
+        float line[5];          // Start, end, thickness
+    };
+    static_assert(sizeof(ColliderRecord) == 64, "ColliderRecord layout changed");
+};
+
+} // namespace Logic
+} // namespace Engine
+
+#endif
@@ -8,6 +8,8 @@
 namespace Engine {
 namespace Logic {
 
+class TransformComponent;
+
 // Simple physics component for basic physics simulation
 class SimplePhysicsComponent : public Component {
 private:
@@ -16,19 +18,28 @@ private:
     float mass = 1.0f;
     float bounceDamping = 0.7f; // Energy loss on bounce
     bool affectedByGravity = true;
+    bool worldBounds = true; // Floor at y = 0.5 and walls at +-10 in Integrate
+
+    // Managed by the collision system's contact solver
+    bool sleeping = false;
+    float sleepTime = 0.0f; // Seconds spent below the solver's sleep velocity
 
 public:
     SimplePhysicsComponent(float m = 1.0f, bool gravity = true)
         : mass(m), affectedByGravity(gravity) {}
 
-    void Update(float deltaTime) override;
+    // Advances the owner's transform by one step. Runs from the scene's
+    // "Physics" system, the component itself has no per-frame Update.
+    // Sleeping bodies are skipped.
+    void Integrate(TransformComponent& transform, float deltaTime);
+
     std::string GetTypeName() const override { return "SimplePhysicsComponent"; }
     std::string GetDebugInfo() const override;
 
     // Physics properties
     void SetVelocity(const glm::vec3& vel) { velocity = vel; }
     const glm::vec3& GetVelocity() const { return velocity; }
-    void AddVelocity(const glm::vec3& vel) { velocity += vel; }
+    void AddVelocity(const glm::vec3& vel) { velocity += vel; WakeUp(); }
 
     void SetAcceleration(const glm::vec3& acc) { acceleration = acc; }
     const glm::vec3& GetAcceleration() const { return acceleration; }
@@ -42,9 +53,21 @@ public:
     void SetAffectedByGravity(bool affected) { affectedByGravity = affected; }
     bool IsAffectedByGravity() const { return affectedByGravity; }
 
-    // Physics actions
-    void ApplyForce(const glm::vec3& force) { velocity += force / mass; }
-    void ApplyImpulse(const glm::vec3& impulse) { velocity += impulse; }
+    // Off for bodies kept in place by colliders instead
+    void SetWorldBounds(bool enabled) { worldBounds = enabled; }
+    bool HasWorldBounds() const { return worldBounds; }
+
+    // Physics actions (wake the body up)
+    void ApplyForce(const glm::vec3& force) { velocity += force / mass; WakeUp(); }
+    void ApplyImpulse(const glm::vec3& impulse) { velocity += impulse; WakeUp(); }
+
+    // Sleeping. SetVelocity leaves the state alone, since the collision
+    // system writes solved velocities back through it every step.
+    bool IsSleeping() const { return sleeping; }
+    void Sleep() { sleeping = true; velocity = glm::vec3(0.0f); }
+    void WakeUp() { sleeping = false; sleepTime = 0.0f; }
+    float GetSleepTime() const { return sleepTime; }
+    void SetSleepTime(float seconds) { sleepTime = seconds; }
 };
 
 } // namespace Logic
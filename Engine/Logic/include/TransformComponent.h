@@ -2,6 +2,8 @@
 #define TRANSFORM_COMPONENT_H
 
 #include "Component.h"
+#include <cstdint>
+#include <vector>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
@@ -9,51 +11,129 @@
 namespace Engine{
 namespace Logic{
 
+class TransformSystem;
+
+// Local position, orientation and scale relative to an optional parent.
+// Orientation is stored as a quaternion; the Euler accessors (radians,
+// applied X, then Y, then Z) stay for code that edits angles. Edits only
+// flag the transform and its subtree: the scene's TransformSystem rebuilds
+// the dirty world matrices once per update, parents before children, and
+// the matrix getters rebuild on demand for anything read in between.
+//
+// Positions are doubles, so objects far from the world origin keep their
+// precision. The float accessors and matrices are for code that works near
+// the origin (physics, 2D scenes); renderers take origin-relative matrices
+// (GetRelativeMatrix, TransformSystem::BuildRelativeMatrices) instead.
 class TransformComponent : public Component{
 private:
-    glm::vec3 position;
-    glm::vec3 rotation;
+    glm::dvec3 position;
+    glm::quat orientation;
+    glm::vec3 rotation; // Euler angles of orientation
     glm::vec3 scale;
 
-    mutable glm::mat4 transformMatrix;
+    // State at the start of the last fixed step, for render interpolation
+    glm::dvec3 previousPosition;
+    glm::quat previousOrientation;
+    glm::vec3 previousScale;
+
+    // Hierarchy. Both sides are unlinked when either transform goes away.
+    TransformComponent* parent = nullptr;
+    std::vector<TransformComponent*> children;
+    uint32_t depth = 0; // Number of ancestors
+
+    // World matrix, its translation also kept in double; dirty implies
+    // every descendant is dirty too
+    mutable glm::mat4 worldMatrix;
+    mutable glm::dvec3 worldPosition;
     mutable bool isDirty = true;
 
+    // Dirty list entry, owned by TransformSystem
+    TransformSystem* queuedIn = nullptr;
+    uint32_t queuedSlot = 0;
+
+    friend class TransformSystem;
+    friend class SceneSerializer; // Restores orientation and Euler cache as saved
+
 public:
     TransformComponent(const glm::vec3& pos = glm::vec3(0.0f),
                       const glm::vec3& rot = glm::vec3(0.0f),
                       const glm::vec3& scl = glm::vec3(1.0f));
+    ~TransformComponent() override;
+
+    // Pointers between transforms make a copy meaningless
+    TransformComponent(const TransformComponent&) = delete;
+    TransformComponent& operator=(const TransformComponent&) = delete;
 
     // Component interface
-    void Update(float deltaTime) override;
+    void Initialize() override;
+    void Destroy() override;
     std::string GetTypeName() const override { return "TransformComponent"; }
     std::string GetDebugInfo() const override;
 
-    // Position
+    // Position (local)
     void SetPosition(const glm::vec3& pos);
-    const glm::vec3& GetPosition() const { return position; }
+    glm::vec3 GetPosition() const { return glm::vec3(position); }
     void Translate(const glm::vec3& delta);
+    void SetPrecisePosition(const glm::dvec3& pos);
+    const glm::dvec3& GetPrecisePosition() const { return position; }
 
-    // Rotation (in radians)
+    // Rotation as Euler angles (in radians, local)
     void SetRotation(const glm::vec3& rot);
     const glm::vec3& GetRotation() const { return rotation; }
     void Rotate(const glm::vec3& delta);
 
-    // Scale
+    // Rotation as a quaternion (local). Rotate applies delta after the
+    // current orientation, in local space.
+    void SetOrientation(const glm::quat& quat);
+    const glm::quat& GetOrientation() const { return orientation; }
+    void Rotate(const glm::quat& delta);
+
+    // Scale (local)
     void SetScale(const glm::vec3& scl);
     void SetScale(float uniformScale);
     const glm::vec3& GetScale() const { return scale; }
 
-    // Transform matrix
-    const glm::mat4& GetTransformMatrix() const;
+    // Hierarchy. SetParent keeps the local values, so the transform moves
+    // with its new parent; it refuses parents that would form a cycle.
+    bool SetParent(TransformComponent* newParent);
+    TransformComponent* GetParent() const { return parent; }
+    const std::vector<TransformComponent*>& GetChildren() const { return children; }
+    uint32_t GetDepth() const { return depth; }
+
+    // Transform matrices. GetTransformMatrix is the world matrix (the local
+    // one for transforms without a parent).
+    const glm::mat4& GetWorldMatrix() const;
+    const glm::mat4& GetTransformMatrix() const { return GetWorldMatrix(); }
+    glm::mat4 GetLocalMatrix() const;
+    glm::vec3 GetWorldPosition() const { return glm::vec3(GetWorldMatrix()[3]); }
+    const glm::dvec3& GetPreciseWorldPosition() const;
+    bool IsDirty() const { return isDirty; }
+
+    // World matrix with its translation relative to origin, exact to float
+    // precision around origin however far away both are
+    glm::mat4 GetRelativeMatrix(const glm::dvec3& origin) const;
+
+    // Interpolation between fixed steps. StorePreviousState runs before each
+    // step; call it after moving an object outside the simulation (spawn,
+    // reset) so it doesn't blend in from its old place. alpha 0 is the
+    // previous state, 1 the current one. The translation is relative to
+    // origin, like GetRelativeMatrix.
+    void StorePreviousState();
+    glm::mat4 GetInterpolatedMatrix(float alpha, const glm::dvec3& origin = glm::dvec3(0.0)) const;
 
-    // Direction vectors
+    // Direction vectors (world)
     glm::vec3 GetForward() const;
     glm::vec3 GetRight() const;
     glm::vec3 GetUp() const;
 
 private:
-    void UpdateMatrix() const;
-    void MarkDirty() { isDirty = true; }
+    void MarkDirty();
+    void MarkSubtreeDirty();
+    void DetachFromParent();
+    void UpdateDepth();
+    void RebuildWorldMatrix() const;
+    void InterpolateWorld(float alpha, glm::mat4& linear, glm::dvec3& translation) const;
+    void Unlink();
 };
 
 } // namespace Logic
@@ -0,0 +1,49 @@
+#ifndef TRANSFORM_SYSTEM_H
+#define TRANSFORM_SYSTEM_H
+
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Engine {
+namespace Logic {
+
+class TransformComponent;
+
+// Dirty list of a scene's transforms. A transform queues itself on its first
+// edit since the last rebuild; Update then rebuilds the world matrices of
+// the queued transforms and their subtrees in one pass, ordered by depth so
+// every parent is done before its children. Transforms at rest cost nothing.
+// Not thread-safe, like the rest of the scene.
+class TransformSystem {
+private:
+    std::vector<TransformComponent*> dirty; // nullptr where a transform left early
+    size_t lastRebuildCount = 0;
+
+public:
+    TransformSystem() = default;
+    ~TransformSystem();
+
+    // Transforms keep pointers to their system
+    TransformSystem(const TransformSystem&) = delete;
+    TransformSystem& operator=(const TransformSystem&) = delete;
+
+    void Queue(TransformComponent& transform);
+    void Remove(TransformComponent& transform);
+
+    void Update();
+
+    // Render matrices for a batch of this scene's transforms: each out[i]
+    // is transforms[i]->GetInterpolatedMatrix(alpha, origin). Runs Update
+    // first, so the batch only reads and is split across the job system.
+    void BuildRelativeMatrices(const TransformComponent* const* transforms, size_t count,
+                               const glm::dvec3& origin, float alpha, glm::mat4* out);
+
+    size_t GetQueuedCount() const { return dirty.size(); }
+    size_t GetLastRebuildCount() const { return lastRebuildCount; }
+};
+
+} // namespace Logic
+} // namespace Engine
+
+#endif
@@ -0,0 +1,273 @@
+#include "../include/Broadphase.h"
+#include "../../Common/include/JobSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace Engine {
+namespace Logic {
+
+namespace {
+
+int CellCoord(float value, float cellSize) {
+    float cell = std::floor(value / cellSize);
+    // Keep far-away proxies from overflowing the packed key
+    cell = std::max(cell, static_cast<float>(std::numeric_limits<int32_t>::min() / 2));
+    cell = std::min(cell, static_cast<float>(std::numeric_limits<int32_t>::max() / 2));
+    return static_cast<int>(cell);
+}
+
+uint64_t PackCell(int x, int y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+BroadphasePair MakePair(uint32_t a, uint32_t b) {
+    return (a < b) ? BroadphasePair(a, b) : BroadphasePair(b, a);
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Brute force
+// ---------------------------------------------------------------------------
+
+void BruteForceBroadphase::FindPairs(const std::vector<BroadphaseProxy>& proxies,
+                                     std::vector<BroadphasePair>& outPairs) {
+    outPairs.clear();
+
+    const uint32_t count = static_cast<uint32_t>(proxies.size());
+    for (uint32_t i = 0; i < count; ++i) {
+        for (uint32_t j = i + 1; j < count; ++j) {
+            if (CanCollide(proxies[i], proxies[j]) && Overlaps(proxies[i], proxies[j])) {
+                outPairs.emplace_back(i, j);
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Spatial hash
+// ---------------------------------------------------------------------------
+
+float SpatialHashBroadphase::ComputeCellSize(const std::vector<BroadphaseProxy>& proxies) const {
+    if (cellSize > 0.0f) return cellSize;
+
+    // Use the smaller side of each proxy so long thin walls don't inflate the
+    // grid - they are handled as oversized proxies instead
+    float largest = 0.0f;
+    for (const auto& proxy : proxies) {
+        glm::vec2 size = proxy.max - proxy.min;
+        largest = std::max(largest, std::min(size.x, size.y));
+    }
+
+    return (largest > 0.0f) ? largest : 1.0f;
+}
+
+void SpatialHashBroadphase::FindPairs(const std::vector<BroadphaseProxy>& proxies,
+                                      std::vector<BroadphasePair>& outPairs) {
+    outPairs.clear();
+
+    BuildCells(proxies);
+    FindCellPairs(proxies, 0, runStarts.size() - 1, outPairs);
+    FindOversizedPairs(proxies, outPairs);
+
+    std::sort(outPairs.begin(), outPairs.end());
+}
+
+void SpatialHashBroadphase::FindPairsParallel(const std::vector<BroadphaseProxy>& proxies,
+                                              std::vector<BroadphasePair>& outPairs, size_t maxThreads) {
+    outPairs.clear();
+
+    BuildCells(proxies);
+
+    // A few ranges per thread so a crowded region doesn't stall one worker
+    Common::JobSystem& jobs = Common::JobSystem::Get();
+    size_t threads = jobs.GetThreadCount();
+    if (maxThreads > 0) threads = std::min(threads, maxThreads);
+
+    const size_t runCount = runStarts.size() - 1;
+    const size_t runsPerTask = std::max<size_t>(1, runCount / (threads * 4));
+    taskPairs.resize((runCount + runsPerTask - 1) / runsPerTask);
+
+    jobs.ParallelFor(0, runCount, runsPerTask, [&](size_t firstRun, size_t lastRun) {
+        auto& pairs = taskPairs[firstRun / runsPerTask];
+        pairs.clear();
+        FindCellPairs(proxies, firstRun, lastRun, pairs);
+    }, threads);
+
+    for (const auto& pairs : taskPairs) {
+        outPairs.insert(outPairs.end(), pairs.begin(), pairs.end());
+    }
+    FindOversizedPairs(proxies, outPairs);
+
+    std::sort(outPairs.begin(), outPairs.end());
+}
+
+void SpatialHashBroadphase::BuildCells(const std::vector<BroadphaseProxy>& proxies) {
+    entries.clear();
+    oversized.clear();
+    isOversized.assign(proxies.size(), 0);
+
+    const float size = ComputeCellSize(proxies);
+    lastCellSize = size;
+
+    // Insert every proxy into each cell its bounds touch
+    const uint32_t count = static_cast<uint32_t>(proxies.size());
+    for (uint32_t i = 0; i < count; ++i) {
+        const BroadphaseProxy& proxy = proxies[i];
+        int minX = CellCoord(proxy.min.x, size);
+        int minY = CellCoord(proxy.min.y, size);
+        int maxX = CellCoord(proxy.max.x, size);
+        int maxY = CellCoord(proxy.max.y, size);
+
+        int64_t cells = (static_cast<int64_t>(maxX) - minX + 1) * (static_cast<int64_t>(maxY) - minY + 1);
+        if (cells > maxCellsPerProxy) {
+            oversized.push_back(i);
+            isOversized[i] = 1;
+            continue;
+        }
+
+        for (int x = minX; x <= maxX; ++x) {
+            for (int y = minY; y <= maxY; ++y) {
+                entries.push_back({PackCell(x, y), i});
+            }
+        }
+    }
+
+    // Sorting groups entries by cell; within a cell proxies stay in index order
+    std::sort(entries.begin(), entries.end());
+
+    runStarts.clear();
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (i == 0 || entries[i].cellKey != entries[i - 1].cellKey) {
+            runStarts.push_back(i);
+        }
+    }
+    runStarts.push_back(entries.size());
+}
+
+void SpatialHashBroadphase::FindCellPairs(const std::vector<BroadphaseProxy>& proxies, size_t firstRun, size_t lastRun,
+                                          std::vector<BroadphasePair>& outPairs) const {
+    const float size = lastCellSize;
+
+    for (size_t run = firstRun; run < lastRun; ++run) {
+        const size_t runStart = runStarts[run];
+        const size_t runEnd = runStarts[run + 1];
+
+        const uint64_t key = entries[runStart].cellKey;
+        const int cellX = static_cast<int32_t>(static_cast<uint32_t>(key >> 32));
+        const int cellY = static_cast<int32_t>(static_cast<uint32_t>(key & 0xFFFFFFFFu));
+
+        for (size_t a = runStart; a < runEnd; ++a) {
+            const BroadphaseProxy& proxyA = proxies[entries[a].proxy];
+            for (size_t b = a + 1; b < runEnd; ++b) {
+                const BroadphaseProxy& proxyB = proxies[entries[b].proxy];
+                if (!CanCollide(proxyA, proxyB) || !Overlaps(proxyA, proxyB)) continue;
+
+                // Pairs sharing several cells are only reported by the cell
+                // holding the minimum corner of their overlap
+                int ownerX = CellCoord(std::max(proxyA.min.x, proxyB.min.x), size);
+                int ownerY = CellCoord(std::max(proxyA.min.y, proxyB.min.y), size);
+                if (ownerX == cellX && ownerY == cellY) {
+                    outPairs.push_back(MakePair(entries[a].proxy, entries[b].proxy));
+                }
+            }
+        }
+    }
+}
+
+void SpatialHashBroadphase::FindOversizedPairs(const std::vector<BroadphaseProxy>& proxies,
+                                               std::vector<BroadphasePair>& outPairs) const {
+    // Oversized proxies are tested against everything
+    const uint32_t count = static_cast<uint32_t>(proxies.size());
+    for (uint32_t big : oversized) {
+        for (uint32_t other = 0; other < count; ++other) {
+            if (other == big) continue;
+            if (isOversized[other] && other < big) continue; // Already reported from the other side
+            if (CanCollide(proxies[big], proxies[other]) && Overlaps(proxies[big], proxies[other])) {
+                outPairs.push_back(MakePair(big, other));
+            }
+        }
+    }
+}
+
+Common::FrameString SpatialHashBroadphase::GetDebugInfo() const {
+    Common::FrameStringStream oss;
+    oss << std::fixed << std::setprecision(2);
+    oss << GetTypeName() << " (cell size " << lastCellSize
+        << (cellSize > 0.0f ? "" : ", auto") << ", oversized " << oversized.size() << ")";
+    return oss.str();
+}
+
+// ---------------------------------------------------------------------------
+// Sweep and prune
+// ---------------------------------------------------------------------------
+
+void SweepAndPruneBroadphase::FindPairs(const std::vector<BroadphaseProxy>& proxies,
+                                        std::vector<BroadphasePair>& outPairs) {
+    outPairs.clear();
+
+    const uint32_t count = static_cast<uint32_t>(proxies.size());
+    auto lessMinX = [&proxies](uint32_t a, uint32_t b) {
+        return proxies[a].min.x < proxies[b].min.x;
+    };
+
+    if (order.size() != count) {
+        // Proxy set changed - start over with a full sort
+        order.resize(count);
+        for (uint32_t i = 0; i < count; ++i) order[i] = i;
+        std::sort(order.begin(), order.end(), lessMinX);
+    } else {
+        // Insertion sort is close to linear when proxies move a little per frame
+        for (size_t i = 1; i < order.size(); ++i) {
+            uint32_t value = order[i];
+            size_t j = i;
+            while (j > 0 && lessMinX(value, order[j - 1])) {
+                order[j] = order[j - 1];
+                --j;
+            }
+            order[j] = value;
+        }
+    }
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        const BroadphaseProxy& proxyA = proxies[order[i]];
+        for (size_t j = i + 1; j < order.size(); ++j) {
+            const BroadphaseProxy& proxyB = proxies[order[j]];
+            if (proxyB.min.x > proxyA.max.x) break; // No later proxy can overlap on X
+
+            if (proxyA.min.y <= proxyB.max.y && proxyB.min.y <= proxyA.max.y && CanCollide(proxyA, proxyB)) {
+                outPairs.push_back(MakePair(order[i], order[j]));
+            }
+        }
+    }
+
+    std::sort(outPairs.begin(), outPairs.end());
+}
+
+// ---------------------------------------------------------------------------
+// Factory
+// ---------------------------------------------------------------------------
+
+std::unique_ptr<Broadphase> CreateBroadphase(BroadphaseType type) {
+    switch (type) {
+        case BroadphaseType::BRUTE_FORCE: return std::make_unique<BruteForceBroadphase>();
+        case BroadphaseType::SPATIAL_HASH: return std::make_unique<SpatialHashBroadphase>();
+        case BroadphaseType::SWEEP_AND_PRUNE: return std::make_unique<SweepAndPruneBroadphase>();
+    }
+    return std::make_unique<SpatialHashBroadphase>();
+}
+
+const char* GetBroadphaseTypeName(BroadphaseType type) {
+    switch (type) {
+        case BroadphaseType::BRUTE_FORCE: return "Brute Force";
+        case BroadphaseType::SPATIAL_HASH: return "Spatial Hash";
+        case BroadphaseType::SWEEP_AND_PRUNE: return "Sweep and Prune";
+    }
+    return "Unknown";
+}
+
+} // namespace Logic
+} // namespace Engine
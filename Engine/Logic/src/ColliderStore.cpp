@@ -0,0 +1,180 @@
+#include "../include/ColliderStore.h"
+#include "../include/Entity.h"
+#include "../include/SimplePhysicsComponent.h"
+#include "../include/TransformComponent.h"
+#include "../../Common/include/Profiler.h"
+
+namespace Engine {
+namespace Logic {
+
+void ColliderStore::Clear() {
+    shape.clear();
+    posX.clear();
+    posY.clear();
+    offsetX.clear();
+    offsetY.clear();
+    radius.clear();
+    halfX.clear();
+    halfY.clear();
+    lineStart.clear();
+    lineEnd.clear();
+    lineThickness.clear();
+    flags.clear();
+    category.clear();
+    mask.clear();
+    entityIndex.clear();
+
+    velX.clear();
+    velY.clear();
+    mass.clear();
+    bounceDamping.clear();
+
+    entities.clear();
+    colliders.clear();
+    transforms.clear();
+    physics.clear();
+}
+
+void ColliderStore::Sync(const std::vector<std::shared_ptr<Entity>>& registered) {
+    PROFILE_SCOPE("ColliderStore::Sync");
+    Clear();
+
+    for (size_t i = 0; i < registered.size(); ++i) {
+        Entity* entity = registered[i].get();
+        if (!entity || !entity->IsActive()) continue;
+
+        // Raw pool lookups, no shared_ptr copies per collider
+        auto* collider = entity->GetRegistry().Get<CollisionComponent>(entity->GetHandle());
+        if (!collider) continue;
+
+        Add(entity, collider, static_cast<uint32_t>(i));
+    }
+}
+
+uint32_t ColliderStore::Add(Entity* entity, CollisionComponent* collider, uint32_t ownerIndex) {
+    const uint32_t index = static_cast<uint32_t>(shape.size());
+
+    TransformComponent* transform = entity ? entity->GetRegistry().Get<TransformComponent>(entity->GetHandle()) : nullptr;
+    SimplePhysicsComponent* body = entity ? entity->GetRegistry().Get<SimplePhysicsComponent>(entity->GetHandle()) : nullptr;
+
+    uint8_t slotFlags = 0;
+    if (collider->IsStatic()) slotFlags |= STATIC;
+    if (collider->IsTrigger()) slotFlags |= TRIGGER;
+    if (transform) slotFlags |= HAS_TRANSFORM;
+    if (body) slotFlags |= HAS_PHYSICS;
+    if (body && body->IsSleeping()) slotFlags |= SLEEPING;
+
+    // Same world position rules as CollisionComponent::GetWorldPosition
+    glm::vec2 position(0.0f);
+    if (transform) {
+        position = glm::vec2(transform->GetPosition().x, transform->GetPosition().y);
+    }
+
+    const CircleCollider& circle = collider->GetCircle();
+    const AABBCollider& aabb = collider->GetAABB();
+    const LineCollider& line = collider->GetLine();
+
+    glm::vec2 offset(0.0f);
+    switch (collider->GetShape()) {
+        case CollisionShape::CIRCLE: offset = circle.offset; break;
+        case CollisionShape::AABB: offset = aabb.offset; break;
+        case CollisionShape::LINE_SEGMENT: offset = (line.start + line.end) * 0.5f; break;
+        default: break;
+    }
+
+    shape.push_back(collider->GetShape());
+    posX.push_back(position.x);
+    posY.push_back(position.y);
+    offsetX.push_back(offset.x);
+    offsetY.push_back(offset.y);
+    radius.push_back(circle.radius);
+    halfX.push_back(aabb.size.x * 0.5f);
+    halfY.push_back(aabb.size.y * 0.5f);
+    lineStart.push_back(line.start);
+    lineEnd.push_back(line.end);
+    lineThickness.push_back(line.thickness);
+    flags.push_back(slotFlags);
+    category.push_back(collider->GetCategoryBits());
+    mask.push_back(collider->GetMaskBits());
+    entityIndex.push_back(ownerIndex);
+
+    velX.push_back(body ? body->GetVelocity().x : 0.0f);
+    velY.push_back(body ? body->GetVelocity().y : 0.0f);
+    mass.push_back(body ? body->GetMass() : 0.0f);
+    bounceDamping.push_back(body ? body->GetBounceDamping() : 0.0f);
+
+    entities.push_back(entity);
+    colliders.push_back(collider);
+    transforms.push_back(transform);
+    physics.push_back(body);
+
+    return index;
+}
+
+void ColliderStore::WriteBack() {
+    PROFILE_SCOPE("ColliderStore::WriteBack");
+    for (size_t i = 0; i < flags.size(); ++i) {
+        if (flags[i] & POSITION_DIRTY) {
+            glm::vec3 position = transforms[i]->GetPosition();
+            position.x = posX[i];
+            position.y = posY[i];
+            transforms[i]->SetPosition(position);
+        }
+
+        if (flags[i] & VELOCITY_DIRTY) {
+            glm::vec3 velocity = physics[i]->GetVelocity();
+            velocity.x = velX[i];
+            velocity.y = velY[i];
+            physics[i]->SetVelocity(velocity);
+        }
+
+        flags[i] &= static_cast<uint8_t>(~(POSITION_DIRTY | VELOCITY_DIRTY));
+    }
+}
+
+BroadphaseProxy ColliderStore::ComputeBounds(uint32_t index, float margin) const {
+    BroadphaseProxy proxy;
+
+    switch (shape[index]) {
+        case CollisionShape::CIRCLE: {
+            glm::vec2 center = GetCenter(index);
+            glm::vec2 extent(radius[index]);
+            proxy.min = center - extent;
+            proxy.max = center + extent;
+            break;
+        }
+
+        case CollisionShape::AABB: {
+            glm::vec2 center = GetCenter(index);
+            glm::vec2 halfSize(halfX[index], halfY[index]);
+            proxy.min = center - halfSize;
+            proxy.max = center + halfSize;
+            break;
+        }
+
+        case CollisionShape::LINE_SEGMENT: {
+            // Lines are stored in world space (see CollisionSystem::CheckCircleLine)
+            glm::vec2 extent(lineThickness[index]);
+            proxy.min = glm::min(lineStart[index], lineEnd[index]) - extent;
+            proxy.max = glm::max(lineStart[index], lineEnd[index]) + extent;
+            break;
+        }
+
+        default: {
+            glm::vec2 center = GetCenter(index);
+            proxy.min = center;
+            proxy.max = center;
+            break;
+        }
+    }
+
+    proxy.min -= glm::vec2(margin);
+    proxy.max += glm::vec2(margin);
+    proxy.category = category[index];
+    proxy.mask = mask[index];
+    proxy.isStatic = IsStatic(index);
+    return proxy;
+}
+
+} // namespace Logic
+} // namespace Engine
@@ -19,12 +19,6 @@ CollisionComponent::CollisionComponent(CollisionShape shapeType, bool trigger, b
     lineData = LineCollider(glm::vec2(0.0f), glm::vec2(1.0f, 0.0f), 0.1f);
 }
 
-void CollisionComponent::Update(float deltaTime) {
-    // Clear collisions from previous frame
-    // Note: The collision system will populate this during its update
-    // We don't clear here because multiple collision checks might happen per frame
-}
-
 std::string CollisionComponent::GetDebugInfo() const {
     std::ostringstream oss;
     oss << std::fixed << std::setprecision(2);
@@ -39,7 +33,8 @@ std::string CollisionComponent::GetDebugInfo() const {
     }
 
     oss << "Shape: " << shapeStr << "\n";
-    oss << "Layer: " << collisionLayer << "\n";
+    oss << "Layer: " << collisionLayer << " (bits 0x" << std::hex << categoryBits
+        << ", mask 0x" << maskBits << std::dec << ")\n";
     oss << "Trigger: " << (isTrigger ? "true" : "false") << "\n";
     oss << "Static: " << (isStatic ? "true" : "false") << "\n";
 
@@ -65,7 +60,7 @@ std::string CollisionComponent::GetDebugInfo() const {
             break;
     }
 
-    oss << "\nCollisions: " << collisions.size();
+    oss << "\nCollisions: " << GetCollisions().size();
 
     return oss.str();
 }
@@ -89,6 +84,18 @@ void CollisionComponent::SetLine(glm::vec2 start, glm::vec2 end, float thickness
     lineData.thickness = thickness;
 }
 
+ContactList CollisionComponent::GetCollisions() const {
+    if (!registeredSystem) return ContactList();
+    return registeredSystem->GetContactList(registeredSlot);
+}
+
+void CollisionComponent::SetLayer(const std::string& layer) {
+    collisionLayer = layer;
+    if (registeredSystem) {
+        registeredSystem->ResolveLayer(*this);
+    }
+}
+
 glm::vec2 CollisionComponent::GetWorldPosition() const {
     if (!owner) return glm::vec2(0.0f);
 
@@ -1,130 +1,631 @@
 #include "../include/CollisionSystem.h"
 #include "../include/SimplePhysicsComponent.h"
 #include "../include/TransformComponent.h"
+#include "../../Common/include/JobSystem.h"
+#include "../../Common/include/Profiler.h"
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <iomanip>
+#include <iostream>
 #include <sstream>
 
 namespace Engine {
 namespace Logic {
 
+namespace {
+
+// Two-slot store shared by the component-pointer queries on this thread, so
+// one-off checks reuse its capacity instead of allocating a store per call
+ColliderStore& LoadPair(CollisionComponent* colliderA, CollisionComponent* colliderB) {
+    thread_local ColliderStore pairStore;
+    pairStore.Clear();
+    pairStore.Add(colliderA->GetOwner(), colliderA, 0);
+    pairStore.Add(colliderB->GetOwner(), colliderB, 1);
+    return pairStore;
+}
+
+} // namespace
+
+CollisionSystem::CollisionSystem()
+    : broadphase(CreateBroadphase(BroadphaseType::SPATIAL_HASH)) {
+    std::fill(std::begin(layerMasks), std::end(layerMasks), 0xFFFFFFFFu);
+    layerNames.push_back("default");
+}
+
+uint32_t CollisionSystem::GetLayerBit(const std::string& name) {
+    auto it = std::find(layerNames.begin(), layerNames.end(), name);
+    if (it != layerNames.end()) {
+        return static_cast<uint32_t>(it - layerNames.begin());
+    }
+
+    if (layerNames.size() >= MAX_LAYERS) {
+        std::cerr << "CollisionSystem: Out of layer bits for '" << name << "'" << std::endl;
+        return MAX_LAYERS;
+    }
+    layerNames.push_back(name);
+    return static_cast<uint32_t>(layerNames.size() - 1);
+}
+
+void CollisionSystem::SetLayersCollide(const std::string& layerA, const std::string& layerB, bool collide) {
+    const uint32_t bitA = GetLayerBit(layerA);
+    const uint32_t bitB = GetLayerBit(layerB);
+    if (bitA >= MAX_LAYERS || bitB >= MAX_LAYERS) return;
+
+    if (collide) {
+        layerMasks[bitA] |= 1u << bitB;
+        layerMasks[bitB] |= 1u << bitA;
+    } else {
+        layerMasks[bitA] &= ~(1u << bitB);
+        layerMasks[bitB] &= ~(1u << bitA);
+    }
+    ResolveAllLayers();
+}
+
+bool CollisionSystem::DoLayersCollide(const std::string& layerA, const std::string& layerB) {
+    const uint32_t bitA = GetLayerBit(layerA);
+    const uint32_t bitB = GetLayerBit(layerB);
+    if (bitA >= MAX_LAYERS || bitB >= MAX_LAYERS) return true;
+    return (layerMasks[bitA] & (1u << bitB)) != 0;
+}
+
+void CollisionSystem::ResolveLayer(CollisionComponent& collider) {
+    // Layers past the last bit fall back to "default"
+    uint32_t bit = GetLayerBit(collider.collisionLayer);
+    if (bit >= MAX_LAYERS) bit = 0;
+    collider.categoryBits = 1u << bit;
+    collider.maskBits = layerMasks[bit];
+}
+
+void CollisionSystem::ResolveAllLayers() {
+    for (const auto& entity : entities) {
+        if (!entity) continue;
+        CollisionComponent* collider = entity->GetRegistry().Get<CollisionComponent>(entity->GetHandle());
+        if (collider) ResolveLayer(*collider);
+    }
+}
+
+void CollisionSystem::SetThreadCount(size_t count) {
+    threadCount = count;
+}
+
+CollisionSystem::~CollisionSystem() {
+    Clear();
+}
+
 void CollisionSystem::RegisterEntity(std::shared_ptr<Entity> entity) {
-    if (!entity || !entity->HasComponent<CollisionComponent>()) return;
+    if (!entity) return;
+
+    CollisionComponent* collider = entity->GetRegistry().Get<CollisionComponent>(entity->GetHandle());
+    if (!collider) return;
 
     // Check if already registered
-    auto it = std::find(entities.begin(), entities.end(), entity);
-    if (it == entities.end()) {
-        entities.push_back(entity);
+    if (collider->registeredSystem == this) return;
+    ResolveLayer(*collider);
+    if (collider->registeredSystem) {
+        // Tracked by another system, only that one gets the fast path
+        if (std::find(entities.begin(), entities.end(), entity) != entities.end()) return;
+    } else {
+        collider->registeredSystem = this;
+        collider->registeredSlot = static_cast<uint32_t>(entities.size());
     }
+
+    entities.push_back(std::move(entity));
 }
 
 
 void CollisionSystem::UnregisterEntity(std::shared_ptr<Entity> entity) {
+    if (!entity) return;
+
+    CollisionComponent* collider = entity->GetRegistry().Get<CollisionComponent>(entity->GetHandle());
+    if (collider && collider->registeredSystem == this) {
+        collider->registeredSystem = nullptr;
+        if (entities[collider->registeredSlot] == entity) {
+            entities[collider->registeredSlot] = nullptr;
+            pendingRemovals++;
+            return;
+        }
+    }
+
+    // Entity lost its collider or uses another system's slot
     auto it = std::find(entities.begin(), entities.end(), entity);
     if (it != entities.end()) {
-        entities.erase(it);
+        *it = nullptr;
+        pendingRemovals++;
     }
 }
 
 void CollisionSystem::Clear() {
+    for (const auto& entity : entities) {
+        if (!entity) continue;
+        CollisionComponent* collider = entity->GetRegistry().Get<CollisionComponent>(entity->GetHandle());
+        if (collider && collider->registeredSystem == this) {
+            collider->registeredSystem = nullptr;
+        }
+    }
     entities.clear();
+    pendingRemovals = 0;
+    solver.Clear();
+
+    frameContacts.clear();
+    contactSlots.clear();
+    contactOffsets.clear();
+    contactEntries.clear();
+    touching.clear();
+    previousTouching.clear();
+    beginEvents.clear();
+    stayEvents.clear();
+    endEvents.clear();
+}
+
+void CollisionSystem::CompactEntities() {
+    if (pendingRemovals == 0) return;
+
+    // Stable, so pair order (and with it the resolution order) is unchanged
+    entities.erase(std::remove(entities.begin(), entities.end(), nullptr), entities.end());
+    pendingRemovals = 0;
+
+    for (size_t i = 0; i < entities.size(); ++i) {
+        CollisionComponent* collider = entities[i]->GetRegistry().Get<CollisionComponent>(entities[i]->GetHandle());
+        if (collider && collider->registeredSystem == this) {
+            collider->registeredSlot = static_cast<uint32_t>(i);
+        }
+    }
 }
 
 void CollisionSystem::Update(float deltaTime) {
-    (void)deltaTime; // Suppress unused parameter warning
+    PROFILE_SCOPE("CollisionSystem::Update");
+
+    using Clock = std::chrono::steady_clock;
+    auto elapsedMs = [](Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<float, std::milli>(to - from).count();
+    };
+    const Clock::time_point frameStart = Clock::now();
+
+    const bool parallel = (mode == CollisionMode::PARALLEL);
+    const bool iterative = (resolution == ContactResolution::ITERATIVE);
+
+    CompactEntities();
+
+    // Mirror every active collider into the packed store. Components are
+    // looked up once per entity here instead of once per pair.
+    store.Sync(entities);
 
-    // Clear all collision results from previous frame
-    for (auto& entity : entities) {
-        if (!entity || !entity->IsActive()) continue;
+    // Only the solver manages sleep, everything wakes up without it
+    skipRestingPairs = iterative && solverSettings.sleeping;
+    if (!skipRestingPairs) {
+        WakeAll();
+    }
+
+    // Detection on a full contact list never sees moved colliders, so it
+    // needs no padding
+    const float margin = (parallel || iterative) ? 0.0f : broadphaseMargin;
+
+    const uint32_t count = static_cast<uint32_t>(store.Size());
+    proxies.resize(count);
+    proxyCenters.resize(count);
+    proxyMargins.assign(count, margin);
+    frameContacts.clear();
+    contactSlots.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        proxies[i] = store.ComputeBounds(i, margin);
+        proxyCenters[i] = store.GetCenter(i);
+    }
 
-        auto collider = entity->GetComponent<CollisionComponent>();
-        if (collider) {
-            collider->ClearCollisions();
+    const Clock::time_point syncEnd = Clock::now();
+
+    // Candidate pairs come back sorted, so colliders are visited in registration
+    // order just like the all-pairs loop
+    {
+        PROFILE_SCOPE("Broadphase");
+        if (parallel) {
+            broadphase->FindPairsParallel(proxies, candidatePairs, threadCount);
+        } else {
+            broadphase->FindPairs(proxies, candidatePairs);
         }
     }
 
-    // Check collisions between all pairs
-    for (size_t i = 0; i < entities.size(); ++i) {
-        for (size_t j = i + 1; j < entities.size(); ++j) {
-            auto entityA = entities[i];
-            auto entityB = entities[j];
+    const Clock::time_point broadphaseEnd = Clock::now();
+
+    pairsTested = 0;
+    pairsHit = 0;
+    proxyRefreshes = 0;
+    pairsCulled = 0;
+
+    Clock::time_point narrowphaseEnd;
+    if (parallel || iterative) {
+        // The solver needs every contact up front; sequential mode detects
+        // them on the calling thread alone
+        DetectContacts(parallel ? threadCount : 1);
+        narrowphaseEnd = Clock::now();
+        ResolveContacts();
+    } else {
+        RunSequentialPass();
+        narrowphaseEnd = Clock::now();
+    }
+
+    store.WriteBack();
+
+    BuildContactViews();
+    UpdateContactEvents();
 
-            if (!entityA || !entityB || !entityA->IsActive() || !entityB->IsActive()) continue;
+    if (skipRestingPairs) {
+        solver.UpdateSleep(store, solverContacts, solverSettings, deltaTime);
+    }
+
+    const Clock::time_point frameEnd = Clock::now();
+    timings.syncMs = elapsedMs(frameStart, syncEnd);
+    timings.broadphaseMs = elapsedMs(syncEnd, broadphaseEnd);
+    timings.narrowphaseMs = elapsedMs(broadphaseEnd, narrowphaseEnd);
+    timings.resolveMs = elapsedMs(narrowphaseEnd, frameEnd);
+    timings.totalMs = elapsedMs(frameStart, frameEnd);
+}
+
+void CollisionSystem::RunSequentialPass() {
+    PROFILE_SCOPE("CollisionSystem::RunSequentialPass");
+    const uint32_t count = static_cast<uint32_t>(store.Size());
+    initialProxies = proxies;
+    pendingPairs.clear();
+
+    // Batch filter state. A filter result is only trusted while neither
+    // collider of the pair has been resolved since its block was filtered.
+    lastMovedBlock.assign(count, UINT32_MAX);
+    uint32_t block = 0;
+    size_t blockStart = 0;
+    size_t blockEnd = 0;
+
+    auto heapOrder = [](const BroadphasePair& a, const BroadphasePair& b) { return b < a; };
+
+    size_t next = 0;
+    bool hasLast = false;
+    BroadphasePair last;
+
+    while (next < candidatePairs.size() || !pendingPairs.empty()) {
+        // Merge the broadphase output with pairs discovered during this pass
+        BroadphasePair pair;
+        bool mayOverlap = true;
+        if (!pendingPairs.empty() &&
+            (next >= candidatePairs.size() || pendingPairs.front() < candidatePairs[next])) {
+            std::pop_heap(pendingPairs.begin(), pendingPairs.end(), heapOrder);
+            pair = pendingPairs.back();
+            pendingPairs.pop_back();
+        } else {
+            if (next >= blockEnd) {
+                blockStart = next;
+                blockEnd = std::min(next + CircleBatchKernel::BLOCK_SIZE, candidatePairs.size());
+                circleKernel.Filter(store, &candidatePairs[blockStart], blockEnd - blockStart, blockMayOverlap);
+                block++;
+            }
+
+            pair = candidatePairs[next];
+            mayOverlap = blockMayOverlap[next - blockStart] ||
+                         lastMovedBlock[pair.first] == block || lastMovedBlock[pair.second] == block;
+            next++;
+        }
+
+        if (hasLast && pair == last) continue; // Found by both sources
+        last = pair;
+        hasLast = true;
 
-            auto colliderA = entityA->GetComponent<CollisionComponent>();
-            auto colliderB = entityB->GetComponent<CollisionComponent>();
+        pairsTested++;
+        if (!mayOverlap) {
+            pairsCulled++;
+            continue;
+        }
 
-            if (!colliderA || !colliderB) continue;
+        // Check collision
+        CollisionInfo collision = CheckCollision(store, pair.first, pair.second);
 
-            // Check collision
-            CollisionInfo collision = CheckCollision(colliderA.get(), colliderB.get());
+        if (collision.hasCollision) {
+            pairsHit++;
+            RecordContact(pair.first, pair.second, collision);
 
-            if (collision.hasCollision) {
-                // Add collision info to both entities
-                collision.otherEntity = entityB.get();
-                colliderA->AddCollision(collision);
+            // Resolve collision if neither is a trigger
+            if (!store.IsTrigger(pair.first) && !store.IsTrigger(pair.second)) {
+                ResolveCollision(collision, store, pair.first, pair.second);
+                lastMovedBlock[pair.first] = block;
+                lastMovedBlock[pair.second] = block;
 
-                // Create reverse collision info for entity B
-                CollisionInfo reverseCollision = collision;
-                reverseCollision.normal = -collision.normal;
-                reverseCollision.otherEntity = entityA.get();
-                colliderB->AddCollision(reverseCollision);
+                RefreshEscapedProxy(pair.first, pair);
+                RefreshEscapedProxy(pair.second, pair);
+            }
+        }
+    }
+}
 
-                // Resolve collision if neither is a trigger
-                if (!colliderA->IsTrigger() && !colliderB->IsTrigger()) {
-                    ResolveCollision(collision, colliderA.get(), colliderB.get());
+void CollisionSystem::WakeAll() {
+    for (uint32_t i = 0; i < store.Size(); ++i) {
+        if (!store.HasFlag(i, ColliderStore::SLEEPING)) continue;
+        store.flags[i] &= static_cast<uint8_t>(~ColliderStore::SLEEPING);
+        store.physics[i]->WakeUp();
+    }
+}
+
+bool CollisionSystem::IsAwake(uint32_t index) const {
+    return ContactSolver::IsDynamic(store, index) && !store.HasFlag(index, ColliderStore::SLEEPING);
+}
+
+void CollisionSystem::DetectContacts(size_t maxThreads) {
+    PROFILE_SCOPE("CollisionSystem::DetectContacts");
+    // Every task checks a contiguous slice of the sorted candidate list against
+    // the positions at the start of the pass, so concatenating the task buffers
+    // in order gives the same contact list for any thread count
+    const size_t pairCount = candidatePairs.size();
+    const size_t pairsPerTask = CircleBatchKernel::BLOCK_SIZE * 4;
+    const size_t taskCount = (pairCount + pairsPerTask - 1) / pairsPerTask;
+
+    if (taskContacts.size() < taskCount) {
+        taskContacts.resize(taskCount);
+    }
+    for (size_t task = taskCount; task < taskContacts.size(); ++task) {
+        taskContacts[task].clear(); // Keep capacity, drop last frame's contacts
+    }
+    taskCulled.assign(taskCount, 0);
+
+    Common::JobSystem::Get().ParallelFor(0, pairCount, pairsPerTask, [&](size_t begin, size_t end) {
+        const size_t task = begin / pairsPerTask;
+        auto& contacts = taskContacts[task];
+        contacts.clear();
+
+        uint8_t mayOverlap[CircleBatchKernel::BLOCK_SIZE];
+
+        for (size_t blockStart = begin; blockStart < end; blockStart += CircleBatchKernel::BLOCK_SIZE) {
+            const size_t blockEnd = std::min(blockStart + CircleBatchKernel::BLOCK_SIZE, end);
+            circleKernel.Filter(store, &candidatePairs[blockStart], blockEnd - blockStart, mayOverlap);
+
+            for (size_t i = blockStart; i < blockEnd; ++i) {
+                if (!mayOverlap[i - blockStart]) {
+                    taskCulled[task]++;
+                    continue;
+                }
+
+                const BroadphasePair& pair = candidatePairs[i];
+
+                // Sleeping and static colliders can't start touching each other
+                if (skipRestingPairs && !IsAwake(pair.first) && !IsAwake(pair.second)) {
+                    taskCulled[task]++;
+                    continue;
+                }
+
+                CollisionInfo collision = CheckCollision(store, pair.first, pair.second);
+                if (collision.hasCollision) {
+                    contacts.push_back({pair, collision});
                 }
             }
         }
+    }, maxThreads);
+
+    pairsTested = pairCount;
+    for (size_t culled : taskCulled) {
+        pairsCulled += culled;
+    }
+}
+
+void CollisionSystem::ResolveContacts() {
+    PROFILE_SCOPE("CollisionSystem::ResolveContacts");
+    const bool iterative = (resolution == ContactResolution::ITERATIVE);
+    solverContacts.clear();
+
+    // Single thread, contacts in (first, second) order - keeps replays reproducible
+    for (auto& contacts : taskContacts) {
+        for (Contact& contact : contacts) {
+            const uint32_t a = contact.pair.first;
+            const uint32_t b = contact.pair.second;
+            pairsHit++;
+
+            const CollisionInfo& collision = contact.info;
+            RecordContact(a, b, collision);
+
+            // Resolve collision if neither is a trigger
+            if (store.IsTrigger(a) || store.IsTrigger(b)) continue;
+            if (iterative) {
+                solverContacts.push_back({a, b, collision.normal, collision.penetration});
+            } else {
+                ResolveCollision(collision, store, a, b);
+            }
+        }
+    }
+
+    if (iterative) {
+        solver.Solve(store, solverContacts, solverSettings);
+    }
+}
+
+void CollisionSystem::RecordContact(uint32_t a, uint32_t b, const CollisionInfo& collision) {
+    ContactRecord record;
+    record.entityA = store.entities[a];
+    record.entityB = store.entities[b];
+    record.point = collision.contactPoint;
+    record.normal = collision.normal;
+    record.penetration = collision.penetration;
+    record.isTrigger = store.IsTrigger(a) || store.IsTrigger(b);
+    frameContacts.push_back(record);
+    contactSlots.emplace_back(a, b);
+}
+
+void CollisionSystem::BuildContactViews() {
+    PROFILE_SCOPE("CollisionSystem::BuildContactViews");
+    // Counting sort of both sides of every contact by entity index
+    const size_t entityCount = entities.size();
+    contactOffsets.assign(entityCount + 1, 0);
+    for (const BroadphasePair& slots : contactSlots) {
+        contactOffsets[store.entityIndex[slots.first] + 1]++;
+        contactOffsets[store.entityIndex[slots.second] + 1]++;
+    }
+    for (size_t i = 0; i < entityCount; ++i) {
+        contactOffsets[i + 1] += contactOffsets[i];
+    }
+
+    contactEntries.resize(contactOffsets[entityCount]);
+    contactCursor.assign(contactOffsets.begin(), contactOffsets.end() - 1);
+    for (uint32_t contact = 0; contact < contactSlots.size(); ++contact) {
+        contactEntries[contactCursor[store.entityIndex[contactSlots[contact].first]]++] = contact << 1;
+        contactEntries[contactCursor[store.entityIndex[contactSlots[contact].second]]++] = (contact << 1) | 1u;
+    }
+}
+
+ContactList CollisionSystem::GetContactList(uint32_t entityIndex) const {
+    if (entityIndex + 1 >= contactOffsets.size()) return ContactList(); // Registered after the last Update
+    const uint32_t* entries = contactEntries.data();
+    return ContactList(frameContacts.data(), entries + contactOffsets[entityIndex],
+                       entries + contactOffsets[entityIndex + 1]);
+}
+
+void CollisionSystem::UpdateContactEvents() {
+    PROFILE_SCOPE("CollisionSystem::UpdateContactEvents");
+    touching.clear();
+    for (uint32_t contact = 0; contact < frameContacts.size(); ++contact) {
+        Entity* entityA = frameContacts[contact].entityA;
+        Entity* entityB = frameContacts[contact].entityB;
+
+        TouchingPair pair;
+        pair.handleA = entityA->GetHandle();
+        pair.handleB = entityB->GetHandle();
+        pair.registryA = &entityA->GetRegistry();
+        pair.registryB = &entityB->GetRegistry();
+        pair.contact = contact;
+        const uint64_t low = std::min(pair.handleA.value, pair.handleB.value);
+        const uint64_t high = std::max(pair.handleA.value, pair.handleB.value);
+        pair.key = (low << 32) | high;
+        touching.push_back(pair);
+    }
+    std::sort(touching.begin(), touching.end());
+
+    beginEvents.clear();
+    stayEvents.clear();
+    endEvents.clear();
+
+    auto current = [this](const TouchingPair& pair) {
+        ContactEvent event;
+        event.handleA = pair.handleA;
+        event.handleB = pair.handleB;
+        event.entityA = frameContacts[pair.contact].entityA;
+        event.entityB = frameContacts[pair.contact].entityB;
+        event.contact = pair.contact;
+        return event;
+    };
+    auto ended = [](const TouchingPair& pair) {
+        ContactEvent event;
+        event.handleA = pair.handleA;
+        event.handleB = pair.handleB;
+        event.entityA = pair.registryA->GetEntity(pair.handleA);
+        event.entityB = pair.registryB->GetEntity(pair.handleB);
+        return event;
+    };
+
+    // Merge of the two sorted pair lists
+    size_t now = 0;
+    size_t before = 0;
+    while (now < touching.size() || before < previousTouching.size()) {
+        if (before >= previousTouching.size() ||
+            (now < touching.size() && touching[now].key < previousTouching[before].key)) {
+            beginEvents.push_back(current(touching[now++]));
+        } else if (now >= touching.size() || previousTouching[before].key < touching[now].key) {
+            endEvents.push_back(ended(previousTouching[before++]));
+        } else {
+            stayEvents.push_back(current(touching[now++]));
+            before++;
+        }
+    }
+
+    touching.swap(previousTouching);
+}
+
+void CollisionSystem::RefreshEscapedProxy(uint32_t index, const BroadphasePair& currentPair) {
+    if (store.IsStatic(index)) return;
+
+    glm::vec2 center = store.GetCenter(index);
+    glm::vec2 delta = glm::abs(center - proxyCenters[index]);
+    float displacement = std::max(delta.x, delta.y);
+    if (displacement <= proxyMargins[index]) return;
+
+    // The collider was pushed out of its padded bounds. Rebuild them with more
+    // padding, since a collider that moved once in a pass tends to keep moving,
+    // and queue any new partner the all-pairs loop would still reach after this pair.
+    proxyRefreshes++;
+    proxyMargins[index] = std::max(proxyMargins[index], displacement) * 2.0f;
+    proxies[index] = store.ComputeBounds(index, proxyMargins[index]);
+    proxyCenters[index] = center;
+
+    auto heapOrder = [](const BroadphasePair& a, const BroadphasePair& b) { return b < a; };
+
+    const uint32_t count = static_cast<uint32_t>(proxies.size());
+    for (uint32_t other = 0; other < count; ++other) {
+        if (other == index || !Broadphase::CanCollide(proxies[index], proxies[other]) ||
+            !Broadphase::Overlaps(proxies[index], proxies[other])) continue;
+
+        BroadphasePair candidate = (index < other) ? BroadphasePair(index, other) : BroadphasePair(other, index);
+        if (!(currentPair < candidate)) continue; // Already visited by the loop
+
+        // Pairs the broadphase already reported are still ahead in candidatePairs
+        if (!Broadphase::Overlaps(initialProxies[index], initialProxies[other])) {
+            pendingPairs.push_back(candidate);
+            std::push_heap(pendingPairs.begin(), pendingPairs.end(), heapOrder);
+        }
+    }
+}
+
+void CollisionSystem::SetBroadphase(BroadphaseType type) {
+    broadphase = CreateBroadphase(type);
+}
+
+void CollisionSystem::SetBroadphase(std::unique_ptr<Broadphase> newBroadphase) {
+    if (newBroadphase) {
+        broadphase = std::move(newBroadphase);
     }
 }
 
 CollisionInfo CollisionSystem::CheckCollision(CollisionComponent* colliderA, CollisionComponent* colliderB) {
     if (!colliderA || !colliderB) return CollisionInfo();
 
-    CollisionShape shapeA = colliderA->GetShape();
-    CollisionShape shapeB = colliderB->GetShape();
+    return CheckCollision(LoadPair(colliderA, colliderB), 0, 1);
+}
+
+CollisionInfo CollisionSystem::CheckCollision(const ColliderStore& colliders, uint32_t a, uint32_t b) {
+    CollisionShape shapeA = colliders.shape[a];
+    CollisionShape shapeB = colliders.shape[b];
 
     // Circle-Circle collision
     if (shapeA == CollisionShape::CIRCLE && shapeB == CollisionShape::CIRCLE) {
-        return CheckCircleCircle(colliderA, colliderB);
+        return CheckCircleCircle(colliders, a, b);
     }
 
-    // Circle-Line collision
+    // Circle-Line collision (the line and AABB tests return a normal pointing
+    // from the other shape to the circle)
     if (shapeA == CollisionShape::CIRCLE && shapeB == CollisionShape::LINE_SEGMENT) {
-        return CheckCircleLine(colliderA, colliderB);
-    }
-    if (shapeA == CollisionShape::LINE_SEGMENT && shapeB == CollisionShape::CIRCLE) {
-        CollisionInfo result = CheckCircleLine(colliderB, colliderA);
+        CollisionInfo result = CheckCircleLine(colliders, a, b);
         result.normal = -result.normal; // Flip normal
         return result;
     }
+    if (shapeA == CollisionShape::LINE_SEGMENT && shapeB == CollisionShape::CIRCLE) {
+        return CheckCircleLine(colliders, b, a);
+    }
 
     // Circle-AABB collision
     if (shapeA == CollisionShape::CIRCLE && shapeB == CollisionShape::AABB) {
-        return CheckCircleAABB(colliderA, colliderB);
-    }
-    if (shapeA == CollisionShape::AABB && shapeB == CollisionShape::CIRCLE) {
-        CollisionInfo result = CheckCircleAABB(colliderB, colliderA);
+        CollisionInfo result = CheckCircleAABB(colliders, a, b);
         result.normal = -result.normal; // Flip normal
         return result;
     }
+    if (shapeA == CollisionShape::AABB && shapeB == CollisionShape::CIRCLE) {
+        return CheckCircleAABB(colliders, b, a);
+    }
 
     // AABB-AABB collision
     if (shapeA == CollisionShape::AABB && shapeB == CollisionShape::AABB) {
-        return CheckAABBAABB(colliderA, colliderB);
+        return CheckAABBAABB(colliders, a, b);
     }
 
     // No collision detection implemented for this combination
     return CollisionInfo();
 }
 
-CollisionInfo CollisionSystem::CheckCircleCircle(const CollisionComponent* circleA, const CollisionComponent* circleB) {
-    glm::vec2 centerA = circleA->GetWorldCenter();
-    glm::vec2 centerB = circleB->GetWorldCenter();
+CollisionInfo CollisionSystem::CheckCircleCircle(const ColliderStore& colliders, uint32_t circleA, uint32_t circleB) {
+    glm::vec2 centerA = colliders.GetCenter(circleA);
+    glm::vec2 centerB = colliders.GetCenter(circleB);
 
-    float radiusA = circleA->GetCircle().radius;
-    float radiusB = circleB->GetCircle().radius;
+    float radiusA = colliders.radius[circleA];
+    float radiusB = colliders.radius[circleB];
 
     glm::vec2 direction = centerB - centerA;
     float distance = Distance(centerA, centerB);
@@ -142,14 +643,14 @@ CollisionInfo CollisionSystem::CheckCircleCircle(const CollisionComponent* circl
     return CollisionInfo();
 }
 
-CollisionInfo CollisionSystem::CheckCircleLine(const CollisionComponent* circle, const CollisionComponent* line) {
-    glm::vec2 circleCenter = circle->GetWorldCenter();
-    float radius = circle->GetCircle().radius;
+CollisionInfo CollisionSystem::CheckCircleLine(const ColliderStore& colliders, uint32_t circle, uint32_t line) {
+    glm::vec2 circleCenter = colliders.GetCenter(circle);
+    float radius = colliders.radius[circle];
 
     // Line is in world space already (absolute coordinates)
-    glm::vec2 lineStart = line->GetLine().start;
-    glm::vec2 lineEnd = line->GetLine().end;
-    float thickness = line->GetLine().thickness;
+    glm::vec2 lineStart = colliders.lineStart[line];
+    glm::vec2 lineEnd = colliders.lineEnd[line];
+    float thickness = colliders.lineThickness[line];
 
     // Find closest point on line to circle center
     glm::vec2 closestPoint = ClosestPointOnLine(circleCenter, lineStart, lineEnd);
@@ -169,12 +670,12 @@ CollisionInfo CollisionSystem::CheckCircleLine(const CollisionComponent* circle,
     return CollisionInfo();
 }
 
-CollisionInfo CollisionSystem::CheckCircleAABB(const CollisionComponent* circle, const CollisionComponent* aabb) {
-    glm::vec2 circleCenter = circle->GetWorldCenter();
-    float radius = circle->GetCircle().radius;
+CollisionInfo CollisionSystem::CheckCircleAABB(const ColliderStore& colliders, uint32_t circle, uint32_t aabb) {
+    glm::vec2 circleCenter = colliders.GetCenter(circle);
+    float radius = colliders.radius[circle];
 
-    glm::vec2 aabbCenter = aabb->GetWorldCenter();
-    glm::vec2 aabbHalfSize = aabb->GetAABB().size * 0.5f;
+    glm::vec2 aabbCenter = colliders.GetCenter(aabb);
+    glm::vec2 aabbHalfSize(colliders.halfX[aabb], colliders.halfY[aabb]);
 
     // Find closest point on AABB to circle center
     glm::vec2 closest = glm::vec2(
@@ -196,11 +697,11 @@ CollisionInfo CollisionSystem::CheckCircleAABB(const CollisionComponent* circle,
     return CollisionInfo();
 }
 
-CollisionInfo CollisionSystem::CheckAABBAABB(const CollisionComponent* aabbA, const CollisionComponent* aabbB) {
-    glm::vec2 centerA = aabbA->GetWorldCenter();
-    glm::vec2 centerB = aabbB->GetWorldCenter();
-    glm::vec2 halfSizeA = aabbA->GetAABB().size * 0.5f;
-    glm::vec2 halfSizeB = aabbB->GetAABB().size * 0.5f;
+CollisionInfo CollisionSystem::CheckAABBAABB(const ColliderStore& colliders, uint32_t aabbA, uint32_t aabbB) {
+    glm::vec2 centerA = colliders.GetCenter(aabbA);
+    glm::vec2 centerB = colliders.GetCenter(aabbB);
+    glm::vec2 halfSizeA(colliders.halfX[aabbA], colliders.halfY[aabbA]);
+    glm::vec2 halfSizeB(colliders.halfX[aabbB], colliders.halfY[aabbB]);
 
     glm::vec2 distance = centerB - centerA;
     glm::vec2 combinedHalfSize = halfSizeA + halfSizeB;
@@ -234,19 +735,21 @@ CollisionInfo CollisionSystem::CheckAABBAABB(const CollisionComponent* aabbA, co
 }
 
 void CollisionSystem::ResolveCollision(const CollisionInfo& collision, CollisionComponent* colliderA, CollisionComponent* colliderB) {
-    if (!collision.hasCollision) return;
+    if (!collision.hasCollision || !colliderA || !colliderB) return;
+    if (!colliderA->GetOwner() || !colliderB->GetOwner()) return;
 
-    Entity* entityA = colliderA->GetOwner();
-    Entity* entityB = colliderB->GetOwner();
+    ColliderStore& pairStore = LoadPair(colliderA, colliderB);
+    ResolveCollision(collision, pairStore, 0, 1);
+    pairStore.WriteBack();
+}
 
-    if (!entityA || !entityB) return;
+void CollisionSystem::ResolveCollision(const CollisionInfo& collision, ColliderStore& colliders, uint32_t a, uint32_t b) {
+    if (!collision.hasCollision) return;
 
-    auto transformA = entityA->GetComponent<TransformComponent>();
-    auto transformB = entityB->GetComponent<TransformComponent>();
-    auto physicsA = entityA->GetComponent<SimplePhysicsComponent>();
-    auto physicsB = entityB->GetComponent<SimplePhysicsComponent>();
+    if (!colliders.HasFlag(a, ColliderStore::HAS_TRANSFORM) || !colliders.HasFlag(b, ColliderStore::HAS_TRANSFORM)) return;
 
-    if (!transformA || !transformB) return;
+    const bool staticA = colliders.IsStatic(a);
+    const bool staticB = colliders.IsStatic(b);
 
     // Position correction to prevent sinking
     float correctionPercent = 0.8f; // How much to correct
@@ -257,37 +760,35 @@ void CollisionSystem::ResolveCollision(const CollisionInfo& collision, Collision
         glm::vec2 correction = collision.normal * correctionMagnitude;
 
         // Apply position correction based on whether objects are static
-        if (!colliderA->IsStatic() && !colliderB->IsStatic()) {
+        if (!staticA && !staticB) {
             // Both dynamic - split correction
-            glm::vec3 posA = transformA->GetPosition();
-            glm::vec3 posB = transformB->GetPosition();
-
-            posA.x -= correction.x * 0.5f;
-            posA.y -= correction.y * 0.5f;
-            posB.x += correction.x * 0.5f;
-            posB.y += correction.y * 0.5f;
-
-            transformA->SetPosition(posA);
-            transformB->SetPosition(posB);
-        } else if (!colliderA->IsStatic()) {
+            colliders.posX[a] -= correction.x * 0.5f;
+            colliders.posY[a] -= correction.y * 0.5f;
+            colliders.posX[b] += correction.x * 0.5f;
+            colliders.posY[b] += correction.y * 0.5f;
+
+            colliders.flags[a] |= ColliderStore::POSITION_DIRTY;
+            colliders.flags[b] |= ColliderStore::POSITION_DIRTY;
+        } else if (!staticA) {
             // Only A is dynamic
-            glm::vec3 posA = transformA->GetPosition();
-            posA.x -= correction.x;
-            posA.y -= correction.y;
-            transformA->SetPosition(posA);
-        } else if (!colliderB->IsStatic()) {
+            colliders.posX[a] -= correction.x;
+            colliders.posY[a] -= correction.y;
+            colliders.flags[a] |= ColliderStore::POSITION_DIRTY;
+        } else if (!staticB) {
             // Only B is dynamic
-            glm::vec3 posB = transformB->GetPosition();
-            posB.x += correction.x;
-            posB.y += correction.y;
-            transformB->SetPosition(posB);
+            colliders.posX[b] += correction.x;
+            colliders.posY[b] += correction.y;
+            colliders.flags[b] |= ColliderStore::POSITION_DIRTY;
         }
     }
 
-    // Velocity resolution for physics objects
-    if (physicsA && physicsB) {
-        glm::vec2 velA = glm::vec2(physicsA->GetVelocity().x, physicsA->GetVelocity().y);
-        glm::vec2 velB = glm::vec2(physicsB->GetVelocity().x, physicsB->GetVelocity().y);
+    // Velocity resolution for physics objects. Colliders without a body
+    // (walls) resolve as if at rest.
+    const bool physicsA = colliders.HasFlag(a, ColliderStore::HAS_PHYSICS);
+    const bool physicsB = colliders.HasFlag(b, ColliderStore::HAS_PHYSICS);
+    if ((physicsA && physicsB) || (physicsA && staticB) || (physicsB && staticA)) {
+        glm::vec2 velA = physicsA ? glm::vec2(colliders.velX[a], colliders.velY[a]) : glm::vec2(0.0f);
+        glm::vec2 velB = physicsB ? glm::vec2(colliders.velX[b], colliders.velY[b]) : glm::vec2(0.0f);
 
         glm::vec2 relativeVel = velB - velA;
         float velocityAlongNormal = Dot(relativeVel, collision.normal);
@@ -296,35 +797,40 @@ void CollisionSystem::ResolveCollision(const CollisionInfo& collision, Collision
         if (velocityAlongNormal > 0) return;
 
         // Calculate restitution (bounciness)
-        float restitution = std::min(physicsA->GetBounceDamping(), physicsB->GetBounceDamping());
+        float restitution = std::min(colliders.bounceDamping[a], colliders.bounceDamping[b]);
+        if (!physicsA || !physicsB) restitution = physicsA ? colliders.bounceDamping[a] : colliders.bounceDamping[b];
 
         // Calculate impulse scalar
         float impulseScalar = -(1 + restitution) * velocityAlongNormal;
 
         // Apply mass weighting if both objects are dynamic
-        if (!colliderA->IsStatic() && !colliderB->IsStatic()) {
-            float massA = physicsA->GetMass();
-            float massB = physicsB->GetMass();
+        if (!staticA && !staticB) {
+            float massA = colliders.mass[a];
+            float massB = colliders.mass[b];
             impulseScalar /= (massA + massB);
 
             glm::vec2 impulse = collision.normal * impulseScalar;
 
             velA -= impulse * massB;
             velB += impulse * massA;
-        } else if (!colliderA->IsStatic()) {
+        } else if (!staticA) {
             // Only A is dynamic - B is static
-            velA = velA - collision.normal * 2.0f * velocityAlongNormal * restitution;
-        } else if (!colliderB->IsStatic()) {
+            velA -= collision.normal * impulseScalar;
+        } else if (!staticB) {
             // Only B is dynamic - A is static
-            velB = velB + collision.normal * 2.0f * velocityAlongNormal * restitution;
+            velB += collision.normal * impulseScalar;
         }
 
         // Update physics velocities
-        if (!colliderA->IsStatic()) {
-            physicsA->SetVelocity(glm::vec3(velA.x, velA.y, physicsA->GetVelocity().z));
+        if (!staticA) {
+            colliders.velX[a] = velA.x;
+            colliders.velY[a] = velA.y;
+            colliders.flags[a] |= ColliderStore::VELOCITY_DIRTY;
         }
-        if (!colliderB->IsStatic()) {
-            physicsB->SetVelocity(glm::vec3(velB.x, velB.y, physicsB->GetVelocity().z));
+        if (!staticB) {
+            colliders.velX[b] = velB.x;
+            colliders.velY[b] = velB.y;
+            colliders.flags[b] |= ColliderStore::VELOCITY_DIRTY;
         }
     }
 }
@@ -360,26 +866,51 @@ glm::vec2 CollisionSystem::ClosestPointOnLine(const glm::vec2& point, const glm:
     return lineStart + lineDirection * projectionLength;
 }
 
-std::string CollisionSystem::GetDebugInfo() const {
-    std::ostringstream oss;
+Common::FrameString CollisionSystem::GetDebugInfo() const {
+    // Built every frame for the debug panel, so on the frame arena
+    Common::FrameStringStream oss;
     oss << "=== Collision System ===\n";
-    oss << "Registered Entities: " << entities.size() << "\n";
+    oss << "Registered Entities: " << GetEntityCount() << "\n";
 
     int activeColliders = 0;
-    int totalCollisions = 0;
 
     for (const auto& entity : entities) {
         if (entity && entity->IsActive()) {
             activeColliders++;
-            auto collider = entity->GetComponent<CollisionComponent>();
-            if (collider) {
-                totalCollisions += collider->GetCollisions().size();
-            }
         }
     }
 
+    size_t allPairs = proxies.size() > 1 ? proxies.size() * (proxies.size() - 1) / 2 : 0;
+
     oss << "Active Colliders: " << activeColliders << "\n";
-    oss << "Total Collisions: " << totalCollisions;
+    oss << "Contacts: " << frameContacts.size() << " (begin " << beginEvents.size()
+        << ", stay " << stayEvents.size() << ", end " << endEvents.size() << ")\n";
+    oss << "Broadphase: " << broadphase->GetDebugInfo() << "\n";
+    oss << "Pairs Tested: " << pairsTested << " / " << allPairs << "\n";
+    oss << "Pairs Hit: " << pairsHit << "\n";
+    oss << "Proxy Refreshes: " << proxyRefreshes << "\n";
+    oss << "Narrowphase: " << circleKernel.GetLevelName() << ", culled " << pairsCulled << "\n";
+    size_t threads = 1;
+    if (mode == CollisionMode::PARALLEL) {
+        threads = Common::JobSystem::Get().IsRunning() ? Common::JobSystem::Get().GetThreadCount() : 1;
+        if (threadCount > 0) threads = std::min(threads, threadCount);
+    }
+    oss << "Mode: " << (mode == CollisionMode::PARALLEL ? "Parallel" : "Sequential")
+        << " (" << threads << " threads)\n";
+    if (resolution == ContactResolution::ITERATIVE) {
+        oss << "Solver: Iterative, " << solverSettings.velocityIterations << " iterations, "
+            << solver.GetWarmStartedCount() << " warm started\n";
+        if (solverSettings.sleeping) {
+            oss << "Sleeping: " << solver.GetSleepingBodyCount() << " bodies, "
+                << solver.GetIslandCount() << " islands\n";
+        }
+    } else {
+        oss << "Solver: Per pair\n";
+    }
+    oss << std::fixed << std::setprecision(2);
+    oss << "Timings (ms): sync " << timings.syncMs << ", broadphase " << timings.broadphaseMs
+        << ", narrowphase " << timings.narrowphaseMs << ", resolve " << timings.resolveMs
+        << ", total " << timings.totalMs;
 
     return oss.str();
 }
@@ -0,0 +1,257 @@
+#include "../include/ContactSolver.h"
+#include "../include/Entity.h"
+#include "../include/SimplePhysicsComponent.h"
+#include "../../Common/include/Profiler.h"
+#include <algorithm>
+#include <limits>
+
+namespace Engine {
+namespace Logic {
+
+bool ContactSolver::IsDynamic(const ColliderStore& store, uint32_t index) {
+    return !store.IsStatic(index) && store.HasFlag(index, ColliderStore::HAS_TRANSFORM);
+}
+
+uint64_t ContactSolver::PairKey(const ColliderStore& store, uint32_t a, uint32_t b) {
+    // Handles survive slot changes between steps; slot order does not, so
+    // the key is order independent (the impulses are too, see Solve)
+    uint64_t handleA = store.entities[a] ? store.entities[a]->GetHandle().value : a;
+    uint64_t handleB = store.entities[b] ? store.entities[b]->GetHandle().value : b;
+    if (handleA > handleB) std::swap(handleA, handleB);
+    return (handleA << 32) | handleB;
+}
+
+void ContactSolver::ApplyImpulse(ColliderStore& store, const Constraint& constraint, const glm::vec2& impulse) {
+    const float invMassA = velocityInvMass[constraint.a];
+    const float invMassB = velocityInvMass[constraint.b];
+    store.velX[constraint.a] -= impulse.x * invMassA;
+    store.velY[constraint.a] -= impulse.y * invMassA;
+    store.velX[constraint.b] += impulse.x * invMassB;
+    store.velY[constraint.b] += impulse.y * invMassB;
+}
+
+void ContactSolver::Solve(ColliderStore& store, const std::vector<SolverContact>& contacts,
+                          const SolverSettings& settings) {
+    PROFILE_SCOPE("ContactSolver::Solve");
+    const uint32_t count = static_cast<uint32_t>(store.Size());
+    velocityInvMass.assign(count, 0.0f);
+    positionInvMass.assign(count, 0.0f);
+    startPositions.resize(count);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        startPositions[i] = glm::vec2(store.posX[i], store.posY[i]);
+        if (!IsDynamic(store, i)) continue;
+
+        // Colliders without a body can still be pushed out, as in ResolveCollision
+        float invMass = 1.0f;
+        if (store.HasFlag(i, ColliderStore::HAS_PHYSICS)) {
+            invMass = store.mass[i] > 0.0f ? 1.0f / store.mass[i] : 1.0f;
+            velocityInvMass[i] = invMass;
+        }
+        positionInvMass[i] = invMass;
+    }
+
+    // A contact means an awake body touches this one
+    for (const SolverContact& contact : contacts) {
+        for (uint32_t index : {contact.a, contact.b}) {
+            if (!store.HasFlag(index, ColliderStore::SLEEPING)) continue;
+            store.flags[index] &= static_cast<uint8_t>(~ColliderStore::SLEEPING);
+            store.physics[index]->WakeUp();
+        }
+    }
+
+    constraints.clear();
+    constraints.reserve(contacts.size());
+    warmStarted = 0;
+
+    for (const SolverContact& contact : contacts) {
+        const uint32_t a = contact.a;
+        const uint32_t b = contact.b;
+        const float velocityMass = velocityInvMass[a] + velocityInvMass[b];
+        const float positionMass = positionInvMass[a] + positionInvMass[b];
+        if (positionMass <= 0.0f) continue; // Nothing here can move
+
+        Constraint constraint;
+        constraint.a = a;
+        constraint.b = b;
+        constraint.normal = contact.normal;
+        constraint.tangent = glm::vec2(-contact.normal.y, contact.normal.x);
+        constraint.penetration = contact.penetration;
+        constraint.normalMass = velocityMass > 0.0f ? 1.0f / velocityMass : 0.0f;
+        constraint.positionMass = 1.0f / positionMass;
+        constraint.normalImpulse = 0.0f;
+        constraint.tangentImpulse = 0.0f;
+        constraint.key = PairKey(store, a, b);
+
+        // Bounce only on real impacts, resting contacts would jitter otherwise.
+        // Static partners have no bounce of their own, the body's is used.
+        const bool physicsA = store.HasFlag(a, ColliderStore::HAS_PHYSICS);
+        const bool physicsB = store.HasFlag(b, ColliderStore::HAS_PHYSICS);
+        float restitution = 0.0f;
+        if (physicsA && physicsB) {
+            restitution = std::min(store.bounceDamping[a], store.bounceDamping[b]);
+        } else if (physicsA || physicsB) {
+            restitution = physicsA ? store.bounceDamping[a] : store.bounceDamping[b];
+        }
+
+        const glm::vec2 relative(store.velX[b] - store.velX[a], store.velY[b] - store.velY[a]);
+        const float closing = glm::dot(relative, constraint.normal);
+        constraint.bounce = (closing < -settings.restitutionThreshold) ? -restitution * closing : 0.0f;
+
+        constraints.push_back(constraint);
+    }
+
+    // Warm start once every bounce target is known, so they only see the
+    // velocities the bodies arrived with. Swapping a and b flips both the
+    // normal and the tangent, so cached impulses apply in either slot order.
+    if (settings.warmStarting) {
+        for (Constraint& constraint : constraints) {
+            if (constraint.normalMass <= 0.0f) continue;
+            auto cached = cache.find(constraint.key);
+            if (cached == cache.end()) continue;
+
+            constraint.normalImpulse = cached->second.normal;
+            constraint.tangentImpulse = cached->second.tangent;
+            ApplyImpulse(store, constraint, constraint.normal * constraint.normalImpulse +
+                                            constraint.tangent * constraint.tangentImpulse);
+            warmStarted++;
+        }
+    }
+
+    // Velocity iterations
+    for (int iteration = 0; iteration < settings.velocityIterations; ++iteration) {
+        for (Constraint& constraint : constraints) {
+            if (constraint.normalMass <= 0.0f) continue;
+            const uint32_t a = constraint.a;
+            const uint32_t b = constraint.b;
+
+            // Friction, bounded by the current normal impulse
+            glm::vec2 relative(store.velX[b] - store.velX[a], store.velY[b] - store.velY[a]);
+            const float maxFriction = settings.friction * constraint.normalImpulse;
+            float impulse = -glm::dot(relative, constraint.tangent) * constraint.normalMass;
+            float accumulated = std::clamp(constraint.tangentImpulse + impulse, -maxFriction, maxFriction);
+            impulse = accumulated - constraint.tangentImpulse;
+            constraint.tangentImpulse = accumulated;
+            ApplyImpulse(store, constraint, constraint.tangent * impulse);
+
+            // Normal, the accumulated impulse may only push
+            relative = glm::vec2(store.velX[b] - store.velX[a], store.velY[b] - store.velY[a]);
+            impulse = (constraint.bounce - glm::dot(relative, constraint.normal)) * constraint.normalMass;
+            accumulated = std::max(constraint.normalImpulse + impulse, 0.0f);
+            impulse = accumulated - constraint.normalImpulse;
+            constraint.normalImpulse = accumulated;
+            ApplyImpulse(store, constraint, constraint.normal * impulse);
+        }
+    }
+
+    nextCache.clear();
+    nextCache.reserve(constraints.size());
+    for (const Constraint& constraint : constraints) {
+        nextCache[constraint.key] = {constraint.normalImpulse, constraint.tangentImpulse};
+        if (velocityInvMass[constraint.a] > 0.0f) store.flags[constraint.a] |= ColliderStore::VELOCITY_DIRTY;
+        if (velocityInvMass[constraint.b] > 0.0f) store.flags[constraint.b] |= ColliderStore::VELOCITY_DIRTY;
+    }
+    cache.swap(nextCache);
+
+    // Position iterations. Penetration is tracked from the detected value and
+    // the displacement since, so contacts are not re-tested.
+    for (int iteration = 0; iteration < settings.positionIterations; ++iteration) {
+        for (const Constraint& constraint : constraints) {
+            const uint32_t a = constraint.a;
+            const uint32_t b = constraint.b;
+
+            const glm::vec2 movedA = glm::vec2(store.posX[a], store.posY[a]) - startPositions[a];
+            const glm::vec2 movedB = glm::vec2(store.posX[b], store.posY[b]) - startPositions[b];
+            const float penetration = constraint.penetration - glm::dot(movedB - movedA, constraint.normal);
+            if (penetration <= settings.slop) continue;
+
+            const float correction = (penetration - settings.slop) * settings.positionCorrection * constraint.positionMass;
+            const glm::vec2 push = constraint.normal * correction;
+            store.posX[a] -= push.x * positionInvMass[a];
+            store.posY[a] -= push.y * positionInvMass[a];
+            store.posX[b] += push.x * positionInvMass[b];
+            store.posY[b] += push.y * positionInvMass[b];
+            if (positionInvMass[a] > 0.0f) store.flags[a] |= ColliderStore::POSITION_DIRTY;
+            if (positionInvMass[b] > 0.0f) store.flags[b] |= ColliderStore::POSITION_DIRTY;
+        }
+    }
+}
+
+uint32_t ContactSolver::FindRoot(uint32_t index) {
+    while (parent[index] != index) {
+        parent[index] = parent[parent[index]]; // Path halving
+        index = parent[index];
+    }
+    return index;
+}
+
+void ContactSolver::UpdateSleep(ColliderStore& store, const std::vector<SolverContact>& contacts,
+                                const SolverSettings& settings, float deltaTime) {
+    PROFILE_SCOPE("ContactSolver::UpdateSleep");
+    const uint32_t count = static_cast<uint32_t>(store.Size());
+    parent.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        parent[i] = i;
+    }
+
+    // Islands: dynamic bodies joined by contacts (static colliders don't
+    // connect, a floor would merge everything standing on it)
+    for (const SolverContact& contact : contacts) {
+        if (!IsDynamic(store, contact.a) || !IsDynamic(store, contact.b)) continue;
+        const uint32_t rootA = FindRoot(contact.a);
+        const uint32_t rootB = FindRoot(contact.b);
+        if (rootA != rootB) parent[std::max(rootA, rootB)] = std::min(rootA, rootB);
+    }
+
+    // An island rests as long as its least rested body
+    const float sleepSpeedSquared = settings.sleepVelocity * settings.sleepVelocity;
+    islandRest.assign(count, std::numeric_limits<float>::max());
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!IsDynamic(store, i)) continue;
+
+        float rest = 0.0f; // Bodiless colliders never sleep, nor does their island
+        SimplePhysicsComponent* body = store.physics[i];
+        if (body && body->IsSleeping()) {
+            rest = body->GetSleepTime();
+        } else if (body) {
+            const float speedSquared = store.velX[i] * store.velX[i] + store.velY[i] * store.velY[i];
+            body->SetSleepTime(speedSquared > sleepSpeedSquared ? 0.0f : body->GetSleepTime() + deltaTime);
+            rest = body->GetSleepTime();
+        }
+
+        const uint32_t root = FindRoot(i);
+        islandRest[root] = std::min(islandRest[root], rest);
+    }
+
+    sleepingBodies = 0;
+    islandCount = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!IsDynamic(store, i)) continue;
+
+        const uint32_t root = FindRoot(i);
+        if (root == i) islandCount++;
+
+        SimplePhysicsComponent* body = store.physics[i];
+        if (!body) continue;
+
+        if (islandRest[root] >= settings.timeToSleep) {
+            if (!body->IsSleeping()) body->Sleep();
+            store.flags[i] |= ColliderStore::SLEEPING;
+            sleepingBodies++;
+        } else if (body->IsSleeping()) {
+            body->WakeUp(); // Part of an island that is still moving
+            store.flags[i] &= static_cast<uint8_t>(~ColliderStore::SLEEPING);
+        }
+    }
+}
+
+void ContactSolver::Clear() {
+    cache.clear();
+    nextCache.clear();
+    warmStarted = 0;
+    sleepingBodies = 0;
+    islandCount = 0;
+}
+
+} // namespace Logic
+} // namespace Engine
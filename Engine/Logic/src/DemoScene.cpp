@@ -1,5 +1,6 @@
 //TODO: Move scene files into a separate folder
 #include "../include/DemoScene.h"
+#include "../include/SceneSerializer.h"
 #include <iostream>
 
 namespace Engine {
@@ -100,5 +101,25 @@ void DemoScene::Destroy() {
     staticCube = nullptr;
 }
 
+bool DemoScene::SaveSnapshot(const std::string& path) const {
+    return SceneSerializer::Save(*scene, path);
+}
+
+bool DemoScene::LoadSnapshot(const std::string& path) {
+    Destroy();
+    scene->SetActive(true);
+    if (!SceneSerializer::Load(*scene, path)) {
+        scene->Destroy();
+        scene->SetActive(true);
+        Initialize();
+        return false;
+    }
+
+    movingCube = scene->FindEntity("Moving Cube");
+    rotatingCube = scene->FindEntity("Rotating Cube");
+    staticCube = scene->FindEntity("Static Cube");
+    return true;
+}
+
 } // namespace Logic
 } // namespace Engine
@@ -1,4 +1,5 @@
 #include "../include/Entity.h"
+#include "../include/Scene.h"
 #include <iostream>
 #include <algorithm>
 
@@ -6,31 +7,57 @@ namespace Engine {
 namespace Logic {
 
 // Static member initialization
-int Entity::nextId = 1;
+std::atomic<int> Entity::nextId{1};
 
 // Constructors
 Entity::Entity()
-    : id(nextId++), active(true), name("Entity_" + std::to_string(id)) {
+    : Entity(Registry::GetDefault(), "Entity_" + std::to_string(nextId)) {
 }
 
 Entity::Entity(const std::string& entityName)
-    : id(nextId++), active(true), name(entityName) {
+    : Entity(Registry::GetDefault(), entityName) {
 }
 
 Entity::Entity(int entityId, const std::string& entityName)
-    : id(entityId), active(true), name(entityName.empty() ? "Entity_" + std::to_string(id) : entityName) {
+    : Entity(Registry::GetDefault(), entityId, entityName) {
+}
+
+Entity::Entity(std::shared_ptr<Registry> entityRegistry, const std::string& entityName)
+    : registry(std::move(entityRegistry)), id(nextId++), active(true), name(entityName) {
+    handle = registry->Create(this);
+}
+
+Entity::Entity(std::shared_ptr<Registry> entityRegistry, int entityId, const std::string& entityName)
+    : registry(std::move(entityRegistry)), id(entityId), active(true),
+      name(entityName.empty() ? "Entity_" + std::to_string(id) : entityName) {
+    handle = registry->Create(this);
+
     // Update nextId if this id is higher
-    if (entityId >= nextId) {
-        nextId = entityId + 1;
+    int next = nextId.load();
+    while (entityId >= next && !nextId.compare_exchange_weak(next, entityId + 1)) {
+    }
+}
+
+Entity::~Entity() {
+    registry->Destroy(handle);
+}
+
+void Entity::SetName(const std::string& newName) {
+    if (newName == name) return;
+
+    std::string oldName = std::move(name);
+    name = newName;
+    if (scene) {
+        scene->OnEntityRenamed(*this, oldName);
     }
 }
 
 void Entity::Update(float deltaTime) {
     if (!active) return;
 
-    // Update all enabled components
-    for (auto& component : componentsVector) {
-        if (component && component->IsEnabled()) {
+    // Only components with an Update of their own, the rest never get a call
+    for (Component* component : updatableComponents) {
+        if (component->IsEnabled()) {
             component->Update(deltaTime);
         }
     }
@@ -44,23 +71,25 @@ void Entity::Destroy() {
         }
     }
 
-    // Clear all component containers
-    components.clear();
+    // Drop the components from the registry pools
+    registry->RemoveAll(handle);
     componentsVector.clear();
+    updatableComponents.clear();
 
     // Mark as inactive
     active = false;
 }
 
-std::string Entity::GetDebugInfo() const {
-    std::string info = "Entity: " + name + " (ID: " + std::to_string(id) + ")\n";
-    info += "Active: " + std::string(active ? "true" : "false") + "\n";
-    info += "Components (" + std::to_string(components.size()) + "):\n";
+Common::FrameString Entity::GetDebugInfo() const {
+    Common::FrameString info = "Entity: ";
+    info.append(name).append(" (ID: ").append(std::to_string(id)).append(")\n");
+    info.append("Active: ").append(active ? "true" : "false").append("\n");
+    info.append("Components (").append(std::to_string(componentsVector.size())).append("):\n");
 
     for (const auto& component : componentsVector) {
         if (component) {
-            info += "  - " + component->GetTypeName() + " (Enabled: " +
-                    std::string(component->IsEnabled() ? "true" : "false") + ")\n";
+            info.append("  - ").append(component->GetTypeName());
+            info.append(" (Enabled: ").append(component->IsEnabled() ? "true" : "false").append(")\n");
         }
     }
 
@@ -0,0 +1,51 @@
+#include "../include/FixedTimestep.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Engine {
+namespace Logic {
+
+FixedTimestep::FixedTimestep(float step, int substepCount, int maxSteps)
+    : stepSize(1.0f / 60.0f), substeps(1), maxStepsPerFrame(8) {
+    SetStepSize(step);
+    SetSubsteps(substepCount);
+    SetMaxStepsPerFrame(maxSteps);
+}
+
+int FixedTimestep::Advance(float deltaTime) {
+    accumulator += std::max(deltaTime, 0.0f);
+
+    int steps = static_cast<int>(accumulator / stepSize);
+    if (steps > maxStepsPerFrame) {
+        // Keep the fraction of a step so interpolation stays smooth
+        const float kept = std::fmod(accumulator, stepSize);
+        droppedTime += accumulator - kept - maxStepsPerFrame * stepSize;
+        accumulator = kept + maxStepsPerFrame * stepSize;
+        steps = maxStepsPerFrame;
+    }
+
+    accumulator = std::max(accumulator - steps * stepSize, 0.0f);
+    lastStepCount = steps;
+    return steps;
+}
+
+void FixedTimestep::Reset() {
+    accumulator = 0.0f;
+    lastStepCount = 0;
+}
+
+void FixedTimestep::SetStepSize(float seconds) {
+    stepSize = std::clamp(seconds, 1.0f / 1000.0f, 1.0f / 10.0f);
+    accumulator = std::min(accumulator, stepSize);
+}
+
+void FixedTimestep::SetSubsteps(int count) {
+    substeps = std::clamp(count, 1, 64);
+}
+
+void FixedTimestep::SetMaxStepsPerFrame(int count) {
+    maxStepsPerFrame = std::max(count, 1);
+}
+
+} // namespace Logic
+} // namespace Engine
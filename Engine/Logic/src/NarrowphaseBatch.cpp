@@ -0,0 +1,224 @@
+#include "../include/NarrowphaseBatch.h"
+
+#if defined(BASIC_ENGINE_SIMD)
+    #if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+        #define NARROWPHASE_X86 1
+        #include <immintrin.h>
+        #if defined(_MSC_VER) && !defined(__clang__)
+            #include <intrin.h>
+            #define NARROWPHASE_TARGET_AVX2
+        #else
+            #define NARROWPHASE_TARGET_AVX2 __attribute__((target("avx2")))
+        #endif
+    #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        #define NARROWPHASE_NEON 1
+        #include <arm_neon.h>
+    #endif
+#endif
+
+namespace Engine {
+namespace Logic {
+
+namespace {
+
+// Relative slack on the squared combined radius. Far larger than any rounding
+// difference between this test and sqrt(dx*dx + dy*dy) < r in the scalar path.
+constexpr float kOverlapSlack = 1.001f;
+
+bool IsCirclePair(const ColliderStore& store, const BroadphasePair& pair) {
+    return store.shape[pair.first] == CollisionShape::CIRCLE &&
+           store.shape[pair.second] == CollisionShape::CIRCLE;
+}
+
+uint8_t ScalarMayOverlap(const ColliderStore& store, const BroadphasePair& pair) {
+    if (!IsCirclePair(store, pair)) return 1;
+
+    const uint32_t a = pair.first;
+    const uint32_t b = pair.second;
+    float dx = (store.posX[b] + store.offsetX[b]) - (store.posX[a] + store.offsetX[a]);
+    float dy = (store.posY[b] + store.offsetY[b]) - (store.posY[a] + store.offsetY[a]);
+    float r = store.radius[a] + store.radius[b];
+    return (dx * dx + dy * dy < r * r * kOverlapSlack) ? 1 : 0;
+}
+
+void FilterScalar(const ColliderStore& store, const BroadphasePair* pairs, size_t count, uint8_t* mayOverlap) {
+    for (size_t i = 0; i < count; ++i) {
+        mayOverlap[i] = ScalarMayOverlap(store, pairs[i]);
+    }
+}
+
+#if defined(NARROWPHASE_X86) || defined(NARROWPHASE_NEON)
+
+// Collects the lane inputs for `width` pairs. Lanes that aren't circle-circle
+// get a zero distance so the vector test keeps them.
+void GatherLanes(const ColliderStore& store, const BroadphasePair* pairs, size_t width,
+                 float* ax, float* ay, float* bx, float* by, float* ra, float* rb) {
+    for (size_t l = 0; l < width; ++l) {
+        const uint32_t a = pairs[l].first;
+        const uint32_t b = pairs[l].second;
+
+        if (IsCirclePair(store, pairs[l])) {
+            ax[l] = store.posX[a] + store.offsetX[a];
+            ay[l] = store.posY[a] + store.offsetY[a];
+            bx[l] = store.posX[b] + store.offsetX[b];
+            by[l] = store.posY[b] + store.offsetY[b];
+            ra[l] = store.radius[a];
+            rb[l] = store.radius[b];
+        } else {
+            ax[l] = ay[l] = bx[l] = by[l] = 0.0f;
+            ra[l] = rb[l] = 1.0f;
+        }
+    }
+}
+
+#endif // NARROWPHASE_X86 || NARROWPHASE_NEON
+
+#if defined(NARROWPHASE_X86)
+
+void FilterSSE2(const ColliderStore& store, const BroadphasePair* pairs, size_t count, uint8_t* mayOverlap) {
+    alignas(16) float ax[4], ay[4], bx[4], by[4], ra[4], rb[4];
+    const __m128 slack = _mm_set1_ps(kOverlapSlack);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        GatherLanes(store, pairs + i, 4, ax, ay, bx, by, ra, rb);
+
+        __m128 dx = _mm_sub_ps(_mm_load_ps(bx), _mm_load_ps(ax));
+        __m128 dy = _mm_sub_ps(_mm_load_ps(by), _mm_load_ps(ay));
+        __m128 r = _mm_add_ps(_mm_load_ps(ra), _mm_load_ps(rb));
+        __m128 distSq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        __m128 limit = _mm_mul_ps(_mm_mul_ps(r, r), slack);
+
+        int mask = _mm_movemask_ps(_mm_cmplt_ps(distSq, limit));
+        for (int l = 0; l < 4; ++l) {
+            mayOverlap[i + l] = static_cast<uint8_t>((mask >> l) & 1);
+        }
+    }
+
+    FilterScalar(store, pairs + i, count - i, mayOverlap + i);
+}
+
+NARROWPHASE_TARGET_AVX2
+void FilterAVX2(const ColliderStore& store, const BroadphasePair* pairs, size_t count, uint8_t* mayOverlap) {
+    alignas(32) float ax[8], ay[8], bx[8], by[8], ra[8], rb[8];
+    const __m256 slack = _mm256_set1_ps(kOverlapSlack);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        GatherLanes(store, pairs + i, 8, ax, ay, bx, by, ra, rb);
+
+        // Separate mul and add (no FMA) like the SSE2 path
+        __m256 dx = _mm256_sub_ps(_mm256_load_ps(bx), _mm256_load_ps(ax));
+        __m256 dy = _mm256_sub_ps(_mm256_load_ps(by), _mm256_load_ps(ay));
+        __m256 r = _mm256_add_ps(_mm256_load_ps(ra), _mm256_load_ps(rb));
+        __m256 distSq = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 limit = _mm256_mul_ps(_mm256_mul_ps(r, r), slack);
+
+        int mask = _mm256_movemask_ps(_mm256_cmp_ps(distSq, limit, _CMP_LT_OQ));
+        for (int l = 0; l < 8; ++l) {
+            mayOverlap[i + l] = static_cast<uint8_t>((mask >> l) & 1);
+        }
+    }
+
+    FilterScalar(store, pairs + i, count - i, mayOverlap + i);
+}
+
+bool CpuHasAVX2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx) return false;
+    if ((_xgetbv(0) & 0x6) != 0x6) return false; // OS saves YMM state
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // NARROWPHASE_X86
+
+#if defined(NARROWPHASE_NEON)
+
+void FilterNEON(const ColliderStore& store, const BroadphasePair* pairs, size_t count, uint8_t* mayOverlap) {
+    alignas(16) float ax[4], ay[4], bx[4], by[4], ra[4], rb[4];
+    alignas(16) uint32_t lanes[4];
+    const float32x4_t slack = vdupq_n_f32(kOverlapSlack);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        GatherLanes(store, pairs + i, 4, ax, ay, bx, by, ra, rb);
+
+        float32x4_t dx = vsubq_f32(vld1q_f32(bx), vld1q_f32(ax));
+        float32x4_t dy = vsubq_f32(vld1q_f32(by), vld1q_f32(ay));
+        float32x4_t r = vaddq_f32(vld1q_f32(ra), vld1q_f32(rb));
+        float32x4_t distSq = vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy));
+        float32x4_t limit = vmulq_f32(vmulq_f32(r, r), slack);
+
+        vst1q_u32(lanes, vcltq_f32(distSq, limit));
+        for (int l = 0; l < 4; ++l) {
+            mayOverlap[i + l] = lanes[l] ? 1 : 0;
+        }
+    }
+
+    FilterScalar(store, pairs + i, count - i, mayOverlap + i);
+}
+
+#endif // NARROWPHASE_NEON
+
+} // namespace
+
+CircleBatchKernel::CircleBatchKernel(SimdLevel requested)
+    : level(IsSimdLevelSupported(requested) ? requested : DetectSimdLevel()),
+      filter(FilterScalar) {
+
+    switch (level) {
+#if defined(NARROWPHASE_X86)
+        case SimdLevel::SSE2: filter = FilterSSE2; break;
+        case SimdLevel::AVX2: filter = FilterAVX2; break;
+#endif
+#if defined(NARROWPHASE_NEON)
+        case SimdLevel::NEON: filter = FilterNEON; break;
+#endif
+        default: filter = FilterScalar; break;
+    }
+}
+
+SimdLevel CircleBatchKernel::DetectSimdLevel() {
+#if defined(NARROWPHASE_X86)
+    return CpuHasAVX2() ? SimdLevel::AVX2 : SimdLevel::SSE2;
+#elif defined(NARROWPHASE_NEON)
+    return SimdLevel::NEON;
+#else
+    return SimdLevel::SCALAR;
+#endif
+}
+
+bool CircleBatchKernel::IsSimdLevelSupported(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SCALAR: return true;
+#if defined(NARROWPHASE_X86)
+        case SimdLevel::SSE2: return true;
+        case SimdLevel::AVX2: return CpuHasAVX2();
+#endif
+#if defined(NARROWPHASE_NEON)
+        case SimdLevel::NEON: return true;
+#endif
+        default: return false;
+    }
+}
+
+const char* CircleBatchKernel::GetSimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SCALAR: return "Scalar";
+        case SimdLevel::SSE2: return "SSE2";
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::NEON: return "NEON";
+    }
+    return "Unknown";
+}
+
+} // namespace Logic
+} // namespace Engine
@@ -1,13 +1,15 @@
 #include "../include/ParticleScene.h"
 #include "../include/SimplePhysicsComponent.h"
+#include "../include/SceneSerializer.h"
+#include "../../Common/include/Profiler.h"
 #include <iostream>
 #include <algorithm>
 
 namespace Engine {
 namespace Logic {
 
-    ParticleScene::ParticleScene()
-        : gen(rd()), colorDist(0.3f, 1.0f), positionDist(-1.0f, 1.0f), velocityDist(-50.0f, 50.0f) {
+    ParticleScene::ParticleScene(uint32_t randomSeed)
+        : seed(randomSeed), gen(randomSeed), colorDist(0.3f, 1.0f), positionDist(-1.0f, 1.0f), velocityDist(-50.0f, 50.0f) {
         scene = std::make_shared<Scene>("Particle Physics Scene");
         collisionSystem = std::make_unique<CollisionSystem>();
 
@@ -24,6 +26,24 @@ namespace Logic {
         spawnArea = glm::vec2(140.0f, 30.0f); // Adjust to new cup width
         spawnHeight = 80.0f;         // Lower spawn height
 
+        // Fast particles against thin walls: two substeps per 60 Hz step
+        scene->GetTimestep().SetSubsteps(2);
+
+        // Solver thresholds in pixels: one substep of gravity alone is ~4 px/s
+        SolverSettings& solver = collisionSystem->GetSolverSettings();
+        solver.restitutionThreshold = 20.0f;
+        solver.slop = 0.5f;
+        solver.sleepVelocity = 5.0f;
+
+        // Gravity and collisions run ahead of the scene's integration pass
+        scene->InsertSystem("Physics", "Gravity", [this](float dt) { UpdatePhysics(dt); });
+        scene->InsertSystem("Physics", "Collisions", [this](float dt) { collisionSystem->Update(dt); });
+        scene->InsertSystem("Physics", "GPU Particles", [this](float dt) {
+            if (gpuStep) gpuStep(dt);
+        });
+        scene->SetSystemEnabled("GPU Particles", false);
+
+        ReserveParticles(initialPoolSize);
         Initialize();
     }
 
@@ -68,6 +88,8 @@ namespace Logic {
 
 void ParticleScene::CreateCupBoundaries() {
     // Calculate wall positions for a proper U-shaped cup
+    cupRevision++;
+
     float halfWidth = cupWidth / 2.0f;
     float cupBottom = cupCenter.y;          // Bottom of the cup
     float cupTop = cupCenter.y + cupHeight; // Top of the cup
@@ -159,48 +181,45 @@ void ParticleScene::CreateWall(std::shared_ptr<Entity>& wall, const std::string&
 }
 
 void ParticleScene::Update(float deltaTime) {
+    PROFILE_SCOPE("ParticleScene::Update");
+    const bool gpu = IsGpuSimulation();
+    scene->SetSystemEnabled("Gravity", physicsEnabled && !gpu);
+    scene->SetSystemEnabled("Collisions", physicsEnabled && !gpu);
+    scene->SetSystemEnabled("GPU Particles", physicsEnabled && gpu);
+
     if (!physicsEnabled) {
         // Still update the scene but don't apply physics time scaling
         scene->Update(0.0f);
         return;
     }
 
-    // Apply time scaling to physics
+    // Apply time scaling to physics. Gravity, collisions and integration all
+    // run as scene systems, in fixed steps.
     float scaledDeltaTime = deltaTime * timeScale;
-
-    // Update physics for all particles
-    UpdatePhysics(scaledDeltaTime);
-
-    // Update collision system
-    collisionSystem->Update(scaledDeltaTime);
-
-    // Update the base scene
-    scene->Update(scaledDeltaTime);
+    scene->UpdateFixed(scaledDeltaTime);
 
     // Clean up any destroyed particles
     CleanupDestroyedParticles();
 }
 
 void ParticleScene::UpdatePhysics(float deltaTime) {
-    // Apply gravity and update positions for all particles
-    for (auto& particle : particles) {
-        if (!particle || !particle->IsActive()) continue;
-
-        auto physics = particle->GetComponent<SimplePhysicsComponent>();
-        if (physics) {
-            // Apply 2D gravity
-            glm::vec3 currentVel = physics->GetVelocity();
-            currentVel.x += gravity.x * deltaTime;
-            currentVel.y += gravity.y * deltaTime;
-
-            // Simple air resistance for more realistic movement
-            float airResistance = 0.99f;
-            currentVel.x *= airResistance;
-            currentVel.z = 0.0f; // Keep Z velocity at 0 for 2D simulation
-
-            physics->SetVelocity(currentVel);
-        }
-    }
+    // Apply gravity to every particle, straight from the packed physics pool
+    scene->GetView<SimplePhysicsComponent>().Each([&](EntityHandle, SimplePhysicsComponent& physics) {
+        Entity* particle = physics.GetOwner();
+        if (!particle || !particle->IsActive() || physics.IsSleeping()) return;
+
+        // Apply 2D gravity
+        glm::vec3 currentVel = physics.GetVelocity();
+        currentVel.x += gravity.x * deltaTime;
+        currentVel.y += gravity.y * deltaTime;
+
+        // Simple air resistance for more realistic movement
+        float airResistance = 0.99f;
+        currentVel.x *= airResistance;
+        currentVel.z = 0.0f; // Keep Z velocity at 0 for 2D simulation
+
+        physics.SetVelocity(currentVel);
+    });
 }
 
 void ParticleScene::SpawnParticle() {
@@ -211,48 +230,109 @@ void ParticleScene::SpawnParticle() {
 void ParticleScene::SpawnParticle(const glm::vec2& position, float radius) {
     if (radius < 0) radius = particleRadius;
 
-    static int particleCounter = 0;
     particleCounter++;
 
-    auto particle = scene->CreateEntity("Particle_" + std::to_string(particleCounter));
+    auto particle = AcquireParticle();
+    particle->SetName("Particle_" + std::to_string(particleCounter));
 
     // Transform component
-    auto transform = particle->AddComponent<TransformComponent>(
-        glm::vec3(position.x, position.y, 0.0f),
-        glm::vec3(0.0f, 0.0f, 0.0f),
-        glm::vec3(radius * 2.0f, radius * 2.0f, radius * 2.0f) // Scale for visual size
-    );
+    auto transform = particle->GetComponent<TransformComponent>();
+    transform->SetPosition(glm::vec3(position.x, position.y, 0.0f));
+    transform->SetRotation(glm::vec3(0.0f, 0.0f, 0.0f));
+    transform->SetScale(glm::vec3(radius * 2.0f, radius * 2.0f, radius * 2.0f)); // Scale for visual size
+    transform->StorePreviousState(); // Pooled particles would blend in from where they died
 
     // Render component - circle
-    auto render = particle->AddComponent<RenderComponent>(
-        PrimitiveType::CIRCLE,
-        GenerateParticleColor(),
-        true
-    );
+    auto render = particle->GetComponent<RenderComponent>();
+    render->SetColor(GenerateParticleColor());
+    render->SetVisible(true);
 
     // Collision component - circle collider
-    auto collision = particle->AddComponent<CollisionComponent>(
-        CollisionShape::CIRCLE,
-        false, // Not a trigger
-        false, // Dynamic object
-        "particle"
-    );
+    auto collision = particle->GetComponent<CollisionComponent>();
     collision->SetCircle(radius, glm::vec2(0.0f, 0.0f));
 
     // Physics component
-    auto physics = particle->AddComponent<SimplePhysicsComponent>(
-        particleMass * radius, // Mass proportional to radius
-        true // Affected by gravity
-    );
+    auto physics = particle->GetComponent<SimplePhysicsComponent>();
+    physics->SetMass(particleMass * radius); // Mass proportional to radius
+    physics->SetAffectedByGravity(true);
+    physics->SetWorldBounds(false); // The cup holds them
     physics->SetBounceDamping(particleBounciness);
     physics->SetVelocity(glm::vec3(GenerateInitialVelocity(), 0.0f));
+    physics->WakeUp(); // Pooled particles may have been asleep
 
     // Add to particle list and collision system
+    const uint32_t index = particle->GetHandle().GetIndex();
+    if (index >= particleSlots.size()) {
+        particleSlots.resize(index + 1);
+    }
+    particleSlots[index] = static_cast<uint32_t>(particles.size());
     particles.push_back(particle);
     collisionSystem->RegisterEntity(particle);
 
-    std::cout << "Spawned particle at (" << position.x << ", " << position.y
-              << ") with radius " << radius << std::endl;
+    if (verbose) {
+        std::cout << "Spawned particle at (" << position.x << ", " << position.y
+                  << ") with radius " << radius << std::endl;
+    }
+}
+
+std::shared_ptr<Entity> ParticleScene::CreateParticleEntity() {
+    auto particle = scene->CreateEntity();
+    particle->AddComponent<TransformComponent>();
+    particle->AddComponent<RenderComponent>(PrimitiveType::CIRCLE, glm::vec3(1.0f), true);
+    particle->AddComponent<CollisionComponent>(
+        CollisionShape::CIRCLE,
+        false, // Not a trigger
+        false, // Dynamic object
+        "particle"
+    );
+    particle->AddComponent<SimplePhysicsComponent>(particleMass, true);
+    return particle;
+}
+
+std::shared_ptr<Entity> ParticleScene::AcquireParticle() {
+    if (freeParticles.empty()) {
+        return CreateParticleEntity();
+    }
+
+    auto particle = std::move(freeParticles.back());
+    freeParticles.pop_back();
+    particle->SetActive(true);
+    scene->AddEntity(particle);
+    return particle;
+}
+
+void ParticleScene::ReleaseParticle(size_t slot) {
+    auto particle = std::move(particles[slot]);
+
+    // Swap-and-pop
+    const size_t last = particles.size() - 1;
+    if (slot != last) {
+        particles[slot] = std::move(particles[last]);
+        particleSlots[particles[slot]->GetHandle().GetIndex()] = static_cast<uint32_t>(slot);
+    }
+    particles.pop_back();
+
+    if (!particle) return;
+    collisionSystem->UnregisterEntity(particle);
+    scene->DetachEntity(particle);
+    particle->SetActive(false);
+
+    // Entity::Destroy drops the components, such a particle can't be reused
+    if (particle->HasComponent<CollisionComponent>()) {
+        freeParticles.push_back(std::move(particle));
+    }
+}
+
+void ParticleScene::ReserveParticles(size_t count) {
+    particles.reserve(count);
+    freeParticles.reserve(count);
+
+    while (particles.size() + freeParticles.size() < count) {
+        auto particle = CreateParticleEntity();
+        scene->DetachEntity(particle);
+        particle->SetActive(false);
+        freeParticles.push_back(std::move(particle));
+    }
 }
 
 glm::vec3 ParticleScene::GenerateParticleColor() {
@@ -268,9 +348,11 @@ glm::vec2 ParticleScene::GenerateSpawnPosition() {
     float spawnX = cupCenter.x + (positionDist(gen) * (cupWidth * 0.8f) / 2.0f); // Slightly narrower than cup
     float spawnY = cupCenter.y + cupHeight + spawnHeight + (positionDist(gen) * 20.0f); // Above cup with some randomness
 
-    std::cout << "Generated spawn position: (" << spawnX << ", " << spawnY << ")" << std::endl;
-    std::cout << "  Cup range: X(" << (cupCenter.x - cupWidth/2) << " to " << (cupCenter.x + cupWidth/2)
-              << ") Y(" << cupCenter.y << " to " << (cupCenter.y + cupHeight) << ")" << std::endl;
+    if (verbose) {
+        std::cout << "Generated spawn position: (" << spawnX << ", " << spawnY << ")" << std::endl;
+        std::cout << "  Cup range: X(" << (cupCenter.x - cupWidth/2) << " to " << (cupCenter.x + cupWidth/2)
+                  << ") Y(" << cupCenter.y << " to " << (cupCenter.y + cupHeight) << ")" << std::endl;
+    }
 
     return glm::vec2(spawnX, spawnY);
 }
@@ -283,21 +365,12 @@ glm::vec2 ParticleScene::GenerateInitialVelocity() {
 }
 
 void ParticleScene::CleanupDestroyedParticles() {
-    // Remove inactive particles from our list
-    particles.erase(
-        std::remove_if(particles.begin(), particles.end(),
-            [this](const std::shared_ptr<Entity>& particle) {
-                if (!particle || !particle->IsActive()) {
-                    // Unregister from collision system
-                    if (particle) {
-                        collisionSystem->UnregisterEntity(particle);
-                    }
-                    return true;
-                }
-                return false;
-            }),
-        particles.end()
-    );
+    // Return inactive particles to the pool (back to front, removal swaps)
+    for (size_t i = particles.size(); i-- > 0;) {
+        if (!particles[i] || !particles[i]->IsActive()) {
+            ReleaseParticle(i);
+        }
+    }
 }
 
 void ParticleScene::SetParticleRadius(float radius) {
@@ -320,19 +393,107 @@ void ParticleScene::SetCupDimensions(float width, float height) {
     CreateCupBoundaries();
 }
 
+void ParticleScene::SetGpuStep(std::function<void(float)> step) {
+    gpuStep = std::move(step);
+    if (gpuStep) {
+        ClearAllParticles();
+    }
+}
+
+std::vector<ParticleScene::WallSegment> ParticleScene::GetWallSegments() const {
+    std::vector<WallSegment> walls;
+    for (const std::shared_ptr<Entity>* wall : {&bottomWall, &leftWall, &rightWall}) {
+        if (!*wall) continue;
+        auto collision = (*wall)->GetComponent<CollisionComponent>();
+        if (!collision || collision->GetShape() != CollisionShape::LINE_SEGMENT) continue;
+
+        const LineCollider& line = collision->GetLine();
+        walls.push_back({line.start, line.end, line.thickness});
+    }
+    return walls;
+}
+
+void ParticleScene::GenerateSpawns(size_t count, float width, std::vector<ParticleSpawn>& spawns) {
+    const float spacing = particleRadius * 2.5f;
+    const size_t perRow = std::max<size_t>(1, static_cast<size_t>(width / spacing));
+    const float left = cupCenter.x - (perRow - 1) * spacing * 0.5f;
+    const float bottom = cupCenter.y + cupHeight + spawnHeight;
+    const float jitter = (spacing - particleRadius * 2.0f) * 0.5f;
+
+    spawns.reserve(spawns.size() + count);
+    for (size_t i = 0; i < count; ++i) {
+        const float column = static_cast<float>(i % perRow);
+        const float row = static_cast<float>(i / perRow);
+        ParticleSpawn spawn;
+        spawn.position = glm::vec2(left + column * spacing + positionDist(gen) * jitter,
+                                   bottom + row * spacing + positionDist(gen) * jitter);
+        spawn.velocity = GenerateInitialVelocity();
+        spawn.radius = particleRadius;
+        spawn.color = GenerateParticleColor();
+        spawns.push_back(spawn);
+    }
+}
+
 void ParticleScene::ClearAllParticles() {
-    // Unregister all particles from collision system
-    for (auto& particle : particles) {
-        if (particle) {
-            collisionSystem->UnregisterEntity(particle);
-            scene->RemoveEntity(particle);
-        }
+    // Unregister all particles and keep them for reuse
+    while (!particles.empty()) {
+        ReleaseParticle(particles.size() - 1);
     }
 
-    particles.clear();
     std::cout << "Cleared all particles" << std::endl;
 }
 
+bool ParticleScene::SaveSnapshot(const std::string& path) const {
+    return SceneSerializer::Save(*scene, path);
+}
+
+bool ParticleScene::LoadSnapshot(const std::string& path) {
+    // Old particles go back to the pool, the walls go for good
+    while (!particles.empty()) {
+        ReleaseParticle(particles.size() - 1);
+    }
+    for (std::shared_ptr<Entity>* wall : {&leftWall, &rightWall, &bottomWall}) {
+        if (*wall) {
+            collisionSystem->UnregisterEntity(*wall);
+            scene->RemoveEntity(*wall);
+            *wall = nullptr;
+        }
+    }
+    scene->FlushRemovals();
+
+    std::vector<std::shared_ptr<Entity>> loaded;
+    if (!SceneSerializer::Load(*scene, path, &loaded)) {
+        CreateCupBoundaries();
+        return false;
+    }
+
+    // Walls by name, anything else with a collider is a particle
+    for (auto& entity : loaded) {
+        auto collision = entity->GetComponent<CollisionComponent>();
+        if (!collision) continue;
+
+        collisionSystem->RegisterEntity(entity);
+        if (collision->GetLayer() == "wall") {
+            const std::string& name = entity->GetName();
+            if (name == "Left Wall") leftWall = entity;
+            else if (name == "Right Wall") rightWall = entity;
+            else if (name == "Bottom Wall") bottomWall = entity;
+            continue;
+        }
+
+        const uint32_t index = entity->GetHandle().GetIndex();
+        if (index >= particleSlots.size()) {
+            particleSlots.resize(index + 1);
+        }
+        particleSlots[index] = static_cast<uint32_t>(particles.size());
+        particles.push_back(std::move(entity));
+    }
+
+    cupRevision++; // Walls came from the file
+    std::cout << "Loaded " << particles.size() << " particles from " << path << std::endl;
+    return true;
+}
+
 void ParticleScene::Reset() {
     std::cout << "Resetting Particle Scene..." << std::endl;
     ClearAllParticles();
@@ -348,6 +509,7 @@ void ParticleScene::Destroy() {
     }
 
     particles.clear();
+    freeParticles.clear();
     leftWall = nullptr;
     rightWall = nullptr;
     bottomWall = nullptr;
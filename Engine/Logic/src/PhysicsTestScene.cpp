@@ -1,5 +1,6 @@
 //TODO: Move scene files into a separate folder
 #include "../include/PhysicsTestScene.h"
+#include "../include/SceneSerializer.h"
 #include <iostream>
 #include <random>
 #include <iomanip>
@@ -8,63 +9,8 @@
 namespace Engine {
 namespace Logic {
 
-// SimplePhysicsComponent implementation
-void SimplePhysicsComponent::Update(float deltaTime) {
-    if (!owner) return;
-
-    auto transform = owner->GetComponent<TransformComponent>();
-    if (!transform) return;
-
-    glm::vec3 position = transform->GetPosition();
-
-    // Apply gravity if enabled
-    if (affectedByGravity) {
-        velocity += acceleration * deltaTime;
-    }
-
-    // Update position
-    position += velocity * deltaTime;
-
-    // Simple floor collision (bounce)
-    if (position.y < 0.5f && velocity.y < 0.0f) { // Assuming cube size ~1.0
-        position.y = 0.5f; // Keep above floor
-        velocity.y = -velocity.y * bounceDamping; // Bounce with energy loss
-
-        // Add some friction to horizontal movement
-        velocity.x *= 0.9f;
-        velocity.z *= 0.9f;
-
-        // Stop tiny bounces
-        if (std::abs(velocity.y) < 0.1f) {
-            velocity.y = 0.0f;
-        }
-    }
-
-    // Simple boundary checks (keep objects in reasonable bounds)
-    if (position.x > 10.0f || position.x < -10.0f) {
-        velocity.x = -velocity.x * 0.5f; // Bounce off sides
-        position.x = std::clamp(position.x, -10.0f, 10.0f);
-    }
-    if (position.z > 10.0f || position.z < -10.0f) {
-        velocity.z = -velocity.z * 0.5f; // Bounce off front/back
-        position.z = std::clamp(position.z, -10.0f, 10.0f);
-    }
-
-    transform->SetPosition(position);
-}
-
-std::string SimplePhysicsComponent::GetDebugInfo() const {
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(2);
-    oss << "Velocity: (" << velocity.x << ", " << velocity.y << ", " << velocity.z << ")\n";
-    oss << "Mass: " << mass << "\n";
-    oss << "Gravity: " << (affectedByGravity ? "ON" : "OFF") << "\n";
-    oss << "Bounce Damping: " << bounceDamping;
-    return oss.str();
-}
-
 // PhysicsTestScene implementation
-PhysicsTestScene::PhysicsTestScene() {
+PhysicsTestScene::PhysicsTestScene(uint32_t randomSeed) : seed(randomSeed), gen(randomSeed) {
     scene = std::make_shared<Scene>("Physics Test Scene");
     Initialize();
 }
@@ -146,8 +92,8 @@ void PhysicsTestScene::Update(float deltaTime) {
     // Apply time scaling to physics
     float scaledDeltaTime = deltaTime * timeScale;
 
-    // Update the base scene
-    scene->Update(scaledDeltaTime);
+    // Update the base scene in fixed steps
+    scene->UpdateFixed(scaledDeltaTime);
 }
 
 void PhysicsTestScene::Reset() {
@@ -201,15 +147,13 @@ void PhysicsTestScene::Reset() {
             if (physics) physics->SetVelocity(glm::vec3(2.0f, 0.0f, 1.0f));
         }
     }
+
+    scene->StorePreviousTransforms();
 }
 
 void PhysicsTestScene::SpawnRandomCube() {
-    static int cubeCounter = 0;
     cubeCounter++;
 
-    // Random generator
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
     std::uniform_real_distribution<float> posDist(-3.0f, 3.0f);
     std::uniform_real_distribution<float> heightDist(3.0f, 8.0f);
     std::uniform_real_distribution<float> colorDist(0.2f, 1.0f);
@@ -232,7 +176,9 @@ void PhysicsTestScene::SpawnRandomCube() {
 
     fallingCubes.push_back(newCube);
 
-    std::cout << "Spawned random cube: " << newCube->GetName() << std::endl;
+    if (verbose) {
+        std::cout << "Spawned random cube: " << newCube->GetName() << std::endl;
+    }
 }
 
 void PhysicsTestScene::Destroy() {
@@ -245,5 +191,30 @@ void PhysicsTestScene::Destroy() {
     pendulum = nullptr;
 }
 
+bool PhysicsTestScene::SaveSnapshot(const std::string& path) const {
+    return SceneSerializer::Save(*scene, path);
+}
+
+bool PhysicsTestScene::LoadSnapshot(const std::string& path) {
+    Destroy();
+    scene->SetActive(true);
+    std::vector<std::shared_ptr<Entity>> loaded;
+    if (!SceneSerializer::Load(*scene, path, &loaded)) {
+        scene->Destroy();
+        scene->SetActive(true);
+        Initialize();
+        return false;
+    }
+
+    bouncingBall = scene->FindEntity("Bouncing Ball");
+    floatingCube = scene->FindEntity("Floating Cube");
+    for (const auto& entity : loaded) {
+        if (entity->GetName().find("Random Cube") == 0) {
+            fallingCubes.push_back(entity);
+        }
+    }
+    return true;
+}
+
 } // namespace Logic
 } // namespace Engine
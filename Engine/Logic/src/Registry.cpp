@@ -0,0 +1,74 @@
+#include "../include/Registry.h"
+#include <iostream>
+
+namespace Engine {
+namespace Logic {
+
+size_t Registry::NextTypeId() {
+    static std::atomic<size_t> nextId{0};
+    return nextId.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::shared_ptr<Registry> Registry::GetDefault() {
+    static std::shared_ptr<Registry> defaultRegistry = std::make_shared<Registry>();
+    return defaultRegistry;
+}
+
+EntityHandle Registry::Create(Entity* owner) {
+    uint32_t index;
+    if (!freeIndices.empty()) {
+        index = freeIndices.back();
+        freeIndices.pop_back();
+    } else {
+        // The last index stays unused so no live handle equals INVALID
+        if (generations.size() >= EntityHandle::INDEX_MASK) {
+            std::cerr << "Registry: entity limit (" << EntityHandle::INDEX_MASK << ") reached" << std::endl;
+            return EntityHandle();
+        }
+        index = static_cast<uint32_t>(generations.size());
+        generations.push_back(0);
+        owners.push_back(nullptr);
+    }
+
+    owners[index] = owner;
+    return EntityHandle(index, generations[index]);
+}
+
+void Registry::Reserve(size_t entityCount) {
+    generations.reserve(entityCount);
+    owners.reserve(entityCount);
+}
+
+void Registry::Destroy(EntityHandle handle) {
+    if (!IsAlive(handle)) return;
+
+    RemoveAll(handle);
+
+    // Bumping the generation invalidates every copy of the handle
+    const uint32_t index = handle.GetIndex();
+    generations[index] = (generations[index] + 1) & EntityHandle::GENERATION_MASK;
+    owners[index] = nullptr;
+    freeIndices.push_back(index);
+}
+
+void Registry::RemoveAll(EntityHandle handle) {
+    if (!IsAlive(handle)) return;
+
+    const uint32_t index = handle.GetIndex();
+    for (auto& pool : pools) {
+        if (pool) pool->Remove(index);
+    }
+}
+
+bool Registry::IsAlive(EntityHandle handle) const {
+    if (!handle.IsValid()) return false;
+    const uint32_t index = handle.GetIndex();
+    return index < generations.size() && generations[index] == handle.GetGeneration();
+}
+
+Entity* Registry::GetEntity(EntityHandle handle) const {
+    return IsAlive(handle) ? owners[handle.GetIndex()] : nullptr;
+}
+
+} // namespace Logic
+} // namespace Engine
@@ -9,11 +9,6 @@ RenderComponent::RenderComponent(PrimitiveType type, const glm::vec3& col, bool
     : primitiveType(type), color(col), visible(isVisible) {
 }
 
-void RenderComponent::Update(float deltaTime) {
-    // Render components typically don't need updates
-    // unless doing animations or material changes
-}
-
 std::string RenderComponent::GetDebugInfo() const {
     std::ostringstream oss;
     oss << std::fixed << std::setprecision(2);
@@ -1,4 +1,7 @@
 #include "../include/Scene.h"
+#include "../include/SimplePhysicsComponent.h"
+#include "../include/TransformComponent.h"
+#include "../../Common/include/Profiler.h"
 #include <iostream>
 #include <algorithm>
 
@@ -6,91 +9,303 @@ namespace Engine {
 namespace Logic {
 
 Scene::Scene(const std::string& sceneName)
-    : name(sceneName), active(true) {
+    : registry(std::make_shared<Registry>()), name(sceneName), active(true) {
+    AddComponentSystem<SimplePhysicsComponent, TransformComponent>("Physics",
+        [](float deltaTime, SimplePhysicsComponent& physics, TransformComponent& transform) {
+            physics.Integrate(transform, deltaTime);
+        });
+}
+
+Scene::~Scene() {
+    FlushRemovals();
+
+    // Entities can outlive the scene, they must not point back into it
+    for (auto& entity : entities) {
+        if (entity) {
+            entity->scene = nullptr;
+        }
+    }
+}
+
+void Scene::AddSystem(const std::string& systemName, std::function<void(float)> update) {
+    systems.push_back({systemName, std::move(update), true, Common::Profiler::Get().Intern(systemName)});
+}
+
+bool Scene::InsertSystem(const std::string& beforeName, const std::string& systemName,
+                         std::function<void(float)> update) {
+    auto it = std::find_if(systems.begin(), systems.end(),
+        [&beforeName](const SceneSystem& system) { return system.name == beforeName; });
+    if (it == systems.end()) return false;
+
+    systems.insert(it, {systemName, std::move(update), true, Common::Profiler::Get().Intern(systemName)});
+    return true;
+}
+
+bool Scene::RemoveSystem(const std::string& systemName) {
+    auto it = std::find_if(systems.begin(), systems.end(),
+        [&systemName](const SceneSystem& system) { return system.name == systemName; });
+    if (it == systems.end()) return false;
+
+    systems.erase(it);
+    return true;
+}
+
+bool Scene::SetSystemEnabled(const std::string& systemName, bool enabled) {
+    for (auto& system : systems) {
+        if (system.name == systemName) {
+            system.enabled = enabled;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Scene::HasSystem(const std::string& systemName) const {
+    return std::any_of(systems.begin(), systems.end(),
+        [&systemName](const SceneSystem& system) { return system.name == systemName; });
 }
 
 std::shared_ptr<Entity> Scene::CreateEntity(const std::string& entityName) {
-    auto entity = std::make_shared<Entity>(entityName);
-    entities.push_back(entity);
+    auto entity = std::make_shared<Entity>(registry, entityName);
+    Attach(entity);
     return entity;
 }
 
 std::shared_ptr<Entity> Scene::CreateEntity(int id, const std::string& entityName) {
-    auto entity = std::make_shared<Entity>(id, entityName);
-    entities.push_back(entity);
+    auto entity = std::make_shared<Entity>(registry, id, entityName);
+    Attach(entity);
     return entity;
 }
 
+void Scene::Reserve(size_t entityCount) {
+    const size_t total = entities.size() + entityCount;
+    entities.reserve(total);
+    entitySlots.reserve(registry->GetEntityCount() + entityCount);
+    idIndex.reserve(idIndex.size() + entityCount);
+    nameIndex.reserve(nameIndex.size() + entityCount);
+    registry->Reserve(registry->GetEntityCount() + entityCount);
+}
+
 void Scene::RemoveEntity(int entityId) {
-    auto it = std::find_if(entities.begin(), entities.end(),
-    [entityId](const std::shared_ptr<Entity>& entity) {
-    return entity && entity->GetID() == entityId;
-    });
+    const uint32_t slot = FindSlot(entityId);
+    if (slot != ComponentPoolBase::NONE) {
+        RemoveAt(slot);
+    }
+}
+
+void Scene::RemoveEntity(std::shared_ptr<Entity> entity) {
+    if (!entity) return;
+
+    const uint32_t slot = FindSlot(entity.get());
+    if (slot == ComponentPoolBase::NONE) {
+        RemoveEntity(entity->GetID());
+        return;
+    }
+    RemoveAt(slot);
+}
+
+void Scene::RemoveAt(uint32_t slot) {
+    std::shared_ptr<Entity> entity = entities[slot];
+    DetachAt(slot);
+    if (entity) {
+        entity->SetActive(false); // Systems skip it until the flush
+        pendingDestroy.push_back(std::move(entity));
+    }
+}
+
+void Scene::FlushRemovals() {
+    for (auto& entity : pendingDestroy) {
+        // Added back since (AddEntity), the removal no longer applies
+        if (entity->scene) continue;
+        entity->Destroy();
+    }
+    pendingDestroy.clear();
+}
 
-    if (it != entities.end()) {
-        // Store the entity to destroy it after removal
-        auto entityToDestroy = *it;
+bool Scene::DetachEntity(const std::shared_ptr<Entity>& entity) {
+    const uint32_t slot = FindSlot(entity.get());
+    if (slot == ComponentPoolBase::NONE) return false;
 
-        // Remove from vector first
-        entities.erase(it);
+    DetachAt(slot);
+    return true;
+}
+
+bool Scene::AddEntity(std::shared_ptr<Entity> entity) {
+    if (!entity || &entity->GetRegistry() != registry.get()) return false;
+    if (FindSlot(entity.get()) != ComponentPoolBase::NONE) return false;
+
+    Attach(std::move(entity));
+    return true;
+}
+
+void Scene::Attach(std::shared_ptr<Entity> entity) {
+    const uint32_t index = entity->GetHandle().GetIndex();
+    if (index >= entitySlots.size()) {
+        entitySlots.resize(index + 1, ComponentPoolBase::NONE);
+    }
+    entitySlots[index] = static_cast<uint32_t>(entities.size());
+    idIndex.emplace(entity->GetID(), index); // Keeps an earlier entity with the same ID
+    IndexName(entity->GetName(), index);
+    entity->scene = this;
 
-        // Then destroy the entity
-        if (entityToDestroy) {
-            entityToDestroy->Destroy();
+    // Edited while detached (pooled particles): catch up in the next rebuild
+    TransformComponent* transform = registry->Get<TransformComponent>(entity->GetHandle());
+    if (transform && transform->IsDirty()) {
+        transformSystem.Queue(*transform);
+    }
+    entities.push_back(std::move(entity));
+}
+
+void Scene::DetachAt(uint32_t slot) {
+    const uint32_t last = static_cast<uint32_t>(entities.size() - 1);
+    if (Entity* entity = entities[slot].get()) {
+        const uint32_t index = entity->GetHandle().GetIndex();
+        entitySlots[index] = ComponentPoolBase::NONE;
+        auto id = idIndex.find(entity->GetID());
+        if (id != idIndex.end() && id->second == index) {
+            idIndex.erase(id);
+        }
+        UnindexName(entity->GetName(), index);
+        entity->scene = nullptr;
+    }
+
+    // Swap-and-pop
+    if (slot != last) {
+        entities[slot] = std::move(entities[last]);
+        if (entities[slot]) {
+            entitySlots[entities[slot]->GetHandle().GetIndex()] = slot;
         }
     }
+    entities.pop_back();
 }
 
-void Scene::RemoveEntity(std::shared_ptr<Entity> entity) {
-    if (!entity) return;
-    RemoveEntity(entity->GetID());
+uint32_t Scene::FindSlot(const Entity* entity) const {
+    if (!entity || &entity->GetRegistry() != registry.get()) return ComponentPoolBase::NONE;
+
+    const uint32_t index = entity->GetHandle().GetIndex();
+    if (index >= entitySlots.size()) return ComponentPoolBase::NONE;
+
+    const uint32_t slot = entitySlots[index];
+    return (slot < entities.size() && entities[slot].get() == entity) ? slot : ComponentPoolBase::NONE;
 }
 
-std::shared_ptr<Entity> Scene::FindEntity(int entityId) {
-    auto it = std::find_if(entities.begin(), entities.end(),
-        [entityId](const std::shared_ptr<Entity>& entity) {
-            return entity->GetID() == entityId;
-        });
+uint32_t Scene::FindSlot(int entityId) const {
+    auto it = idIndex.find(entityId);
+    return it != idIndex.end() ? entitySlots[it->second] : ComponentPoolBase::NONE;
+}
 
-    return (it != entities.end()) ? *it : nullptr;
+void Scene::IndexName(const std::string& entityName, uint32_t index) {
+    if (!entityName.empty()) {
+        nameIndex.emplace(entityName, index);
+    }
 }
 
-std::shared_ptr<Entity> Scene::FindEntity(const std::string& entityName) {
-    auto it = std::find_if(entities.begin(), entities.end(),
-        [&entityName](const std::shared_ptr<Entity>& entity) {
-            return entity->GetName() == entityName;
-        });
+void Scene::UnindexName(const std::string& entityName, uint32_t index) {
+    if (entityName.empty()) return;
+
+    auto range = nameIndex.equal_range(entityName);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == index) {
+            nameIndex.erase(it);
+            return;
+        }
+    }
+}
+
+void Scene::OnEntityRenamed(Entity& entity, const std::string& oldName) {
+    const uint32_t index = entity.GetHandle().GetIndex();
+    UnindexName(oldName, index);
+    IndexName(entity.GetName(), index);
+}
 
-    return (it != entities.end()) ? *it : nullptr;
+std::shared_ptr<Entity> Scene::FindEntity(int entityId) {
+    const uint32_t slot = FindSlot(entityId);
+    return slot != ComponentPoolBase::NONE ? entities[slot] : nullptr;
+}
+
+std::shared_ptr<Entity> Scene::FindEntity(const std::string& entityName) {
+    auto it = nameIndex.find(entityName);
+    return it != nameIndex.end() ? entities[entitySlots[it->second]] : nullptr;
 }
 
 void Scene::Update(float deltaTime) {
     if (!active) return;
+    PROFILE_SCOPE("Scene::Update");
 
-    // Update all active entities
-    for (auto& entity : entities) {
-        if (entity && entity->IsActive()) {
-            entity->Update(deltaTime);
+    Step(deltaTime);
+    transformSystem.Update();
+}
+
+void Scene::Step(float deltaTime) {
+    PROFILE_SCOPE("Scene::Step");
+
+    // Batched per-component work
+    for (auto& system : systems) {
+        if (system.enabled) {
+            PROFILE_SCOPE(system.zoneName);
+            system.update(deltaTime);
+        }
+    }
+
+    // Entities with components that still update themselves
+    {
+        PROFILE_SCOPE("Entity updates");
+        // By index, an update may remove entities (one swapped into a freed
+        // slot waits until the next frame)
+        for (size_t i = 0; i < entities.size(); ++i) {
+            Entity* entity = entities[i].get();
+            if (entity && entity->IsActive() && entity->NeedsUpdate()) {
+                entity->Update(deltaTime);
+            }
         }
     }
 
-    // Remove destroyed entities
-    entities.erase(
-        std::remove_if(entities.begin(), entities.end(),
-            [](const std::shared_ptr<Entity>& entity) {
-                return !entity || !entity->IsActive();
-            }),
-        entities.end()
-    );
+    // Drop deactivated entities (back to front, removal swaps) and destroy
+    // the removed ones
+    PROFILE_SCOPE("Entity cleanup");
+    for (size_t i = entities.size(); i-- > 0;) {
+        if (!entities[i] || !entities[i]->IsActive()) {
+            DetachAt(static_cast<uint32_t>(i));
+        }
+    }
+    FlushRemovals();
+}
+
+int Scene::UpdateFixed(float deltaTime) {
+    if (!active) return 0;
+    PROFILE_SCOPE("Scene::UpdateFixed");
+
+    const int steps = timestep.Advance(deltaTime);
+    for (int step = 0; step < steps; ++step) {
+        StorePreviousTransforms();
+        for (int substep = 0; substep < timestep.GetSubsteps(); ++substep) {
+            Step(timestep.GetSubstepSize());
+        }
+    }
+
+    // Substeps only read positions, the matrices are needed once for rendering
+    transformSystem.Update();
+    return steps;
+}
+
+void Scene::StorePreviousTransforms() {
+    GetView<TransformComponent>().Each([](EntityHandle, TransformComponent& transform) {
+        transform.StorePreviousState();
+    });
 }
 
 void Scene::Destroy() {
     for (auto& entity : entities) {
         if (entity) {
+            entity->scene = nullptr;
             entity->Destroy();
         }
     }
     entities.clear();
+    entitySlots.clear();
+    idIndex.clear();
+    nameIndex.clear();
+    FlushRemovals();
     active = false;
 }
 
@@ -98,16 +313,19 @@ void Scene::PrintEntityList() const {
     std::cout << GetDebugInfo() << std::endl;
 }
 
-std::string Scene::GetDebugInfo() const {
-    std::string info = "Scene: " + name + "\n";
-    info += "Active: " + std::string(active ? "true" : "false") + "\n";
-    info += "Entities (" + std::to_string(entities.size()) + "):\n";
+Common::FrameString Scene::GetDebugInfo() const {
+    // One line per entity every frame the panel is open, appended in place
+    // on the frame arena instead of concatenating temporaries
+    Common::FrameString info = "Scene: ";
+    info.append(name).append("\n");
+    info.append("Active: ").append(active ? "true" : "false").append("\n");
+    info.append("Entities (").append(std::to_string(entities.size())).append("):\n");
 
     for (const auto& entity : entities) {
         if (entity) {
-            info += "  - " + entity->GetName() + " (ID: " +
-                   std::to_string(entity->GetID()) + ", Components: " +
-                   std::to_string(entity->GetComponentCount()) + ")\n";
+            info.append("  - ").append(entity->GetName());
+            info.append(" (ID: ").append(std::to_string(entity->GetID()));
+            info.append(", Components: ").append(std::to_string(entity->GetComponentCount())).append(")\n");
         }
     }
 
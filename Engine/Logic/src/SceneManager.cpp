@@ -1,10 +1,17 @@
 #include "../include/SceneManager.h"
+#include "../../Common/include/Profiler.h"
 #include <iostream>
 #include <algorithm>
+#include <chrono>
+#include <exception>
 
 namespace Engine {
 namespace Logic {
 
+SceneManager::~SceneManager() {
+    StopLoader();
+}
+
 void SceneManager::RegisterScene(const std::string& name, std::shared_ptr<Scene> scene) {
     if (!scene) {
         std::cerr << "Warning: Attempting to register null scene: " << name << std::endl;
@@ -23,6 +30,11 @@ bool SceneManager::LoadScene(const std::string& name) {
         return false;
     }
 
+    // A scene still loading no longer takes over when it's done
+    if (IsLoading() && loadingSceneName != name) {
+        activateWhenLoaded = false;
+    }
+
     // Mark for transition (don't switch immediately to avoid mid-frame issues)
     nextScene = it->second;
     sceneTransitionPending = true;
@@ -30,7 +42,179 @@ bool SceneManager::LoadScene(const std::string& name) {
     return true;
 }
 
+void SceneManager::RegisterSceneBuilder(const std::string& name, SceneBuilder builder) {
+    builders[name] = std::move(builder);
+}
+
+bool SceneManager::LoadSceneAsync(const std::string& name) {
+    if (scenes.find(name) != scenes.end()) {
+        return LoadScene(name);
+    }
+
+    if (IsLoading()) {
+        if (loadingSceneName == name) {
+            activateWhenLoaded = true;
+            return true;
+        }
+        std::cerr << "Error: Cannot load " << name << " while " << loadingSceneName
+                  << " is still loading" << std::endl;
+        return false;
+    }
+
+    auto it = builders.find(name);
+    if (it == builders.end()) {
+        std::cerr << "Error: Scene not found: " << name << std::endl;
+        return false;
+    }
+
+    if (!loaderThread.joinable()) {
+        loaderThread = std::thread(&SceneManager::LoaderLoop, this);
+    }
+
+    loadingSceneName = name;
+    loadContext = std::make_shared<SceneLoadContext>();
+    staging = false;
+    stagedSteps = 0;
+    activateWhenLoaded = true;
+    {
+        std::lock_guard<std::mutex> lock(loaderMutex);
+        queuedBuild = it->second;
+        queuedContext = loadContext;
+        buildFinished = false;
+    }
+    loaderWake.notify_all();
+
+    std::cout << "Building scene in the background: " << name << std::endl;
+    return true;
+}
+
+void SceneManager::LoaderLoop() {
+    PROFILE_THREAD("Scene Loader");
+    std::unique_lock<std::mutex> lock(loaderMutex);
+    for (;;) {
+        loaderWake.wait(lock, [this] { return loaderStopping || queuedBuild; });
+        if (loaderStopping) return;
+
+        SceneBuilder build = std::move(queuedBuild);
+        queuedBuild = nullptr;
+        std::shared_ptr<SceneLoadContext> context = std::move(queuedContext);
+        lock.unlock();
+
+        std::shared_ptr<Scene> scene;
+        {
+            PROFILE_SCOPE("SceneManager::Build");
+            try {
+                scene = build(*context);
+            } catch (const std::exception& e) {
+                std::cerr << "Error: Scene builder failed: " << e.what() << std::endl;
+                scene = nullptr;
+            }
+
+            // World matrices here, not in the new scene's first frame
+            if (scene && !context->IsCancelled()) {
+                scene->GetTransformSystem().Update();
+            }
+        }
+        context->SetProgress(1.0f);
+
+        lock.lock();
+        builtScene = std::move(scene);
+        buildFinished = true;
+        loaderWake.notify_all();
+    }
+}
+
+void SceneManager::UpdateAsyncLoad() {
+    if (!IsLoading()) return;
+
+    if (!staging) {
+        std::lock_guard<std::mutex> lock(loaderMutex);
+        if (!buildFinished) return;
+        staging = true;
+    }
+
+    // The loader leaves builtScene and the steps alone until the next build
+    if (!builtScene) {
+        std::cerr << "Error: Failed to build scene: " << loadingSceneName << std::endl;
+        loadingSceneName.clear();
+        loadContext = nullptr;
+        staging = false;
+        return;
+    }
+
+    // Staged main thread work, as much as fits in this frame's budget
+    PROFILE_SCOPE("SceneManager::Stage");
+    const auto& steps = loadContext->mainThreadSteps;
+    const auto start = std::chrono::steady_clock::now();
+    while (stagedSteps < steps.size()) {
+        steps[stagedSteps++]();
+        const float elapsedMs =
+            std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (elapsedMs >= stagingBudgetMs) break;
+    }
+    if (stagedSteps < steps.size()) return;
+
+    const std::string name = loadingSceneName;
+    std::shared_ptr<Scene> scene = std::move(builtScene);
+    loadingSceneName.clear();
+    loadContext = nullptr;
+    staging = false;
+
+    RegisterScene(name, scene);
+    if (activateWhenLoaded) {
+        LoadScene(name);
+    }
+}
+
+float SceneManager::GetLoadProgress() const {
+    if (!IsLoading()) return 0.0f;
+    if (!staging) {
+        return 0.9f * std::clamp(loadContext->GetProgress(), 0.0f, 1.0f);
+    }
+
+    const size_t total = loadContext->mainThreadSteps.size();
+    return total > 0 ? 0.9f + 0.1f * static_cast<float>(stagedSteps) / static_cast<float>(total) : 1.0f;
+}
+
+void SceneManager::CancelLoad() {
+    if (!IsLoading()) return;
+
+    loadContext->cancelled.store(true, std::memory_order_relaxed);
+    std::shared_ptr<Scene> dropped;
+    {
+        std::unique_lock<std::mutex> lock(loaderMutex);
+        if (queuedBuild) {
+            // Never started
+            queuedBuild = nullptr;
+            queuedContext = nullptr;
+        } else {
+            loaderWake.wait(lock, [this] { return buildFinished; });
+        }
+        dropped = std::move(builtScene);
+        buildFinished = false;
+    }
+
+    std::cout << "Cancelled loading scene: " << loadingSceneName << std::endl;
+    loadingSceneName.clear();
+    loadContext = nullptr;
+    staging = false;
+    stagedSteps = 0;
+}
+
+void SceneManager::StopLoader() {
+    CancelLoad();
+    if (!loaderThread.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(loaderMutex);
+        loaderStopping = true;
+    }
+    loaderWake.notify_all();
+    loaderThread.join();
+}
+
 void SceneManager::ProcessSceneTransition() {
+    UpdateAsyncLoad();
     if (!sceneTransitionPending) return;
 
     // Unload current scene
@@ -93,21 +277,25 @@ void SceneManager::Update(float deltaTime) {
     }
 }
 
-std::string SceneManager::GetDebugInfo() const {
-    std::string info = "=== Scene Manager ===\n";
-    info += "Current Scene: " + (currentScene ? currentSceneName : "None") + "\n";
-    info += "Available Scenes (" + std::to_string(scenes.size()) + "):\n";
+Common::FrameString SceneManager::GetDebugInfo() const {
+    Common::FrameString info = "=== Scene Manager ===\n";
+    info.append("Current Scene: ").append(currentScene ? currentSceneName.c_str() : "None").append("\n");
+    info.append("Available Scenes (").append(std::to_string(scenes.size())).append("):\n");
 
     for (const auto& pair : scenes) {
-        info += "  - " + pair.first;
+        info.append("  - ").append(pair.first);
         if (pair.second == currentScene) {
-            info += " (ACTIVE)";
+            info.append(" (ACTIVE)");
         }
-        info += "\n";
+        info.append("\n");
     }
 
     if (sceneTransitionPending) {
-        info += "Pending transition to new scene...\n";
+        info.append("Pending transition to new scene...\n");
+    }
+    if (IsLoading()) {
+        info.append("Loading ").append(loadingSceneName.c_str()).append(": ")
+            .append(std::to_string(static_cast<int>(GetLoadProgress() * 100.0f))).append("%\n");
     }
 
     return info;
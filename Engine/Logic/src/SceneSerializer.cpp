@@ -0,0 +1,475 @@
+#include "../include/SceneSerializer.h"
+#include "../include/TransformComponent.h"
+#include "../include/RenderComponent.h"
+#include "../include/SimplePhysicsComponent.h"
+#include "../include/CollisionComponent.h"
+#include "../../Common/include/MappedFile.h"
+#include "../../Common/include/Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+namespace Engine {
+namespace Logic {
+
+namespace {
+
+    uint64_t AlignUp(uint64_t bytes) {
+        return (bytes + 7) & ~uint64_t(7);
+    }
+
+    // Records are copied out, the mapping gives no alignment guarantee for
+    // strides a later version may pick. Fields appended after the file was
+    // written are left zero.
+    template<typename T>
+    T ReadRecord(const unsigned char* table, uint32_t stride, uint32_t index) {
+        T record{};
+        std::memcpy(&record, table + static_cast<size_t>(index) * stride, std::min<size_t>(stride, sizeof(T)));
+        return record;
+    }
+
+    // Deduplicated strings for Save. Index NONE stands for the empty string.
+    class StringTableWriter {
+    private:
+        std::unordered_map<std::string, uint32_t> indices;
+        std::vector<uint32_t> offsets{0};
+        std::string chars;
+
+    public:
+        uint32_t Intern(const std::string& text, uint32_t none) {
+            if (text.empty()) return none;
+
+            auto inserted = indices.emplace(text, static_cast<uint32_t>(offsets.size() - 1));
+            if (inserted.second) {
+                chars += text;
+                offsets.push_back(static_cast<uint32_t>(chars.size()));
+            }
+            return inserted.first->second;
+        }
+
+        uint32_t GetCount() const { return static_cast<uint32_t>(offsets.size() - 1); }
+
+        // count + 1 offsets into the characters, then the characters
+        std::vector<unsigned char> Build() const {
+            std::vector<unsigned char> bytes(offsets.size() * sizeof(uint32_t) + chars.size());
+            std::memcpy(bytes.data(), offsets.data(), offsets.size() * sizeof(uint32_t));
+            std::memcpy(bytes.data() + offsets.size() * sizeof(uint32_t), chars.data(), chars.size());
+            return bytes;
+        }
+    };
+
+    // String table of a mapped file, checked by Open
+    class StringTableReader {
+    private:
+        const unsigned char* offsets = nullptr;
+        const char* chars = nullptr;
+        uint32_t count = 0;
+
+        uint32_t Offset(uint32_t index) const {
+            uint32_t offset;
+            std::memcpy(&offset, offsets + static_cast<size_t>(index) * sizeof(uint32_t), sizeof(offset));
+            return offset;
+        }
+
+    public:
+        bool Open(const unsigned char* table, uint32_t stringCount, uint64_t bytes) {
+            const uint64_t offsetBytes = (static_cast<uint64_t>(stringCount) + 1) * sizeof(uint32_t);
+            if (bytes < offsetBytes) return false;
+
+            offsets = table;
+            chars = reinterpret_cast<const char*>(table + offsetBytes);
+            count = stringCount;
+
+            // Offsets must rise and stay inside the characters
+            uint32_t previous = 0;
+            for (uint32_t i = 0; i <= count; ++i) {
+                const uint32_t offset = Offset(i);
+                if (offset < previous || offset > bytes - offsetBytes) return false;
+                previous = offset;
+            }
+            return true;
+        }
+
+        bool IsValid(uint32_t index, uint32_t none) const { return index == none || index < count; }
+
+        std::string Get(uint32_t index, uint32_t none) const {
+            if (index == none) return std::string();
+            const uint32_t start = Offset(index);
+            return std::string(chars + start, Offset(index + 1) - start);
+        }
+    };
+
+} // namespace
+
+bool SceneSerializer::Save(const Scene& scene, const std::string& path) {
+    PROFILE_SCOPE("SceneSerializer::Save");
+    const Registry& registry = scene.GetRegistry();
+    const auto& entities = scene.GetEntities();
+
+    StringTableWriter strings;
+    std::vector<EntityRecord> entityRecords;
+    std::vector<TransformRecord> transformRecords;
+    std::vector<RenderRecord> renderRecords;
+    std::vector<PhysicsRecord> physicsRecords;
+    std::vector<ColliderRecord> colliderRecords;
+    entityRecords.reserve(entities.size());
+
+    // Rows first, parents may come later in the list than their children
+    std::vector<uint32_t> rows; // Registry index -> row
+    for (const auto& entity : entities) {
+        if (!entity) continue;
+
+        const uint32_t index = entity->GetHandle().GetIndex();
+        if (index >= rows.size()) {
+            rows.resize(index + 1, NONE);
+        }
+        rows[index] = static_cast<uint32_t>(entityRecords.size());
+        entityRecords.push_back({entity->GetID(), strings.Intern(entity->GetName(), NONE),
+                                 entity->IsActive() ? FLAG_ACTIVE : 0u});
+    }
+
+    uint32_t row = 0;
+    for (const auto& entity : entities) {
+        if (!entity) continue;
+        const EntityHandle handle = entity->GetHandle();
+
+        if (const TransformComponent* transform = registry.Get<TransformComponent>(handle)) {
+            uint32_t parentRow = NONE;
+            if (const TransformComponent* parent = transform->GetParent()) {
+                const Entity* parentEntity = parent->GetOwner();
+                if (parentEntity && parentEntity->GetScene() == &scene) {
+                    parentRow = rows[parentEntity->GetHandle().GetIndex()];
+                }
+            }
+
+            const glm::dvec3& position = transform->GetPrecisePosition();
+            const glm::quat& orientation = transform->GetOrientation();
+            const glm::vec3& rotation = transform->GetRotation();
+            const glm::vec3& scale = transform->GetScale();
+            transformRecords.push_back({row, parentRow, transform->IsEnabled() ? FLAG_ENABLED : 0u,
+                                        {static_cast<float>(position.x), static_cast<float>(position.y),
+                                         static_cast<float>(position.z)},
+                                        {orientation.w, orientation.x, orientation.y, orientation.z},
+                                        {rotation.x, rotation.y, rotation.z},
+                                        {scale.x, scale.y, scale.z},
+                                        {position.x, position.y, position.z}});
+        }
+
+        if (const RenderComponent* render = registry.Get<RenderComponent>(handle)) {
+            const glm::vec3& color = render->GetColor();
+            renderRecords.push_back({row, static_cast<uint32_t>(render->GetPrimitiveType()),
+                                     strings.Intern(render->GetMeshPath(), NONE),
+                                     (render->IsEnabled() ? FLAG_ENABLED : 0u) |
+                                         (render->IsVisible() ? FLAG_VISIBLE : 0u),
+                                     {color.x, color.y, color.z}});
+        }
+
+        if (const SimplePhysicsComponent* physics = registry.Get<SimplePhysicsComponent>(handle)) {
+            const glm::vec3& velocity = physics->GetVelocity();
+            const glm::vec3& acceleration = physics->GetAcceleration();
+            physicsRecords.push_back({row,
+                                      (physics->IsEnabled() ? FLAG_ENABLED : 0u) |
+                                          (physics->IsAffectedByGravity() ? FLAG_GRAVITY : 0u) |
+                                          (physics->HasWorldBounds() ? FLAG_BOUNDS : 0u) |
+                                          (physics->IsSleeping() ? FLAG_SLEEPING : 0u),
+                                      {velocity.x, velocity.y, velocity.z},
+                                      {acceleration.x, acceleration.y, acceleration.z},
+                                      physics->GetMass(), physics->GetBounceDamping(), physics->GetSleepTime()});
+        }
+
+        if (const CollisionComponent* collider = registry.Get<CollisionComponent>(handle)) {
+            const CircleCollider& circle = collider->GetCircle();
+            const AABBCollider& aabb = collider->GetAABB();
+            const LineCollider& line = collider->GetLine();
+            colliderRecords.push_back({row, static_cast<uint32_t>(collider->GetShape()),
+                                       strings.Intern(collider->GetLayer(), NONE),
+                                       (collider->IsEnabled() ? FLAG_ENABLED : 0u) |
+                                           (collider->IsTrigger() ? FLAG_TRIGGER : 0u) |
+                                           (collider->IsStatic() ? FLAG_STATIC : 0u),
+                                       {circle.radius, circle.offset.x, circle.offset.y},
+                                       {aabb.size.x, aabb.size.y, aabb.offset.x, aabb.offset.y},
+                                       {line.start.x, line.start.y, line.end.x, line.end.y, line.thickness}});
+        }
+        ++row;
+    }
+    const std::vector<unsigned char> stringBytes = strings.Build();
+
+    // Directory, then the tables in the same order
+    struct Chunk {
+        const void* data;
+        uint64_t bytes;
+    };
+    std::vector<TableInfo> tables;
+    std::vector<Chunk> chunks;
+    uint64_t offset = AlignUp(sizeof(FileHeader) + TABLE_TYPE_COUNT * sizeof(TableInfo));
+    auto addTable = [&](TableType type, size_t count, uint32_t stride, const void* data, uint64_t bytes) {
+        tables.push_back({type, static_cast<uint32_t>(count), stride, 0, offset, bytes});
+        chunks.push_back({data, bytes});
+        offset = AlignUp(offset + bytes);
+    };
+    addTable(TABLE_ENTITIES, entityRecords.size(), sizeof(EntityRecord), entityRecords.data(),
+             entityRecords.size() * sizeof(EntityRecord));
+    addTable(TABLE_TRANSFORMS, transformRecords.size(), sizeof(TransformRecord), transformRecords.data(),
+             transformRecords.size() * sizeof(TransformRecord));
+    addTable(TABLE_RENDERS, renderRecords.size(), sizeof(RenderRecord), renderRecords.data(),
+             renderRecords.size() * sizeof(RenderRecord));
+    addTable(TABLE_PHYSICS, physicsRecords.size(), sizeof(PhysicsRecord), physicsRecords.data(),
+             physicsRecords.size() * sizeof(PhysicsRecord));
+    addTable(TABLE_COLLIDERS, colliderRecords.size(), sizeof(ColliderRecord), colliderRecords.data(),
+             colliderRecords.size() * sizeof(ColliderRecord));
+    addTable(TABLE_STRINGS, strings.GetCount(), 0, stringBytes.data(), stringBytes.size());
+
+    FileHeader header{};
+    std::memcpy(header.magic, "BESC", 4);
+    header.formatVersion = FORMAT_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.tableCount = static_cast<uint32_t>(tables.size());
+    header.stepSize = scene.GetTimestep().GetStepSize();
+    header.substeps = scene.GetTimestep().GetSubsteps();
+    header.maxStepsPerFrame = scene.GetTimestep().GetMaxStepsPerFrame();
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "SceneSerializer: Cannot open " << path << " for writing" << std::endl;
+        return false;
+    }
+
+    const unsigned char padding[8] = {};
+    uint64_t written = sizeof(FileHeader) + tables.size() * sizeof(TableInfo);
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(tables.data(), sizeof(TableInfo), tables.size(), file) == tables.size();
+    for (size_t i = 0; ok && i < chunks.size(); ++i) {
+        const size_t gap = static_cast<size_t>(tables[i].offset - written);
+        ok = (gap == 0 || std::fwrite(padding, 1, gap, file) == gap) &&
+             (chunks[i].bytes == 0 ||
+              std::fwrite(chunks[i].data, 1, static_cast<size_t>(chunks[i].bytes), file) == chunks[i].bytes);
+        written = tables[i].offset + chunks[i].bytes;
+    }
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::cerr << "SceneSerializer: Write to " << path << " failed" << std::endl;
+    }
+    return ok;
+}
+
+bool SceneSerializer::Load(Scene& scene, const std::string& path, std::vector<std::shared_ptr<Entity>>* created) {
+    PROFILE_SCOPE("SceneSerializer::Load");
+    auto fail = [&path](const char* reason) {
+        std::cerr << "SceneSerializer: " << path << ": " << reason << std::endl;
+        return false;
+    };
+
+    Common::MappedFile file;
+    if (!file.Open(path)) {
+        std::cerr << "SceneSerializer: Cannot open " << path << std::endl;
+        return false;
+    }
+    const unsigned char* data = file.GetData();
+    const size_t size = file.GetSize();
+
+    FileHeader header;
+    if (size < sizeof(header)) return fail("file too short");
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, "BESC", 4) != 0) return fail("not a scene file");
+    if (header.byteOrder != BYTE_ORDER_MARK) return fail("written with another byte order");
+    if (header.formatVersion != FORMAT_VERSION) {
+        std::cerr << "SceneSerializer: " << path << ": format version " << header.formatVersion
+                  << ", expected " << FORMAT_VERSION << std::endl;
+        return false;
+    }
+    if (header.tableCount > (size - sizeof(header)) / sizeof(TableInfo)) return fail("table directory cut short");
+    if (!(header.stepSize > 0.0f) || !std::isfinite(header.stepSize) || header.substeps < 1 ||
+        header.maxStepsPerFrame < 1) {
+        return fail("invalid timestep settings");
+    }
+
+    // Directory: every known table at most once, inside the file, with
+    // records at least as large as the first version's
+    static const uint32_t minStrides[TABLE_TYPE_COUNT] = {
+        sizeof(EntityRecord), offsetof(TransformRecord, precisePosition), sizeof(RenderRecord),
+        sizeof(PhysicsRecord), sizeof(ColliderRecord), 0
+    };
+    TableInfo tables[TABLE_TYPE_COUNT] = {};
+    bool present[TABLE_TYPE_COUNT] = {};
+    for (uint32_t i = 0; i < header.tableCount; ++i) {
+        TableInfo table;
+        std::memcpy(&table, data + sizeof(header) + i * sizeof(TableInfo), sizeof(table));
+        if (table.type >= TABLE_TYPE_COUNT) continue; // From a later version
+
+        if (present[table.type]) return fail("duplicate table");
+        if (table.offset > size || table.bytes > size - table.offset) return fail("table past the end of the file");
+        if (table.type != TABLE_STRINGS &&
+            (table.stride < minStrides[table.type] ||
+             static_cast<uint64_t>(table.count) * table.stride > table.bytes)) {
+            return fail("invalid table size");
+        }
+        tables[table.type] = table;
+        present[table.type] = true;
+    }
+    auto tableData = [&](TableType type) { return data + tables[type].offset; };
+
+    StringTableReader strings;
+    if (present[TABLE_STRINGS] &&
+        !strings.Open(tableData(TABLE_STRINGS), tables[TABLE_STRINGS].count, tables[TABLE_STRINGS].bytes)) {
+        return fail("invalid string table");
+    }
+
+    // Check every reference before creating anything
+    const TableInfo& entityTable = tables[TABLE_ENTITIES];
+    const uint32_t entityCount = entityTable.count;
+    for (uint32_t i = 0; i < entityCount; ++i) {
+        const auto record = ReadRecord<EntityRecord>(tableData(TABLE_ENTITIES), entityTable.stride, i);
+        if (!strings.IsValid(record.name, NONE)) return fail("invalid entity name");
+    }
+
+    // Components per entity, so each entity's list is allocated once
+    std::vector<uint32_t> componentCounts(entityCount, 0);
+
+    const TableInfo& transformTable = tables[TABLE_TRANSFORMS];
+    std::vector<unsigned char> hasTransform(entityCount, 0);
+    for (uint32_t i = 0; i < transformTable.count; ++i) {
+        const auto record = ReadRecord<TransformRecord>(tableData(TABLE_TRANSFORMS), transformTable.stride, i);
+        if (record.entity >= entityCount || hasTransform[record.entity]) return fail("invalid transform entity");
+        hasTransform[record.entity] = 1;
+        componentCounts[record.entity]++;
+    }
+    for (uint32_t i = 0; i < transformTable.count; ++i) {
+        const auto record = ReadRecord<TransformRecord>(tableData(TABLE_TRANSFORMS), transformTable.stride, i);
+        if (record.parent != NONE && (record.parent >= entityCount || !hasTransform[record.parent])) {
+            return fail("invalid transform parent");
+        }
+    }
+
+    const TableInfo& renderTable = tables[TABLE_RENDERS];
+    for (uint32_t i = 0; i < renderTable.count; ++i) {
+        const auto record = ReadRecord<RenderRecord>(tableData(TABLE_RENDERS), renderTable.stride, i);
+        if (record.entity >= entityCount || record.primitive > static_cast<uint32_t>(PrimitiveType::CUSTOM_MESH) ||
+            !strings.IsValid(record.meshPath, NONE)) {
+            return fail("invalid render record");
+        }
+        componentCounts[record.entity]++;
+    }
+
+    const TableInfo& physicsTable = tables[TABLE_PHYSICS];
+    for (uint32_t i = 0; i < physicsTable.count; ++i) {
+        const auto record = ReadRecord<PhysicsRecord>(tableData(TABLE_PHYSICS), physicsTable.stride, i);
+        if (record.entity >= entityCount) return fail("invalid physics record");
+        componentCounts[record.entity]++;
+    }
+
+    const TableInfo& colliderTable = tables[TABLE_COLLIDERS];
+    for (uint32_t i = 0; i < colliderTable.count; ++i) {
+        const auto record = ReadRecord<ColliderRecord>(tableData(TABLE_COLLIDERS), colliderTable.stride, i);
+        if (record.entity >= entityCount || record.shape > static_cast<uint32_t>(CollisionShape::POINT) ||
+            !strings.IsValid(record.layer, NONE)) {
+            return fail("invalid collider record");
+        }
+        componentCounts[record.entity]++;
+    }
+
+    // Build: room for everything up front, then one pass per table
+    Registry& registry = scene.GetRegistry();
+    scene.Reserve(entityCount);
+    registry.GetPool<TransformComponent>().Reserve(registry.GetPool<TransformComponent>().Size() + transformTable.count);
+    registry.GetPool<RenderComponent>().Reserve(registry.GetPool<RenderComponent>().Size() + renderTable.count);
+    registry.GetPool<SimplePhysicsComponent>().Reserve(registry.GetPool<SimplePhysicsComponent>().Size() + physicsTable.count);
+    registry.GetPool<CollisionComponent>().Reserve(registry.GetPool<CollisionComponent>().Size() + colliderTable.count);
+
+    std::vector<std::shared_ptr<Entity>> rows;
+    rows.reserve(entityCount);
+    for (uint32_t i = 0; i < entityCount; ++i) {
+        const auto record = ReadRecord<EntityRecord>(tableData(TABLE_ENTITIES), entityTable.stride, i);
+        auto entity = scene.CreateEntity(record.id, strings.Get(record.name, NONE));
+        if (record.name == NONE) {
+            entity->SetName(""); // CreateEntity names unnamed entities after their ID
+        }
+        entity->SetActive((record.flags & FLAG_ACTIVE) != 0);
+        entity->ReserveComponents(componentCounts[i]);
+        rows.push_back(std::move(entity));
+    }
+
+    std::vector<TransformComponent*> transforms(entityCount, nullptr);
+    for (uint32_t i = 0; i < transformTable.count; ++i) {
+        const auto record = ReadRecord<TransformRecord>(tableData(TABLE_TRANSFORMS), transformTable.stride, i);
+        auto transform = rows[record.entity]->AddComponent<TransformComponent>(
+            glm::vec3(record.position[0], record.position[1], record.position[2]),
+            glm::vec3(record.rotation[0], record.rotation[1], record.rotation[2]),
+            glm::vec3(record.scale[0], record.scale[1], record.scale[2]));
+
+        // Exactly as saved, instead of rebuilding it from the Euler cache
+        transform->orientation = glm::quat(record.orientation[0], record.orientation[1],
+                                           record.orientation[2], record.orientation[3]);
+        transform->previousOrientation = transform->orientation;
+        if (transformTable.stride >= sizeof(TransformRecord)) {
+            transform->position = glm::dvec3(record.precisePosition[0], record.precisePosition[1],
+                                             record.precisePosition[2]);
+            transform->previousPosition = transform->position;
+        }
+        transform->SetEnabled((record.flags & FLAG_ENABLED) != 0);
+        transforms[record.entity] = transform.get();
+    }
+    for (uint32_t i = 0; i < transformTable.count; ++i) {
+        const auto record = ReadRecord<TransformRecord>(tableData(TABLE_TRANSFORMS), transformTable.stride, i);
+        if (record.parent != NONE && !transforms[record.entity]->SetParent(transforms[record.parent])) {
+            std::cerr << "SceneSerializer: " << path << ": parent of entity " << rows[record.entity]->GetID()
+                      << " would form a cycle, loaded as a root" << std::endl;
+        }
+    }
+
+    for (uint32_t i = 0; i < renderTable.count; ++i) {
+        const auto record = ReadRecord<RenderRecord>(tableData(TABLE_RENDERS), renderTable.stride, i);
+        auto render = rows[record.entity]->AddComponent<RenderComponent>(
+            static_cast<PrimitiveType>(record.primitive),
+            glm::vec3(record.color[0], record.color[1], record.color[2]),
+            (record.flags & FLAG_VISIBLE) != 0);
+        if (record.meshPath != NONE) {
+            render->SetMeshPath(strings.Get(record.meshPath, NONE));
+        }
+        render->SetEnabled((record.flags & FLAG_ENABLED) != 0);
+    }
+
+    for (uint32_t i = 0; i < physicsTable.count; ++i) {
+        const auto record = ReadRecord<PhysicsRecord>(tableData(TABLE_PHYSICS), physicsTable.stride, i);
+        auto physics = rows[record.entity]->AddComponent<SimplePhysicsComponent>(
+            record.mass, (record.flags & FLAG_GRAVITY) != 0);
+        if (record.flags & FLAG_SLEEPING) {
+            physics->Sleep();
+        }
+        physics->SetVelocity(glm::vec3(record.velocity[0], record.velocity[1], record.velocity[2]));
+        physics->SetAcceleration(glm::vec3(record.acceleration[0], record.acceleration[1], record.acceleration[2]));
+        physics->SetBounceDamping(record.bounceDamping);
+        physics->SetWorldBounds((record.flags & FLAG_BOUNDS) != 0);
+        physics->SetSleepTime(record.sleepTime);
+        physics->SetEnabled((record.flags & FLAG_ENABLED) != 0);
+    }
+
+    for (uint32_t i = 0; i < colliderTable.count; ++i) {
+        const auto record = ReadRecord<ColliderRecord>(tableData(TABLE_COLLIDERS), colliderTable.stride, i);
+        auto collider = rows[record.entity]->AddComponent<CollisionComponent>(
+            static_cast<CollisionShape>(record.shape), (record.flags & FLAG_TRIGGER) != 0,
+            (record.flags & FLAG_STATIC) != 0, strings.Get(record.layer, NONE));
+        collider->SetCircle(record.circle[0], glm::vec2(record.circle[1], record.circle[2]));
+        collider->SetAABB(glm::vec2(record.aabb[0], record.aabb[1]), glm::vec2(record.aabb[2], record.aabb[3]));
+        collider->SetLine(glm::vec2(record.line[0], record.line[1]), glm::vec2(record.line[2], record.line[3]),
+                          record.line[4]);
+        collider->SetShape(static_cast<CollisionShape>(record.shape)); // The setters above switch shapes
+        collider->SetEnabled((record.flags & FLAG_ENABLED) != 0);
+    }
+
+    FixedTimestep& timestep = scene.GetTimestep();
+    timestep.SetStepSize(header.stepSize);
+    timestep.SetSubsteps(header.substeps);
+    timestep.SetMaxStepsPerFrame(header.maxStepsPerFrame);
+
+    if (created) {
+        created->insert(created->end(), rows.begin(), rows.end());
+    }
+    return true;
+}
+
+} // namespace Logic
+} // namespace Engine
@@ -1,5 +1,4 @@
 #include "../include/SimplePhysicsComponent.h"
-#include "../include/Entity.h"
 #include "../include/TransformComponent.h"
 #include <iostream>
 #include <iomanip>
@@ -9,13 +8,10 @@
 namespace Engine {
 namespace Logic {
 
-void SimplePhysicsComponent::Update(float deltaTime) {
-    if (!owner) return;
+void SimplePhysicsComponent::Integrate(TransformComponent& transform, float deltaTime) {
+    if (sleeping) return;
 
-    auto transform = owner->GetComponent<TransformComponent>();
-    if (!transform) return;
-
-    glm::vec3 position = transform->GetPosition();
+    glm::vec3 position = transform.GetPosition();
 
     // Apply gravity if enabled
     if (affectedByGravity) {
@@ -25,6 +21,11 @@ void SimplePhysicsComponent::Update(float deltaTime) {
     // Update position
     position += velocity * deltaTime;
 
+    if (!worldBounds) {
+        transform.SetPosition(position);
+        return;
+    }
+
     // Simple floor collision (bounce)
     if (position.y < 0.5f && velocity.y < 0.0f) { // Assuming cube size ~1.0
         position.y = 0.5f; // Keep above floor
@@ -50,7 +51,7 @@ void SimplePhysicsComponent::Update(float deltaTime) {
         position.z = std::clamp(position.z, -10.0f, 10.0f);
     }
 
-    transform->SetPosition(position);
+    transform.SetPosition(position);
 }
 
 std::string SimplePhysicsComponent::GetDebugInfo() const {
@@ -59,7 +60,8 @@ std::string SimplePhysicsComponent::GetDebugInfo() const {
     oss << "Velocity: (" << velocity.x << ", " << velocity.y << ", " << velocity.z << ")\n";
     oss << "Mass: " << mass << "\n";
     oss << "Gravity: " << (affectedByGravity ? "ON" : "OFF") << "\n";
-    oss << "Bounce Damping: " << bounceDamping;
+    oss << "Bounce Damping: " << bounceDamping << "\n";
+    oss << "Sleeping: " << (sleeping ? "YES" : "NO");
     return oss.str();
 }
 
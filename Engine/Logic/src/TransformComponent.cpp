@@ -1,21 +1,94 @@
 #include "../include/TransformComponent.h"
+#include "../include/Scene.h"
+#include "../include/TransformSystem.h"
 #include <glm/gtc/type_ptr.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/euler_angles.hpp>
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
 
 namespace Engine{
 namespace Logic{
 
+namespace {
+
+    // Euler angles in the order UpdateMatrix always used: X, then Y, then Z
+    glm::quat EulerToQuat(const glm::vec3& rotation) {
+        return glm::angleAxis(rotation.x, glm::vec3(1, 0, 0)) *
+               glm::angleAxis(rotation.y, glm::vec3(0, 1, 0)) *
+               glm::angleAxis(rotation.z, glm::vec3(0, 0, 1));
+    }
+
+    glm::vec3 QuatToEuler(const glm::quat& orientation) {
+        glm::vec3 rotation;
+        glm::extractEulerAngleXYZ(glm::mat4_cast(orientation), rotation.x, rotation.y, rotation.z);
+        return rotation;
+    }
+
+    // R * S written out column by column, no matrix products. The
+    // translation column is left at zero: callers add it, in double where
+    // it matters.
+    glm::mat4 ComposeLinear(const glm::quat& orientation, const glm::vec3& scale) {
+        glm::mat4 matrix(1.0f);
+        if (orientation.x == 0.0f && orientation.y == 0.0f) {
+            // 2D fast path (particles, walls): rotation about Z only, or none
+            const float cosine = orientation.w * orientation.w - orientation.z * orientation.z;
+            const float sine = 2.0f * orientation.w * orientation.z;
+            matrix[0] = glm::vec4(cosine * scale.x, sine * scale.x, 0.0f, 0.0f);
+            matrix[1] = glm::vec4(-sine * scale.y, cosine * scale.y, 0.0f, 0.0f);
+            matrix[2] = glm::vec4(0.0f, 0.0f, scale.z, 0.0f);
+        } else {
+            const glm::mat3 rotation = glm::mat3_cast(orientation);
+            matrix[0] = glm::vec4(rotation[0] * scale.x, 0.0f);
+            matrix[1] = glm::vec4(rotation[1] * scale.y, 0.0f);
+            matrix[2] = glm::vec4(rotation[2] * scale.z, 0.0f);
+        }
+        return matrix;
+    }
+
+    // Parent's rotation and scale applied to a local position, in double
+    glm::dvec3 TransformOffset(const glm::mat4& linear, const glm::dvec3& offset) {
+        return glm::dvec3(linear[0]) * offset.x + glm::dvec3(linear[1]) * offset.y +
+               glm::dvec3(linear[2]) * offset.z;
+    }
+
+} // namespace
+
     TransformComponent::TransformComponent(const glm::vec3& pos, const glm::vec3& rot, const glm::vec3& scl)
-        : position(pos), rotation(rot), scale(scl), transformMatrix(1.0f), isDirty(true) {
+        : position(pos), orientation(EulerToQuat(rot)), rotation(rot), scale(scl),
+          previousPosition(pos), previousOrientation(orientation), previousScale(scl),
+          worldMatrix(1.0f), worldPosition(0.0), isDirty(true) {
     }
 
-    void TransformComponent::Update(float deltaTime) {
-        // Transform components typically don't need per-frame updates
-        // unless you're doing interpolation or animations
-        // For now, this can remain empty or handle interpolation if needed
+    TransformComponent::~TransformComponent() {
+        Unlink();
+    }
+
+    void TransformComponent::Initialize() {
+        // Owner is set by now; new transforms start out dirty
+        MarkDirty();
+    }
+
+    void TransformComponent::Destroy() {
+        Unlink();
+    }
+
+    void TransformComponent::Unlink() {
+        DetachFromParent();
+
+        // Children stay where they are in local terms, as roots
+        for (TransformComponent* child : children) {
+            child->parent = nullptr;
+            child->UpdateDepth();
+            child->MarkDirty();
+        }
+        children.clear();
+
+        // Last, nothing above may queue this transform again
+        if (queuedIn) {
+            queuedIn->Remove(*this);
+        }
     }
 
     std::string TransformComponent::GetDebugInfo() const {
@@ -24,29 +97,47 @@ namespace Logic{
         oss << "Position: (" << position.x << ", " << position.y << ", " << position.z << ")\n";
         oss << "Rotation: (" << rotation.x << ", " << rotation.y << ", " << rotation.z << ")\n";
         oss << "Scale: (" << scale.x << ", " << scale.y << ", " << scale.z << ")";
+        if (parent || !children.empty()) {
+            oss << "\nDepth: " << depth << ", Children: " << children.size();
+        }
         return oss.str();
     }
 
     void TransformComponent::SetPosition(const glm::vec3& pos) {
-        position = pos;
+        position = glm::dvec3(pos);
         MarkDirty();
     }
 
     void TransformComponent::Translate(const glm::vec3& delta) {
-        position += delta;
+        position += glm::dvec3(delta);
+        MarkDirty();
+    }
+
+    void TransformComponent::SetPrecisePosition(const glm::dvec3& pos) {
+        position = pos;
         MarkDirty();
     }
 
     void TransformComponent::SetRotation(const glm::vec3& rot) {
         rotation = rot;
+        orientation = EulerToQuat(rot);
         MarkDirty();
     }
 
     void TransformComponent::Rotate(const glm::vec3& delta) {
-        rotation += delta;
+        SetRotation(rotation + delta);
+    }
+
+    void TransformComponent::SetOrientation(const glm::quat& quat) {
+        orientation = glm::normalize(quat);
+        rotation = QuatToEuler(orientation);
         MarkDirty();
     }
 
+    void TransformComponent::Rotate(const glm::quat& delta) {
+        SetOrientation(orientation * delta);
+    }
+
     void TransformComponent::SetScale(const glm::vec3& scl) {
         scale = scl;
         MarkDirty();
@@ -57,44 +148,165 @@ namespace Logic{
         MarkDirty();
     }
 
-    const glm::mat4& TransformComponent::GetTransformMatrix() const {
+    bool TransformComponent::SetParent(TransformComponent* newParent) {
+        if (newParent == parent) return true;
+        for (const TransformComponent* ancestor = newParent; ancestor; ancestor = ancestor->parent) {
+            if (ancestor == this) return false;
+        }
+
+        DetachFromParent();
+        parent = newParent;
+        if (parent) {
+            parent->children.push_back(this);
+        }
+        UpdateDepth();
+        MarkDirty();
+        return true;
+    }
+
+    void TransformComponent::DetachFromParent() {
+        if (!parent) return;
+
+        auto& siblings = parent->children;
+        auto it = std::find(siblings.begin(), siblings.end(), this);
+        if (it != siblings.end()) {
+            *it = siblings.back();
+            siblings.pop_back();
+        }
+        parent = nullptr;
+    }
+
+    void TransformComponent::UpdateDepth() {
+        depth = parent ? parent->depth + 1 : 0;
+        for (TransformComponent* child : children) {
+            child->UpdateDepth();
+        }
+    }
+
+    void TransformComponent::MarkDirty() {
+        MarkSubtreeDirty();
+
+        // First edit since the last rebuild: join the scene's dirty list.
+        // Detached entities have none and rebuild on demand instead.
+        if (!queuedIn && owner) {
+            if (Scene* scene = owner->GetScene()) {
+                scene->GetTransformSystem().Queue(*this);
+            }
+        }
+    }
+
+    void TransformComponent::MarkSubtreeDirty() {
+        isDirty = true;
+        for (TransformComponent* child : children) {
+            if (!child->isDirty) {
+                child->MarkSubtreeDirty();
+            }
+        }
+    }
+
+    void TransformComponent::RebuildWorldMatrix() const {
+        const glm::mat4 local = ComposeLinear(orientation, scale);
+        if (parent) {
+            const glm::mat4& parentWorld = parent->GetWorldMatrix();
+            worldMatrix = parentWorld * local;
+            worldPosition = parent->worldPosition + TransformOffset(parentWorld, position);
+        } else {
+            worldMatrix = local;
+            worldPosition = position;
+        }
+        worldMatrix[3] = glm::vec4(glm::vec3(worldPosition), 1.0f);
+        isDirty = false;
+    }
+
+    const glm::mat4& TransformComponent::GetWorldMatrix() const {
+        if (isDirty) {
+            RebuildWorldMatrix();
+        }
+        return worldMatrix;
+    }
+
+    const glm::dvec3& TransformComponent::GetPreciseWorldPosition() const {
         if (isDirty) {
-            UpdateMatrix();
-            isDirty = false;
+            RebuildWorldMatrix();
+        }
+        return worldPosition;
+    }
+
+    glm::mat4 TransformComponent::GetRelativeMatrix(const glm::dvec3& origin) const {
+        glm::mat4 matrix = GetWorldMatrix();
+        matrix[3] = glm::vec4(glm::vec3(worldPosition - origin), 1.0f);
+        return matrix;
+    }
+
+    glm::mat4 TransformComponent::GetLocalMatrix() const {
+        glm::mat4 matrix = ComposeLinear(orientation, scale);
+        matrix[3] = glm::vec4(glm::vec3(position), 1.0f);
+        return matrix;
+    }
+
+    void TransformComponent::StorePreviousState() {
+        previousPosition = position;
+        previousOrientation = orientation;
+        previousScale = scale;
+    }
+
+    glm::mat4 TransformComponent::GetInterpolatedMatrix(float alpha, const glm::dvec3& origin) const {
+        glm::mat4 matrix;
+        glm::dvec3 translation;
+        InterpolateWorld(alpha, matrix, translation);
+        matrix[3] = glm::vec4(glm::vec3(translation - origin), 1.0f);
+        return matrix;
+    }
+
+    void TransformComponent::InterpolateWorld(float alpha, glm::mat4& linear, glm::dvec3& translation) const {
+        const bool atRest = position == previousPosition && orientation == previousOrientation &&
+                            scale == previousScale;
+
+        // Objects at rest (walls, settled bodies) reuse the cached matrix
+        if (alpha >= 1.0f || (atRest && !parent)) {
+            linear = GetWorldMatrix();
+            translation = worldPosition;
+            return;
         }
-        return transformMatrix;
+
+        glm::mat4 local;
+        glm::dvec3 localPosition;
+        if (atRest) {
+            local = ComposeLinear(orientation, scale);
+            localPosition = position;
+        } else {
+            local = ComposeLinear(glm::slerp(previousOrientation, orientation, alpha),
+                                  glm::mix(previousScale, scale, alpha));
+            localPosition = glm::mix(previousPosition, position, static_cast<double>(alpha));
+        }
+
+        if (!parent) {
+            linear = local;
+            translation = localPosition;
+            return;
+        }
+
+        glm::mat4 parentLinear;
+        glm::dvec3 parentTranslation;
+        parent->InterpolateWorld(alpha, parentLinear, parentTranslation);
+        linear = parentLinear * local;
+        translation = parentTranslation + TransformOffset(parentLinear, localPosition);
     }
 
     glm::vec3 TransformComponent::GetForward() const {
-        const glm::mat4& transform = GetTransformMatrix();
+        const glm::mat4& transform = GetWorldMatrix();
         return -glm::normalize(glm::vec3(transform[2])); // Negative Z is forward in OpenGL
     }
 
     glm::vec3 TransformComponent::GetRight() const {
-        const glm::mat4& transform = GetTransformMatrix();
+        const glm::mat4& transform = GetWorldMatrix();
         return glm::normalize(glm::vec3(transform[0])); // Positive X is right
     }
 
     glm::vec3 TransformComponent::GetUp() const {
-        const glm::mat4& transform = GetTransformMatrix();
+        const glm::mat4& transform = GetWorldMatrix();
         return glm::normalize(glm::vec3(transform[1])); // Positive Y is up
     }
 
-    void TransformComponent::UpdateMatrix() const {
-        // Create transformation matrix: T * R * S
-        transformMatrix = glm::mat4(1.0f);
-
-        // Apply translation
-        transformMatrix = glm::translate(transformMatrix, position);
-
-        // Apply rotation (assuming rotation is in radians)
-        if (rotation.x != 0.0f) transformMatrix = glm::rotate(transformMatrix, rotation.x, glm::vec3(1, 0, 0));
-        if (rotation.y != 0.0f) transformMatrix = glm::rotate(transformMatrix, rotation.y, glm::vec3(0, 1, 0));
-        if (rotation.z != 0.0f) transformMatrix = glm::rotate(transformMatrix, rotation.z, glm::vec3(0, 0, 1));
-
-        // Apply scale
-        transformMatrix = glm::scale(transformMatrix, scale);
-    }
-
 } // namespace Logic
 } // namespace Engine
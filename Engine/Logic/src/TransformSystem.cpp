@@ -0,0 +1,96 @@
+#include "../include/TransformSystem.h"
+#include "../include/TransformComponent.h"
+#include "../../Common/include/FrameArena.h"
+#include "../../Common/include/JobSystem.h"
+#include "../../Common/include/Profiler.h"
+#include <algorithm>
+
+namespace Engine {
+namespace Logic {
+
+TransformSystem::~TransformSystem() {
+    for (TransformComponent* transform : dirty) {
+        if (transform) {
+            transform->queuedIn = nullptr;
+        }
+    }
+}
+
+void TransformSystem::Queue(TransformComponent& transform) {
+    if (transform.queuedIn) return;
+
+    transform.queuedIn = this;
+    transform.queuedSlot = static_cast<uint32_t>(dirty.size());
+    dirty.push_back(&transform);
+}
+
+void TransformSystem::Remove(TransformComponent& transform) {
+    if (transform.queuedIn != this) return;
+
+    dirty[transform.queuedSlot] = nullptr;
+    transform.queuedIn = nullptr;
+}
+
+void TransformSystem::Update() {
+    lastRebuildCount = 0;
+    if (dirty.empty()) return;
+    PROFILE_SCOPE("TransformSystem::Update");
+
+    Common::FrameVector<TransformComponent*> order;
+    order.reserve(dirty.size());
+    bool nested = false;
+    for (TransformComponent* transform : dirty) {
+        if (!transform) continue;
+        transform->queuedIn = nullptr;
+        order.push_back(transform);
+        nested = nested || transform->depth > 0;
+    }
+    dirty.clear();
+
+    // Sorting by depth is a topological order of the hierarchy. Scenes
+    // without parents (all of them so far) skip it.
+    if (nested) {
+        std::stable_sort(order.begin(), order.end(),
+            [](const TransformComponent* a, const TransformComponent* b) { return a->depth < b->depth; });
+    }
+
+    // Each queued transform rebuilds its dirty subtree; transforms already
+    // rebuilt as part of an ancestor's subtree are clean by then
+    Common::FrameVector<const TransformComponent*> stack;
+    for (const TransformComponent* root : order) {
+        if (!root->isDirty) continue;
+
+        stack.push_back(root);
+        while (!stack.empty()) {
+            const TransformComponent* transform = stack.back();
+            stack.pop_back();
+
+            transform->RebuildWorldMatrix();
+            lastRebuildCount++;
+            for (const TransformComponent* child : transform->children) {
+                if (child->isDirty) {
+                    stack.push_back(child);
+                }
+            }
+        }
+    }
+}
+
+void TransformSystem::BuildRelativeMatrices(const TransformComponent* const* transforms, size_t count,
+                                            const glm::dvec3& origin, float alpha, glm::mat4* out) {
+    // Afterwards nothing in the scene is dirty, the getters below don't
+    // write to the transforms
+    Update();
+    if (count == 0) return;
+    PROFILE_SCOPE("TransformSystem::BuildRelativeMatrices");
+
+    const size_t transformsPerTask = 1024;
+    Common::JobSystem::Get().ParallelFor(0, count, transformsPerTask, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            out[i] = transforms[i]->GetInterpolatedMatrix(alpha, origin);
+        }
+    });
+}
+
+} // namespace Logic
+} // namespace Engine
@@ -9,6 +9,7 @@
  * 
  * Compile:
  *   g++ -std=c++17 -o test_density test_density.cpp -lm
+ *   (add -DBASIC_ENGINE_SIMD -O2 to test and time the SIMD batch kernels)
  * 
  * Run:
  *   ./test_density
@@ -223,6 +224,58 @@ void testIslandDistribution() {
 // PERFORMANCE TEST
 // ============================================================================
 
+void testBatchSampling() {
+    std::cout << "\n=== Batch Sampling Tests ===" << std::endl;
+    
+    const char* levels[] = {"scalar", "AVX2", "NEON"};
+    std::cout << "  Batch kernel: " << levels[static_cast<int>(SimplexNoise::simdLevel())] << std::endl;
+    
+    SimplexNoise noise(12345);
+    EndDensity density(0);
+    
+    // Points spanning all regions, odd count to exercise the lane tail
+    std::vector<double> xs, ys, zs;
+    for (int i = 0; i < 4099; i++) {
+        double angle = i * 0.0137;
+        double radius = (i % 7) * 450.0 + i * 0.37;
+        xs.push_back(std::cos(angle) * radius);
+        ys.push_back(40.0 + (i % 31) * 2.3);
+        zs.push_back(std::sin(angle) * radius);
+    }
+    const size_t n = xs.size();
+    
+    std::vector<double> batch(n);
+    noise.sample3DBatch(xs.data(), ys.data(), zs.data(), batch.data(), n);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (batch[i] != noise.sample3D(xs[i], ys[i], zs[i])) mismatches++;
+    }
+    test("sample3DBatch matches sample3D exactly", mismatches == 0);
+    
+    noise.octave3DBatch(xs.data(), ys.data(), zs.data(), batch.data(), n, 4);
+    mismatches = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (batch[i] != noise.octave3D(xs[i], ys[i], zs[i], 4)) mismatches++;
+    }
+    test("octave3DBatch matches octave3D exactly", mismatches == 0);
+    
+    density.sampleBatch(xs.data(), ys.data(), zs.data(), batch.data(), n);
+    mismatches = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (batch[i] != density.sample(xs[i], ys[i], zs[i])) mismatches++;
+    }
+    test("EndDensity::sampleBatch matches sample exactly", mismatches == 0);
+    
+    std::vector<float> fx(xs.begin(), xs.end()), fy(ys.begin(), ys.end()), fz(zs.begin(), zs.end());
+    std::vector<float> fout(n);
+    density.sampleBatch(fx.data(), fy.data(), fz.data(), fout.data(), n);
+    mismatches = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (fout[i] != static_cast<float>(density.sample(fx[i], fy[i], fz[i]))) mismatches++;
+    }
+    test("Float sampleBatch matches widened scalar samples", mismatches == 0);
+}
+
 void testPerformance() {
     std::cout << "\n=== Performance Tests ===" << std::endl;
     
@@ -238,6 +291,8 @@ void testPerformance() {
         sum += noise.sample3D(i * 0.01, i * 0.02, i * 0.03);
     }
     auto end = std::chrono::high_resolution_clock::now();
+    volatile double sink = sum;  // Keep the loop from being optimized away
+    (void)sink;
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
     
     std::cout << "  Simplex 3D: " << iterations << " samples in " 
@@ -257,10 +312,36 @@ void testPerformance() {
               << duration.count() / 1000.0 << " ms" << std::endl;
     std::cout << "    (" << duration.count() * 1000.0 / (iterations / 10) << " ns/sample)" << std::endl;
     
+    // Same samples through the batch API
+    std::vector<double> xs(iterations), ys(iterations), zs(iterations), out(iterations);
+    for (int i = 0; i < iterations; i++) {
+        xs[i] = i * 0.01;
+        ys[i] = i * 0.02;
+        zs[i] = i * 0.03;
+    }
+    start = std::chrono::high_resolution_clock::now();
+    noise.sample3DBatch(xs.data(), ys.data(), zs.data(), out.data(), iterations);
+    end = std::chrono::high_resolution_clock::now();
+    auto batchDuration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    std::cout << "  Simplex 3D batch: " << batchDuration.count() * 1000.0 / iterations << " ns/sample" << std::endl;
+    
+    const int densitySamples = iterations / 10;
+    for (int i = 0; i < densitySamples; i++) {
+        xs[i] = i * 0.5;
+        ys[i] = 64.0;
+        zs[i] = i * 0.3;
+    }
+    start = std::chrono::high_resolution_clock::now();
+    density.sampleBatch(xs.data(), ys.data(), zs.data(), out.data(), densitySamples);
+    end = std::chrono::high_resolution_clock::now();
+    batchDuration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    std::cout << "  End Density batch: " << batchDuration.count() * 1000.0 / densitySamples
+              << " ns/sample" << std::endl;
+    
     // Estimate ray march performance
     // Assume 256 steps per ray, 1920x1080 pixels
     double samplesPerFrame = 256 * 1920 * 1080;
-    double nsPerSample = duration.count() * 1000.0 / (iterations / 10);
+    double nsPerSample = batchDuration.count() * 1000.0 / densitySamples;
     double msPerFrame = samplesPerFrame * nsPerSample / 1e6;
     
     std::cout << "\n  Estimated CPU ray march time: " << msPerFrame << " ms/frame" << std::endl;
@@ -279,6 +360,7 @@ int main() {
     testSimplexNoise();
     testEndDensity();
     testIslandDistribution();
+    testBatchSampling();
     testPerformance();
     
     std::cout << "\n============================================" << std::endl;